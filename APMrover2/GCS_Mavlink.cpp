@@ -565,6 +565,11 @@ bool GCS_MAVLINK::try_send_message(enum ap_message id)
         rover.gcs[chan-MAVLINK_COMM_0].send_battery2(rover.battery);
         break;
 
+    case MSG_LATENCY:
+        CHECK_PAYLOAD_SIZE(DEBUG_VECT);
+        rover.gcs[chan-MAVLINK_COMM_0].send_latency();
+        break;
+
     case MSG_CAMERA_FEEDBACK:
 #if CAMERA == ENABLED
         CHECK_PAYLOAD_SIZE(CAMERA_FEEDBACK);
@@ -604,6 +609,7 @@ bool GCS_MAVLINK::try_send_message(enum ap_message id)
     case MSG_OPTICAL_FLOW:
     case MSG_GIMBAL_REPORT:
     case MSG_RPM:
+    case MSG_GYRO_FFT:
         break; // just here to prevent a warning
 
     }
@@ -835,6 +841,7 @@ GCS_MAVLINK::data_stream_send(void)
         send_message(MSG_MAG_CAL_PROGRESS);
         send_message(MSG_MOUNT_STATUS);
         send_message(MSG_EKF_STATUS_REPORT);
+        send_message(MSG_LATENCY);
     }
 }
 
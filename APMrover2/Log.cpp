@@ -405,6 +405,8 @@ const LogStructure Rover::log_structure[] = {
 void Rover::log_init(void)
 {
 	DataFlash.Init(log_structure, ARRAY_SIZE(log_structure));
+    DataFlash.set_msg_rate(LOG_NTUN_MSG, 10);
+    DataFlash.set_msg_rate(LOG_CTUN_MSG, 10);
     if (!DataFlash.CardInserted()) {
         gcs_send_text(MAV_SEVERITY_WARNING, "No dataflash card inserted");
         g.log_bitmask.set(0);
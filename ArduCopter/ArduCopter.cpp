@@ -134,6 +134,8 @@ const AP_Scheduler::Task Copter::scheduler_tasks[] = {
     SCHED_TASK(perf_update,           0.1,    75),
     SCHED_TASK(read_receiver_rssi,    10,     75),
     SCHED_TASK(rpm_update,            10,    200),
+    SCHED_TASK(gyro_fft_update,      400,     50),
+    SCHED_TASK(update_dynamic_notch,  50,     50),
     SCHED_TASK(compass_cal_update,   100,    100),
     SCHED_TASK(accel_cal_update,      10,    100),
 #if ADSB_ENABLED == ENABLED
@@ -258,15 +260,17 @@ void Copter::fast_loop()
     // --------------------
     read_AHRS();
 
-    // run low level rate controllers that only require IMU data
-    attitude_control.rate_controller_run();
-    
+    if (!rate_thread_active) {
+        // run low level rate controllers that only require IMU data
+        attitude_control.rate_controller_run();
+
 #if FRAME_CONFIG == HELI_FRAME
-    update_heli_control_dynamics();
+        update_heli_control_dynamics();
 #endif //HELI_FRAME
 
-    // send outputs to the motors library
-    motors_output();
+        // send outputs to the motors library
+        motors_output();
+    }
 
     // Inertial Nav
     // --------------------
@@ -278,6 +282,11 @@ void Copter::fast_loop()
     // run the attitude controllers
     update_flight_mode();
 
+    // hand the new rate targets to the rate loop
+    if (rate_thread_active) {
+        attitude_control.publish_rate_targets();
+    }
+
     // update home from EKF if necessary
     update_home_from_EKF();
 
@@ -290,6 +299,55 @@ void Copter::fast_loop()
     }
 }
 
+/*
+  run the rate controller and send outputs to the motors, on the
+  rate loop thread straight after each IMU read, from the targets
+  last published by fast_loop()
+ */
+void Copter::rate_loop()
+{
+    const uint32_t now = AP_HAL::micros();
+    const float dt = constrain_float((now - rate_loop_timer) * 1.0e-6f, 0.5f*rate_loop_dt, 2.0f*rate_loop_dt);
+    rate_loop_timer = now;
+
+    if (__atomic_load_n(&rate_loop_paused, __ATOMIC_SEQ_CST)) {
+        // the main loop is driving the motors, as compassmot does
+    } else if (__atomic_load_n(&rate_loop_failsafe, __ATOMIC_ACQUIRE)) {
+        // the main loop has locked up, see failsafe_check()
+        if (__atomic_exchange_n(&rate_loop_disarm, false, __ATOMIC_ACQ_REL)) {
+            motors.armed(false);
+        }
+        motors.output_min();
+    } else if (attitude_control.rate_controller_run_latest(dt)) {
+        motors_output();
+    } else {
+        // no targets from the main loop yet, or too old to fly on
+        motors.output_min();
+    }
+
+    __atomic_add_fetch(&rate_loop_count, 1, __ATOMIC_SEQ_CST);
+}
+
+/*
+  stop or restart rate_loop() sending outputs, so the main loop can
+  drive the motors itself. Pausing waits for a run already in progress
+  to finish, so the two threads never send outputs at once
+ */
+void Copter::rate_loop_pause(bool pause)
+{
+    __atomic_store_n(&rate_loop_paused, pause, __ATOMIC_SEQ_CST);
+    if (!pause || !rate_thread_active) {
+        return;
+    }
+
+    // a run which missed the flag has finished once a later run has
+    const uint32_t count = __atomic_load_n(&rate_loop_count, __ATOMIC_SEQ_CST);
+    const uint32_t start_ms = millis();
+    while (__atomic_load_n(&rate_loop_count, __ATOMIC_SEQ_CST) - count < 2 && millis() - start_ms < 100) {
+        hal.scheduler->delay_microseconds(100);
+    }
+}
+
 // rc_loops - reads user input from transmitter/receiver
 // called at 100hz
 void Copter::rc_loop()
@@ -351,6 +409,8 @@ void Copter::update_batt_compass(void)
         // update compass with throttle value - used for compassmot
         compass.set_throttle(motors.get_throttle()/1000.0f);
         compass.read();
+        // refine offsets and motor compensation while flying
+        compass.learn_inflight(ahrs.get_rotation_body_to_ned(), motors.armed() && !ap.land_complete);
         // log compass information
         if (should_log(MASK_LOG_COMPASS)) {
             DataFlash.Log_Write_Compass(compass);
@@ -390,6 +450,12 @@ void Copter::ten_hz_logging_loop()
     }
     if (should_log(MASK_LOG_IMU) || should_log(MASK_LOG_IMU_FAST) || should_log(MASK_LOG_IMU_RAW)) {
         DataFlash.Log_Write_Vibration(ins);
+        if (ins.get_gyro_harmonic_notch_params().enabled()) {
+            DataFlash.Log_Write_Notch(ins);
+        }
+        if (gyro_fft.enabled()) {
+            DataFlash.Log_Write_GyroFFT(gyro_fft);
+        }
     }
 #if FRAME_CONFIG == HELI_FRAME
     Log_Write_Heli();
@@ -90,6 +90,13 @@ Copter::Copter(void) :
     pmTest1(0),
     fast_loopTimer(0),
     mainLoop_count(0),
+    rate_thread_active(false),
+    rate_loop_timer(0),
+    rate_loop_dt(MAIN_LOOP_SECONDS),
+    rate_loop_count(0),
+    rate_loop_paused(false),
+    rate_loop_failsafe(false),
+    rate_loop_disarm(false),
     rtl_loiter_start_time(0),
     auto_trim_counter(0),
     ServoRelayEvents(relay),
@@ -101,6 +101,7 @@
 #include <AP_Terrain/AP_Terrain.h>
 #include <AP_ADSB/AP_ADSB.h>
 #include <AP_RPM/AP_RPM.h>
+#include <AP_GyroFFT/AP_GyroFFT.h>
 #if PRECISION_LANDING == ENABLED
 #include <AC_PrecLand/AC_PrecLand.h>
 #include <AP_IRLock/AP_IRLock.h>
@@ -182,6 +183,9 @@ private:
 
     AP_RPM rpm_sensor;
 
+    // onboard vibration analysis
+    AP_GyroFFT gyro_fft{ins};
+
     // Inertial Navigation EKF
     NavEKF EKF{&ahrs, barometer, sonar};
     NavEKF2 EKF2{&ahrs, barometer, sonar};
@@ -442,6 +446,18 @@ private:
     uint32_t fast_loopTimer;
     // Counter of main loop executions.  Used for performance monitoring and failsafe processing
     uint16_t mainLoop_count;
+    // true if the rate controller and motor outputs are run by rate_loop() on their own thread
+    bool rate_thread_active;
+    // Time in microseconds of the last rate_loop() and its nominal interval in seconds
+    uint32_t rate_loop_timer;
+    float rate_loop_dt;
+    // Number of rate_loop() runs finished, so rate_loop_pause() can wait for one in progress
+    uint32_t rate_loop_count;
+    // true while the main loop drives the motors itself and rate_loop() must not
+    bool rate_loop_paused;
+    // set by failsafe_check() on the timer thread, for rate_loop() to send minimum outputs and to disarm
+    bool rate_loop_failsafe;
+    bool rate_loop_disarm;
     // Loiter timer - Records how long we have been in loiter
     uint32_t rtl_loiter_start_time;
 
@@ -559,6 +575,9 @@ private:
     void barometer_accumulate(void);
     void perf_update(void);
     void fast_loop();
+    void rate_loop();
+    void rate_thread_init();
+    void rate_loop_pause(bool pause);
     void rc_loop();
     void throttle_loop();
     void update_mount();
@@ -620,7 +639,10 @@ private:
     void send_current_waypoint(mavlink_channel_t chan);
     void send_rangefinder(mavlink_channel_t chan);
     void send_rpm(mavlink_channel_t chan);
+    void send_gyro_fft(mavlink_channel_t chan);
     void rpm_update();
+    void gyro_fft_update();
+    void update_dynamic_notch();
     void send_pid_tuning(mavlink_channel_t chan);
     void send_statustext(mavlink_channel_t chan);
     bool telemetry_delayed(mavlink_channel_t chan);
@@ -423,6 +423,31 @@ void NOINLINE Copter::send_rpm(mavlink_channel_t chan)
 }
 
 
+/*
+  send the peak vibration frequency on each gyro axis. Axes without a
+  clear peak are sent as zero
+ */
+void NOINLINE Copter::send_gyro_fft(mavlink_channel_t chan)
+{
+    if (!gyro_fft.enabled()) {
+        return;
+    }
+    float peak_hz[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        const AP_GyroFFT::Axis &axis = gyro_fft.get_axis(i);
+        peak_hz[i] = axis.valid ? axis.peak_freq_hz : 0.0f;
+    }
+    // DEBUG_VECT copies all 10 characters of the name
+    const char name[10] = "GYROFFT";
+    mavlink_msg_debug_vect_send(
+        chan,
+        name,
+        AP_HAL::micros64(),
+        peak_hz[0],
+        peak_hz[1],
+        peak_hz[2]);
+}
+
 /*
   send PID tuning message
  */
@@ -731,6 +756,16 @@ bool GCS_MAVLINK::try_send_message(enum ap_message id)
         send_vibration(copter.ins);
         break;
 
+    case MSG_GYRO_FFT:
+        CHECK_PAYLOAD_SIZE(DEBUG_VECT);
+        copter.send_gyro_fft(chan);
+        break;
+
+    case MSG_LATENCY:
+        CHECK_PAYLOAD_SIZE(DEBUG_VECT);
+        send_latency();
+        break;
+
     case MSG_MISSION_ITEM_REACHED:
         CHECK_PAYLOAD_SIZE(MISSION_ITEM_REACHED);
         mavlink_msg_mission_item_reached_send(chan, mission_item_reached_index);
@@ -972,6 +1007,8 @@ GCS_MAVLINK::data_stream_send(void)
         send_message(MSG_EKF_STATUS_REPORT);
         send_message(MSG_VIBRATION);
         send_message(MSG_RPM);
+        send_message(MSG_GYRO_FFT);
+        send_message(MSG_LATENCY);
     }
 }
 
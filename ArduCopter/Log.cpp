@@ -806,6 +806,9 @@ void Copter::start_logging()
 void Copter::log_init(void)
 {
     DataFlash.Init(log_structure, ARRAY_SIZE(log_structure));
+    DataFlash.set_msg_rate(LOG_NAV_TUNING_MSG, 10);
+    DataFlash.set_msg_rate(LOG_CONTROL_TUNING_MSG, 10);
+    DataFlash.set_msg_rate(LOG_RATE_MSG, 50);
     if (!DataFlash.CardInserted()) {
         gcs_send_text(MAV_SEVERITY_WARNING, "No dataflash card inserted");
         g.log_bitmask.set(0);
@@ -387,7 +387,7 @@ const AP_Param::Info Copter::var_info[] = {
     // @Param: FRAME
     // @DisplayName: Frame Orientation (+, X or V)
     // @Description: Controls motor mixing for multicopters.  Not used for Tri or Traditional Helicopters.
-    // @Values: 0:Plus, 1:X, 2:V, 3:H, 4:V-Tail, 5:A-Tail, 10:Y6B (New)
+    // @Values: 0:Plus, 1:X, 2:V, 3:H, 4:V-Tail, 5:A-Tail, 10:Y6B (New), 14:Custom (MOT_MIXn)
     // @User: Standard
     GSCALAR(frame_orientation, "FRAME",             AP_MOTORS_X_FRAME),
 
@@ -511,6 +511,15 @@ const AP_Param::Info Copter::var_info[] = {
     // @Values: 0:Disabled, 1:Enabled
     // @User: Advanced
     GSCALAR(fs_crash_check, "FS_CRASH_CHECK",    1),
+
+    // @Param: RATE_THREAD_HZ
+    // @DisplayName: Rate loop thread rate
+    // @Description: On boards that support it, runs the rate controller and motor outputs on their own realtime thread at this rate, straight after each IMU read, rather than in the main loop. Rates are limited to 1kHz to 2kHz. Not supported on helicopters. Requires a reboot
+    // @Values: 0:Disabled, 1000:1kHz, 2000:2kHz
+    // @Units: Hz
+    // @Range: 0 2000
+    // @User: Advanced
+    GSCALAR(rate_thread_hz, "RATE_THREAD_HZ",    0),
     
 #if FRAME_CONFIG ==     HELI_FRAME
     // @Group: HS1_
@@ -1013,8 +1022,8 @@ const AP_Param::Info Copter::var_info[] = {
 
 #else
     // @Group: MOT_
-    // @Path: ../libraries/AP_Motors/AP_MotorsMulticopter.cpp
-    GOBJECT(motors, "MOT_",         AP_MotorsMulticopter),
+    // @Path: ../libraries/AP_Motors/AP_MotorsMatrix.cpp,../libraries/AP_Motors/AP_MotorsMulticopter.cpp
+    GOBJECT(motors, "MOT_",         AP_MotorsMatrix),
 #endif
 
     // @Group: RCMAP_
@@ -1065,6 +1074,10 @@ const AP_Param::Info Copter::var_info[] = {
     // @Path: ../libraries/AP_RPM/AP_RPM.cpp
     GOBJECT(rpm_sensor, "RPM", AP_RPM),
 
+    // @Group: FFT_
+    // @Path: ../libraries/AP_GyroFFT/AP_GyroFFT.cpp
+    GOBJECT(gyro_fft, "FFT_", AP_GyroFFT),
+
     // @Group: ADSB_
     // @Path: ../libraries/AP_ADSB/AP_ADSB.cpp
     GOBJECT(adsb,                "ADSB_", AP_ADSB),
@@ -55,6 +55,7 @@ public:
         k_param_ins_old,                        // *** Deprecated, remove with next eeprom number change
         k_param_ins,                            // libraries/AP_InertialSensor variables
         k_param_NavEKF2,
+        k_param_gyro_fft,                       // libraries/AP_GyroFFT variables
 
         // simulation
         k_param_sitl = 10,
@@ -180,6 +181,7 @@ public:
         k_param_motors = 90,
         k_param_disarm_delay,
         k_param_fs_crash_check,
+        k_param_rate_thread_hz,
 
         // 97: RSSI
         k_param_rssi = 97,
@@ -445,6 +447,7 @@ public:
     AP_Int8         land_repositioning;
     AP_Int8         fs_ekf_action;
     AP_Int8         fs_crash_check;
+    AP_Int16        rate_thread_hz;
     AP_Float        fs_ekf_thresh;
     AP_Int16        gcs_pid_mask;
 
@@ -128,7 +128,8 @@ uint8_t Copter::mavlink_compassmot(mavlink_channel_t chan)
         interference_pct[i] = 0.0f;
     }
 
-    // enable motors and pass through throttle
+    // take the motors from the rate loop thread, then enable them and pass through throttle
+    rate_loop_pause(true);
     init_rc_out();
     enable_motor_output();
     motors.armed(true);
@@ -236,6 +237,7 @@ uint8_t Copter::mavlink_compassmot(mavlink_channel_t chan)
     // stop motors
     motors.output_min();
     motors.armed(false);
+    rate_loop_pause(false);
 
     // set and save motor compensation
     if (updated) {
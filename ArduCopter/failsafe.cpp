@@ -44,6 +44,8 @@ void Copter::failsafe_check()
         failsafe_last_timestamp = tnow;
         if (in_failsafe) {
             in_failsafe = false;
+            __atomic_store_n(&rate_loop_disarm, false, __ATOMIC_RELEASE);
+            __atomic_store_n(&rate_loop_failsafe, false, __ATOMIC_RELEASE);
             Log_Write_Error(ERROR_SUBSYSTEM_CPU,ERROR_CODE_FAILSAFE_RESOLVED);
         }
         return;
@@ -55,7 +57,10 @@ void Copter::failsafe_check()
         // disarm the motors.
         in_failsafe = true;
         // reduce motors to minimum (we do not immediately disarm because we want to log the failure)
-        if (motors.armed()) {
+        if (rate_thread_active) {
+            // the rate loop thread owns the motors, and sends the minimum itself
+            __atomic_store_n(&rate_loop_failsafe, true, __ATOMIC_RELEASE);
+        } else if (motors.armed()) {
             motors.output_min();
         }
         // log an error
@@ -66,8 +71,12 @@ void Copter::failsafe_check()
         // disarm motors every second
         failsafe_last_timestamp = tnow;
         if(motors.armed()) {
-            motors.armed(false);
-            motors.output();
+            if (rate_thread_active) {
+                __atomic_store_n(&rate_loop_disarm, true, __ATOMIC_RELEASE);
+            } else {
+                motors.armed(false);
+                motors.output();
+            }
         }
     }
 }
@@ -110,11 +110,13 @@ uint8_t Copter::mavlink_motor_test_start(mavlink_channel_t chan, uint8_t motor_s
             // start test
             ap.motor_test = true;
 
-            // enable and arm motors
+            // enable and arm motors, with the rate loop thread kept off them meanwhile
             if (!motors.armed()) {
+                rate_loop_pause(true);
                 init_rc_out();
                 enable_motor_output();
                 motors.armed(true);
+                rate_loop_pause(false);
             }
 
             // disable throttle, battery and gps failsafe
@@ -82,6 +82,66 @@ void Copter::rpm_update(void)
     }
 }
 
+/*
+  collect gyro samples for onboard vibration analysis
+ */
+void Copter::gyro_fft_update()
+{
+    gyro_fft.update();
+}
+
+/*
+  move the gyro harmonic notch to follow the motor frequency, estimated
+  from the configured source
+ */
+void Copter::update_dynamic_notch()
+{
+    const HarmonicNotchFilterParams &notch = ins.get_gyro_harmonic_notch_params();
+    if (!notch.enabled()) {
+        return;
+    }
+
+    const float base_freq_hz = notch.center_freq_hz();
+    const float ref = notch.reference();
+
+    if (notch.tracking_mode() == HarmonicNotchFilterParams::TRACKING_FFT) {
+        // the analysis measures the vibration directly so needs no reference
+        if (gyro_fft.healthy()) {
+            ins.update_harmonic_notch_freq_hz(gyro_fft.get_weighted_peak_freq_hz());
+        } else {
+            ins.update_harmonic_notch_freq_hz(base_freq_hz);
+        }
+        return;
+    }
+
+    if (ref <= 0.0f) {
+        ins.update_harmonic_notch_freq_hz(base_freq_hz);
+        return;
+    }
+
+    switch (notch.tracking_mode()) {
+    case HarmonicNotchFilterParams::TRACKING_THROTTLE: {
+        // motor speed is roughly proportional to the square root of thrust
+        float throttle = motors.get_throttle() * 0.001f;
+        ins.update_harmonic_notch_freq_hz(base_freq_hz * safe_sqrt(throttle / ref));
+        break;
+    }
+
+    case HarmonicNotchFilterParams::TRACKING_RPM:
+        if (rpm_sensor.healthy(0)) {
+            ins.update_harmonic_notch_freq_hz(rpm_sensor.get_rpm(0) * (1.0f/60.0f) * ref);
+        } else {
+            ins.update_harmonic_notch_freq_hz(base_freq_hz);
+        }
+        break;
+
+    case HarmonicNotchFilterParams::TRACKING_FIXED:
+    default:
+        ins.update_harmonic_notch_freq_hz(base_freq_hz);
+        break;
+    }
+}
+
 // initialise compass
 void Copter::init_compass()
 {
@@ -199,6 +199,9 @@ void Copter::init_ardupilot()
     attitude_control.set_dt(MAIN_LOOP_SECONDS);
     pos_control.set_dt(MAIN_LOOP_SECONDS);
 
+    // move the rate controller onto its own thread if enabled
+    rate_thread_init();
+
     // init the optical flow sensor
     init_optflow();
 
@@ -263,6 +266,9 @@ void Copter::init_ardupilot()
 
     startup_INS_ground();
 
+    // start onboard vibration analysis now the gyros are registered
+    gyro_fft.init();
+
     // set landed flags
     set_land_complete(true);
     set_land_complete_maybe(true);
@@ -288,6 +294,27 @@ void Copter::init_ardupilot()
 }
 
 
+/*
+  start the rate loop thread if RATE_THREAD_HZ is set and the board
+  supports it, otherwise the rate controller stays in fast_loop()
+ */
+void Copter::rate_thread_init()
+{
+#if FRAME_CONFIG != HELI_FRAME
+    if (g.rate_thread_hz <= 0) {
+        return;
+    }
+    const uint16_t rate_hz = constrain_int16(g.rate_thread_hz, 1000, 2000);
+    if (!hal.scheduler->register_rate_process(FUNCTOR_BIND_MEMBER(&Copter::rate_loop, void), rate_hz)) {
+        cliSerial->printf("Rate thread not supported\n");
+        return;
+    }
+    rate_loop_dt = 1.0f / rate_hz;
+    motors.set_loop_rate(rate_hz);
+    rate_thread_active = true;
+#endif
+}
+
 //******************************************************************************
 //This function does all the calibrations, etc. that we need during a ground start
 //******************************************************************************
@@ -804,6 +804,7 @@ bool GCS_MAVLINK::try_send_message(enum ap_message id)
         break; // just here to prevent a warning
 
     case MSG_LIMITS_STATUS:
+    case MSG_GYRO_FFT:
         // unused
         break;
 
@@ -817,6 +818,11 @@ bool GCS_MAVLINK::try_send_message(enum ap_message id)
         send_vibration(plane.ins);
         break;
 
+    case MSG_LATENCY:
+        CHECK_PAYLOAD_SIZE(DEBUG_VECT);
+        send_latency();
+        break;
+
     case MSG_RPM:
         CHECK_PAYLOAD_SIZE(RPM);
         plane.send_rpm(chan);
@@ -1076,6 +1082,7 @@ GCS_MAVLINK::data_stream_send(void)
         send_message(MSG_EKF_STATUS_REPORT);
         send_message(MSG_GIMBAL_REPORT);
         send_message(MSG_VIBRATION);
+        send_message(MSG_LATENCY);
     }
 }
 
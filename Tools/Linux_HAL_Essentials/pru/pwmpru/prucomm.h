@@ -26,6 +26,8 @@ struct pwm_config {
 
 #define MIN_PWM_PULSE	PRU_us(4)
 
+#define DSHOT_FRAME_BITS	16
+
 struct pwm_multi_config {
 	u32 enmask;	/* enable mask */
 	u32 offmsk;	/* state when pwm is off */
@@ -42,6 +44,9 @@ struct pwm_multi_config {
 #define PWM_CMD_CLR	5	/* clr a pwm output explicitly */ 
 #define PWM_CMD_TEST	6	/* various crap */
 
+/* features of this firmware, written back to pwm_cmd.caps */
+#define PWM_CAPS_DSHOT	BIT(0)
+
 struct pwm_cmd {
         u32 magic;
 	u32 enmask;	/* enable mask */
@@ -49,6 +54,14 @@ struct pwm_cmd {
 	u32 periodhi[MAX_PWMS][2];
         u32 hilo_read[MAX_PWMS][2];
         u32 enmask_read;
+	/* DShot: outputs in dshot_mask send packet[] when dshot_seq changes */
+	u32 dshot_mask;
+	u32 dshot_bit;		/* bit period, in cycles */
+	u32 dshot_t0h;		/* high time of a 0 bit */
+	u32 dshot_t1h;		/* high time of a 1 bit */
+	u32 dshot_seq;
+	u32 dshot_packet[MAX_PWMS];
+	u32 caps;		/* PWM_CAPS_*, the host clears it to probe */
 };
 struct pwm_cmd_l{
     u32 enmask;
@@ -33,6 +33,45 @@ static inline u32 read_PIEP_COUNT(void)
 
 }
 
+/*
+ * send the DShot packets on all the outputs in mask at once. Bits are
+ * timed from the start of the frame, so the time taken between edges
+ * does not add up over the frame
+ */
+static void dshot_send(u32 mask)
+{
+	u32 zeros[DSHOT_FRAME_BITS];
+	u32 bit, t0h, t1h, start;
+	u8 i, b;
+
+	bit = PWM_CMD->dshot_bit;
+	t0h = PWM_CMD->dshot_t0h;
+	t1h = PWM_CMD->dshot_t1h;
+
+	/* outputs that go low at t0h in each bit, the rest at t1h */
+	for (b = 0; b < DSHOT_FRAME_BITS; b++) {
+		zeros[b] = 0;
+		for (i = 0; i < MAX_PWMS; i++) {
+			if ((mask & (1U << i)) &&
+			    (PWM_CMD->dshot_packet[i] & (0x8000 >> b)) == 0)
+				zeros[b] |= 1U << i;
+		}
+	}
+
+	start = read_PIEP_COUNT();
+	for (b = 0; b < DSHOT_FRAME_BITS; b++, start += bit) {
+		while ((read_PIEP_COUNT() - start) & (1U << 31))
+			;
+		__R30 |= mask;
+		while (read_PIEP_COUNT() - start < t0h)
+			;
+		__R30 &= ~zeros[b];
+		while (read_PIEP_COUNT() - start < t1h)
+			;
+		__R30 &= ~mask;
+	}
+}
+
 int main(int argc, char *argv[])
 {
        	u8 i;
@@ -44,6 +83,9 @@ int main(int argc, char *argv[])
     u32 period;
 	u32 enmask;	/* enable mask */
 	u32 stmask;	/* state mask */
+	u32 dshotmask;	/* enabled outputs sending DShot */
+	u32 dshotseq;
+	u32 pwmmask;	/* enabled outputs sending PWM */
 	static u32 next_hi_lo[MAX_PWMS][3];
 	static struct cxt cxt;
 	/* enable OCP master port */
@@ -86,6 +128,8 @@ int main(int argc, char *argv[])
         PWM_CMD->periodhi[i][1] = 180000;        
 	}
     PWM_CMD->enmask = 0;
+	PWM_CMD->dshot_mask = 0;
+	dshotseq = PWM_CMD->dshot_seq;
 	clrmsk = enmask;
 	setmsk = 0;
 	/* guaranteed to be immediate */
@@ -141,8 +185,22 @@ int main(int argc, char *argv[])
             PWM_CMD->magic = PWM_REPLY_MAGIC;
 		}
         PWM_CMD->enmask_read = enmask;
+		PWM_CMD->caps = PWM_CAPS_DSHOT;
+
+		/*
+		 * a DShot frame is sent as soon as the host has new packets.
+		 * PWM edges due during the frame are late by up to its length
+		 */
+		dshotmask = PWM_CMD->dshot_mask & enmask & PWM_EN_MASK;
+		if (dshotmask != 0 && PWM_CMD->dshot_seq != dshotseq) {
+			dshotseq = PWM_CMD->dshot_seq;
+			dshot_send(dshotmask);
+			cnt = read_PIEP_COUNT();
+		}
+		pwmmask = enmask & ~dshotmask;
+
 		/* if nothing is enabled just skip it all */
-		if (enmask == 0)
+		if (pwmmask == 0)
 			continue;
 
 		setmsk = 0;
@@ -152,7 +210,7 @@ int main(int argc, char *argv[])
 
 #define SINGLE_PWM(_i) \
 	do { \
-		if (enmask & (1U << (_i))) { \
+		if (pwmmask & (1U << (_i))) { \
 			nextp = &next_hi_lo[(_i)][0]; \
 			tnext = nextp[0]; \
 			hi = nextp[1]; \
@@ -230,6 +288,8 @@ int main(int argc, char *argv[])
 			if(PWM_CMD->magic == PWM_CMD_MAGIC){
 				break;
 			}
+			if (dshotmask != 0 && PWM_CMD->dshot_seq != dshotseq)
+				break;
 		} while (((next - cnt) & (1U << 31)) == 0);
 	}
 }
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+'''
+run Replay over a set of logs to measure the accuracy impact of running
+the EKF2 prediction at a reduced rate (EK2_PRED_MS)
+
+for each log a reference solution is generated at the default 10msec
+prediction period, then the log is replayed at each requested period and
+the maximum difference from the reference is reported
+'''
+
+import optparse, os, sys, glob
+
+parser = optparse.OptionParser("CompareEKF2Predict")
+parser.add_option("--logdir", type='string', default='testlogs', help='directory of logs to use, or a single log')
+parser.add_option("--periods", type='string', default='20,30,40', help='comma separated list of EK2_PRED_MS values to compare')
+parser.add_option("--parm", type='string', action='append', default=[], help='extra NAME=VALUE parameters passed to every replay')
+
+opts, args = parser.parse_args()
+
+def run_cmd(cmd, dir=".", show=False, output=False, checkfail=True):
+    '''run a shell command'''
+    from subprocess import call, check_call,Popen, PIPE
+    if show:
+        print("Running: '%s' in '%s'" % (cmd, dir))
+    if output:
+        return Popen([cmd], shell=True, stdout=PIPE, cwd=dir).communicate()[0]
+    elif checkfail:
+        return check_call(cmd, shell=True, cwd=dir)
+    else:
+        return call(cmd, shell=True, cwd=dir)
+
+def extra_parms():
+    '''command line arguments for user supplied parameters'''
+    return " ".join(["--parm %s" % p for p in opts.parm])
+
+def get_log_list():
+    '''get a list of source logs to process'''
+    if os.path.isfile(opts.logdir):
+        full_file_list = [opts.logdir]
+    else:
+        full_file_list = glob.glob(os.path.join(opts.logdir, "*.bin"))
+    file_list = [f for f in full_file_list if not f.endswith("-ekf2ref.bin")]
+    if len(file_list) == 0:
+        print("No logs to process in %s" % opts.logdir)
+        sys.exit(1)
+    return file_list
+
+def create_reference_log(logfile):
+    '''replay a log at the default prediction period, recording the solution in CHEK messages'''
+    log_list_current = set(glob.glob("logs/*.BIN"))
+    cmd = "./Replay.elf -- --check-generate --check-ekf2 --parm EK2_PRED_MS=10 %s %s" % (extra_parms(), logfile)
+    run_cmd(cmd, checkfail=True)
+    log_list_after = set(glob.glob("logs/*.BIN"))
+    changed = log_list_after.difference(log_list_current)
+    if len(changed) != 1:
+        print("Failed to generate reference log for %s" % logfile)
+        sys.exit(1)
+    name, ext = os.path.splitext(logfile)
+    refname = name + '-ekf2ref.bin'
+    os.rename(list(changed)[0], refname)
+    return refname
+
+def compare_period(reflog, period):
+    '''replay a reference log at the given prediction period and return the errors'''
+    try:
+        os.unlink("replay_results.txt")
+    except OSError:
+        pass
+    cmd = "./Replay.elf -- --check --check-ekf2 --parm EK2_PRED_MS=%u %s %s" % (period, extra_parms(), reflog)
+    run_cmd(cmd, checkfail=False)
+    try:
+        line = open("replay_results.txt").readline().strip()
+    except IOError:
+        return None
+    a = line.split("\t")
+    if len(a) != 6:
+        return None
+    return a[1:]
+
+periods = [int(p) for p in opts.periods.split(',')]
+
+results = []
+for logfile in get_log_list():
+    print("Processing %s" % logfile)
+    reflog = create_reference_log(logfile)
+    for period in periods:
+        results.append((logfile, period, compare_period(reflog, period)))
+
+print("")
+print("%-40s %6s %8s %8s %8s %8s %8s" % ("Log", "PredMS", "Roll", "Pitch", "Yaw", "Pos(m)", "Vel(m/s)"))
+for (logfile, period, errors) in results:
+    if errors is None:
+        print("%-40s %6u %s" % (os.path.basename(logfile), period, "replay failed"))
+        continue
+    print("%-40s %6u %8s %8s %8s %8s %8s" % tuple([os.path.basename(logfile), period] + errors))
@@ -254,6 +254,7 @@ private:
     bool have_fram = false;
     bool use_imt = true;
     bool check_generate = false;
+    bool check_ekf2 = false;
     float tolerance_euler = 3;
     float tolerance_pos = 2;
     float tolerance_vel = 2;
@@ -285,6 +286,7 @@ private:
     void set_user_parameters(void);
     void read_sensors(const char *type);
     void log_check_generate();
+    void get_check_solution(Vector3f &euler, Vector3f &velocity, Location &loc);
     void log_check_solution();
     bool show_error(const char *text, float max_error, float tolerance);
     void report_checks();
@@ -304,6 +306,7 @@ void Replay::usage(void)
     ::printf("\t--no-imt           don't use IMT data\n");
     ::printf("\t--check-generate   generate CHEK messages in output\n");
     ::printf("\t--check            check solution against CHEK messages\n");
+    ::printf("\t--check-ekf2       use EKF2 rather than EKF1 for CHEK messages\n");
     ::printf("\t--tolerance-euler  tolerance for euler angles in degrees\n");
     ::printf("\t--tolerance-pos    tolerance for position in meters\n");
     ::printf("\t--tolerance-vel    tolerance for velocity in meters/second\n");
@@ -315,6 +318,7 @@ void Replay::usage(void)
 enum {
     OPT_CHECK = 128,
     OPT_CHECK_GENERATE,
+    OPT_CHECK_EKF2,
     OPT_TOLERANCE_EULER,
     OPT_TOLERANCE_POS,
     OPT_TOLERANCE_VEL,
@@ -366,6 +370,7 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"no-imt",          false,  0, 'n'},
         {"check-generate",  false,  0, OPT_CHECK_GENERATE},
         {"check",           false,  0, OPT_CHECK},
+        {"check-ekf2",      false,  0, OPT_CHECK_EKF2},
         {"tolerance-euler", true,   0, OPT_TOLERANCE_EULER},
         {"tolerance-pos",   true,   0, OPT_TOLERANCE_POS},
         {"tolerance-vel",   true,   0, OPT_TOLERANCE_VEL},
@@ -421,6 +426,10 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             check_solution = true;
             break;
 
+        case OPT_CHECK_EKF2:
+            check_ekf2 = true;
+            break;
+
         case OPT_TOLERANCE_EULER:
             tolerance_euler = atof(gopt.optarg);
             break;
@@ -771,6 +780,22 @@ void Replay::read_sensors(const char *type)
 }
 
 
+/*
+  get the solution used for CHEK messages from the selected EKF
+ */
+void Replay::get_check_solution(Vector3f &euler, Vector3f &velocity, Location &loc)
+{
+    if (check_ekf2) {
+        _vehicle.EKF2.getEulerAngles(-1, euler);
+        _vehicle.EKF2.getVelNED(-1, velocity);
+        _vehicle.EKF2.getLLH(loc);
+    } else {
+        _vehicle.EKF.getEulerAngles(euler);
+        _vehicle.EKF.getVelNED(velocity);
+        _vehicle.EKF.getLLH(loc);
+    }
+}
+
 /*
   copy current data to CHEK message
  */
@@ -780,9 +805,7 @@ void Replay::log_check_generate(void)
     Vector3f velocity;
     Location loc {};
 
-    _vehicle.EKF.getEulerAngles(euler);
-    _vehicle.EKF.getVelNED(velocity);
-    _vehicle.EKF.getLLH(loc);
+    get_check_solution(euler, velocity, loc);
 
     struct log_Chek packet = {
         LOG_PACKET_HEADER_INIT(LOG_CHEK_MSG),
@@ -812,9 +835,7 @@ void Replay::log_check_solution(void)
     Vector3f velocity;
     Location loc {};
 
-    _vehicle.EKF.getEulerAngles(euler);
-    _vehicle.EKF.getVelNED(velocity);
-    _vehicle.EKF.getLLH(loc);
+    get_check_solution(euler, velocity, loc);
 
     float roll_error  = degrees(fabsf(euler.x - check_state.euler.x));
     float pitch_error = degrees(fabsf(euler.y - check_state.euler.y));
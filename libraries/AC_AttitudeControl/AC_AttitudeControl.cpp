@@ -76,9 +76,15 @@ void AC_AttitudeControl::relax_bf_rate_controller()
     // to the input angular velocity and reset the angular velocity integrators.
     // This zeros the output of the angular velocity controller.
     _ang_vel_target_rads = _ahrs.get_gyro();
-    _pid_rate_roll.reset_I();
-    _pid_rate_pitch.reset_I();
-    _pid_rate_yaw.reset_I();
+
+    // once targets are published a rate loop thread owns the integrators, and
+    // resets them itself when it sees the count change
+    if (_rate_targets.count() == 0) {
+        _pid_rate_roll.reset_I();
+        _pid_rate_pitch.reset_I();
+        _pid_rate_yaw.reset_I();
+    }
+    _rate_reset_count++;
 
     // Write euler derivatives derived from vehicle angular velocity to
     // _att_target_euler_rate_rads. This resets the state of the input shapers.
@@ -401,9 +407,58 @@ void AC_AttitudeControl::input_att_quat_bf_ang_vel(const Quaternion& att_target_
 
 void AC_AttitudeControl::rate_controller_run()
 {
-    _motors.set_roll(rate_bf_to_motor_roll(_ang_vel_target_rads.x));
-    _motors.set_pitch(rate_bf_to_motor_pitch(_ang_vel_target_rads.y));
-    _motors.set_yaw(rate_bf_to_motor_yaw(_ang_vel_target_rads.z));
+    rate_controller_update(_ang_vel_target_rads, _ahrs.get_gyro());
+}
+
+void AC_AttitudeControl::publish_rate_targets()
+{
+    rate_targets targets;
+    targets.ang_vel_target_rads = _ang_vel_target_rads;
+    targets.gyro_correction_rads = _ahrs.get_gyro() - _ahrs.get_ins().get_gyro();
+    targets.reset_count = _rate_reset_count;
+    targets.time_us = AP_HAL::micros();
+    targets.max_age_us = AC_ATTITUDE_RATE_TARGETS_TIMEOUT_LOOPS * _dt * 1.0e6f;
+    _rate_targets.write(targets);
+}
+
+bool AC_AttitudeControl::rate_controller_run_latest(float dt)
+{
+    // keep the last targets and gyro if they are being written
+    if (_rate_targets.read(_rate_targets_latest)) {
+        _rate_targets_valid = true;
+    }
+    if (_ahrs.get_ins().get_latest_gyro(_rate_gyro_latest)) {
+        _rate_gyro_valid = true;
+    }
+    if (!_rate_targets_valid || !_rate_gyro_valid) {
+        return false;
+    }
+
+    // don't keep flying on the targets of a main loop which has stopped
+    if (AP_HAL::micros() - _rate_targets_latest.time_us > _rate_targets_latest.max_age_us) {
+        return false;
+    }
+
+    if (_rate_targets_latest.reset_count != _rate_reset_count_seen) {
+        _rate_reset_count_seen = _rate_targets_latest.reset_count;
+        _pid_rate_roll.reset_I();
+        _pid_rate_pitch.reset_I();
+        _pid_rate_yaw.reset_I();
+    }
+
+    _pid_rate_roll.set_dt(dt);
+    _pid_rate_pitch.set_dt(dt);
+    _pid_rate_yaw.set_dt(dt);
+    rate_controller_update(_rate_targets_latest.ang_vel_target_rads,
+                           _rate_gyro_latest + _rate_targets_latest.gyro_correction_rads);
+    return true;
+}
+
+void AC_AttitudeControl::rate_controller_update(const Vector3f& ang_vel_target_rads, const Vector3f& gyro_rads)
+{
+    _motors.set_roll(rate_bf_to_motor_roll(ang_vel_target_rads.x, gyro_rads.x));
+    _motors.set_pitch(rate_bf_to_motor_pitch(ang_vel_target_rads.y, gyro_rads.y));
+    _motors.set_yaw(rate_bf_to_motor_yaw(ang_vel_target_rads.z, gyro_rads.z));
 }
 
 void AC_AttitudeControl::euler_rate_to_ang_vel(const Vector3f& euler_rad, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads)
@@ -519,9 +574,8 @@ void AC_AttitudeControl::update_ang_vel_target_from_att_error()
     _ang_vel_target_rads.y += -_att_error_rot_vec_rad.x * _ahrs.get_gyro().z;
 }
 
-float AC_AttitudeControl::rate_bf_to_motor_roll(float rate_target_rads)
+float AC_AttitudeControl::rate_bf_to_motor_roll(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().x;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // For legacy reasons, we convert to centi-degrees before inputting to the PID
@@ -542,9 +596,8 @@ float AC_AttitudeControl::rate_bf_to_motor_roll(float rate_target_rads)
     return constrain_float(output, -AC_ATTITUDE_RATE_RP_CONTROLLER_OUT_MAX, AC_ATTITUDE_RATE_RP_CONTROLLER_OUT_MAX);
 }
 
-float AC_AttitudeControl::rate_bf_to_motor_pitch(float rate_target_rads)
+float AC_AttitudeControl::rate_bf_to_motor_pitch(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().y;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // For legacy reasons, we convert to centi-degrees before inputting to the PID
@@ -565,9 +618,8 @@ float AC_AttitudeControl::rate_bf_to_motor_pitch(float rate_target_rads)
     return constrain_float(output, -AC_ATTITUDE_RATE_RP_CONTROLLER_OUT_MAX, AC_ATTITUDE_RATE_RP_CONTROLLER_OUT_MAX);
 }
 
-float AC_AttitudeControl::rate_bf_to_motor_yaw(float rate_target_rads)
+float AC_AttitudeControl::rate_bf_to_motor_yaw(float rate_target_rads, float current_rate_rads)
 {
-    float current_rate_rads = _ahrs.get_gyro().z;
     float rate_error_rads = rate_target_rads - current_rate_rads;
 
     // For legacy reasons, we convert to centi-degrees before inputting to the PID
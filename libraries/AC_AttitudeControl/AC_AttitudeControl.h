@@ -8,6 +8,7 @@
 
 #include <AP_Common/AP_Common.h>
 #include <AP_Param/AP_Param.h>
+#include <AP_HAL/utility/SeqLock.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
 #include <AP_AHRS/AP_AHRS.h>
@@ -44,6 +45,8 @@
 
 #define AC_ATTITUDE_CONTROL_ALTHOLD_LEANANGLE_FILT_HZ   1.0f    // filter (in hz) of throttle filter used to limit lean angle so that vehicle does not lose altitude
 
+#define AC_ATTITUDE_RATE_TARGETS_TIMEOUT_LOOPS          5       // main loop periods after which a rate loop thread stops flying on the published rate targets
+
 class AC_AttitudeControl {
 public:
     AC_AttitudeControl( AP_AHRS &ahrs,
@@ -64,7 +67,11 @@ public:
         _p_angle_yaw(pi_angle_yaw),
         _pid_rate_roll(pid_rate_roll),
         _pid_rate_pitch(pid_rate_pitch),
-        _pid_rate_yaw(pid_rate_yaw)
+        _pid_rate_yaw(pid_rate_yaw),
+        _rate_reset_count(0),
+        _rate_targets_valid(false),
+        _rate_reset_count_seen(0),
+        _rate_gyro_valid(false)
         {
             AP_Param::setup_object_defaults(this, var_info);
         }
@@ -132,6 +139,16 @@ public:
     // Run angular velocity controller and send outputs to the motors
     virtual void rate_controller_run();
 
+    // Hand the angular velocity target to a rate loop running on its own thread.
+    // Called by the main loop in place of rate_controller_run()
+    void publish_rate_targets();
+
+    // Run angular velocity controller on a rate loop thread, from the last published targets
+    // and the latest gyro sample, and send outputs to the motors. Returns false until targets
+    // and a gyro sample are available, and once the targets are more than
+    // AC_ATTITUDE_RATE_TARGETS_TIMEOUT_LOOPS main loop periods old
+    bool rate_controller_run_latest(float dt);
+
     // Convert a 321-intrinsic euler angle derivative to an angular velocity vector
     void euler_rate_to_ang_vel(const Vector3f& euler_rad, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads);
 
@@ -247,14 +264,17 @@ protected:
     // Update _ang_vel_target_rads using _att_error_rot_vec_rad
     void update_ang_vel_target_from_att_error();
 
+    // Run angular velocity controller on a target and a body-frame angular velocity
+    void rate_controller_update(const Vector3f& ang_vel_target_rads, const Vector3f& gyro_rads);
+
     // Run the roll angular velocity PID controller and return the output
-    float rate_bf_to_motor_roll(float rate_target_rads);
+    float rate_bf_to_motor_roll(float rate_target_rads, float current_rate_rads);
 
     // Run the pitch angular velocity PID controller and return the output
-    float rate_bf_to_motor_pitch(float rate_target_rads);
+    float rate_bf_to_motor_pitch(float rate_target_rads, float current_rate_rads);
 
     // Run the yaw angular velocity PID controller and return the output
-    virtual float rate_bf_to_motor_yaw(float rate_target_rads);
+    float rate_bf_to_motor_yaw(float rate_target_rads, float current_rate_rads);
 
     // Compute a throttle value that is adjusted for the tilt angle of the vehicle
     virtual float get_boosted_throttle(float throttle_in) = 0;
@@ -341,6 +361,24 @@ protected:
     AC_PID&             _pid_rate_roll;
     AC_PID&             _pid_rate_pitch;
     AC_PID&             _pid_rate_yaw;
+
+    // targets handed from the main loop to a rate loop thread
+    struct rate_targets {
+        Vector3f        ang_vel_target_rads;    // reference angular velocity
+        Vector3f        gyro_correction_rads;   // AHRS less INS angular velocity, such as the EKF gyro bias
+        uint32_t        reset_count;            // changes each time the rate integrators are reset
+        uint32_t        time_us;                // system time the targets were published
+        uint32_t        max_age_us;             // age after which the targets are too old to fly on
+    };
+    SeqLock<rate_targets> _rate_targets;
+    uint32_t            _rate_reset_count;      // main loop count of rate integrator resets
+
+    // rate loop thread copies of the targets and gyro
+    rate_targets        _rate_targets_latest;
+    bool                _rate_targets_valid;
+    uint32_t            _rate_reset_count_seen;
+    Vector3f            _rate_gyro_latest;
+    bool                _rate_gyro_valid;
 };
 
 #define AC_ATTITUDE_CONTROL_LOG_FORMAT(msg) { msg, sizeof(AC_AttitudeControl::log_Attitude),	\
@@ -39,6 +39,14 @@ Compass::compass_cal_update()
     }
 }
 
+void
+Compass::_calibration_io_timer()
+{
+    for (uint8_t i=0; i<COMPASS_MAX_INSTANCES; i++) {
+        _calibrator[i].run_fit();
+    }
+}
+
 bool
 Compass::start_calibration(uint8_t i, bool retry, bool autosave, float delay, bool autoreboot)
 {
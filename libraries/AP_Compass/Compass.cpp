@@ -47,8 +47,8 @@ const AP_Param::GroupInfo Compass::var_info[] = {
 
     // @Param: LEARN
     // @DisplayName: Learn compass offsets automatically
-    // @Description: Enable or disable the automatic learning of compass offsets
-    // @Values: 0:Disabled,1:Enabled
+    // @Description: Enable or disable the automatic learning of compass offsets. InFlight learns the offsets, and the motor compensation factors when COMPASS_MOTCT is set, from the vehicle's attitude while flying
+    // @Values: 0:Disabled,1:Enabled,2:InFlight
     // @User: Advanced
     AP_GROUPINFO("LEARN",  3, Compass, _learn, COMPASS_LEARN_DEFAULT),
 
@@ -362,6 +362,8 @@ Compass::Compass(void) :
     _compass_count(0),
     _board_orientation(ROTATION_NONE),
     _null_init_done(false),
+    _learn_save_pending(false),
+    _learn_save_ms(0),
     _thr_or_curr(0.0f),
     _hil_mode(false)
 {
@@ -386,6 +388,7 @@ Compass::init()
     if (_compass_count == 0) {
         // detect available backends. Only called once
         _detect_backends();
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&Compass::_calibration_io_timer, void));
     }
     if (_compass_count != 0) {
         // get initial health status
@@ -513,6 +516,7 @@ Compass::set_offsets(uint8_t i, const Vector3f &offsets)
     // sanity check compass instance provided
     if (i < COMPASS_MAX_INSTANCES) {
         _state[i].offset.set(offsets);
+        _inflight_learn[i].reset();
     }
 }
 
@@ -522,6 +526,7 @@ Compass::set_and_save_offsets(uint8_t i, const Vector3f &offsets)
     // sanity check compass instance provided
     if (i < COMPASS_MAX_INSTANCES) {
         _state[i].offset.set(offsets);
+        _inflight_learn[i].reset();
         save_offsets(i);
     }
 }
@@ -563,6 +568,7 @@ void
 Compass::set_motor_compensation(uint8_t i, const Vector3f &motor_comp_factor)
 {
     _state[i].motor_compensation.set(motor_comp_factor);
+    _inflight_learn[i].reset();
 }
 
 void
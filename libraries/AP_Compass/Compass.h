@@ -5,6 +5,7 @@
 #include <inttypes.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include "CompassCalibrator.h"
+#include "CompassInflightLearn.h"
 #include <AP_Common/AP_Common.h>
 #include <AP_Param/AP_Param.h>
 #include <AP_Math/AP_Math.h>
@@ -28,6 +29,14 @@
 #define AP_COMPASS_MOT_COMP_THROTTLE    0x01
 #define AP_COMPASS_MOT_COMP_CURRENT     0x02
 
+// offset learning types (for use with COMPASS_LEARN)
+#define AP_COMPASS_LEARN_NONE           0x00
+#define AP_COMPASS_LEARN_INTERNAL       0x01
+#define AP_COMPASS_LEARN_INFLIGHT       0x02
+
+// minimum time between saves of the offsets learnt in flight
+#define AP_COMPASS_LEARN_SAVE_MS        30000
+
 // setup default mag orientation for some board types
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX && CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_RASPILOT
 # define MAG_BOARD_ORIENTATION ROTATION_ROLL_180
@@ -201,6 +210,14 @@ public:
     ///
     void learn_offsets(void);
 
+    /// Refine offsets and motor compensation in flight from the field
+    /// expected at the vehicle's attitude. Call after read()
+    ///
+    /// @param  dcm_matrix          body to NED rotation, from the EKF when it is in use
+    /// @param  flying              true while the vehicle is flying
+    ///
+    void learn_inflight(const Matrix3f &dcm_matrix, bool flying);
+
     /// return true if the compass should be used for yaw calculations
     bool use_for_yaw(uint8_t i) const;
     bool use_for_yaw(void) const;
@@ -315,6 +332,9 @@ private:
     void _add_backend(AP_Compass_Backend *backend);
     void _detect_backends(void);
 
+    // runs the calibration fits on the IO thread
+    void _calibration_io_timer(void);
+
     //keep track of number of calibration reports sent
     uint8_t _reports_sent[COMPASS_MAX_INSTANCES];
     
@@ -351,6 +371,11 @@ private:
     // used by offset correction
     static const uint8_t _mag_history_size = 20;
 
+    // in flight learning, offsets waiting to be saved
+    CompassInflightLearn _inflight_learn[COMPASS_MAX_INSTANCES];
+    bool        _learn_save_pending;
+    uint32_t    _learn_save_ms;
+
     // motor compensation type
     // 0 = disabled, 1 = enabled for throttle, 2 = enabled for current
     AP_Int8     _motor_comp_type;
@@ -382,6 +407,9 @@ private:
         // latest compensation added to compass
         Vector3f    motor_offset;
 
+        // last sample used by in flight learning
+        uint32_t    learn_last_usec;
+
         // corrected magnetic field strength
         Vector3f    field;
 
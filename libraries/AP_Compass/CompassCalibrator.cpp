@@ -54,8 +54,16 @@
  * again, the full ellipsoid fit is run, and the state transitions to either
  * SUCCESS or FAILED.
  *
- * The fitting algorithm used is Levenberg-Marquardt. See also:
+ * Each fit starts from a closed form algebraic sphere or ellipsoid fit,
+ * solved from normal equations that are updated as samples are added to or
+ * thinned from the buffer, and is then polished with Levenberg-Marquardt. See
+ * also:
  * http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm
+ *
+ * The fits run on the IO thread, in run_fit(). update() hands the fit over
+ * once the sample buffer is full and takes the result back on a later call,
+ * so the main loop never waits for a fit. The sample buffer is not touched
+ * while a fit is running.
  */
 
 #include "CompassCalibrator.h"
@@ -63,13 +71,131 @@
 
 extern const AP_HAL::HAL& hal;
 
+// samples are scaled down before they are accumulated, so the terms of the
+// normal equations are of similar size
+#define COMPASS_CAL_ACCUM_SCALE 1024.0f
+
+// index of row i, column j (i <= j) in a packed upper triangle of an n by n matrix
+static uint8_t packed_index(uint8_t i, uint8_t j, uint8_t n)
+{
+    return i*n - i*(i-1)/2 + (j-i);
+}
+
+/*
+  solve A x = b in place for symmetric positive definite A (n by n,
+  row major) by Cholesky decomposition. b is replaced by x. Returns
+  false if A is not positive definite
+ */
+static bool cholesky_solve(double *A, double *b, uint8_t n)
+{
+    // A = L L^T, L stored in the lower triangle of A
+    for (uint8_t j=0; j<n; j++) {
+        double d = A[j*n+j];
+        for (uint8_t k=0; k<j; k++) {
+            d -= A[j*n+k] * A[j*n+k];
+        }
+        if (d <= 0.0 || isnan(d)) {
+            return false;
+        }
+        d = sqrt(d);
+        A[j*n+j] = d;
+        for (uint8_t i=j+1; i<n; i++) {
+            double v = A[i*n+j];
+            for (uint8_t k=0; k<j; k++) {
+                v -= A[i*n+k] * A[j*n+k];
+            }
+            A[i*n+j] = v / d;
+        }
+    }
+    // L y = b
+    for (uint8_t i=0; i<n; i++) {
+        for (uint8_t k=0; k<i; k++) {
+            b[i] -= A[i*n+k] * b[k];
+        }
+        b[i] /= A[i*n+i];
+    }
+    // L^T x = y
+    for (int8_t i=n-1; i>=0; i--) {
+        for (uint8_t k=i+1; k<n; k++) {
+            b[i] -= A[k*n+i] * b[k];
+        }
+        b[i] /= A[i*n+i];
+    }
+    return true;
+}
+
+/*
+  square root of a symmetric positive definite 3x3 matrix, by Jacobi
+  eigen decomposition: Q = V D V^T, sqrt(Q) = V sqrt(D) V^T. Returns
+  false if Q is not positive definite
+ */
+static bool sqrt_symmetric(const double Q[3][3], double S[3][3])
+{
+    double A[3][3];
+    double V[3][3] = { {1, 0, 0}, {0, 1, 0}, {0, 0, 1} };
+    memcpy(A, Q, sizeof(A));
+
+    for (uint8_t sweep=0; sweep<20; sweep++) {
+        const double off = fabs(A[0][1]) + fabs(A[0][2]) + fabs(A[1][2]);
+        if (off <= 1.0e-15 * (fabs(A[0][0]) + fabs(A[1][1]) + fabs(A[2][2]))) {
+            break;
+        }
+        for (uint8_t p=0; p<2; p++) {
+            for (uint8_t q=p+1; q<3; q++) {
+                if (A[p][q] == 0.0) {
+                    continue;
+                }
+                // rotate rows and columns p and q to zero A[p][q]
+                const double theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+                const double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta*theta + 1.0));
+                const double c = 1.0 / sqrt(t*t + 1.0);
+                const double s = t * c;
+                for (uint8_t k=0; k<3; k++) {
+                    const double akp = A[k][p];
+                    const double akq = A[k][q];
+                    A[k][p] = c*akp - s*akq;
+                    A[k][q] = s*akp + c*akq;
+                }
+                for (uint8_t k=0; k<3; k++) {
+                    const double apk = A[p][k];
+                    const double aqk = A[q][k];
+                    A[p][k] = c*apk - s*aqk;
+                    A[q][k] = s*apk + c*aqk;
+                }
+                for (uint8_t k=0; k<3; k++) {
+                    const double vkp = V[k][p];
+                    const double vkq = V[k][q];
+                    V[k][p] = c*vkp - s*vkq;
+                    V[k][q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+
+    double root[3];
+    for (uint8_t i=0; i<3; i++) {
+        if (!(A[i][i] > 0.0)) {
+            return false;
+        }
+        root[i] = sqrt(A[i][i]);
+    }
+    for (uint8_t i=0; i<3; i++) {
+        for (uint8_t j=0; j<3; j++) {
+            S[i][j] = V[i][0]*root[0]*V[j][0] + V[i][1]*root[1]*V[j][1] + V[i][2]*root[2]*V[j][2];
+        }
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////
 ///////////////////// PUBLIC INTERFACE /////////////////////
 ////////////////////////////////////////////////////////////
 
 CompassCalibrator::CompassCalibrator():
 _tolerance(COMPASS_CAL_DEFAULT_TOLERANCE),
-_sample_buffer(NULL)
+_sample_buffer(NULL),
+_fit_state(FIT_IDLE),
+_generation(0)
 {
     clear();
 }
@@ -136,8 +262,15 @@ void CompassCalibrator::new_sample(const Vector3f& sample) {
         set_status(COMPASS_CAL_RUNNING_STEP_ONE);
     }
 
+    // a fit left running by an earlier attempt may still be reading the buffer
+    if(__atomic_load_n(&_fit_state, __ATOMIC_ACQUIRE) == FIT_PENDING) {
+        return;
+    }
+
     if(running() && _samples_collected < COMPASS_CAL_NUM_SAMPLES && accept_sample(sample)) {
         _sample_buffer[_samples_collected].set(sample);
+        // accumulate the stored sample, so thinning removes exactly what was added
+        accumulate(_accum, _sample_buffer[_samples_collected].get(), 1.0);
         _samples_collected++;
     }
 }
@@ -145,37 +278,60 @@ void CompassCalibrator::new_sample(const Vector3f& sample) {
 void CompassCalibrator::update(bool &failure) {
     failure = false;
 
+    // free a sample buffer that was kept for a fit that has now finished
+    if(_sample_buffer != NULL && !running() && _status != COMPASS_CAL_WAITING_TO_START) {
+        release_sample_buffer();
+    }
+
     if(!fitting()) {
         return;
     }
 
-    if(_status == COMPASS_CAL_RUNNING_STEP_ONE) {
-        if (_fit_step >= 10) {
-            if(is_equal(_fitness,_initial_fitness) || isnan(_fitness)) {           //if true, means that fitness is diverging instead of converging
-                set_status(COMPASS_CAL_FAILED);
-                failure = true;
-            }
-            set_status(COMPASS_CAL_RUNNING_STEP_TWO);
-        } else {
-            run_sphere_fit();
-            _fit_step++;
+    update_fit(failure);
+}
+
+void CompassCalibrator::run_fit() {
+    if(__atomic_load_n(&_fit_state, __ATOMIC_ACQUIRE) != FIT_PENDING) {
+        return;
+    }
+
+    fit_t &fit = _job.fit;
+    const uint16_t num_samples = _job.num_samples;
+    param_t params;
+
+    fit.fitness = calc_mean_squared_residuals(fit.params, num_samples);
+    fit.sphere_lambda = 1.0f;
+    fit.ellipsoid_lambda = 1.0f;
+    const float initial_fitness = fit.fitness;
+
+    // the closed form fits replace the current parameters only if they are better
+    params = fit.params;
+    if(solve_sphere(_job.accum, params)) {
+        const float fitness = calc_mean_squared_residuals(params, num_samples);
+        if(!isnan(fitness) && fitness < fit.fitness) {
+            fit.params = params;
+            fit.fitness = fitness;
         }
-    } else if(_status == COMPASS_CAL_RUNNING_STEP_TWO) {
-        if (_fit_step >= 35) {
-            if(fit_acceptable()) {
-                set_status(COMPASS_CAL_SUCCESS);
-            } else {
-                set_status(COMPASS_CAL_FAILED);
-                failure = true;
+    }
+    polish_sphere_fit(fit, num_samples);
+
+    if(_job.step == COMPASS_CAL_RUNNING_STEP_ONE) {
+        //if false, means that fitness is diverging instead of converging
+        _job.ok = !isnan(fit.fitness) && fit.fitness < initial_fitness;
+    } else {
+        params = fit.params;
+        if(solve_ellipsoid(_job.accum, params)) {
+            const float fitness = calc_mean_squared_residuals(params, num_samples);
+            if(!isnan(fitness) && fitness < fit.fitness) {
+                fit.params = params;
+                fit.fitness = fitness;
             }
-        } else if (_fit_step < 15) {
-            run_sphere_fit();
-            _fit_step++;
-        } else {
-            run_ellipsoid_fit();
-            _fit_step++;
         }
+        polish_ellipsoid_fit(fit, num_samples);
+        _job.ok = !isnan(fit.fitness);
     }
+
+    __atomic_store_n(&_fit_state, FIT_DONE, __ATOMIC_RELEASE);
 }
 
 /////////////////////////////////////////////////////////////
@@ -189,17 +345,52 @@ bool CompassCalibrator::fitting() const {
     return running() && _samples_collected == COMPASS_CAL_NUM_SAMPLES;
 }
 
+void CompassCalibrator::update_fit(bool &failure) {
+    const uint8_t state = __atomic_load_n(&_fit_state, __ATOMIC_ACQUIRE);
+
+    if(state == FIT_PENDING) {
+        return;
+    }
+
+    if(state == FIT_DONE) {
+        __atomic_store_n(&_fit_state, FIT_IDLE, __ATOMIC_RELAXED);
+        if(_job.generation == _generation && _job.step == _status) {
+            _params = _job.fit.params;
+            _fitness = _job.fit.fitness;
+            if(_status == COMPASS_CAL_RUNNING_STEP_ONE) {
+                if(_job.ok) {
+                    set_status(COMPASS_CAL_RUNNING_STEP_TWO);
+                } else {
+                    set_status(COMPASS_CAL_FAILED);
+                    failure = true;
+                }
+            } else if(_job.ok && fit_acceptable()) {
+                set_status(COMPASS_CAL_SUCCESS);
+            } else {
+                set_status(COMPASS_CAL_FAILED);
+                failure = true;
+            }
+            return;
+        }
+        // the result is for a cancelled attempt, fit this one instead
+    }
+
+    _job.step = _status;
+    _job.num_samples = _samples_collected;
+    _job.generation = _generation;
+    _job.accum = _accum;
+    _job.fit.params = _params;
+    _job.ok = false;
+    __atomic_store_n(&_fit_state, FIT_PENDING, __ATOMIC_RELEASE);
+}
+
 void CompassCalibrator::initialize_fit() {
     //initialize _fitness before starting a fit
     if (_samples_collected != 0) {
-        _fitness = calc_mean_squared_residuals(_params);
+        _fitness = calc_mean_squared_residuals(_params, _samples_collected);
     } else {
         _fitness = 1.0e30f;
     }
-    _ellipsoid_lambda = 1.0f;
-    _sphere_lambda = 1.0f;
-    _initial_fitness = _fitness;
-    _fit_step = 0;
 }
 
 void CompassCalibrator::reset_state() {
@@ -209,10 +400,20 @@ void CompassCalibrator::reset_state() {
     _params.offset.zero();
     _params.diag = Vector3f(1.0f,1.0f,1.0f);
     _params.offdiag.zero();
+    memset(&_accum, 0, sizeof(_accum));
+    _generation++;
 
     initialize_fit();
 }
 
+void CompassCalibrator::release_sample_buffer() {
+    if(_sample_buffer == NULL || __atomic_load_n(&_fit_state, __ATOMIC_ACQUIRE) == FIT_PENDING) {
+        return;
+    }
+    free(_sample_buffer);
+    _sample_buffer = NULL;
+}
+
 bool CompassCalibrator::set_status(compass_cal_status_t status) {
     if (status != COMPASS_CAL_NOT_STARTED && _status == status) {
         return true;
@@ -223,10 +424,7 @@ bool CompassCalibrator::set_status(compass_cal_status_t status) {
             reset_state();
             _status = COMPASS_CAL_NOT_STARTED;
 
-            if(_sample_buffer != NULL) {
-                free(_sample_buffer);
-                _sample_buffer = NULL;
-            }
+            release_sample_buffer();
             return true;
 
         case COMPASS_CAL_WAITING_TO_START:
@@ -273,10 +471,7 @@ bool CompassCalibrator::set_status(compass_cal_status_t status) {
                 return false;
             }
 
-            if(_sample_buffer != NULL) {
-                free(_sample_buffer);
-                _sample_buffer = NULL;
-            }
+            release_sample_buffer();
 
             _status = COMPASS_CAL_SUCCESS;
             return true;
@@ -291,10 +486,7 @@ bool CompassCalibrator::set_status(compass_cal_status_t status) {
                 return true;
             }
 
-            if(_sample_buffer != NULL) {
-                free(_sample_buffer);
-                _sample_buffer = NULL;
-            }
+            release_sample_buffer();
 
             _status = COMPASS_CAL_FAILED;
             return true;
@@ -339,6 +531,7 @@ void CompassCalibrator::thin_samples() {
 
     for(uint16_t i=0; i < _samples_collected; i++) {
         if(!accept_sample(_sample_buffer[i])) {
+            accumulate(_accum, _sample_buffer[i].get(), -1.0);
             _sample_buffer[i] = _sample_buffer[_samples_collected-1];
             _samples_collected --;
             _samples_thinned ++;
@@ -396,26 +589,156 @@ float CompassCalibrator::calc_residual(const Vector3f& sample, const param_t& pa
     return params.radius - (softiron*(sample+params.offset)).length();
 }
 
-float CompassCalibrator::calc_mean_squared_residuals() const
+float CompassCalibrator::calc_mean_squared_residuals(const param_t& params, uint16_t num_samples) const
 {
-    return calc_mean_squared_residuals(_params);
-}
-
-float CompassCalibrator::calc_mean_squared_residuals(const param_t& params) const
-{
-    if(_sample_buffer == NULL || _samples_collected == 0) {
+    if(_sample_buffer == NULL || num_samples == 0) {
         return 1.0e30f;
     }
     float sum = 0.0f;
-    for(uint16_t i=0; i < _samples_collected; i++){
+    for(uint16_t i=0; i < num_samples; i++){
         Vector3f sample = _sample_buffer[i].get();
         float resid = calc_residual(sample, params);
         sum += sq(resid);
     }
-    sum /= _samples_collected;
+    sum /= num_samples;
     return sum;
 }
 
+/*
+  the algebraic ellipsoid fit minimises the sum of (d.p - 1)^2 with
+    d = [x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z]
+  for the parameters p, so the normal equations are sum(d d^T) p = sum(d)
+ */
+void CompassCalibrator::accumulate(accumulator_t &accum, const Vector3f &sample, double sign)
+{
+    const double x = sample.x / COMPASS_CAL_ACCUM_SCALE;
+    const double y = sample.y / COMPASS_CAL_ACCUM_SCALE;
+    const double z = sample.z / COMPASS_CAL_ACCUM_SCALE;
+    const double d[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { x*x, y*y, z*z, 2*x*y, 2*x*z, 2*y*z, 2*x, 2*y, 2*z };
+
+    uint8_t k = 0;
+    for(uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
+        for(uint8_t j = i; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
+            accum.ata[k++] += sign * d[i] * d[j];
+        }
+        accum.atb[i] += sign * d[i];
+    }
+    if(sign > 0) {
+        accum.count++;
+    } else {
+        accum.count--;
+    }
+}
+
+/*
+  algebraic sphere fit, minimising the sum of (2c.x + K - |x|^2)^2 for
+  the centre c and K = r^2 - |c|^2. All the sums it needs are already in
+  the ellipsoid normal equations
+ */
+bool CompassCalibrator::solve_sphere(const accumulator_t &accum, param_t &params)
+{
+    if(accum.count < COMPASS_CAL_NUM_SPHERE_PARAMS) {
+        return false;
+    }
+
+    const uint8_t n = COMPASS_CAL_NUM_ELLIPSOID_PARAMS;
+    const double sxx = accum.atb[0];
+    const double syy = accum.atb[1];
+    const double szz = accum.atb[2];
+    const double sxy = accum.atb[3] * 0.5;
+    const double sxz = accum.atb[4] * 0.5;
+    const double syz = accum.atb[5] * 0.5;
+
+    double A[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = {
+        4*sxx, 4*sxy, 4*sxz, accum.atb[6],
+        4*sxy, 4*syy, 4*syz, accum.atb[7],
+        4*sxz, 4*syz, 4*szz, accum.atb[8],
+        accum.atb[6], accum.atb[7], accum.atb[8], (double)accum.count
+    };
+    double b[COMPASS_CAL_NUM_SPHERE_PARAMS];
+    for(uint8_t i = 0; i < 3; i++) {
+        // sum(2 x_i |x|^2)
+        b[i] = accum.ata[packed_index(0, 6+i, n)] + accum.ata[packed_index(1, 6+i, n)] + accum.ata[packed_index(2, 6+i, n)];
+    }
+    b[3] = sxx + syy + szz;
+
+    if(!cholesky_solve(A, b, COMPASS_CAL_NUM_SPHERE_PARAMS)) {
+        return false;
+    }
+
+    const double radius_sq = b[3] + b[0]*b[0] + b[1]*b[1] + b[2]*b[2];
+    if(!(radius_sq > 0.0)) {
+        return false;
+    }
+    params.radius = sqrt(radius_sq) * COMPASS_CAL_ACCUM_SCALE;
+    params.offset = Vector3f(-b[0], -b[1], -b[2]) * COMPASS_CAL_ACCUM_SCALE;
+    return true;
+}
+
+/*
+  algebraic ellipsoid fit. The fitted surface x^T M x + 2 v.x = 1 is
+  (x - c)^T M (x - c) = k with c = -M^-1 v and k = 1 + c^T M c, so
+  samples are corrected onto a sphere of the current radius R by
+  S = R sqrt(M/k)
+ */
+bool CompassCalibrator::solve_ellipsoid(const accumulator_t &accum, param_t &params)
+{
+    const uint8_t n = COMPASS_CAL_NUM_ELLIPSOID_PARAMS;
+    if(accum.count < n) {
+        return false;
+    }
+
+    double A[n*n];
+    double p[n];
+    for(uint8_t i = 0; i < n; i++) {
+        for(uint8_t j = i; j < n; j++) {
+            A[i*n+j] = A[j*n+i] = accum.ata[packed_index(i, j, n)];
+        }
+        p[i] = accum.atb[i];
+    }
+    if(!cholesky_solve(A, p, n)) {
+        return false;
+    }
+
+    double M[3][3] = {
+        { p[0], p[3], p[4] },
+        { p[3], p[1], p[5] },
+        { p[4], p[5], p[2] }
+    };
+    double v[3] = { p[6], p[7], p[8] };
+
+    // c = -M^-1 v, by Cholesky as M must be positive definite for an ellipsoid
+    double Mc[9];
+    memcpy(Mc, M, sizeof(Mc));
+    double c[3] = { -v[0], -v[1], -v[2] };
+    if(!cholesky_solve(Mc, c, 3)) {
+        return false;
+    }
+
+    // c^T M c = -c.v
+    const double k = 1.0 - (c[0]*v[0] + c[1]*v[1] + c[2]*v[2]);
+    if(!(k > 0.0)) {
+        return false;
+    }
+    for(uint8_t i = 0; i < 3; i++) {
+        for(uint8_t j = 0; j < 3; j++) {
+            M[i][j] /= k;
+        }
+    }
+
+    double S[3][3];
+    if(!sqrt_symmetric(M, S)) {
+        return false;
+    }
+
+    // S was found for samples divided by the accumulator scale
+    const double scale = params.radius / COMPASS_CAL_ACCUM_SCALE;
+    params.offset = Vector3f(-c[0], -c[1], -c[2]) * COMPASS_CAL_ACCUM_SCALE;
+    params.diag = Vector3f(S[0][0], S[1][1], S[2][2]) * scale;
+    params.offdiag = Vector3f(S[0][1], S[0][2], S[1][2]) * scale;
+    return true;
+}
+
 void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const{
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
@@ -439,7 +762,7 @@ void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t&
     ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
 }
 
-void CompassCalibrator::run_sphere_fit()
+void CompassCalibrator::run_sphere_fit(fit_t &fit, uint16_t num_samples) const
 {
     if(_sample_buffer == NULL) {
         return;
@@ -447,10 +770,10 @@ void CompassCalibrator::run_sphere_fit()
 
     const float lma_damping = 10.0f;
 
-    float fitness = _fitness;
+    float fitness = fit.fitness;
     float fit1, fit2;
     param_t fit1_params, fit2_params;
-    fit1_params = fit2_params = _params;
+    fit1_params = fit2_params = fit.params;
 
     float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
     float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
@@ -460,7 +783,7 @@ void CompassCalibrator::run_sphere_fit()
     memset(&JTJ2,0,sizeof(JTJ2));
     memset(&JTFI,0,sizeof(JTFI));
     // Gauss Newton Part common for all kind of extensions including LM
-    for(uint16_t k = 0; k<_samples_collected; k++) {
+    for(uint16_t k = 0; k<num_samples; k++) {
         Vector3f sample = _sample_buffer[k].get();
 
         float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
@@ -482,8 +805,8 @@ void CompassCalibrator::run_sphere_fit()
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
     for(uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda/lma_damping;
+        JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += fit.sphere_lambda;
+        JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += fit.sphere_lambda/lma_damping;
     }
 
     if(!inverse(JTJ, JTJ, 4)) {
@@ -501,23 +824,38 @@ void CompassCalibrator::run_sphere_fit()
         }
     }
 
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    fit1 = calc_mean_squared_residuals(fit1_params, num_samples);
+    fit2 = calc_mean_squared_residuals(fit2_params, num_samples);
 
-    if(fit1 > _fitness && fit2 > _fitness){
-        _sphere_lambda *= lma_damping;
-    } else if(fit2 < _fitness && fit2 < fit1) {
-        _sphere_lambda /= lma_damping;
+    if(fit1 > fit.fitness && fit2 > fit.fitness){
+        fit.sphere_lambda *= lma_damping;
+    } else if(fit2 < fit.fitness && fit2 < fit1) {
+        fit.sphere_lambda /= lma_damping;
         fit1_params = fit2_params;
         fitness = fit2;
-    } else if(fit1 < _fitness){
+    } else if(fit1 < fit.fitness){
         fitness = fit1;
     }
     //--------------------Levenberg-Marquardt-part-ends-here--------------------------------//
 
-    if(!isnan(fitness) && fitness < _fitness) {
-        _fitness = fitness;
-        _params = fit1_params;
+    if(!isnan(fitness) && fitness < fit.fitness) {
+        fit.fitness = fitness;
+        fit.params = fit1_params;
+    }
+}
+
+/*
+  Levenberg-Marquardt iterations from the closed form fit, until the
+  fitness stops improving or COMPASS_CAL_MAX_LM_ITERATIONS is reached
+ */
+void CompassCalibrator::polish_sphere_fit(fit_t &fit, uint16_t num_samples) const
+{
+    for(uint8_t i = 0; i < COMPASS_CAL_MAX_LM_ITERATIONS; i++) {
+        const float last_fitness = fit.fitness;
+        run_sphere_fit(fit, num_samples);
+        if(fit.fitness < last_fitness && last_fitness - fit.fitness < last_fitness * COMPASS_CAL_LM_CONVERGED) {
+            break;
+        }
     }
 }
 
@@ -552,7 +890,7 @@ void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param
     ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
 }
 
-void CompassCalibrator::run_ellipsoid_fit()
+void CompassCalibrator::run_ellipsoid_fit(fit_t &fit, uint16_t num_samples) const
 {
     if(_sample_buffer == NULL) {
         return;
@@ -561,10 +899,10 @@ void CompassCalibrator::run_ellipsoid_fit()
     const float lma_damping = 10.0f;
 
 
-    float fitness = _fitness;
+    float fitness = fit.fitness;
     float fit1, fit2;
     param_t fit1_params, fit2_params;
-    fit1_params = fit2_params = _params;
+    fit1_params = fit2_params = fit.params;
 
 
     float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
@@ -575,7 +913,7 @@ void CompassCalibrator::run_ellipsoid_fit()
     memset(&JTJ2,0,sizeof(JTJ2));
     memset(&JTFI,0,sizeof(JTFI));
     // Gauss Newton Part common for all kind of extensions including LM
-    for(uint16_t k = 0; k<_samples_collected; k++) {
+    for(uint16_t k = 0; k<num_samples; k++) {
         Vector3f sample = _sample_buffer[k].get();
 
         float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
@@ -598,8 +936,8 @@ void CompassCalibrator::run_ellipsoid_fit()
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
     for(uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda/lma_damping;
+        JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += fit.ellipsoid_lambda;
+        JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += fit.ellipsoid_lambda/lma_damping;
     }
 
     if(!inverse(JTJ, JTJ, 9)) {
@@ -617,23 +955,34 @@ void CompassCalibrator::run_ellipsoid_fit()
         }
     }
 
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+    fit1 = calc_mean_squared_residuals(fit1_params, num_samples);
+    fit2 = calc_mean_squared_residuals(fit2_params, num_samples);
 
-    if(fit1 > _fitness && fit2 > _fitness){
-        _ellipsoid_lambda *= lma_damping;
-    } else if(fit2 < _fitness && fit2 < fit1) {
-        _ellipsoid_lambda /= lma_damping;
+    if(fit1 > fit.fitness && fit2 > fit.fitness){
+        fit.ellipsoid_lambda *= lma_damping;
+    } else if(fit2 < fit.fitness && fit2 < fit1) {
+        fit.ellipsoid_lambda /= lma_damping;
         fit1_params = fit2_params;
         fitness = fit2;
-    } else if(fit1 < _fitness){
+    } else if(fit1 < fit.fitness){
         fitness = fit1;
     }
     //--------------------Levenberg-part-ends-here--------------------------------//
 
-    if(fitness < _fitness) {
-        _fitness = fitness;
-        _params = fit1_params;
+    if(fitness < fit.fitness) {
+        fit.fitness = fitness;
+        fit.params = fit1_params;
+    }
+}
+
+void CompassCalibrator::polish_ellipsoid_fit(fit_t &fit, uint16_t num_samples) const
+{
+    for(uint8_t i = 0; i < COMPASS_CAL_MAX_LM_ITERATIONS; i++) {
+        const float last_fitness = fit.fitness;
+        run_ellipsoid_fit(fit, num_samples);
+        if(fit.fitness < last_fitness && last_fitness - fit.fitness < last_fitness * COMPASS_CAL_LM_CONVERGED) {
+            break;
+        }
     }
 }
 
@@ -4,6 +4,11 @@
 #define COMPASS_CAL_NUM_ELLIPSOID_PARAMS 9
 #define COMPASS_CAL_NUM_SAMPLES 300
 
+// Levenberg-Marquardt iterations used to polish each closed form fit
+#define COMPASS_CAL_MAX_LM_ITERATIONS 20
+// an iteration improving the mean squared residual by less than this fraction ends the polish
+#define COMPASS_CAL_LM_CONVERGED 1.0e-3f
+
 //RMS tolerance
 #define COMPASS_CAL_DEFAULT_TOLERANCE 5.0f
 
@@ -26,6 +31,9 @@ public:
     void update(bool &failure);
     void new_sample(const Vector3f &sample);
 
+    // run a fit handed over by update(). Called from the IO thread
+    void run_fit();
+
     bool check_for_timeout();
 
     bool running() const;
@@ -67,7 +75,43 @@ private:
         int16_t z;
     };
 
+    /*
+      normal equations of the algebraic ellipsoid fit
+        Ax^2 + By^2 + Cz^2 + 2Dxy + 2Exz + 2Fyz + 2Gx + 2Hy + 2Iz = 1
+      summed over the samples, so a sample is added or removed in
+      constant time and a fit does not need to go through the samples.
+      Kept in double, as sums of fourth powers of the field lose too
+      much precision in float
+     */
+    struct accumulator_t {
+        double ata[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*(COMPASS_CAL_NUM_ELLIPSOID_PARAMS+1)/2];  // upper triangle, row by row
+        double atb[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+        uint16_t count;
+    };
 
+    // a fit in progress, with its own Levenberg-Marquardt damping
+    struct fit_t {
+        param_t params;
+        float fitness;      // mean squared residuals
+        float sphere_lambda;
+        float ellipsoid_lambda;
+    };
+
+    enum fit_state_t {
+        FIT_IDLE = 0,       // no fit, the main thread owns the job
+        FIT_PENDING,        // the IO thread owns the job and is fitting it
+        FIT_DONE            // the result is ready for the main thread
+    };
+
+    // a fit handed to the IO thread, along with the samples it was taken from
+    struct job_t {
+        compass_cal_status_t step;
+        uint16_t num_samples;
+        uint32_t generation;
+        accumulator_t accum;
+        fit_t fit;
+        bool ok;
+    };
 
     enum compass_cal_status_t _status;
 
@@ -84,14 +128,17 @@ private:
 
     //fit state
     struct param_t _params;
-    uint16_t _fit_step;
     CompassSample *_sample_buffer;
     float _fitness; // mean squared residuals
-    float _initial_fitness;
-    float _sphere_lambda;
-    float _ellipsoid_lambda;
     uint16_t _samples_collected;
     uint16_t _samples_thinned;
+    accumulator_t _accum;
+
+    // the background fit. _generation changes with every attempt, so a
+    // fit finishing after its attempt was cancelled is ignored
+    job_t _job;
+    uint8_t _fit_state;
+    uint32_t _generation;
 
     bool set_status(compass_cal_status_t status);
 
@@ -107,18 +154,32 @@ private:
 
     bool fitting() const;
 
+    // frees the sample buffer, unless the IO thread is still fitting it
+    void release_sample_buffer();
+
+    // hands the full sample buffer to the IO thread, or takes the result back
+    void update_fit(bool &failure);
+
     // thins out samples between step one and step two
     void thin_samples();
 
+    // adds (sign 1) or removes (sign -1) a sample from the normal equations
+    static void accumulate(accumulator_t &accum, const Vector3f &sample, double sign);
+
+    // closed form fits from the normal equations. Return false if the samples don't fit
+    static bool solve_sphere(const accumulator_t &accum, param_t &params);
+    static bool solve_ellipsoid(const accumulator_t &accum, param_t &params);
+
     float calc_residual(const Vector3f& sample, const param_t& params) const;
-    float calc_mean_squared_residuals(const param_t& params) const;
-    float calc_mean_squared_residuals() const;
+    float calc_mean_squared_residuals(const param_t& params, uint16_t num_samples) const;
 
     void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
-    void run_sphere_fit();
+    void run_sphere_fit(fit_t &fit, uint16_t num_samples) const;
+    void polish_sphere_fit(fit_t &fit, uint16_t num_samples) const;
 
     void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
-    void run_ellipsoid_fit();
+    void run_ellipsoid_fit(fit_t &fit, uint16_t num_samples) const;
+    void polish_ellipsoid_fit(fit_t &fit, uint16_t num_samples) const;
 
     uint16_t get_random();
 };
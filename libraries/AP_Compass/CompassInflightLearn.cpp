@@ -0,0 +1,174 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * The states are the earth field in NED and the errors in the offsets and
+ * in the motor compensation factors. Each axis of a sample is a linear
+ * measurement of the states, so they are estimated by recursive least
+ * squares, one axis at a time. The covariance grows a little with every
+ * sample, up to its initial value, which forgets old samples so the
+ * estimate follows slow changes of the earth field as the vehicle travels.
+ *
+ * The earth field and the offsets can only be told apart once the vehicle
+ * has turned, and the offsets and motor factors once the throttle or
+ * current has changed, so each error is only handed out once its own
+ * variance shows it has been observed.
+ */
+
+#include "CompassInflightLearn.h"
+
+static const float initial_sd[COMPASS_LEARN_NUM_STATES] = {
+    COMPASS_LEARN_EARTH_SD, COMPASS_LEARN_EARTH_SD, COMPASS_LEARN_EARTH_SD,
+    COMPASS_LEARN_OFFSET_SD, COMPASS_LEARN_OFFSET_SD, COMPASS_LEARN_OFFSET_SD,
+    COMPASS_LEARN_MOTOR_SD, COMPASS_LEARN_MOTOR_SD, COMPASS_LEARN_MOTOR_SD
+};
+
+static const float drift_sd[COMPASS_LEARN_NUM_STATES] = {
+    COMPASS_LEARN_EARTH_DRIFT, COMPASS_LEARN_EARTH_DRIFT, COMPASS_LEARN_EARTH_DRIFT,
+    COMPASS_LEARN_OFFSET_DRIFT, COMPASS_LEARN_OFFSET_DRIFT, COMPASS_LEARN_OFFSET_DRIFT,
+    COMPASS_LEARN_MOTOR_DRIFT, COMPASS_LEARN_MOTOR_DRIFT, COMPASS_LEARN_MOTOR_DRIFT
+};
+
+CompassInflightLearn::CompassInflightLearn()
+{
+    reset();
+}
+
+void CompassInflightLearn::reset()
+{
+    memset(_x, 0, sizeof(_x));
+    memset(_P, 0, sizeof(_P));
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        _P[i][i] = sq(initial_sd[i]);
+    }
+    _initialised = false;
+    _rejected = 0;
+}
+
+void CompassInflightLearn::update(const Vector3f &field, const Matrix3f &dcm, const Matrix3f &softiron,
+                                  float motor, bool learn_motor)
+{
+    if (field.is_nan() || dcm.a.is_nan() || dcm.b.is_nan() || dcm.c.is_nan()) {
+        return;
+    }
+
+    if (!_initialised) {
+        // start from the earth field seen through the current offsets
+        const Vector3f earth = dcm * field;
+        _x[0] = earth.x;
+        _x[1] = earth.y;
+        _x[2] = earth.z;
+        _initialised = true;
+        return;
+    }
+
+    // forget old samples
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        if (_P[i][i] < sq(initial_sd[i])) {
+            _P[i][i] += sq(drift_sd[i]);
+        }
+    }
+
+    // regressors of each body axis: column of R, then -S and -motor*S rows
+    const Vector3f *softiron_rows[3] = { &softiron.a, &softiron.b, &softiron.c };
+    const float y[3] = { field.x, field.y, field.z };
+    float h[3][COMPASS_LEARN_NUM_STATES];
+    for (uint8_t j = 0; j < 3; j++) {
+        const Vector3f &s = *softiron_rows[j];
+        h[j][0] = dcm.a[j];
+        h[j][1] = dcm.b[j];
+        h[j][2] = dcm.c[j];
+        for (uint8_t k = 0; k < 3; k++) {
+            h[j][3+k] = -s[k];
+            h[j][6+k] = learn_motor ? -motor * s[k] : 0.0f;
+        }
+    }
+
+    // reject the whole sample if any axis is an outlier, such as a passing
+    // interference the model doesn't cover
+    for (uint8_t j = 0; j < 3; j++) {
+        float innovation = y[j];
+        float var = sq(COMPASS_LEARN_FIELD_NOISE);
+        for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+            innovation -= h[j][i] * _x[i];
+            float Ph = 0.0f;
+            for (uint8_t k = 0; k < COMPASS_LEARN_NUM_STATES; k++) {
+                Ph += _P[i][k] * h[j][k];
+            }
+            var += h[j][i] * Ph;
+        }
+        if (sq(innovation) > sq(COMPASS_LEARN_GATE) * var) {
+            _rejected++;
+            return;
+        }
+    }
+
+    for (uint8_t j = 0; j < 3; j++) {
+        fuse(h[j], y[j]);
+    }
+}
+
+void CompassInflightLearn::fuse(const float *h, float y)
+{
+    float Ph[COMPASS_LEARN_NUM_STATES];
+    float var = sq(COMPASS_LEARN_FIELD_NOISE);
+    float innovation = y;
+
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        Ph[i] = 0.0f;
+        for (uint8_t k = 0; k < COMPASS_LEARN_NUM_STATES; k++) {
+            Ph[i] += _P[i][k] * h[k];
+        }
+    }
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        var += h[i] * Ph[i];
+        innovation -= h[i] * _x[i];
+    }
+
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        _x[i] += Ph[i] * innovation / var;
+    }
+    for (uint8_t i = 0; i < COMPASS_LEARN_NUM_STATES; i++) {
+        for (uint8_t k = 0; k < COMPASS_LEARN_NUM_STATES; k++) {
+            _P[i][k] -= Ph[i] * Ph[k] / var;
+        }
+    }
+}
+
+void CompassInflightLearn::get_corrections(Vector3f &offset, Vector3f &motor) const
+{
+    offset.zero();
+    motor.zero();
+    if (!_initialised) {
+        return;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        if (_P[3+i][3+i] < sq(COMPASS_LEARN_CONVERGED_SD)) {
+            offset[i] = _x[3+i];
+        }
+        if (_P[6+i][6+i] < sq(COMPASS_LEARN_CONVERGED_SD)) {
+            motor[i] = _x[6+i];
+        }
+    }
+}
+
+void CompassInflightLearn::corrections_applied(const Vector3f &offset, const Vector3f &motor)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        _x[3+i] -= offset[i];
+        _x[6+i] -= motor[i];
+    }
+}
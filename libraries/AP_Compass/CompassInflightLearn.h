@@ -0,0 +1,67 @@
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+// earth field, offset corrections and motor compensation corrections
+#define COMPASS_LEARN_NUM_STATES 9
+
+// noise on each axis of the corrected field, milligauss
+#define COMPASS_LEARN_FIELD_NOISE 10.0f
+
+// initial standard deviations of the states
+#define COMPASS_LEARN_EARTH_SD 500.0f
+#define COMPASS_LEARN_OFFSET_SD 200.0f
+#define COMPASS_LEARN_MOTOR_SD 100.0f
+
+// growth of the standard deviations per sample, so older samples are forgotten
+#define COMPASS_LEARN_EARTH_DRIFT 0.5f
+#define COMPASS_LEARN_OFFSET_DRIFT 0.05f
+#define COMPASS_LEARN_MOTOR_DRIFT 0.05f
+
+// a correction is handed out once its standard deviation is below this
+#define COMPASS_LEARN_CONVERGED_SD 5.0f
+
+// samples with an innovation beyond this many standard deviations are rejected
+#define COMPASS_LEARN_GATE 5.0f
+
+/*
+  recursive least squares estimate of the errors left in a corrected
+  compass field, using the vehicle's attitude. The corrected field is
+  modelled as
+
+    field = R^T E - S (offset_error + motor * motor_error)
+
+  with R the body to NED rotation, E the earth field in NED, S the soft
+  iron matrix and motor the throttle or current used for motor
+  compensation. Offsets and motor compensation factors are then
+  improved by adding the errors to them
+ */
+class CompassInflightLearn {
+public:
+    CompassInflightLearn();
+
+    // forget everything learnt, for when the offsets are changed elsewhere
+    void reset();
+
+    // add a sample of the corrected field
+    void update(const Vector3f &field, const Matrix3f &dcm, const Matrix3f &softiron,
+                float motor, bool learn_motor);
+
+    // errors known well enough to be corrected, zero for the others
+    void get_corrections(Vector3f &offset, Vector3f &motor) const;
+
+    // the caller has added these corrections to its offsets and motor compensation
+    void corrections_applied(const Vector3f &offset, const Vector3f &motor);
+
+    Vector3f get_earth_field() const { return Vector3f(_x[0], _x[1], _x[2]); }
+    uint32_t get_rejected() const { return _rejected; }
+
+private:
+    // fuse one axis of a sample with regressors h
+    void fuse(const float *h, float y);
+
+    float _x[COMPASS_LEARN_NUM_STATES];
+    float _P[COMPASS_LEARN_NUM_STATES][COMPASS_LEARN_NUM_STATES];
+    bool _initialised;
+    uint32_t _rejected;
+};
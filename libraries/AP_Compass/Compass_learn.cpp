@@ -28,7 +28,7 @@
 void
 Compass::learn_offsets(void)
 {
-    if (_learn == 0) {
+    if (_learn != AP_COMPASS_LEARN_INTERNAL) {
         // auto-calibration is disabled
         return;
     }
@@ -127,3 +127,77 @@ Compass::learn_offsets(void)
         _state[k].offset.set(new_offsets);
     }
 }
+
+/*
+  in flight learning of the offset and motor compensation errors, see
+  CompassInflightLearn. Corrections are applied a little at a time, as
+  in learn_offsets(), and saved at most every AP_COMPASS_LEARN_SAVE_MS
+ */
+void
+Compass::learn_inflight(const Matrix3f &dcm_matrix, bool flying)
+{
+    if (_learn != AP_COMPASS_LEARN_INFLIGHT) {
+        return;
+    }
+
+    const float max_change = 10.0f;
+    const bool learn_motor = _motor_comp_type != AP_COMPASS_MOT_COMP_DISABLED;
+
+    for (uint8_t k=0; flying && k<_compass_count; k++) {
+        mag_state &state = _state[k];
+
+        // only learn from new samples
+        if (!state.healthy || state.last_update_usec == state.learn_last_usec) {
+            continue;
+        }
+        state.learn_last_usec = state.last_update_usec;
+
+        const Vector3f &diagonals = state.diagonals.get();
+        const Vector3f &offdiagonals = state.offdiagonals.get();
+        const Matrix3f softiron(
+            diagonals.x, offdiagonals.x, offdiagonals.y,
+            offdiagonals.x,    diagonals.y, offdiagonals.z,
+            offdiagonals.y, offdiagonals.z,    diagonals.z
+        );
+        _inflight_learn[k].update(state.field, dcm_matrix, softiron, _thr_or_curr, learn_motor);
+
+        Vector3f ofs_change, mot_change;
+        _inflight_learn[k].get_corrections(ofs_change, mot_change);
+        if (ofs_change.is_zero() && mot_change.is_zero()) {
+            continue;
+        }
+
+        // limit the change from any one reading
+        float length = ofs_change.length();
+        if (length > max_change) {
+            ofs_change *= max_change / length;
+        }
+        length = mot_change.length();
+        if (length > max_change) {
+            mot_change *= max_change / length;
+        }
+
+        const Vector3f &ofs = state.offset.get();
+        Vector3f new_offsets = ofs + ofs_change;
+        new_offsets.x = constrain_float(new_offsets.x, -COMPASS_OFS_LIMIT, COMPASS_OFS_LIMIT);
+        new_offsets.y = constrain_float(new_offsets.y, -COMPASS_OFS_LIMIT, COMPASS_OFS_LIMIT);
+        new_offsets.z = constrain_float(new_offsets.z, -COMPASS_OFS_LIMIT, COMPASS_OFS_LIMIT);
+        ofs_change = new_offsets - ofs;
+
+        state.offset.set(new_offsets);
+        state.motor_compensation.set(state.motor_compensation.get() + mot_change);
+        _inflight_learn[k].corrections_applied(ofs_change, mot_change);
+        _learn_save_pending = true;
+    }
+
+    // parameter writes are slow, so save what was learnt now and then
+    const uint32_t now = AP_HAL::millis();
+    if (_learn_save_pending && now - _learn_save_ms > AP_COMPASS_LEARN_SAVE_MS) {
+        for (uint8_t k=0; k<_compass_count; k++) {
+            save_offsets(k);
+            _state[k].motor_compensation.save();
+        }
+        _learn_save_pending = false;
+        _learn_save_ms = now;
+    }
+}
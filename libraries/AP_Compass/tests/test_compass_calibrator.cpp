@@ -0,0 +1,148 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Compass/CompassCalibrator.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a compass with hard and soft iron errors, rotated through random attitudes
+class SyntheticCompass {
+public:
+    SyntheticCompass(const Vector3f &offset, const Matrix3f &softiron, float field) :
+        _offset(offset),
+        _softiron_inv(softiron),
+        _field(field),
+        _seed(0x12345678)
+    {
+        float m[9] = { softiron.a.x, softiron.a.y, softiron.a.z,
+                       softiron.b.x, softiron.b.y, softiron.b.z,
+                       softiron.c.x, softiron.c.y, softiron.c.z };
+        float inv[9];
+        inverse3x3(m, inv);
+        _softiron_inv = Matrix3f(inv[0], inv[1], inv[2],
+                                 inv[3], inv[4], inv[5],
+                                 inv[6], inv[7], inv[8]);
+    }
+
+    // raw field such that softiron * (raw + offset) has length field
+    Vector3f sample()
+    {
+        const float z = random_float() * 2.0f - 1.0f;
+        const float phi = random_float() * M_2PI_F;
+        const float r = sqrtf(1.0f - z*z);
+        const Vector3f field(r * cosf(phi) * _field, r * sinf(phi) * _field, z * _field);
+        const Vector3f noise(random_float() - 0.5f, random_float() - 0.5f, random_float() - 0.5f);
+        return _softiron_inv * field - _offset + noise;
+    }
+
+private:
+    float random_float()
+    {
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+        return (_seed & 0xFFFFFF) / 16777216.0f;
+    }
+
+    Vector3f _offset;
+    Matrix3f _softiron_inv;
+    float _field;
+    uint32_t _seed;
+};
+
+static const Vector3f true_offset(120.0f, -80.0f, 45.0f);
+static const Matrix3f true_softiron(1.10f, 0.05f, -0.03f,
+                                    0.05f, 0.95f, 0.02f,
+                                    -0.03f, 0.02f, 1.00f);
+static const float true_field = 450.0f;
+
+// the calibration matches the truth up to the scale shared by the soft iron and the radius
+static void check_calibration(CompassCalibrator &cal)
+{
+    Vector3f offsets, diagonals, offdiagonals;
+
+    ASSERT_EQ(COMPASS_CAL_SUCCESS, cal.get_status());
+    cal.get_calibration(offsets, diagonals, offdiagonals);
+    EXPECT_NEAR(true_offset.x, offsets.x, 3.0f);
+    EXPECT_NEAR(true_offset.y, offsets.y, 3.0f);
+    EXPECT_NEAR(true_offset.z, offsets.z, 3.0f);
+
+    const float scale = true_softiron.a.x / diagonals.x;
+    EXPECT_NEAR(true_softiron.b.y, diagonals.y * scale, 0.02f);
+    EXPECT_NEAR(true_softiron.c.z, diagonals.z * scale, 0.02f);
+    EXPECT_NEAR(true_softiron.a.y, offdiagonals.x * scale, 0.02f);
+    EXPECT_NEAR(true_softiron.a.z, offdiagonals.y * scale, 0.02f);
+    EXPECT_NEAR(true_softiron.b.z, offdiagonals.z * scale, 0.02f);
+    EXPECT_LT(cal.get_fitness(), 2.0f);
+}
+
+TEST(CompassCalibrator, Ellipsoid)
+{
+    SyntheticCompass compass(true_offset, true_softiron, true_field);
+    CompassCalibrator cal;
+    bool failure = false;
+
+    cal.start();
+    for (uint16_t i = 0; i < 20000 && cal.running(); i++) {
+        cal.new_sample(compass.sample());
+        cal.update(failure);
+        ASSERT_FALSE(failure);
+        cal.run_fit();
+    }
+    check_calibration(cal);
+}
+
+// the main loop only hands the fit over, the IO thread runs it
+TEST(CompassCalibrator, FitsInRunFit)
+{
+    SyntheticCompass compass(true_offset, true_softiron, true_field);
+    CompassCalibrator cal;
+    bool failure = false;
+
+    cal.start();
+    for (uint16_t i = 0; i < 20000; i++) {
+        cal.new_sample(compass.sample());
+        cal.update(failure);
+    }
+    EXPECT_EQ(COMPASS_CAL_RUNNING_STEP_ONE, cal.get_status());
+    EXPECT_NEAR(33.3f, cal.get_completion_percent(), 0.01f);
+
+    cal.run_fit();
+    cal.update(failure);
+    EXPECT_FALSE(failure);
+    EXPECT_EQ(COMPASS_CAL_RUNNING_STEP_TWO, cal.get_status());
+}
+
+TEST(CompassCalibrator, TwoCompasses)
+{
+    const Vector3f offset2(-200.0f, 30.0f, 150.0f);
+    SyntheticCompass compass1(true_offset, true_softiron, true_field);
+    SyntheticCompass compass2(offset2, Matrix3f(1, 0, 0, 0, 1, 0, 0, 0, 1), 300.0f);
+    CompassCalibrator cal[2];
+    bool failure = false;
+
+    cal[0].start();
+    cal[1].start();
+    for (uint16_t i = 0; i < 20000 && (cal[0].running() || cal[1].running()); i++) {
+        cal[0].new_sample(compass1.sample());
+        cal[1].new_sample(compass2.sample());
+        for (uint8_t j = 0; j < 2; j++) {
+            cal[j].update(failure);
+            ASSERT_FALSE(failure);
+        }
+        for (uint8_t j = 0; j < 2; j++) {
+            cal[j].run_fit();
+        }
+    }
+    check_calibration(cal[0]);
+
+    Vector3f offsets, diagonals, offdiagonals;
+    ASSERT_EQ(COMPASS_CAL_SUCCESS, cal[1].get_status());
+    cal[1].get_calibration(offsets, diagonals, offdiagonals);
+    EXPECT_NEAR(offset2.x, offsets.x, 3.0f);
+    EXPECT_NEAR(offset2.y, offsets.y, 3.0f);
+    EXPECT_NEAR(offset2.z, offsets.z, 3.0f);
+    EXPECT_NEAR(0.0f, offdiagonals.x, 0.02f);
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,93 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Compass/CompassInflightLearn.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const Vector3f earth_field(200.0f, 40.0f, 400.0f);
+static const Matrix3f softiron(1.05f, 0.02f, 0.0f,
+                               0.02f, 0.98f, -0.01f,
+                               0.0f, -0.01f, 1.0f);
+
+// a compass whose offsets and motor factors are off by offset_error and motor_error
+class LearnTest : public ::testing::Test {
+protected:
+    LearnTest() :
+        offset_error(30.0f, -20.0f, 15.0f),
+        motor_error(25.0f, -10.0f, 40.0f),
+        seed(0x2468ace1)
+    {}
+
+    float noise()
+    {
+        seed = seed * 1103515245 + 12345;
+        return ((seed >> 8) & 0xFFFF) / 65536.0f * 4.0f - 2.0f;
+    }
+
+    Vector3f field(const Matrix3f &dcm, float motor)
+    {
+        const Vector3f error = offset_error + motor_error * motor;
+        return dcm.mul_transpose(earth_field) - softiron * error + Vector3f(noise(), noise(), noise());
+    }
+
+    // fly for the given number of 10Hz samples, applying corrections as Compass does
+    void fly(uint16_t samples, bool turning, bool throttle_changing)
+    {
+        for (uint16_t i = 0; i < samples; i++) {
+            const float t = i * 0.1f;
+            Matrix3f dcm;
+            if (turning) {
+                dcm.from_euler(radians(20.0f) * sinf(t * 0.3f), radians(15.0f) * cosf(t * 0.2f), t * 0.25f);
+            } else {
+                dcm.from_euler(0.0f, 0.0f, 1.0f);
+            }
+            const float motor = throttle_changing ? 0.5f + 0.2f * sinf(t * 0.7f) : 0.5f;
+
+            learn.update(field(dcm, motor), dcm, softiron, motor, true);
+
+            Vector3f ofs, mot;
+            learn.get_corrections(ofs, mot);
+            offset_error -= ofs;
+            motor_error -= mot;
+            learn.corrections_applied(ofs, mot);
+        }
+    }
+
+    CompassInflightLearn learn;
+    Vector3f offset_error;
+    Vector3f motor_error;
+    uint32_t seed;
+};
+
+TEST_F(LearnTest, LearnsOffsetsAndMotor)
+{
+    fly(3000, true, true);
+
+    EXPECT_LT(offset_error.length(), 3.0f);
+    EXPECT_LT(motor_error.length(), 6.0f);
+    EXPECT_LT((learn.get_earth_field() - earth_field).length(), 5.0f);
+}
+
+// without turning the offsets can't be told from the earth field, so nothing is corrected
+TEST_F(LearnTest, NeedsTurns)
+{
+    const Vector3f initial_offset_error = offset_error;
+
+    fly(3000, false, false);
+
+    EXPECT_TRUE(offset_error == initial_offset_error);
+}
+
+TEST_F(LearnTest, RejectsOutliers)
+{
+    fly(1000, true, true);
+    const uint32_t rejected = learn.get_rejected();
+
+    Matrix3f dcm;
+    dcm.from_euler(0.0f, 0.0f, 0.5f);
+    learn.update(field(dcm, 0.5f) + Vector3f(300.0f, 0.0f, 0.0f), dcm, softiron, 0.5f, true);
+    EXPECT_EQ(rejected + 1, learn.get_rejected());
+}
+
+AP_GTEST_MAIN()
@@ -19,9 +19,28 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Notify/AP_Notify.h>
+#include <DataFlash/DataFlash.h>
 
 extern const AP_HAL::HAL &hal;
 
+// receivers without a fix for this long are not blended
+#define GPS_BLEND_TIMEOUT_MS 500
+
+// smallest accuracy used when weighting, so a receiver reporting zero
+// error cannot take all of the weight through a divide by zero
+#define GPS_BLEND_MIN_ACCURACY 0.01f
+
+#define GPS_MSEC_PER_WEEK (7 * 86400 * 1000UL)
+
+// correction data waiting for each receiver
+#define GPS_INJECT_QUEUE_SIZE 2048
+
+// corrections not sent within this time are dropped as stale
+#define GPS_INJECT_MAX_AGE_MS 2000
+
+// data is passed through unframed if no RTCM3 frame is seen for this long
+#define GPS_INJECT_RTCM_TIMEOUT_MS 5000
+
 // table of user settable parameters
 const AP_Param::GroupInfo AP_GPS::var_info[] = {
     // @Param: TYPE
@@ -47,8 +66,8 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
 
     // @Param: AUTO_SWITCH
     // @DisplayName: Automatic Switchover Setting
-    // @Description: Automatic switchover to GPS reporting best lock
-    // @Values: 0:Disabled,1:Enabled
+    // @Description: Automatic switchover to GPS reporting best lock. When set to blend the receivers are combined into a single solution weighted by their reported accuracy, selected with GPS_BLEND_MASK
+    // @Values: 0:Disabled,1:UseBest,2:Blend
     // @User: Advanced
     AP_GROUPINFO("AUTO_SWITCH", 3, AP_GPS, _auto_switch, 1),
 
@@ -80,7 +99,7 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
     // @Param: INJECT_TO
     // @DisplayName: Destination for GPS_INJECT_DATA MAVLink packets
     // @Description: The GGS can send raw serial packets to inject data to multiple GPSes.
-    // @Values: 0:send to first GPS, 1:send to 2nd GPS, 127:send to all
+    // @Values: 0:send to first GPS, 1:send to 2nd GPS, 2:send to 3rd GPS, 127:send to all
     AP_GROUPINFO("INJECT_TO",   7, AP_GPS, _inject_to, GPS_RTK_INJECT_TO_ALL),
 
     // @Param: SBP_LOGMASK
@@ -113,6 +132,28 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("SAVE_CFG", 11, AP_GPS, _save_config, 0),
 
+    // @Param: TYPE3
+    // @DisplayName: 3rd GPS type
+    // @Description: GPS type of 3rd GPS
+    // @Values: 0:None,1:AUTO,2:uBlox,3:MTK,4:MTK19,5:NMEA,6:SiRF,7:HIL,8:SwiftNav,9:PX4-UAVCAN,10:SBF,11:GSOF
+    // @RebootRequired: True
+    AP_GROUPINFO("TYPE3",   12, AP_GPS, _type[2], 0),
+
+    // @Param: BLEND_MASK
+    // @DisplayName: Multi GPS Blending Mask
+    // @Description: Determines which of the accuracy measures horizontal position, vertical position and speed are used to calculate the weighting of each receiver when GPS_AUTO_SWITCH is set to blend. Receivers that do not report a selected measure are not blended
+    // @Bitmask: 0:Horiz Pos,1:Vert Pos,2:Speed
+    // @User: Advanced
+    AP_GROUPINFO("BLEND_MASK", 13, AP_GPS, _blend_mask, GPS_BLEND_MASK_HPOS | GPS_BLEND_MASK_SPEED),
+
+    // @Param: BLEND_TC
+    // @DisplayName: Blending time constant
+    // @Description: Time constant of the filter that removes steps from the blended solution when receivers join or leave the blend or their weights change. Zero disables the filter
+    // @Units: seconds
+    // @Range: 0 30
+    // @User: Advanced
+    AP_GROUPINFO("BLEND_TC", 14, AP_GPS, _blend_tc, 10.0f),
+
     AP_GROUPEND
 };
 
@@ -123,9 +164,14 @@ void AP_GPS::init(DataFlash_Class *dataflash, const AP_SerialManager& serial_man
     primary_instance = 0;
 
     // search for serial ports with gps protocol
-    _port[0] = serial_manager.find_serial(AP_SerialManager::SerialProtocol_GPS, 0);
-    _port[1] = serial_manager.find_serial(AP_SerialManager::SerialProtocol_GPS, 1);
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        _port[i] = serial_manager.find_serial(AP_SerialManager::SerialProtocol_GPS, i);
+    }
     _last_instance_swap_ms = 0;
+
+    state[GPS_BLENDED_INSTANCE].instance = GPS_BLENDED_INSTANCE;
+    state[GPS_BLENDED_INSTANCE].hdop = 9999;
+    state[GPS_BLENDED_INSTANCE].vdop = 9999;
 }
 
 // baudrates to try to detect GPSes with
@@ -307,7 +353,18 @@ found_gps:
 AP_GPS::GPS_Status 
 AP_GPS::highest_supported_status(uint8_t instance) const
 {
-    if (drivers[instance] != NULL)
+    if (instance == GPS_BLENDED_INSTANCE) {
+        // the best of the receivers in the blend
+        GPS_Status ret = AP_GPS::GPS_OK_FIX_3D;
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if (_blend_weights[i] > 0 && drivers[i] != NULL &&
+                drivers[i]->highest_supported_status() > ret) {
+                ret = drivers[i]->highest_supported_status();
+            }
+        }
+        return ret;
+    }
+    if (instance < GPS_MAX_RECEIVERS && drivers[instance] != NULL)
         return drivers[instance]->highest_supported_status();
     return AP_GPS::GPS_OK_FIX_3D;
 }
@@ -315,9 +372,7 @@ AP_GPS::highest_supported_status(uint8_t instance) const
 AP_GPS::GPS_Status 
 AP_GPS::highest_supported_status(void) const
 {
-    if (drivers[primary_instance] != NULL)
-        return drivers[primary_instance]->highest_supported_status();
-    return AP_GPS::GPS_OK_FIX_3D;
+    return highest_supported_status(primary_instance);
 }
 
 
@@ -384,50 +439,299 @@ AP_GPS::update_instance(uint8_t instance)
 void
 AP_GPS::update(void)
 {
-    for (uint8_t i=0; i<GPS_MAX_INSTANCES; i++) {
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
         update_instance(i);
+        update_inject(i);
     }
+    log_inject_stats();
 
-    // work out which GPS is the primary, and how many sensors we have
-    for (uint8_t i=0; i<GPS_MAX_INSTANCES; i++) {
+    // work out how many sensors we have
+    num_instances = 0;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
         if (state[i].status != NO_GPS) {
             num_instances = i+1;
         }
-        if (_auto_switch) {            
-            if (i == primary_instance) {
-                continue;
+    }
+
+    if (_auto_switch == GPS_AUTO_SWITCH_BLEND && calc_blend_weights()) {
+        calc_blended_state();
+        _output_is_blended = true;
+        primary_instance = GPS_BLENDED_INSTANCE;
+        num_instances = GPS_MAX_INSTANCES;
+    } else {
+        if (_output_is_blended) {
+            // carry on from the receiver that had the most weight
+            uint8_t best = 0;
+            for (uint8_t i=1; i<GPS_MAX_RECEIVERS; i++) {
+                if (_blend_weights[i] > _blend_weights[best]) {
+                    best = i;
+                }
             }
-            if (state[i].status > state[primary_instance].status) {
-                // we have a higher status lock, change GPS
-                primary_instance = i;
-                continue;
+            primary_instance = best;
+            _output_is_blended = false;
+            memset(_blend_weights, 0, sizeof(_blend_weights));
+            for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+                _blend_offset_ned[i].zero();
             }
+            state[GPS_BLENDED_INSTANCE].status = NO_GPS;
+        }
+        update_primary();
+    }
 
-            bool another_gps_has_1_or_more_sats = (state[i].num_sats >= state[primary_instance].num_sats + 1);
+	// update notify with gps status. We always base this on the primary_instance
+    AP_Notify::flags.gps_status = state[primary_instance].status;
+}
 
-            if (state[i].status == state[primary_instance].status && another_gps_has_1_or_more_sats) {
+/*
+  choose the primary receiver when not blending
+ */
+void
+AP_GPS::update_primary(void)
+{
+    if (!_auto_switch) {
+        primary_instance = 0;
+        return;
+    }
 
-                uint32_t now = AP_HAL::millis();
-                bool another_gps_has_2_or_more_sats = (state[i].num_sats >= state[primary_instance].num_sats + 2);
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (i == primary_instance) {
+            continue;
+        }
+        if (state[i].status > state[primary_instance].status) {
+            // we have a higher status lock, change GPS
+            primary_instance = i;
+            continue;
+        }
 
-                if ( (another_gps_has_1_or_more_sats && (now - _last_instance_swap_ms) >= 20000) ||
-                     (another_gps_has_2_or_more_sats && (now - _last_instance_swap_ms) >= 5000 ) ) {
-                // this GPS has more satellites than the
-                // current primary, switch primary. Once we switch we will
-                // then tend to stick to the new GPS as primary. We don't
-                // want to switch too often as it will look like a
-                // position shift to the controllers.
-                primary_instance = i;
-                _last_instance_swap_ms = now;
-                }
+        bool another_gps_has_1_or_more_sats = (state[i].num_sats >= state[primary_instance].num_sats + 1);
+
+        if (state[i].status == state[primary_instance].status && another_gps_has_1_or_more_sats) {
+
+            uint32_t now = AP_HAL::millis();
+            bool another_gps_has_2_or_more_sats = (state[i].num_sats >= state[primary_instance].num_sats + 2);
+
+            if ( (another_gps_has_1_or_more_sats && (now - _last_instance_swap_ms) >= 20000) ||
+                 (another_gps_has_2_or_more_sats && (now - _last_instance_swap_ms) >= 5000 ) ) {
+            // this GPS has more satellites than the
+            // current primary, switch primary. Once we switch we will
+            // then tend to stick to the new GPS as primary. We don't
+            // want to switch too often as it will look like a
+            // position shift to the controllers.
+            primary_instance = i;
+            _last_instance_swap_ms = now;
             }
-        } else {
-            primary_instance = 0;
         }
     }
+}
 
-	// update notify with gps status. We always base this on the primary_instance
-    AP_Notify::flags.gps_status = state[primary_instance].status;
+/*
+  work out the weight of each receiver in the blended solution from
+  the inverse of its reported error variances. Returns false if
+  nothing can be blended. Once blending has started it continues with
+  a single receiver, so the offset filter can remove the step from
+  losing the others
+ */
+bool
+AP_GPS::calc_blend_weights(void)
+{
+    const uint32_t now = AP_HAL::millis();
+    float hpos_var[GPS_MAX_RECEIVERS] {};
+    float vpos_var[GPS_MAX_RECEIVERS] {};
+    float speed_var[GPS_MAX_RECEIVERS] {};
+    float sum_hpos = 0, sum_vpos = 0, sum_speed = 0;
+    uint8_t count = 0;
+
+    memset(_blend_weights, 0, sizeof(_blend_weights));
+
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        const GPS_State &s = state[i];
+        if (s.status < GPS_OK_FIX_3D || now - timing[i].last_fix_time_ms > GPS_BLEND_TIMEOUT_MS) {
+            continue;
+        }
+        if (((_blend_mask & GPS_BLEND_MASK_HPOS) && !s.have_horizontal_accuracy) ||
+            ((_blend_mask & GPS_BLEND_MASK_VPOS) && !s.have_vertical_accuracy) ||
+            ((_blend_mask & GPS_BLEND_MASK_SPEED) && !s.have_speed_accuracy)) {
+            continue;
+        }
+        hpos_var[i] = sq(MAX(s.horizontal_accuracy, GPS_BLEND_MIN_ACCURACY));
+        vpos_var[i] = sq(MAX(s.vertical_accuracy, GPS_BLEND_MIN_ACCURACY));
+        speed_var[i] = sq(MAX(s.speed_accuracy, GPS_BLEND_MIN_ACCURACY));
+        sum_hpos += 1.0f / hpos_var[i];
+        sum_vpos += 1.0f / vpos_var[i];
+        sum_speed += 1.0f / speed_var[i];
+        count++;
+    }
+
+    if (count == 0 || (count == 1 && !_output_is_blended) || (_blend_mask & 0x07) == 0) {
+        memset(_blend_weights, 0, sizeof(_blend_weights));
+        return false;
+    }
+
+    // each selected measure gives a set of weights summing to one, and
+    // the sets are averaged
+    uint8_t terms = 0;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (is_zero(hpos_var[i])) {
+            continue;
+        }
+        if (_blend_mask & GPS_BLEND_MASK_HPOS) {
+            _blend_weights[i] += 1.0f / (hpos_var[i] * sum_hpos);
+        }
+        if (_blend_mask & GPS_BLEND_MASK_VPOS) {
+            _blend_weights[i] += 1.0f / (vpos_var[i] * sum_vpos);
+        }
+        if (_blend_mask & GPS_BLEND_MASK_SPEED) {
+            _blend_weights[i] += 1.0f / (speed_var[i] * sum_speed);
+        }
+    }
+    if (_blend_mask & GPS_BLEND_MASK_HPOS) {
+        terms++;
+    }
+    if (_blend_mask & GPS_BLEND_MASK_VPOS) {
+        terms++;
+    }
+    if (_blend_mask & GPS_BLEND_MASK_SPEED) {
+        terms++;
+    }
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        _blend_weights[i] /= terms;
+    }
+
+    return true;
+}
+
+/*
+  combine the weighted receivers into the blended instance.
+
+  Receivers report their fixes at different times, so each position is
+  first moved forward along its velocity to the time of the newest fix
+  using the GPS_timing data. The receivers are then combined in NED
+  relative to the most heavily weighted one.
+
+  Each receiver also has a filtered offset to the blended position,
+  which is added to it before combining. Weights can change suddenly
+  when a receiver joins or drops out, but the offsets keep the output
+  continuous and then decay the difference away with time constant
+  GPS_BLEND_TC
+ */
+void
+AP_GPS::calc_blended_state(void)
+{
+    GPS_State &blend = state[GPS_BLENDED_INSTANCE];
+    GPS_timing &blend_timing = timing[GPS_BLENDED_INSTANCE];
+
+    uint8_t best = 0;
+    uint32_t newest_fix_ms = 0;
+    uint32_t newest_message_ms = 0;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (_blend_weights[i] > _blend_weights[best]) {
+            best = i;
+        }
+        if (_blend_weights[i] > 0) {
+            if (newest_fix_ms == 0 || (int32_t)(timing[i].last_fix_time_ms - newest_fix_ms) > 0) {
+                newest_fix_ms = timing[i].last_fix_time_ms;
+            }
+            if (newest_message_ms == 0 || (int32_t)(timing[i].last_message_time_ms - newest_message_ms) > 0) {
+                newest_message_ms = timing[i].last_message_time_ms;
+            }
+        }
+    }
+    const Location ref = state[best].location;
+
+    // positions of each receiver at the newest fix time, NED from ref
+    Vector3f pos_ned[GPS_MAX_RECEIVERS];
+    Vector3f raw_pos;
+    Vector3f velocity;
+    float hacc = 0, vacc = 0, sacc = 0;
+
+    blend.status = NO_FIX;
+    blend.hdop = 9999;
+    blend.vdop = 9999;
+    blend.num_sats = 0;
+    blend.have_vertical_velocity = true;
+    blend.have_speed_accuracy = true;
+    blend.have_horizontal_accuracy = true;
+    blend.have_vertical_accuracy = true;
+    blend.last_gps_time_ms = 0;
+
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        const float w = _blend_weights[i];
+        if (w <= 0) {
+            continue;
+        }
+        const GPS_State &s = state[i];
+        const float dt = (newest_fix_ms - timing[i].last_fix_time_ms) * 0.001f;
+        const Vector2f ne = location_diff(ref, s.location);
+        pos_ned[i] = Vector3f(ne.x, ne.y, (ref.alt - s.location.alt) * 0.01f);
+        pos_ned[i].x += s.velocity.x * dt;
+        pos_ned[i].y += s.velocity.y * dt;
+        if (s.have_vertical_velocity) {
+            pos_ned[i].z += s.velocity.z * dt;
+        }
+
+        raw_pos += pos_ned[i] * w;
+        velocity += s.velocity * w;
+        hacc += s.horizontal_accuracy * w;
+        vacc += s.vertical_accuracy * w;
+        sacc += s.speed_accuracy * w;
+
+        if (s.status > blend.status) {
+            blend.status = s.status;
+        }
+        blend.hdop = MIN(blend.hdop, s.hdop);
+        blend.vdop = MIN(blend.vdop, s.vdop);
+        // the best single receiver, not the sum, so satellite count
+        // checks keep their meaning
+        blend.num_sats = MAX(blend.num_sats, s.num_sats);
+        blend.have_vertical_velocity &= s.have_vertical_velocity;
+        blend.have_speed_accuracy &= s.have_speed_accuracy;
+        blend.have_horizontal_accuracy &= s.have_horizontal_accuracy;
+        blend.have_vertical_accuracy &= s.have_vertical_accuracy;
+        if ((int32_t)(s.last_gps_time_ms - blend.last_gps_time_ms) > 0 || blend.last_gps_time_ms == 0) {
+            blend.last_gps_time_ms = s.last_gps_time_ms;
+        }
+    }
+
+    // update the offsets once per new fix
+    if (newest_fix_ms != _last_blend_fix_ms) {
+        const float dt = _last_blend_fix_ms == 0 ? 0 : (newest_fix_ms - _last_blend_fix_ms) * 0.001f;
+        _last_blend_fix_ms = newest_fix_ms;
+        const float alpha = _blend_tc > 0 ? constrain_float(dt / (_blend_tc + dt), 0.0f, 1.0f) : 1.0f;
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if (_blend_weights[i] > 0) {
+                _blend_offset_ned[i] += ((raw_pos - pos_ned[i]) - _blend_offset_ned[i]) * alpha;
+            }
+        }
+    }
+
+    Vector3f pos;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (_blend_weights[i] > 0) {
+            pos += (pos_ned[i] + _blend_offset_ned[i]) * _blend_weights[i];
+        }
+    }
+
+    blend.location = ref;
+    location_offset(blend.location, pos.x, pos.y);
+    blend.location.alt = ref.alt - pos.z * 100;
+    blend.velocity = velocity;
+    blend.ground_speed = pythagorous2(velocity.x, velocity.y);
+    blend.ground_course_cd = wrap_360_cd(degrees(atan2f(velocity.y, velocity.x)) * 100);
+    blend.horizontal_accuracy = hacc;
+    blend.vertical_accuracy = vacc;
+    blend.speed_accuracy = sacc;
+
+    // GPS time from the heaviest receiver, moved on to the blended fix time
+    uint32_t week_ms = state[best].time_week_ms + (newest_fix_ms - timing[best].last_fix_time_ms);
+    blend.time_week = state[best].time_week;
+    if (week_ms >= GPS_MSEC_PER_WEEK) {
+        week_ms -= GPS_MSEC_PER_WEEK;
+        blend.time_week++;
+    }
+    blend.time_week_ms = week_ms;
+
+    blend_timing.last_fix_time_ms = newest_fix_ms;
+    blend_timing.last_message_time_ms = newest_message_ms;
 }
 
 /*
@@ -438,7 +742,7 @@ AP_GPS::setHIL(uint8_t instance, GPS_Status _status, uint64_t time_epoch_ms,
                const Location &_location, const Vector3f &_velocity, uint8_t _num_sats, 
                uint16_t hdop, bool _have_vertical_velocity)
 {
-    if (instance >= GPS_MAX_INSTANCES) {
+    if (instance >= GPS_MAX_RECEIVERS) {
         return;
     }
     uint32_t tnow = AP_HAL::millis();
@@ -470,7 +774,7 @@ void
 AP_GPS::lock_port(uint8_t instance, bool lock)
 {
 
-    if (instance >= GPS_MAX_INSTANCES) {
+    if (instance >= GPS_MAX_RECEIVERS) {
         return;
     }
     if (lock) {
@@ -480,13 +784,43 @@ AP_GPS::lock_port(uint8_t instance, bool lock)
     }
 }
 
-    //Inject a packet of raw binary to a GPS
+/*
+  inject correction data from the ground station. RTCM3 frames may be
+  split across any number of packets; once the stream is known to be
+  RTCM3 only complete frames with a good CRC are queued for the
+  receivers. Other correction formats are passed through unchanged
+ */
 void 
-AP_GPS::inject_data(uint8_t *data, uint8_t len)
+AP_GPS::inject_data(const uint8_t *data, uint16_t len)
+{
+    const uint32_t now = AP_HAL::millis();
+    const bool rtcm_stream = _rtcm_last_frame_ms != 0 &&
+        now - _rtcm_last_frame_ms < GPS_INJECT_RTCM_TIMEOUT_MS;
+
+    for (uint16_t i=0; i<len; i++) {
+        if (!_rtcm.read(data[i])) {
+            continue;
+        }
+        _rtcm_last_frame_ms = now;
+        if (rtcm_stream) {
+            const uint8_t *frame;
+            const uint16_t frame_len = _rtcm.get_frame(frame);
+            inject_to_receivers(frame, frame_len, now);
+        }
+    }
+
+    if (!rtcm_stream) {
+        _inject_raw_bytes += len;
+        inject_to_receivers(data, len, now);
+    }
+}
+
+void 
+AP_GPS::inject_to_receivers(const uint8_t *data, uint16_t len, uint32_t now)
 {
     //Support broadcasting to all GPSes.
     if (_inject_to == GPS_RTK_INJECT_TO_ALL) {
-        for (uint8_t i=0; i<GPS_MAX_INSTANCES; i++) {
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
             inject_data(i, data, len);
         }
     } else {
@@ -494,12 +828,83 @@ AP_GPS::inject_data(uint8_t *data, uint8_t len)
     }
 }
 
+/*
+  queue data for one receiver. It is written from update() as the
+  receiver's port has room, so a burst of corrections does not have to
+  fit in the UART transmit buffer at once
+ */
 void 
-AP_GPS::inject_data(uint8_t instance, uint8_t *data, uint8_t len)
+AP_GPS::inject_data(uint8_t instance, const uint8_t *data, uint16_t len)
 {
-    if (instance < GPS_MAX_INSTANCES && drivers[instance] != NULL)
-        drivers[instance]->inject_data(data, len);
-}  
+    if (instance >= GPS_MAX_RECEIVERS || drivers[instance] == NULL) {
+        return;
+    }
+    if (_inject_queue[instance] == NULL) {
+        _inject_queue[instance] = new GPS_InjectQueue(GPS_INJECT_QUEUE_SIZE);
+        if (_inject_queue[instance] == NULL) {
+            return;
+        }
+    }
+    _inject_queue[instance]->push(data, len, AP_HAL::millis());
+}
+
+void
+AP_GPS::update_inject(uint8_t instance)
+{
+    GPS_InjectQueue *queue = _inject_queue[instance];
+    if (queue == NULL) {
+        return;
+    }
+    if (drivers[instance] == NULL) {
+        queue->flush();
+        return;
+    }
+    queue->drain(drivers[instance], AP_HAL::millis(), GPS_INJECT_MAX_AGE_MS);
+}
+
+void
+AP_GPS::get_inject_stats(Inject_Stats &stats) const
+{
+    stats.frames = _rtcm.get_frame_count();
+    stats.raw_bytes = _inject_raw_bytes;
+    stats.crc_errors = _rtcm.get_crc_errors();
+    stats.bytes_skipped = _rtcm.get_bytes_skipped();
+    stats.dropped = 0;
+    stats.late = 0;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (_inject_queue[i] != NULL) {
+            stats.dropped += _inject_queue[i]->get_dropped();
+            stats.late += _inject_queue[i]->get_late();
+        }
+    }
+}
+
+/*
+  log the injection statistics at 1Hz while corrections are arriving
+ */
+void
+AP_GPS::log_inject_stats(void)
+{
+    const uint32_t now = AP_HAL::millis();
+    if (_DataFlash == NULL || !_DataFlash->logging_started() ||
+        now - _inject_last_log_ms < 1000) {
+        return;
+    }
+    Inject_Stats stats;
+    get_inject_stats(stats);
+    if (stats.frames == 0 && stats.raw_bytes == 0) {
+        return;
+    }
+    _inject_last_log_ms = now;
+
+    _DataFlash->WriteSchema<log_GPS_Inject>(AP_HAL::micros64(),
+                                            stats.frames,
+                                            stats.raw_bytes,
+                                            stats.crc_errors,
+                                            stats.bytes_skipped,
+                                            stats.dropped,
+                                            stats.late);
+}
 
 void 
 AP_GPS::send_mavlink_gps_raw(mavlink_channel_t chan)
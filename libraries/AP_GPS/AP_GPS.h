@@ -26,12 +26,22 @@
 #include <AP_Vehicle/AP_Vehicle.h>
 #include "GPS_detect_state.h"
 #include <AP_SerialManager/AP_SerialManager.h>
+#include "RTCM3_Parser.h"
+#include "GPS_InjectQueue.h"
 
 /**
-   maximum number of GPS instances available on this platform. If more
-   than 1 then redundent sensors may be available
+   maximum number of GPS receivers available on this platform. If more
+   than 1 then redundent sensors may be available. Each receiver needs
+   its own GPS_TYPEn parameter
  */
-#define GPS_MAX_INSTANCES 2
+#define GPS_MAX_RECEIVERS 3
+
+/**
+   the blended solution is presented as an extra GPS instance after the
+   real receivers
+ */
+#define GPS_MAX_INSTANCES (GPS_MAX_RECEIVERS + 1)
+#define GPS_BLENDED_INSTANCE GPS_MAX_RECEIVERS
 #define GPS_RTK_INJECT_TO_ALL 127
 
 class DataFlash_Class;
@@ -82,6 +92,21 @@ public:
         GPS_OK_FIX_3D_RTK = 5,  ///< Receiving valid messages and 3D lock, with relative-positioning improvements
     };
 
+    // GPS_AUTO_SWITCH settings
+    enum GPS_Auto_Switch {
+        GPS_AUTO_SWITCH_NONE  = 0,
+        GPS_AUTO_SWITCH_BEST  = 1,
+        GPS_AUTO_SWITCH_BLEND = 2
+    };
+
+    // GPS_BLEND_MASK bits, selecting the accuracy figures used to
+    // weight each receiver
+    enum GPS_Blend_Mask {
+        GPS_BLEND_MASK_HPOS  = (1<<0),
+        GPS_BLEND_MASK_VPOS  = (1<<1),
+        GPS_BLEND_MASK_SPEED = (1<<2)
+    };
+
     // GPS navigation engine settings. Not all GPS receivers support
     // this
     enum GPS_Engine_Setting {
@@ -127,7 +152,8 @@ public:
     // Accessor functions
 
     // return number of active GPS sensors. Note that if the first GPS
-    // is not present but the 2nd is then we return 2
+    // is not present but the 2nd is then we return 2. While blending
+    // this includes the blended instance
     uint8_t num_sensors(void) const {
         return num_instances;
     }
@@ -293,6 +319,21 @@ public:
         return have_vertical_velocity(primary_instance);
     }
 
+    // true when the primary instance is the blended solution
+    bool blend_active(void) const {
+        return _output_is_blended;
+    }
+
+    // weight of a receiver in the blended solution, zero when unused
+    float get_blend_weight(uint8_t instance) const {
+        return instance < GPS_MAX_RECEIVERS ? _blend_weights[instance] : 0.0f;
+    }
+
+    // filtered NED offset applied to a receiver in the blended solution
+    const Vector3f &get_blend_offset(uint8_t instance) const {
+        return _blend_offset_ned[instance < GPS_MAX_RECEIVERS ? instance : 0];
+    }
+
     // the expected lag (in seconds) in the position and velocity readings from the gps
     float get_lag() const { return 0.2f; }
 
@@ -307,7 +348,7 @@ public:
     DataFlash_Class *_DataFlash;
 
     // configuration parameters
-    AP_Int8 _type[GPS_MAX_INSTANCES];
+    AP_Int8 _type[GPS_MAX_RECEIVERS];
     AP_Int8 _navfilter;
     AP_Int8 _auto_switch;
     AP_Int8 _min_dgps;
@@ -319,6 +360,8 @@ public:
     AP_Int8 _raw_data;
     AP_Int8 _gnss_mode;
     AP_Int8 _save_config;
+    AP_Int8 _blend_mask;
+    AP_Float _blend_tc;
     
     // handle sending of initialisation strings to the GPS
     void send_blob_start(uint8_t instance, const char *_blob, uint16_t size);
@@ -328,8 +371,19 @@ public:
     void lock_port(uint8_t instance, bool locked);
 
     //Inject a packet of raw binary to a GPS
-    void inject_data(uint8_t *data, uint8_t len);
-    void inject_data(uint8_t instance, uint8_t *data, uint8_t len);
+    void inject_data(const uint8_t *data, uint16_t len);
+    void inject_data(uint8_t instance, const uint8_t *data, uint16_t len);
+
+    // statistics on injected correction data
+    struct Inject_Stats {
+        uint32_t frames;            ///< good RTCM3 frames
+        uint32_t raw_bytes;         ///< bytes passed through without RTCM3 framing
+        uint32_t crc_errors;        ///< RTCM3 frames failing their CRC
+        uint32_t bytes_skipped;     ///< bytes outside any RTCM3 frame
+        uint32_t dropped;           ///< entries lost to a full receiver queue
+        uint32_t late;              ///< entries too old to send by the time the receiver had room
+    };
+    void get_inject_stats(Inject_Stats &stats) const;
 
     //MAVLink Status Sending
     void send_mavlink_gps_raw(mavlink_channel_t chan);
@@ -348,17 +402,17 @@ private:
     };
     GPS_timing timing[GPS_MAX_INSTANCES];
     GPS_State state[GPS_MAX_INSTANCES];
-    AP_GPS_Backend *drivers[GPS_MAX_INSTANCES];
-    AP_HAL::UARTDriver *_port[GPS_MAX_INSTANCES];
+    AP_GPS_Backend *drivers[GPS_MAX_RECEIVERS];
+    AP_HAL::UARTDriver *_port[GPS_MAX_RECEIVERS];
 
     /// primary GPS instance
-    uint8_t primary_instance:2;
+    uint8_t primary_instance;
 
     /// number of GPS instances present
-    uint8_t num_instances:2;
+    uint8_t num_instances;
 
     // which ports are locked
-    uint8_t locked_ports:2;
+    uint8_t locked_ports;
 
     // state of auto-detection process, per instance
     struct detect_state {
@@ -371,12 +425,27 @@ private:
         struct SIRF_detect_state sirf_detect_state;
         struct NMEA_detect_state nmea_detect_state;
         struct SBP_detect_state sbp_detect_state;
-    } detect_state[GPS_MAX_INSTANCES];
+    } detect_state[GPS_MAX_RECEIVERS];
 
     struct {
         const char *blob;
         uint16_t remaining;
-    } initblob_state[GPS_MAX_INSTANCES];
+    } initblob_state[GPS_MAX_RECEIVERS];
+
+    // injected correction data. Once RTCM3 frames are seen only whole
+    // checked frames are sent on, otherwise data is passed through as
+    // received
+    RTCM3_Parser _rtcm;
+    uint32_t _rtcm_last_frame_ms;
+    uint32_t _inject_raw_bytes;
+    uint32_t _inject_last_log_ms;
+    GPS_InjectQueue *_inject_queue[GPS_MAX_RECEIVERS];
+
+    // blending state
+    float _blend_weights[GPS_MAX_RECEIVERS];
+    Vector3f _blend_offset_ned[GPS_MAX_RECEIVERS];
+    uint32_t _last_blend_fix_ms;
+    bool _output_is_blended;
 
     static const uint32_t  _baudrates[];
     static const char _initialisation_blob[];
@@ -384,6 +453,12 @@ private:
 
     void detect_instance(uint8_t instance);
     void update_instance(uint8_t instance);
+    void update_primary(void);
+    void update_inject(uint8_t instance);
+    void inject_to_receivers(const uint8_t *data, uint16_t len, uint32_t now);
+    void log_inject_stats(void);
+    bool calc_blend_weights(void);
+    void calc_blended_state(void);
 };
 
 #define GPS_BAUD_TIME_MS 1200
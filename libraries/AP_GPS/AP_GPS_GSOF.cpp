@@ -41,10 +41,9 @@ do {                                            \
 
 AP_GPS_GSOF::AP_GPS_GSOF(AP_GPS &_gps, AP_GPS::GPS_State &_state,
                          AP_HAL::UARTDriver *_port) :
-    AP_GPS_Backend(_gps, _state, _port)
+    AP_GPS_Backend(_gps, _state, _port),
+    _reader(_frame_protocol)
 {
-    gsof_msg.gsof_state = gsof_msg_parser_t::STARTTX;
-
     // baud request for port 0
     requestBaud(0);
     // baud request for port 3
@@ -71,70 +70,48 @@ AP_GPS_GSOF::read(void)
     }
 
     bool ret = false;
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
-        ret |= parse(temp);
+    const uint8_t *frame;
+    uint16_t len;
+    while (_reader.next(port, frame, len)) {
+        gsof_msg.status = frame[1];
+        gsof_msg.packettype = frame[2];
+        gsof_msg.length = frame[3];
+        memcpy(gsof_msg.data, &frame[GSOF_HEADER_LEN], gsof_msg.length);
+        ret |= process_message();
     }
+    crc_error_counter = _reader.get_checksum_errors();
 
     return ret;
 }
 
+/*
+  GSOF framing: STX, status, packet type, length, data, a checksum
+  which is the sum of status to the end of data, then ETX
+ */
+uint16_t
+AP_GPS_GSOF::_frame_length(const uint8_t *header)
+{
+    return GSOF_HEADER_LEN + header[3] + 2;
+}
+
 bool
-AP_GPS_GSOF::parse(uint8_t temp)
+AP_GPS_GSOF::_frame_check(const uint8_t *frame, uint16_t len)
 {
-    switch (gsof_msg.gsof_state)
-    {
-    default:
-    case gsof_msg_parser_t::STARTTX:
-        if (temp == GSOF_STX)
-        {
-            gsof_msg.starttx = temp;
-            gsof_msg.gsof_state = gsof_msg_parser_t::STATUS;
-            gsof_msg.read = 0;
-            gsof_msg.checksumcalc = 0;
-        }
-        break;
-    case gsof_msg_parser_t::STATUS:
-        gsof_msg.status = temp;
-        gsof_msg.gsof_state = gsof_msg_parser_t::PACKETTYPE;
-        gsof_msg.checksumcalc += temp;
-        break;
-    case gsof_msg_parser_t::PACKETTYPE:
-        gsof_msg.packettype = temp;
-        gsof_msg.gsof_state = gsof_msg_parser_t::LENGTH;
-        gsof_msg.checksumcalc += temp;
-        break;
-    case gsof_msg_parser_t::LENGTH:
-        gsof_msg.length = temp;
-        gsof_msg.gsof_state = gsof_msg_parser_t::DATA;
-        gsof_msg.checksumcalc += temp;
-        break;
-    case gsof_msg_parser_t::DATA:
-        gsof_msg.data[gsof_msg.read] = temp;
-        gsof_msg.read++;
-        gsof_msg.checksumcalc += temp;
-        if (gsof_msg.read >= gsof_msg.length)
-        {
-            gsof_msg.gsof_state = gsof_msg_parser_t::CHECKSUM;
-        }
-        break;
-    case gsof_msg_parser_t::CHECKSUM:
-        gsof_msg.checksum = temp;
-        gsof_msg.gsof_state = gsof_msg_parser_t::ENDTX;
-        if (gsof_msg.checksum == gsof_msg.checksumcalc)
-        {
-            return process_message();
-        }
-        break;
-    case gsof_msg_parser_t::ENDTX:
-        gsof_msg.endtx = temp;
-        gsof_msg.gsof_state = gsof_msg_parser_t::STARTTX;
-        break;
+    uint8_t checksum = 0;
+    for (uint16_t i = 1; i < len - 2; i++) {
+        checksum += frame[i];
     }
-
-    return false;
+    return frame[len-2] == checksum && frame[len-1] == GSOF_ETX;
 }
 
+const GPS_FrameReader::Protocol AP_GPS_GSOF::_frame_protocol = {
+    { GSOF_STX, 0 }, 1,
+    GSOF_HEADER_LEN,
+    GSOF_HEADER_LEN + 255 + 2,
+    &AP_GPS_GSOF::_frame_length,
+    &AP_GPS_GSOF::_frame_check
+};
+
 void
 AP_GPS_GSOF::requestBaud(uint8_t portindex)
 {
@@ -344,14 +321,12 @@ AP_GPS_GSOF::process_message(void)
     return false;
 }
 
-void
-AP_GPS_GSOF::inject_data(uint8_t *data, uint8_t len)
+uint16_t
+AP_GPS_GSOF::inject_data(const uint8_t *data, uint16_t len)
 {
-
-    if (port->txspace() > len) {
+    uint16_t written = AP_GPS_Backend::inject_data(data, len);
+    if (written > 0) {
         last_injected_data_ms = AP_HAL::millis();
-        port->write(data, len);
-    } else {
-        Debug("GSOF: Not enough TXSPACE");
     }
+    return written;
 }
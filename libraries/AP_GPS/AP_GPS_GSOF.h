@@ -23,6 +23,7 @@
 #define __AP_GPS_GSOF_H__
 
 #include "AP_GPS.h"
+#include "GPS_FrameReader.h"
 
 class AP_GPS_GSOF : public AP_GPS_Backend
 {
@@ -36,11 +37,10 @@ public:
     // Methods
     bool read();
 
-    void inject_data(uint8_t *data, uint8_t len);
+    uint16_t inject_data(const uint8_t *data, uint16_t len);
 
 private:
 
-    bool parse(uint8_t temp);
     bool process_message();
     void requestBaud(uint8_t portindex);
     void requestGSOF(uint8_t messagetype, uint8_t portindex);
@@ -50,34 +50,25 @@ private:
     uint16_t SwapUint16(uint8_t* src, uint32_t pos);
 
 
+    // the last message received
     struct gsof_msg_parser_t
     {
-        enum
-        {
-            STARTTX = 0,
-            STATUS,
-            PACKETTYPE,
-            LENGTH,
-            DATA,
-            CHECKSUM,
-            ENDTX
-        } gsof_state;
-
-        uint8_t starttx;
         uint8_t status;
         uint8_t packettype;
         uint8_t length;
         uint8_t data[256];
-        uint8_t checksum;
-        uint8_t endtx;
-
-        uint16_t read;
-        uint8_t checksumcalc;
     } gsof_msg;
 
     static const uint8_t GSOF_STX = 0x02;
     static const uint8_t GSOF_ETX = 0x03;
 
+    // STX, status, packet type and length
+    static const uint8_t GSOF_HEADER_LEN = 4;
+
+    static const GPS_FrameReader::Protocol _frame_protocol;
+    static uint16_t _frame_length(const uint8_t *header);
+    static bool _frame_check(const uint8_t *frame, uint16_t len);
+
     uint8_t packetcount = 0;
 
     uint32_t gsofmsg_time = 0;
@@ -87,6 +78,8 @@ private:
     uint32_t last_hdop = 9999;
     uint32_t crc_error_counter = 0;
     uint32_t last_injected_data_ms = 0;
+
+    GPS_FrameReader _reader;
 };
 
 #endif // __AP_GPS_GSOF_H__
@@ -60,14 +60,9 @@ bool
 AP_GPS_MTK::read(void)
 {
     uint8_t data;
-    int16_t numc;
     bool parsed = false;
 
-    numc = port->available();
-    for (int16_t i = 0; i < numc; i++) {        // Process bytes received
-
-        // read the next byte
-        data = port->read();
+    while (read_byte(data)) {                   // Process bytes received
 
 restart:
         switch(_step) {
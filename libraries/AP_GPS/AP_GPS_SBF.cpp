@@ -69,8 +69,8 @@ AP_GPS_SBF::read(void)
     }
 
     bool ret = false;
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
+    uint8_t temp;
+    while (read_byte(temp)) {
         ret |= parse(temp);
     }
 
@@ -295,14 +295,12 @@ AP_GPS_SBF::process_message(void)
     return false;
 }
 
-void
-AP_GPS_SBF::inject_data(uint8_t *data, uint8_t len)
+uint16_t
+AP_GPS_SBF::inject_data(const uint8_t *data, uint16_t len)
 {
-
-    if (port->txspace() > len) {
+    uint16_t written = AP_GPS_Backend::inject_data(data, len);
+    if (written > 0) {
         last_injected_data_ms = AP_HAL::millis();
-        port->write(data, len);
-    } else {
-        Debug("SBF: Not enough TXSPACE");
     }
+    return written;
 }
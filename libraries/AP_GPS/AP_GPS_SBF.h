@@ -36,7 +36,7 @@ public:
     // Methods
     bool read();
 
-    void inject_data(uint8_t *data, uint8_t len);
+    uint16_t inject_data(const uint8_t *data, uint16_t len);
 
 private:
 
@@ -53,12 +53,12 @@ AP_GPS_SBP::AP_GPS_SBP(AP_GPS &_gps, AP_GPS::GPS_State &_state,
     last_iar_num_hypotheses(0),
     last_full_update_tow(0),
     last_full_update_cpu_ms(0),
-    crc_error_counter(0)
+    crc_error_counter(0),
+    _reader(_frame_protocol)
 {
 
     Debug("SBP Driver Initialized");
 
-    parser_state.state = sbp_parser_state_t::WAITING;
 
     //Externally visible state
     state.status = AP_GPS::NO_FIX;
@@ -84,99 +84,57 @@ AP_GPS_SBP::read(void)
 
 }
 
-void 
-AP_GPS_SBP::inject_data(uint8_t *data, uint8_t len)
+uint16_t
+AP_GPS_SBP::inject_data(const uint8_t *data, uint16_t len)
 {
-
-    if (port->txspace() > len) {
+    uint16_t written = AP_GPS_Backend::inject_data(data, len);
+    if (written > 0) {
         last_injected_data_ms = AP_HAL::millis();
-        port->write(data, len);
-    } else {
-        Debug("PIKSI: Not enough TXSPACE");
     }
+    return written;
+}
 
+/*
+  SBP framing: preamble, 16 bit message type, 16 bit sender, length,
+  payload and a CRC-16-CCITT over everything after the preamble
+ */
+uint16_t
+AP_GPS_SBP::_frame_length(const uint8_t *header)
+{
+    return SBP_HEADER_LEN + header[5] + 2;
 }
 
+bool
+AP_GPS_SBP::_frame_check(const uint8_t *frame, uint16_t len)
+{
+    uint16_t crc = crc16_ccitt(&frame[1], len - 3, 0);
+    return frame[len-2] == (crc & 0xFF) && frame[len-1] == (crc >> 8);
+}
+
+const GPS_FrameReader::Protocol AP_GPS_SBP::_frame_protocol = {
+    { SBP_PREAMBLE, 0 }, 1,
+    SBP_HEADER_LEN,
+    SBP_HEADER_LEN + 255 + 2,
+    &AP_GPS_SBP::_frame_length,
+    &AP_GPS_SBP::_frame_check
+};
+
 //This attempts to reads all SBP messages from the incoming port.
-//Returns true if a new message was read, false if we failed to read a message.
 void
 AP_GPS_SBP::_sbp_process() 
 {
-
-    while (port->available() > 0) {
-        uint8_t temp = port->read();
-        uint16_t crc;
-
-
-        //This switch reads one character at a time,
-        //parsing it into buffers until a full message is dispatched
-        switch(parser_state.state) {
-            case sbp_parser_state_t::WAITING:
-                if (temp == SBP_PREAMBLE) {
-                    parser_state.n_read = 0;
-                    parser_state.state = sbp_parser_state_t::GET_TYPE;
-                }
-                break;
-
-            case sbp_parser_state_t::GET_TYPE:
-                *((uint8_t*)&(parser_state.msg_type) + parser_state.n_read) = temp;
-                parser_state.n_read += 1;
-                if (parser_state.n_read >= 2) {
-                    parser_state.n_read = 0;
-                    parser_state.state = sbp_parser_state_t::GET_SENDER;
-                }
-                break;
-
-            case sbp_parser_state_t::GET_SENDER:
-                *((uint8_t*)&(parser_state.sender_id) + parser_state.n_read) = temp;
-                parser_state.n_read += 1;
-                if (parser_state.n_read >= 2) {
-                    parser_state.n_read = 0;
-                    parser_state.state = sbp_parser_state_t::GET_LEN;
-                }
-                break;
-
-            case sbp_parser_state_t::GET_LEN:
-                parser_state.msg_len = temp;
-                parser_state.n_read = 0;
-                parser_state.state = sbp_parser_state_t::GET_MSG;
-                break;
-
-            case sbp_parser_state_t::GET_MSG:
-                *((uint8_t*)&(parser_state.msg_buff) + parser_state.n_read) = temp;
-                parser_state.n_read += 1;
-                if (parser_state.n_read >= parser_state.msg_len) {
-                    parser_state.n_read = 0;
-                    parser_state.state = sbp_parser_state_t::GET_CRC;
-                }
-                break;
-
-            case sbp_parser_state_t::GET_CRC:
-                *((uint8_t*)&(parser_state.crc) + parser_state.n_read) = temp;
-                parser_state.n_read += 1;
-                if (parser_state.n_read >= 2) {
-                    parser_state.state = sbp_parser_state_t::WAITING;
-
-                    crc = crc16_ccitt((uint8_t*)&(parser_state.msg_type), 2, 0);
-                    crc = crc16_ccitt((uint8_t*)&(parser_state.sender_id), 2, crc);
-                    crc = crc16_ccitt(&(parser_state.msg_len), 1, crc);
-                    crc = crc16_ccitt(parser_state.msg_buff, parser_state.msg_len, crc);
-                    if (parser_state.crc == crc) {
-                        _sbp_process_message();
-                    } else {
-                        Debug("CRC Error Occurred!");
-                        crc_error_counter += 1;
-                    }
-
-                    parser_state.state = sbp_parser_state_t::WAITING;                
-                }
-                break;
-
-            default:
-                parser_state.state = sbp_parser_state_t::WAITING;
-                break;
-            }
+    const uint8_t *frame;
+    uint16_t len;
+    while (_reader.next(port, frame, len)) {
+        parser_state.msg_type = frame[1] | (frame[2] << 8);
+        parser_state.sender_id = frame[3] | (frame[4] << 8);
+        parser_state.msg_len = frame[5];
+        parser_state.crc = frame[len-2] | (frame[len-1] << 8);
+        memcpy(parser_state.msg_buff, &frame[SBP_HEADER_LEN], parser_state.msg_len);
+
+        _sbp_process_message();
     }
+    crc_error_counter = _reader.get_checksum_errors();
 }
 
 
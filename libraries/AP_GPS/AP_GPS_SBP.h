@@ -25,6 +25,7 @@
 #define __AP_GPS_SBP_H__
 
 #include "AP_GPS.h"
+#include "GPS_FrameReader.h"
 
 class AP_GPS_SBP : public AP_GPS_Backend
 {
@@ -36,7 +37,7 @@ public:
     // Methods
     bool read();
 
-    void inject_data(uint8_t *data, uint8_t len);
+    uint16_t inject_data(const uint8_t *data, uint16_t len);
 
     static bool _detect(struct SBP_detect_state &state, uint8_t data);
 
@@ -46,24 +47,23 @@ private:
     // Swift Navigation SBP protocol types and definitions
     // ************************************************************************
   
+    // the last message received
     struct sbp_parser_state_t {
-      enum {
-        WAITING = 0,
-        GET_TYPE = 1,
-        GET_SENDER = 2,
-        GET_LEN = 3,
-        GET_MSG = 4,
-        GET_CRC = 5
-      } state:8;
       uint16_t msg_type;
       uint16_t sender_id;
       uint16_t crc;
       uint8_t msg_len;
-      uint8_t n_read;
       uint8_t msg_buff[256];
     } parser_state;
 
     static const uint8_t SBP_PREAMBLE = 0x55;
+
+    // preamble, type, sender and length
+    static const uint8_t SBP_HEADER_LEN = 6;
+
+    static const GPS_FrameReader::Protocol _frame_protocol;
+    static uint16_t _frame_length(const uint8_t *header);
+    static bool _frame_check(const uint8_t *frame, uint16_t len);
     
     //Message types supported by this driver
     static const uint16_t SBP_STARTUP_MSGTYPE        = 0xFF00;    
@@ -160,6 +160,8 @@ private:
 
     uint32_t crc_error_counter;
 
+    GPS_FrameReader _reader;
+
     // ************************************************************************
     // Logging to DataFlash
     // ************************************************************************
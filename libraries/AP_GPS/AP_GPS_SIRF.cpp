@@ -58,14 +58,9 @@ bool
 AP_GPS_SIRF::read(void)
 {
     uint8_t data;
-    int16_t numc;
     bool parsed = false;
 
-    numc = port->available();
-    while(numc--) {
-
-        // read the next byte
-        data = port->read();
+    while (read_byte(data)) {
 
         switch(_step) {
 
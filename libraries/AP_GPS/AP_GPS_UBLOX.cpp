@@ -44,10 +44,8 @@ extern const AP_HAL::HAL& hal;
 
 AP_GPS_UBLOX::AP_GPS_UBLOX(AP_GPS &_gps, AP_GPS::GPS_State &_state, AP_HAL::UARTDriver *_port) :
     AP_GPS_Backend(_gps, _state, _port),
-    _step(0),
     _msg_id(0),
     _payload_length(0),
-    _payload_counter(0),
     _fix_count(0),
     _class(0),
     _cfg_saved(false),
@@ -60,7 +58,8 @@ AP_GPS_UBLOX::AP_GPS_UBLOX(AP_GPS &_gps, AP_GPS::GPS_State &_state, AP_HAL::UART
     next_fix(AP_GPS::NO_FIX),
     rate_update_step(0),
     _last_5hz_time(0),
-    noReceivedHdop(true)
+    noReceivedHdop(true),
+    _reader(_frame_protocol)
 {
     // stop any config strings that are pending
     gps.send_blob_start(state.instance, NULL, 0);
@@ -142,20 +141,44 @@ AP_GPS_UBLOX::send_next_rate_update(void)
 }
 
 
-// Process bytes available from the stream
+/*
+  UBX framing: preamble, class, id, 16 bit payload length, payload
+  and a two byte Fletcher checksum over class to the end of payload
+ */
+uint16_t
+AP_GPS_UBLOX::_frame_length(const uint8_t *header)
+{
+    return UBX_HEADER_LEN + (header[4] | (header[5] << 8)) + 2;
+}
+
+bool
+AP_GPS_UBLOX::_frame_check(const uint8_t *frame, uint16_t len)
+{
+    uint8_t ck_a = 0, ck_b = 0;
+    for (uint16_t i = 2; i < len - 2; i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    return frame[len-2] == ck_a && frame[len-1] == ck_b;
+}
+
+const GPS_FrameReader::Protocol AP_GPS_UBLOX::_frame_protocol = {
+    { PREAMBLE1, PREAMBLE2 }, 2,
+    UBX_HEADER_LEN,
+    UBX_HEADER_LEN + sizeof(AP_GPS_UBLOX::_buffer) + 2,
+    &AP_GPS_UBLOX::_frame_length,
+    &AP_GPS_UBLOX::_frame_check
+};
+
+// Process messages available from the stream
 //
-// The stream is assumed to contain only messages we recognise.  If it
-// contains other messages, and those messages contain the preamble
-// bytes, it is possible for this code to fail to synchronise to the
-// stream immediately.  Without buffering the entire message and
-// re-processing it from the top, this is unavoidable. The parser
-// attempts to avoid this when possible.
+// Frames are found and checked in the UART buffer, so a preamble
+// appearing inside a message we don't know about can't make us lose
+// sync with the stream. Messages larger than our buffer are skipped.
 //
 bool
 AP_GPS_UBLOX::read(void)
 {
-    uint8_t data;
-    int16_t numc;
     bool parsed = false;
     uint32_t millis_now = AP_HAL::millis();
 
@@ -167,108 +190,18 @@ AP_GPS_UBLOX::read(void)
         _num_cfg_save_tries++;
     }
 
-    numc = port->available();
-    for (int16_t i = 0; i < numc; i++) {        // Process bytes received
+    const uint8_t *frame;
+    uint16_t len;
+    while (_reader.next(port, frame, len)) {
+        _class = frame[2];
+        _msg_id = frame[3];
+        _payload_length = len - (UBX_HEADER_LEN + 2);
 
-        // read the next byte
-        data = port->read();
+        // copy into the aligned message union before decoding
+        memcpy(_buffer.bytes, &frame[UBX_HEADER_LEN], _payload_length);
 
-	reset:
-        switch(_step) {
-
-        // Message preamble detection
-        //
-        // If we fail to match any of the expected bytes, we reset
-        // the state machine and re-consider the failed byte as
-        // the first byte of the preamble.  This improves our
-        // chances of recovering from a mismatch and makes it less
-        // likely that we will be fooled by the preamble appearing
-        // as data in some other message.
-        //
-        case 1:
-            if (PREAMBLE2 == data) {
-                _step++;
-                break;
-            }
-            _step = 0;
-            Debug("reset %u", __LINE__);
-            /* no break */
-        case 0:
-            if(PREAMBLE1 == data)
-                _step++;
-            break;
-
-        // Message header processing
-        //
-        // We sniff the class and message ID to decide whether we
-        // are going to gather the message bytes or just discard
-        // them.
-        //
-        // We always collect the length so that we can avoid being
-        // fooled by preamble bytes in messages.
-        //
-        case 2:
-            _step++;
-            _class = data;
-            _ck_b = _ck_a = data;                               // reset the checksum accumulators
-            break;
-        case 3:
-            _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
-            _msg_id = data;
-            break;
-        case 4:
-            _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
-            _payload_length = data;                             // payload length low byte
-            break;
-        case 5:
-            _step++;
-            _ck_b += (_ck_a += data);                   // checksum byte
-
-            _payload_length += (uint16_t)(data<<8);
-            if (_payload_length > sizeof(_buffer)) {
-                Debug("large payload %u", (unsigned)_payload_length);
-                // assume any payload bigger then what we know about is noise
-                _payload_length = 0;
-                _step = 0;
-				goto reset;
-            }
-            _payload_counter = 0;                               // prepare to receive payload
-            break;
-
-        // Receive message data
-        //
-        case 6:
-            _ck_b += (_ck_a += data);                   // checksum byte
-            if (_payload_counter < sizeof(_buffer)) {
-                _buffer.bytes[_payload_counter] = data;
-            }
-            if (++_payload_counter == _payload_length)
-                _step++;
-            break;
-
-        // Checksum and message processing
-        //
-        case 7:
-            _step++;
-            if (_ck_a != data) {
-                Debug("bad cka %x should be %x", data, _ck_a);
-                _step = 0;
-				goto reset;
-            }
-            break;
-        case 8:
-            _step = 0;
-            if (_ck_b != data) {
-                Debug("bad ckb %x should be %x", data, _ck_b);
-                break;                                                  // bad checksum
-            }
-
-            if (_parse_gps()) {
-                parsed = true;
-            }
-            break;
+        if (_parse_gps()) {
+            parsed = true;
         }
     }
     return parsed;
@@ -25,6 +25,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include "AP_GPS.h"
+#include "GPS_FrameReader.h"
 
 /*
  *  try to put a UBlox into binary mode. This is in two parts. 
@@ -387,15 +388,9 @@ private:
         UBLOX_M8
     };
 
-    // Packet checksum accumulators
-    uint8_t         _ck_a;
-    uint8_t         _ck_b;
-
-    // State machine state
-    uint8_t         _step;
+    // header of the message in _buffer
     uint8_t         _msg_id;
     uint16_t        _payload_length;
-    uint16_t        _payload_counter;
 
     // 8 bit count of fix messages processed, used for periodic
     // processing
@@ -427,6 +422,14 @@ private:
 
     bool noReceivedHdop;
 
+    // preamble, class, id and length
+    static const uint8_t UBX_HEADER_LEN = 6;
+
+    static const GPS_FrameReader::Protocol _frame_protocol;
+    static uint16_t _frame_length(const uint8_t *header);
+    static bool _frame_check(const uint8_t *frame, uint16_t len);
+    GPS_FrameReader _reader;
+
     void 	    _configure_navigation_rate(uint16_t rate_ms);
     void        _configure_message_rate(uint8_t msg_class, uint8_t msg_id, uint8_t rate);
     void        _configure_gps(void);
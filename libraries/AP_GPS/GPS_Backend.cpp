@@ -21,13 +21,31 @@ extern const AP_HAL::HAL& hal;
 AP_GPS_Backend::AP_GPS_Backend(AP_GPS &_gps, AP_GPS::GPS_State &_state, AP_HAL::UARTDriver *_port) :
     port(_port),
     gps(_gps),
-    state(_state)
+    state(_state),
+    _read_len(0),
+    _read_ofs(0)
 {
     state.have_speed_accuracy = false;
     state.have_horizontal_accuracy = false;
     state.have_vertical_accuracy = false;
 }
 
+uint16_t AP_GPS_Backend::inject_data(const uint8_t *data, uint16_t len)
+{
+    if (port == NULL) {
+        // nothing to send it to
+        return len;
+    }
+    int16_t space = port->txspace();
+    if (space <= 0) {
+        return 0;
+    }
+    if (len > (uint16_t)space) {
+        len = space;
+    }
+    return port->write(data, len);
+}
+
 int32_t AP_GPS_Backend::swap_int32(int32_t v) const
 {
     const uint8_t *b = (const uint8_t *)&v;
@@ -23,6 +23,9 @@
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include "AP_GPS.h"
 
+// bytes fetched from the port at a time by read_byte()
+#define GPS_BACKEND_READ_BLOCK 64
+
 class AP_GPS_Backend
 {
 public:
@@ -37,7 +40,9 @@ public:
     // valid packet from the GPS.
     virtual bool read() = 0;
 
-    virtual void inject_data(uint8_t *data, uint8_t len) { return; }
+    // write correction data to the receiver, returning the number of
+    // bytes the port had room for
+    virtual uint16_t inject_data(const uint8_t *data, uint16_t len);
 
     // Highest status supported by this GPS. 
     // Allows external system to identify type of receiver connected.
@@ -53,6 +58,23 @@ protected:
     AP_GPS &gps;                        ///< access to frontend (for parameters)
     AP_GPS::GPS_State &state;           ///< public state for this instance
 
+    /*
+      get the next received byte for drivers that parse a byte at a
+      time. Bytes are fetched from the port in blocks, so a driver
+      using this must not also read the port directly
+     */
+    bool read_byte(uint8_t &c) {
+        if (_read_ofs == _read_len) {
+            _read_len = port->read_bytes(_read_block, sizeof(_read_block));
+            _read_ofs = 0;
+            if (_read_len == 0) {
+                return false;
+            }
+        }
+        c = _read_block[_read_ofs++];
+        return true;
+    }
+
     // common utility functions
     int32_t swap_int32(int32_t v) const;
     int16_t swap_int16(int16_t v) const;
@@ -67,6 +89,11 @@ protected:
        assumes MTK19 millisecond form of bcd_time
     */
     void make_gps_time(uint32_t bcd_date, uint32_t bcd_milliseconds);
+
+private:
+    uint8_t _read_block[GPS_BACKEND_READ_BLOCK];
+    uint8_t _read_len;
+    uint8_t _read_ofs;
 };
 
 #endif // __AP_GPS_BACKEND_H__
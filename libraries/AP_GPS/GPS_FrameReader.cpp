@@ -0,0 +1,179 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GPS_FrameReader.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+GPS_FrameReader::GPS_FrameReader(const Protocol &protocol) :
+    _protocol(protocol),
+    _buf_len(0),
+    _span_used(0),
+    _buf_used(0),
+    _frame_count(0),
+    _checksum_errors(0),
+    _bytes_skipped(0)
+{
+    _buf = (uint8_t *)calloc(_protocol.max_frame_len, 1);
+}
+
+GPS_FrameReader::~GPS_FrameReader(void)
+{
+    free(_buf);
+}
+
+/*
+  look for the first good frame in n bytes. On SCAN_FRAME start and len
+  give the frame. On SCAN_PARTIAL start is where a frame begins that
+  needs at least len bytes. On SCAN_NONE all n bytes can be dropped
+ */
+GPS_FrameReader::scan_result GPS_FrameReader::_scan(const uint8_t *data, uint16_t n, uint16_t &start, uint16_t &len)
+{
+    uint16_t pos = 0;
+
+    while (pos < n) {
+        const uint8_t *p = (const uint8_t *)memchr(&data[pos], _protocol.preamble[0], n - pos);
+        if (p == nullptr) {
+            break;
+        }
+        start = p - data;
+        _bytes_skipped += start - pos;
+        pos = start + 1;
+
+        if (n - start < _protocol.header_len) {
+            len = _protocol.header_len;
+            return SCAN_PARTIAL;
+        }
+        if (_protocol.preamble_len > 1 && p[1] != _protocol.preamble[1]) {
+            _bytes_skipped++;
+            continue;
+        }
+        len = _protocol.frame_length(p);
+        if (len < _protocol.header_len || len > _protocol.max_frame_len) {
+            _bytes_skipped++;
+            continue;
+        }
+        if (n - start < len) {
+            return SCAN_PARTIAL;
+        }
+        if (!_protocol.check(p, len)) {
+            _checksum_errors++;
+            _bytes_skipped++;
+            continue;
+        }
+        _frame_count++;
+        return SCAN_FRAME;
+    }
+
+    _bytes_skipped += n - pos;
+    start = n;
+    return SCAN_NONE;
+}
+
+void GPS_FrameReader::_buf_discard(uint16_t n)
+{
+    _buf_len -= n;
+    memmove(_buf, &_buf[n], _buf_len);
+}
+
+bool GPS_FrameReader::next(AP_HAL::UARTDriver *port, const uint8_t *&frame, uint16_t &len)
+{
+    if (_buf == nullptr) {
+        return false;
+    }
+
+    // the driver has finished with the last frame
+    if (_span_used != 0) {
+        port->consume(_span_used);
+        _span_used = 0;
+    }
+    if (_buf_used != 0) {
+        _buf_discard(_buf_used);
+        _buf_used = 0;
+    }
+
+    uint16_t start, flen;
+
+    while (true) {
+        // finish off anything already copied out of the port
+        if (_buf_len > 0) {
+            switch (_scan(_buf, _buf_len, start, flen)) {
+            case SCAN_FRAME:
+                frame = &_buf[start];
+                len = flen;
+                _buf_used = start + flen;
+                return true;
+
+            case SCAN_PARTIAL: {
+                _buf_discard(start);
+                const uint16_t n = port->read_bytes(&_buf[_buf_len], flen - _buf_len);
+                if (n == 0) {
+                    return false;
+                }
+                _buf_len += n;
+                break;
+            }
+
+            case SCAN_NONE:
+                _buf_len = 0;
+                break;
+            }
+            continue;
+        }
+
+        const uint8_t *data;
+        const uint16_t n = port->peek_span(data);
+        if (n == 0) {
+            // empty, or a port without span support
+            _buf_len = port->read_bytes(_buf, _protocol.max_frame_len);
+            if (_buf_len == 0) {
+                return false;
+            }
+            continue;
+        }
+
+        switch (_scan(data, n, start, flen)) {
+        case SCAN_FRAME:
+            frame = &data[start];
+            len = flen;
+            _span_used = start + flen;
+            return true;
+
+        case SCAN_PARTIAL: {
+            port->consume(start);
+            const uint16_t capacity = port->rx_capacity();
+            const uint16_t avail = port->available();
+            if (flen <= capacity && avail < capacity && avail <= n - start) {
+                // the rest of the frame has not arrived yet, leave it
+                // in the port so it can be decoded in place later
+                return false;
+            }
+            // the frame wraps around the end of the receive buffer, or
+            // it can never be whole in the port as it is longer than
+            // the buffer or the buffer is full
+            memcpy(_buf, &data[start], n - start);
+            _buf_len = n - start;
+            port->consume(n - start);
+            break;
+        }
+
+        case SCAN_NONE:
+            port->consume(n);
+            break;
+        }
+    }
+}
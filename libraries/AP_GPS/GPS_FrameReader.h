@@ -0,0 +1,93 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Framed protocol reader for binary GPS protocols.
+
+  A protocol is described by its preamble, the number of header bytes
+  needed to know the frame length, and functions giving the frame
+  length and checking a complete frame. Frames are found and checked
+  directly in the UART receive buffer using the UARTDriver span API,
+  and handed to the driver in place. Only a frame that is split across
+  the end of the receive buffer, or received on a port without span
+  support, is copied into the reader's own buffer.
+ */
+#ifndef __GPS_FRAMEREADER_H__
+#define __GPS_FRAMEREADER_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+class GPS_FrameReader
+{
+public:
+    struct Protocol {
+        uint8_t preamble[2];
+        uint8_t preamble_len;
+
+        // bytes needed, including the preamble, before frame_length()
+        // can be called
+        uint8_t header_len;
+
+        // longest frame the driver can accept
+        uint16_t max_frame_len;
+
+        // total length of the frame starting with header, or zero if
+        // the header is invalid
+        uint16_t (*frame_length)(const uint8_t *header);
+
+        // true if the complete frame passes its checksum
+        bool (*check)(const uint8_t *frame, uint16_t len);
+    };
+
+    GPS_FrameReader(const Protocol &protocol);
+    ~GPS_FrameReader(void);
+
+    /*
+      get the next good frame from port. The frame stays valid until
+      the next call. Returns false when no complete frame is available
+     */
+    bool next(AP_HAL::UARTDriver *port, const uint8_t *&frame, uint16_t &len);
+
+    uint32_t get_frame_count(void) const { return _frame_count; }
+    uint32_t get_checksum_errors(void) const { return _checksum_errors; }
+    uint32_t get_bytes_skipped(void) const { return _bytes_skipped; }
+
+private:
+    const Protocol &_protocol;
+
+    // reassembly buffer of max_frame_len bytes
+    uint8_t *_buf;
+    uint16_t _buf_len;
+
+    // bytes of the frame last returned, to drop on the next call
+    uint16_t _span_used;
+    uint16_t _buf_used;
+
+    uint32_t _frame_count;
+    uint32_t _checksum_errors;
+    uint32_t _bytes_skipped;
+
+    enum scan_result {
+        SCAN_NONE,
+        SCAN_PARTIAL,
+        SCAN_FRAME
+    };
+
+    scan_result _scan(const uint8_t *data, uint16_t n, uint16_t &start, uint16_t &len);
+    void _buf_discard(uint16_t n);
+};
+
+#endif // __GPS_FRAMEREADER_H__
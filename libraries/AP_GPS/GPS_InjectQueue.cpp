@@ -0,0 +1,83 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GPS_InjectQueue.h"
+#include "AP_GPS.h"
+
+GPS_InjectQueue::GPS_InjectQueue(uint32_t size) :
+    _buffer(size),
+    _remaining(0),
+    _dropped(0),
+    _late(0)
+{
+}
+
+bool GPS_InjectQueue::push(const uint8_t *data, uint16_t len, uint32_t now_ms)
+{
+    if (len == 0) {
+        return true;
+    }
+    if (_buffer.space() < sizeof(entry_header) + len) {
+        _dropped++;
+        return false;
+    }
+    const struct entry_header hdr = { len, now_ms };
+    _buffer.write((const uint8_t *)&hdr, sizeof(hdr));
+    _buffer.write(data, len);
+    return true;
+}
+
+void GPS_InjectQueue::drain(AP_GPS_Backend *backend, uint32_t now_ms, uint32_t max_age_ms)
+{
+    while (true) {
+        if (_remaining == 0) {
+            struct entry_header hdr;
+            if (_buffer.available() < sizeof(hdr)) {
+                return;
+            }
+            _buffer.read((uint8_t *)&hdr, sizeof(hdr));
+            if (now_ms - hdr.queued_ms > max_age_ms) {
+                _buffer.advance(hdr.len);
+                _late++;
+                continue;
+            }
+            _remaining = hdr.len;
+        }
+
+        uint32_t n;
+        const uint8_t *data = _buffer.readptr(n);
+        if (data == nullptr || n == 0) {
+            return;
+        }
+        if (n > _remaining) {
+            n = _remaining;
+        }
+        const uint16_t written = backend->inject_data(data, n);
+        _buffer.advance(written);
+        _remaining -= written;
+        if (written < n) {
+            // the receiver's transmit buffer is full
+            return;
+        }
+    }
+}
+
+void GPS_InjectQueue::flush(void)
+{
+    _buffer.advance(_buffer.available());
+    _remaining = 0;
+}
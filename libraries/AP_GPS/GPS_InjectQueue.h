@@ -0,0 +1,65 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+  queue of correction data waiting to be written to one GPS receiver.
+
+  Each entry keeps the time it was queued, so corrections that could
+  not be sent in time are dropped rather than confusing the receiver
+  with stale data. An entry is only queued if all of it fits, so the
+  receiver never sees part of a frame followed by a different one.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/utility/RingBuffer.h>
+
+class AP_GPS_Backend;
+
+class GPS_InjectQueue
+{
+public:
+    GPS_InjectQueue(uint32_t size);
+
+    // queue len bytes, returning false if they were dropped
+    bool push(const uint8_t *data, uint16_t len, uint32_t now_ms);
+
+    // write as much as the receiver will take, dropping entries
+    // queued more than max_age_ms ago
+    void drain(AP_GPS_Backend *backend, uint32_t now_ms, uint32_t max_age_ms);
+
+    // drop everything, for when the receiver has gone
+    void flush(void);
+
+    uint32_t get_dropped(void) const { return _dropped; }
+    uint32_t get_late(void) const { return _late; }
+
+private:
+    struct PACKED entry_header {
+        uint16_t len;
+        uint32_t queued_ms;
+    };
+
+    ByteBuffer _buffer;
+
+    // bytes of the entry being written that are still to be sent
+    uint16_t _remaining;
+
+    uint32_t _dropped;
+    uint32_t _late;
+};
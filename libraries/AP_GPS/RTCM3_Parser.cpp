@@ -0,0 +1,126 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "RTCM3_Parser.h"
+
+#include <string.h>
+
+RTCM3_Parser::RTCM3_Parser(void) :
+    _len(0),
+    _frame_len(0),
+    _complete(false),
+    _frame_count(0),
+    _crc_errors(0),
+    _bytes_skipped(0)
+{
+}
+
+void RTCM3_Parser::reset(void)
+{
+    _len = 0;
+    _frame_len = 0;
+    _complete = false;
+}
+
+uint32_t RTCM3_Parser::crc24q(const uint8_t *data, uint16_t len)
+{
+    uint32_t crc = 0;
+    while (len--) {
+        crc ^= ((uint32_t)*data++) << 16;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= 0x1864CFB;
+            }
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+/*
+  look at what is in the buffer. Returns true when it starts with a
+  complete good frame. Bad data at the start is dropped
+ */
+bool RTCM3_Parser::_check_frame(void)
+{
+    while (_len > 0) {
+        if (_buf[0] != RTCM3_PREAMBLE) {
+            _resync();
+            continue;
+        }
+        if (_len < RTCM3_HEADER_LEN) {
+            return false;
+        }
+        // the 6 bits above the length are reserved and zero
+        if ((_buf[1] & 0xFC) != 0) {
+            _resync();
+            continue;
+        }
+        _frame_len = RTCM3_HEADER_LEN + (((_buf[1] & 0x03) << 8) | _buf[2]) + RTCM3_CRC_LEN;
+        if (_len < _frame_len) {
+            return false;
+        }
+        const uint16_t n = _frame_len - RTCM3_CRC_LEN;
+        const uint32_t crc = ((uint32_t)_buf[n] << 16) | ((uint32_t)_buf[n+1] << 8) | _buf[n+2];
+        if (crc != crc24q(_buf, n)) {
+            _crc_errors++;
+            _resync();
+            continue;
+        }
+        _frame_count++;
+        return true;
+    }
+    return false;
+}
+
+/*
+  drop bytes up to the next preamble after the start of the buffer
+ */
+void RTCM3_Parser::_resync(void)
+{
+    const uint8_t *p = (const uint8_t *)memchr(&_buf[1], RTCM3_PREAMBLE, _len > 1 ? _len - 1 : 0);
+    const uint16_t skip = p == nullptr ? _len : p - _buf;
+    _bytes_skipped += skip;
+    _len -= skip;
+    memmove(_buf, &_buf[skip], _len);
+}
+
+bool RTCM3_Parser::read(uint8_t byte)
+{
+    if (_complete) {
+        // the last frame has been handed out, anything received after
+        // it in the same buffer is still to be checked
+        _len -= _frame_len;
+        memmove(_buf, &_buf[_frame_len], _len);
+        _complete = false;
+    }
+
+    if (_len == 0 && byte != RTCM3_PREAMBLE) {
+        _bytes_skipped++;
+        return false;
+    }
+    _buf[_len++] = byte;
+
+    _complete = _check_frame();
+    return _complete;
+}
+
+uint16_t RTCM3_Parser::get_frame(const uint8_t *&frame) const
+{
+    frame = _buf;
+    return _complete ? _frame_len : 0;
+}
@@ -0,0 +1,71 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+  RTCM3 frame reassembly and validation for injected corrections.
+
+  Corrections arrive as arbitrary slices of the RTCM3 stream, so a
+  frame may be split over several injection packets. Bytes are
+  collected until a complete frame with a good CRC-24Q is available.
+  On a bad CRC the search restarts at the next preamble inside the
+  failed frame, so a good frame behind a corrupt one is not lost.
+ */
+#pragma once
+
+#include <stdint.h>
+
+// preamble, 10 bit length, up to 1023 bytes of payload and a 24 bit CRC
+#define RTCM3_PREAMBLE 0xD3
+#define RTCM3_HEADER_LEN 3
+#define RTCM3_CRC_LEN 3
+#define RTCM3_MAX_FRAME_LEN (RTCM3_HEADER_LEN + 1023 + RTCM3_CRC_LEN)
+
+class RTCM3_Parser
+{
+public:
+    RTCM3_Parser(void);
+
+    // process one byte, returning true when a complete good frame is
+    // available from get_frame()
+    bool read(uint8_t byte);
+
+    // get the last complete frame. Valid until the next read()
+    uint16_t get_frame(const uint8_t *&frame) const;
+
+    // drop any partial frame
+    void reset(void);
+
+    uint32_t get_frame_count(void) const { return _frame_count; }
+    uint32_t get_crc_errors(void) const { return _crc_errors; }
+    uint32_t get_bytes_skipped(void) const { return _bytes_skipped; }
+
+    // CRC-24Q of len bytes
+    static uint32_t crc24q(const uint8_t *data, uint16_t len);
+
+private:
+    uint8_t _buf[RTCM3_MAX_FRAME_LEN];
+    uint16_t _len;
+    uint16_t _frame_len;
+    bool _complete;
+
+    uint32_t _frame_count;
+    uint32_t _crc_errors;
+    uint32_t _bytes_skipped;
+
+    bool _check_frame(void);
+    void _resync(void);
+};
@@ -0,0 +1,188 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_GPS/GPS_FrameReader.h>
+
+// a second of 10Hz NAV-PVT sized UBX messages, repeated
+#define STREAM_MESSAGES 40
+#define PAYLOAD_LEN 92
+
+static uint8_t stream[STREAM_MESSAGES * (PAYLOAD_LEN + 8)];
+static uint16_t stream_len;
+
+static void fill_stream(void)
+{
+    if (stream_len != 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < STREAM_MESSAGES; i++) {
+        uint8_t *frame = &stream[stream_len];
+        frame[0] = 0xB5;
+        frame[1] = 0x62;
+        frame[2] = 0x01;
+        frame[3] = 0x07;
+        frame[4] = PAYLOAD_LEN;
+        frame[5] = 0;
+        uint8_t ck_a = 0, ck_b = 0;
+        for (uint8_t j = 0; j < PAYLOAD_LEN; j++) {
+            frame[6 + j] = i + j * 7;
+        }
+        for (uint8_t j = 2; j < PAYLOAD_LEN + 6; j++) {
+            ck_a += frame[j];
+            ck_b += ck_a;
+        }
+        frame[PAYLOAD_LEN + 6] = ck_a;
+        frame[PAYLOAD_LEN + 7] = ck_b;
+        stream_len += PAYLOAD_LEN + 8;
+    }
+}
+
+/*
+  port handing back the stream from a linear buffer
+ */
+class StreamUART : public AP_HAL::UARTDriver {
+public:
+    StreamUART(bool spans) : _spans(spans), _ofs(stream_len) {}
+
+    void rewind(void) { _ofs = 0; }
+
+    void begin(uint32_t baud) override {}
+    void begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace) override {}
+    void end() override {}
+    void flush() override {}
+    bool is_initialized() override { return true; }
+    void set_blocking_writes(bool blocking) override {}
+    bool tx_pending() override { return false; }
+
+    int16_t available() override { return stream_len - _ofs; }
+    int16_t txspace() override { return 0; }
+    int16_t read() override { return _ofs < stream_len ? stream[_ofs++] : -1; }
+
+    uint16_t peek_span(const uint8_t *&data) override {
+        data = &stream[_ofs];
+        return _spans ? stream_len - _ofs : 0;
+    }
+    void consume(uint16_t len) override { _ofs += len; }
+
+    size_t write(uint8_t c) override { return 0; }
+    size_t write(const uint8_t *buffer, size_t size) override { return 0; }
+
+private:
+    bool _spans;
+    uint16_t _ofs;
+};
+
+/*
+  the byte at a time UBX state machine the drivers used to run
+ */
+static void BM_UBXReadChar(benchmark::State& state)
+{
+    StreamUART port(false);
+    uint8_t buffer[PAYLOAD_LEN];
+    uint32_t count = 0;
+
+    fill_stream();
+
+    while (state.KeepRunning()) {
+        uint8_t step = 0, ck_a = 0, ck_b = 0;
+        uint16_t payload_length = 0, payload_counter = 0;
+        port.rewind();
+        while (port.available() > 0) {
+            const uint8_t data = port.read();
+            switch (step) {
+            case 0:
+                step = data == 0xB5 ? 1 : 0;
+                break;
+            case 1:
+                step = data == 0x62 ? 2 : 0;
+                break;
+            case 2:
+                ck_b = ck_a = data;
+                step++;
+                break;
+            case 3:
+                ck_b += (ck_a += data);
+                payload_length = data;
+                step++;
+                break;
+            case 5:
+                ck_b += (ck_a += data);
+                payload_length |= (uint16_t)data << 8;
+                payload_counter = 0;
+                step = payload_length > sizeof(buffer) ? 0 : 6;
+                break;
+            case 6:
+                ck_b += (ck_a += data);
+                buffer[payload_counter] = data;
+                if (++payload_counter == payload_length) {
+                    step++;
+                }
+                break;
+            case 7:
+                step = data == ck_a ? 8 : 0;
+                break;
+            case 8:
+                step = 0;
+                if (data == ck_b) {
+                    count += buffer[0];
+                }
+                break;
+            }
+        }
+        gbenchmark_escape(&count);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+static uint16_t ubx_frame_length(const uint8_t *header)
+{
+    return 6 + (header[4] | (header[5] << 8)) + 2;
+}
+
+static bool ubx_frame_check(const uint8_t *frame, uint16_t len)
+{
+    uint8_t ck_a = 0, ck_b = 0;
+    for (uint16_t i = 2; i < len - 2; i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    return frame[len-2] == ck_a && frame[len-1] == ck_b;
+}
+
+static const GPS_FrameReader::Protocol ubx_protocol = {
+    { 0xB5, 0x62 }, 2,
+    6,
+    PAYLOAD_LEN + 8,
+    &ubx_frame_length,
+    &ubx_frame_check
+};
+
+/*
+  frames found and checked by GPS_FrameReader, with the payload copied
+  out once as the drivers do. range_x selects a port with span support
+ */
+static void BM_UBXFrameReader(benchmark::State& state)
+{
+    StreamUART port(state.range_x() != 0);
+    GPS_FrameReader reader(ubx_protocol);
+    uint8_t buffer[PAYLOAD_LEN];
+    uint32_t count = 0;
+
+    fill_stream();
+
+    while (state.KeepRunning()) {
+        const uint8_t *frame;
+        uint16_t len;
+        port.rewind();
+        while (reader.next(&port, frame, len)) {
+            memcpy(buffer, &frame[6], len - 8);
+            count += buffer[0];
+        }
+        gbenchmark_escape(&count);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+BENCHMARK(BM_UBXReadChar);
+BENCHMARK(BM_UBXFrameReader)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN()
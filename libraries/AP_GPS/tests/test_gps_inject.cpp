@@ -0,0 +1,169 @@
+#include <AP_gtest.h>
+
+#include <vector>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_GPS/RTCM3_Parser.h>
+#include <AP_GPS/GPS_InjectQueue.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static void add_rtcm3(std::vector<uint8_t> &stream, uint16_t msg_type, uint16_t payload_len)
+{
+    std::vector<uint8_t> frame;
+    frame.push_back(RTCM3_PREAMBLE);
+    frame.push_back(payload_len >> 8);
+    frame.push_back(payload_len & 0xFF);
+    for (uint16_t i = 0; i < payload_len; i++) {
+        // message type in the first 12 bits, then plenty of false preambles
+        if (i == 0) {
+            frame.push_back(msg_type >> 4);
+        } else if (i == 1) {
+            frame.push_back((msg_type & 0x0F) << 4);
+        } else {
+            frame.push_back(i % 3 == 0 ? RTCM3_PREAMBLE : (uint8_t)(i + msg_type));
+        }
+    }
+    const uint32_t crc = RTCM3_Parser::crc24q(&frame[0], frame.size());
+    frame.push_back(crc >> 16);
+    frame.push_back(crc >> 8);
+    frame.push_back(crc);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+TEST(RTCM3_Parser, CRC24Q)
+{
+    const uint8_t check[] = "123456789";
+    EXPECT_EQ(0xCDE703U, RTCM3_Parser::crc24q(check, 9));
+}
+
+TEST(RTCM3_Parser, Fragments)
+{
+    std::vector<uint8_t> stream;
+    std::vector<uint16_t> expected;
+
+    for (uint16_t i = 0; i < 40; i++) {
+        if (i % 9 == 4) {
+            // corrupt frame
+            add_rtcm3(stream, 1000 + i, 30 + i);
+            stream[stream.size() - 10] ^= 0x01;
+        }
+        if (i % 7 == 2) {
+            stream.push_back(0x55);
+            stream.push_back(RTCM3_PREAMBLE);
+        }
+        // up to the largest frame the format allows
+        const uint16_t len = i == 39 ? 1023 : 2 + i * 17;
+        add_rtcm3(stream, 1000 + i, len);
+        expected.push_back(1000 + i);
+    }
+
+    // fragments of GPS_INJECT_DATA size and smaller
+    for (uint16_t fragment = 1; fragment <= 110; fragment += 13) {
+        RTCM3_Parser parser;
+        std::vector<uint16_t> types;
+        for (size_t ofs = 0; ofs < stream.size(); ofs += fragment) {
+            for (size_t i = ofs; i < ofs + fragment && i < stream.size(); i++) {
+                if (parser.read(stream[i])) {
+                    const uint8_t *frame;
+                    const uint16_t len = parser.get_frame(frame);
+                    ASSERT_GT(len, RTCM3_HEADER_LEN + RTCM3_CRC_LEN);
+                    types.push_back((frame[3] << 4) | (frame[4] >> 4));
+                }
+            }
+        }
+        EXPECT_EQ(expected, types) << "fragment size " << fragment;
+        EXPECT_EQ(expected.size(), parser.get_frame_count());
+        EXPECT_GE(parser.get_crc_errors(), 5U);
+    }
+}
+
+/*
+  backend that accepts a limited number of bytes per call
+ */
+class CaptureBackend : public AP_GPS_Backend {
+public:
+    CaptureBackend(AP_GPS &_gps, AP_GPS::GPS_State &_state) :
+        AP_GPS_Backend(_gps, _state, nullptr), space(0) {}
+
+    bool read() { return false; }
+
+    uint16_t inject_data(const uint8_t *data, uint16_t len) {
+        if (len > space) {
+            len = space;
+        }
+        written.insert(written.end(), data, data + len);
+        space -= len;
+        return len;
+    }
+
+    uint16_t space;
+    std::vector<uint8_t> written;
+};
+
+class InjectQueueTest : public ::testing::Test {
+protected:
+    InjectQueueTest() : state(), backend(gps, state) {}
+
+    AP_GPS gps;
+    AP_GPS::GPS_State state;
+    CaptureBackend backend;
+};
+
+TEST_F(InjectQueueTest, PartialWrites)
+{
+    GPS_InjectQueue queue(512);
+    std::vector<uint8_t> sent;
+
+    for (uint8_t i = 0; i < 20; i++) {
+        std::vector<uint8_t> data(50 + i, i);
+        sent.insert(sent.end(), data.begin(), data.end());
+        EXPECT_TRUE(queue.push(&data[0], data.size(), 1000));
+        // the port only has room for a little at a time
+        backend.space = 37;
+        queue.drain(&backend, 1000, 2000);
+        if (i % 4 == 3) {
+            while (backend.written.size() < sent.size()) {
+                backend.space = 37;
+                queue.drain(&backend, 1000, 2000);
+            }
+        }
+    }
+    EXPECT_EQ(sent, backend.written);
+    EXPECT_EQ(0U, queue.get_dropped());
+    EXPECT_EQ(0U, queue.get_late());
+}
+
+TEST_F(InjectQueueTest, DropWhenFull)
+{
+    GPS_InjectQueue queue(256);
+    std::vector<uint8_t> data(100, 0xAA);
+
+    EXPECT_TRUE(queue.push(&data[0], data.size(), 1000));
+    EXPECT_TRUE(queue.push(&data[0], data.size(), 1000));
+    // whole entries only, never part of one
+    EXPECT_FALSE(queue.push(&data[0], data.size(), 1000));
+    EXPECT_EQ(1U, queue.get_dropped());
+
+    backend.space = 1000;
+    queue.drain(&backend, 1000, 2000);
+    EXPECT_EQ(200U, backend.written.size());
+}
+
+TEST_F(InjectQueueTest, LateCorrections)
+{
+    GPS_InjectQueue queue(512);
+    std::vector<uint8_t> old_data(40, 1);
+    std::vector<uint8_t> new_data(40, 2);
+
+    queue.push(&old_data[0], old_data.size(), 1000);
+    queue.push(&new_data[0], new_data.size(), 3500);
+
+    backend.space = 1000;
+    queue.drain(&backend, 4000, 2000);
+    EXPECT_EQ(new_data, backend.written);
+    EXPECT_EQ(1U, queue.get_late());
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,469 @@
+#include <AP_gtest.h>
+
+#include <string.h>
+#include <vector>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_GPS/GPS_FrameReader.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  UART replaying a byte stream through a small ring buffer, so frames
+  regularly wrap around the end of the buffer. With spans disabled it
+  behaves like a port that only supports read()
+ */
+class ReplayUART : public AP_HAL::UARTDriver {
+public:
+    ReplayUART(bool spans) : _spans(spans), _head(0), _tail(0) {}
+
+    // move up to n bytes of the stream into the receive buffer
+    void feed(std::vector<uint8_t> &stream, size_t &ofs, size_t n) {
+        while (n-- > 0 && ofs < stream.size() && count() < sizeof(_buf) - 1) {
+            _buf[_tail] = stream[ofs++];
+            _tail = (_tail + 1) % sizeof(_buf);
+        }
+    }
+
+    void begin(uint32_t baud) override {}
+    void begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace) override {}
+    void end() override {}
+    void flush() override {}
+    bool is_initialized() override { return true; }
+    void set_blocking_writes(bool blocking) override {}
+    bool tx_pending() override { return false; }
+
+    int16_t available() override { return count(); }
+    int16_t txspace() override { return 512; }
+    int16_t read() override {
+        if (_head == _tail) {
+            return -1;
+        }
+        uint8_t c = _buf[_head];
+        _head = (_head + 1) % sizeof(_buf);
+        return c;
+    }
+
+    uint16_t peek_span(const uint8_t *&data) override {
+        data = nullptr;
+        if (!_spans || _head == _tail) {
+            return 0;
+        }
+        data = &_buf[_head];
+        return _tail > _head ? _tail - _head : sizeof(_buf) - _head;
+    }
+    void consume(uint16_t len) override {
+        _head = (_head + len) % sizeof(_buf);
+    }
+    uint16_t rx_capacity() override { return _spans ? sizeof(_buf) - 1 : 0; }
+
+    size_t write(uint8_t c) override { return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { return size; }
+
+private:
+    bool _spans;
+    uint8_t _buf[200];
+    uint16_t _head;
+    uint16_t _tail;
+
+    uint16_t count(void) const { return (_tail + sizeof(_buf) - _head) % sizeof(_buf); }
+};
+
+/*
+  stream building helpers
+ */
+static void put_u8(std::vector<uint8_t> &v, uint8_t x) { v.push_back(x); }
+static void put_le16(std::vector<uint8_t> &v, uint16_t x) { put_u8(v, x & 0xFF); put_u8(v, x >> 8); }
+static void put_le32(std::vector<uint8_t> &v, uint32_t x) { put_le16(v, x & 0xFFFF); put_le16(v, x >> 16); }
+static void put_be32(std::vector<uint8_t> &v, uint32_t x) { put_le16(v, (x >> 24) | ((x >> 8) & 0xFF00)); put_le16(v, ((x >> 8) & 0xFF) | ((x & 0xFF) << 8)); }
+static void put_le_double(std::vector<uint8_t> &v, double d) { uint64_t x; memcpy(&x, &d, 8); put_le32(v, x & 0xFFFFFFFF); put_le32(v, x >> 32); }
+static void put_be_double(std::vector<uint8_t> &v, double d) { uint64_t x; memcpy(&x, &d, 8); put_be32(v, x >> 32); put_be32(v, x & 0xFFFFFFFF); }
+static void put_be_float(std::vector<uint8_t> &v, float f) { uint32_t x; memcpy(&x, &f, 4); put_be32(v, x); }
+
+static void add_noise(std::vector<uint8_t> &stream, uint16_t len, uint8_t seed)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        stream.push_back((uint8_t)(seed + i * 37));
+    }
+}
+
+static void add_ubx(std::vector<uint8_t> &stream, uint8_t msg_class, uint8_t msg_id, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> frame;
+    put_u8(frame, 0xB5);
+    put_u8(frame, 0x62);
+    put_u8(frame, msg_class);
+    put_u8(frame, msg_id);
+    put_le16(frame, payload.size());
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = 2; i < frame.size(); i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    put_u8(frame, ck_a);
+    put_u8(frame, ck_b);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+static void add_sbp(std::vector<uint8_t> &stream, uint16_t msg_type, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> frame;
+    put_u8(frame, 0x55);
+    put_le16(frame, msg_type);
+    put_le16(frame, 0x42);
+    put_u8(frame, payload.size());
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    put_le16(frame, crc16_ccitt(&frame[1], frame.size() - 1, 0));
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+static void add_gsof(std::vector<uint8_t> &stream, const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> frame;
+    put_u8(frame, 0x02);
+    put_u8(frame, 0x28);
+    put_u8(frame, 0x40);
+    put_u8(frame, data.size());
+    frame.insert(frame.end(), data.begin(), data.end());
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < frame.size(); i++) {
+        checksum += frame[i];
+    }
+    put_u8(frame, checksum);
+    put_u8(frame, 0x03);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+}
+
+/*
+  GPS_FrameReader on its own, with UBX framing
+ */
+static uint16_t ubx_length(const uint8_t *header)
+{
+    return 6 + (header[4] | (header[5] << 8)) + 2;
+}
+
+static bool ubx_check(const uint8_t *frame, uint16_t len)
+{
+    uint8_t ck_a = 0, ck_b = 0;
+    for (uint16_t i = 2; i < len - 2; i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    return frame[len-2] == ck_a && frame[len-1] == ck_b;
+}
+
+static const GPS_FrameReader::Protocol ubx_protocol = {
+    { 0xB5, 0x62 }, 2, 6, 128, ubx_length, ubx_check
+};
+
+static std::vector<uint8_t> ubx_payload(uint8_t n, uint8_t seed)
+{
+    std::vector<uint8_t> payload;
+    for (uint8_t i = 0; i < n; i++) {
+        // plenty of false preambles inside messages
+        payload.push_back(i % 5 == 0 ? 0xB5 : (uint8_t)(seed + i));
+    }
+    return payload;
+}
+
+class FrameReaderTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(FrameReaderTest, ReplayStream)
+{
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> expected_ids;
+
+    for (uint8_t i = 0; i < 60; i++) {
+        add_noise(stream, i % 7, i);
+        if (i % 11 == 3) {
+            // corrupt frame
+            add_ubx(stream, 1, 200, ubx_payload(i, i));
+            stream[stream.size() - 3] ^= 0x10;
+        }
+        if (i % 13 == 5) {
+            // too long for the reader
+            add_ubx(stream, 1, 201, ubx_payload(150, i));
+        }
+        add_ubx(stream, 1, i, ubx_payload(i, i));
+        expected_ids.push_back(i);
+    }
+
+    // replay in a range of block sizes, so frames split anywhere
+    for (size_t block = 1; block < 90; block += 7) {
+        ReplayUART uart(GetParam());
+        GPS_FrameReader reader(ubx_protocol);
+        std::vector<uint8_t> ids;
+        size_t ofs = 0;
+
+        while (ofs < stream.size()) {
+            uart.feed(stream, ofs, block);
+            const uint8_t *frame;
+            uint16_t len;
+            while (reader.next(&uart, frame, len)) {
+                ASSERT_EQ(ubx_length(frame), len);
+                ASSERT_TRUE(ubx_check(frame, len));
+                ASSERT_EQ(ubx_payload(frame[3], frame[3]), std::vector<uint8_t>(&frame[6], &frame[len-2]));
+                ids.push_back(frame[3]);
+            }
+        }
+
+        EXPECT_EQ(expected_ids, ids) << "block size " << block;
+        EXPECT_EQ(reader.get_frame_count(), expected_ids.size());
+        EXPECT_GE(reader.get_checksum_errors(), 6U);
+    }
+}
+
+// frames longer than the port's receive buffer, as UBX RXM-RAWX can be
+TEST_P(FrameReaderTest, LongerThanPort)
+{
+    static const GPS_FrameReader::Protocol long_protocol = {
+        { 0xB5, 0x62 }, 2, 6, 600, ubx_length, ubx_check
+    };
+    std::vector<uint8_t> stream;
+    const std::vector<uint8_t> expected_ids = { 0, 1, 2 };
+
+    // the first frame starts at the beginning of the receive buffer
+    add_ubx(stream, 1, 0, ubx_payload(250, 0));
+    add_ubx(stream, 1, 1, ubx_payload(20, 1));
+    add_ubx(stream, 1, 2, ubx_payload(250, 2));
+
+    for (size_t block = 1; block < 300; block += 37) {
+        ReplayUART uart(GetParam());
+        GPS_FrameReader reader(long_protocol);
+        std::vector<uint8_t> ids;
+        size_t ofs = 0;
+
+        // a reader waiting on a frame which can't arrive stops the
+        // stream, so give up after a while
+        for (uint16_t i = 0; i < 1000 && ofs < stream.size(); i++) {
+            uart.feed(stream, ofs, block);
+            const uint8_t *frame;
+            uint16_t len;
+            while (reader.next(&uart, frame, len)) {
+                ASSERT_EQ(ubx_length(frame), len);
+                ASSERT_TRUE(ubx_check(frame, len));
+                ids.push_back(frame[3]);
+            }
+        }
+
+        EXPECT_EQ(stream.size(), ofs) << "block size " << block;
+        EXPECT_EQ(expected_ids, ids) << "block size " << block;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(Ports, FrameReaderTest, ::testing::Values(true, false));
+
+/*
+  replay receiver streams through the drivers
+ */
+class GPSDriverTest : public ::testing::TestWithParam<bool> {
+protected:
+    GPSDriverTest() : state(), uart(GetParam()) {
+        // drivers are created directly rather than through init()
+        gps._DataFlash = nullptr;
+    }
+
+    // replay the stream in blocks, returning true if any read()
+    // reported a new fix
+    bool replay(AP_GPS_Backend &backend, std::vector<uint8_t> &stream, size_t block) {
+        bool updated = false;
+        size_t ofs = 0;
+        while (ofs < stream.size()) {
+            uart.feed(stream, ofs, block);
+            updated |= backend.read();
+        }
+        return updated;
+    }
+
+    AP_GPS gps;
+    AP_GPS::GPS_State state;
+    ReplayUART uart;
+};
+
+TEST_P(GPSDriverTest, UBLOX)
+{
+    std::vector<uint8_t> stream;
+    const uint32_t itow = 123456000;
+
+    add_noise(stream, 40, 0xB5);
+
+    std::vector<uint8_t> status;
+    put_le32(status, itow);
+    put_u8(status, 3);      // 3D fix
+    put_u8(status, 1);      // fix valid
+    put_u8(status, 0);
+    put_u8(status, 0);
+    put_le32(status, 0);
+    put_le32(status, 0);
+    add_ubx(stream, 0x01, 0x03, status);
+
+    std::vector<uint8_t> posllh;
+    put_le32(posllh, itow);
+    put_le32(posllh, 1491652300);
+    put_le32(posllh, -353632610);
+    put_le32(posllh, 600000);
+    put_le32(posllh, 584000);
+    put_le32(posllh, 1500);
+    put_le32(posllh, 2500);
+    add_ubx(stream, 0x01, 0x02, posllh);
+
+    add_noise(stream, 17, 0x62);
+
+    std::vector<uint8_t> velned;
+    put_le32(velned, itow);
+    put_le32(velned, 300);
+    put_le32(velned, -400);
+    put_le32(velned, 50);
+    put_le32(velned, 505);
+    put_le32(velned, 500);
+    put_le32(velned, 30000000);
+    put_le32(velned, 20);
+    put_le32(velned, 0);
+    add_ubx(stream, 0x01, 0x12, velned);
+
+    AP_GPS_UBLOX ublox(gps, state, &uart);
+    EXPECT_TRUE(replay(ublox, stream, 23));
+
+    EXPECT_EQ(AP_GPS::GPS_OK_FIX_3D, state.status);
+    EXPECT_EQ(-353632610, state.location.lat);
+    EXPECT_EQ(1491652300, state.location.lng);
+    EXPECT_EQ(58400, state.location.alt);
+    EXPECT_FLOAT_EQ(1.5f, state.horizontal_accuracy);
+    EXPECT_FLOAT_EQ(3.0f, state.velocity.x);
+    EXPECT_FLOAT_EQ(-4.0f, state.velocity.y);
+    EXPECT_FLOAT_EQ(0.5f, state.velocity.z);
+    EXPECT_FLOAT_EQ(5.0f, state.ground_speed);
+}
+
+TEST_P(GPSDriverTest, SBP)
+{
+    std::vector<uint8_t> stream;
+    const uint32_t tow = 345678000;
+
+    add_noise(stream, 30, 0x55);
+    add_sbp(stream, 0xFFFF, std::vector<uint8_t>(4, 0));
+
+    std::vector<uint8_t> gps_time;
+    put_le16(gps_time, 1890);
+    put_le32(gps_time, tow);
+    put_le32(gps_time, 0);
+    put_u8(gps_time, 0);
+    add_sbp(stream, 0x0100, gps_time);
+
+    std::vector<uint8_t> dops;
+    put_le32(dops, tow);
+    put_le16(dops, 200);
+    put_le16(dops, 180);
+    put_le16(dops, 100);
+    put_le16(dops, 120);
+    put_le16(dops, 150);
+    add_sbp(stream, 0x0206, dops);
+
+    add_noise(stream, 9, 0x55);
+
+    std::vector<uint8_t> pos_llh;
+    put_le32(pos_llh, tow);
+    put_le_double(pos_llh, -35.363261);
+    put_le_double(pos_llh, 149.165230);
+    put_le_double(pos_llh, 584.0);
+    put_le16(pos_llh, 20);
+    put_le16(pos_llh, 40);
+    put_u8(pos_llh, 14);
+    put_u8(pos_llh, 1);     // fixed RTK
+    add_sbp(stream, 0x0201, pos_llh);
+
+    std::vector<uint8_t> vel_ned;
+    put_le32(vel_ned, tow);
+    put_le32(vel_ned, 3000);
+    put_le32(vel_ned, 4000);
+    put_le32(vel_ned, -500);
+    put_le16(vel_ned, 0);
+    put_le16(vel_ned, 0);
+    put_u8(vel_ned, 14);
+    put_u8(vel_ned, 0);
+    add_sbp(stream, 0x0205, vel_ned);
+
+    AP_GPS_SBP sbp(gps, state, &uart);
+    EXPECT_TRUE(replay(sbp, stream, 31));
+
+    EXPECT_EQ(AP_GPS::GPS_OK_FIX_3D_RTK, state.status);
+    EXPECT_EQ(1890, state.time_week);
+    EXPECT_EQ(tow, state.time_week_ms);
+    EXPECT_EQ(14, state.num_sats);
+    EXPECT_EQ(120, state.hdop);
+    EXPECT_NEAR(-353632610, state.location.lat, 1);
+    EXPECT_NEAR(1491652300, state.location.lng, 1);
+    EXPECT_EQ(58400, state.location.alt);
+    EXPECT_FLOAT_EQ(5.0f, state.ground_speed);
+}
+
+TEST_P(GPSDriverTest, GSOF)
+{
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> data;
+
+    put_u8(data, 1);        // transmission number
+    put_u8(data, 0);        // page
+    put_u8(data, 0);        // last page
+
+    put_u8(data, 1);        // position time
+    put_u8(data, 10);
+    put_be32(data, 456789000);
+    put_u8(data, 1890 >> 8);
+    put_u8(data, 1890 & 0xFF);
+    put_u8(data, 12);
+    put_u8(data, 1);
+    put_u8(data, 1 | 4);    // RTK
+    put_u8(data, 0);
+
+    put_u8(data, 2);        // position
+    put_u8(data, 24);
+    put_be_double(data, -35.363261 * DEG_TO_RAD_DOUBLE);
+    put_be_double(data, 149.165230 * DEG_TO_RAD_DOUBLE);
+    put_be_double(data, 584.0);
+
+    put_u8(data, 8);        // velocity
+    put_u8(data, 13);
+    put_u8(data, 1);
+    put_be_float(data, 5.0f);
+    put_be_float(data, radians(90.0f));
+    put_be_float(data, 0.5f);
+
+    put_u8(data, 9);        // dops
+    put_u8(data, 16);
+    put_be_float(data, 1.8f);
+    put_be_float(data, 1.25f);
+    put_be_float(data, 1.5f);
+    put_be_float(data, 1.0f);
+
+    put_u8(data, 12);       // position sigma
+    put_u8(data, 38);
+    for (uint8_t i = 0; i < 9; i++) {
+        put_be_float(data, i * 0.01f);
+    }
+    put_u8(data, 0);
+    put_u8(data, 0);
+
+    add_noise(stream, 25, 0x02);
+    add_gsof(stream, data);
+
+    AP_GPS_GSOF gsof(gps, state, &uart);
+    EXPECT_TRUE(replay(gsof, stream, 17));
+
+    EXPECT_EQ(AP_GPS::GPS_OK_FIX_3D_RTK, state.status);
+    EXPECT_EQ(456789000U, state.time_week_ms);
+    EXPECT_EQ(1890, state.time_week);
+    EXPECT_EQ(12, state.num_sats);
+    EXPECT_NEAR(-353632610, state.location.lat, 2);
+    EXPECT_NEAR(1491652300, state.location.lng, 2);
+    EXPECT_EQ(58400, state.location.alt);
+    EXPECT_FLOAT_EQ(5.0f, state.ground_speed);
+    EXPECT_EQ(125, state.hdop);
+}
+
+INSTANTIATE_TEST_CASE_P(Ports, GPSDriverTest, ::testing::Values(true, false));
+
+AP_GTEST_MAIN()
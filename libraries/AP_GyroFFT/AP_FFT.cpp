@@ -0,0 +1,199 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_FFT.h"
+
+#include <stdlib.h>
+#include <AP_Math/AP_Math.h>
+
+AP_FFT::AP_FFT(void) :
+    _window_size(0),
+    _window(nullptr),
+    _cos(nullptr),
+    _sin(nullptr),
+    _split_cos(nullptr),
+    _split_sin(nullptr),
+    _bitrev(nullptr),
+    _re(nullptr),
+    _im(nullptr),
+    _power_scale(0)
+{
+}
+
+AP_FFT::~AP_FFT(void)
+{
+    _free();
+}
+
+void AP_FFT::_free(void)
+{
+    free(_window);
+    free(_cos);
+    free(_sin);
+    free(_split_cos);
+    free(_split_sin);
+    free(_bitrev);
+    free(_re);
+    free(_im);
+    _window = _cos = _sin = _split_cos = _split_sin = _re = _im = nullptr;
+    _bitrev = nullptr;
+    _window_size = 0;
+}
+
+bool AP_FFT::init(uint16_t window_size)
+{
+    if (window_size == _window_size) {
+        return true;
+    }
+    _free();
+
+    if (window_size < AP_FFT_MIN_WINDOW_SIZE || window_size > AP_FFT_MAX_WINDOW_SIZE ||
+        (window_size & (window_size - 1)) != 0) {
+        return false;
+    }
+
+    const uint16_t half = window_size / 2;
+
+    _window    = (float *)calloc(window_size, sizeof(float));
+    _cos       = (float *)calloc(half / 2, sizeof(float));
+    _sin       = (float *)calloc(half / 2, sizeof(float));
+    _split_cos = (float *)calloc(half, sizeof(float));
+    _split_sin = (float *)calloc(half, sizeof(float));
+    _bitrev    = (uint16_t *)calloc(half, sizeof(uint16_t));
+    _re        = (float *)calloc(half, sizeof(float));
+    _im        = (float *)calloc(half, sizeof(float));
+
+    if (_window == nullptr || _cos == nullptr || _sin == nullptr ||
+        _split_cos == nullptr || _split_sin == nullptr || _bitrev == nullptr ||
+        _re == nullptr || _im == nullptr) {
+        _free();
+        return false;
+    }
+
+    float window_sum = 0;
+    for (uint16_t i = 0; i < window_size; i++) {
+        _window[i] = 0.5f - 0.5f * cosf(2 * M_PI_F * i / window_size);
+        window_sum += _window[i];
+    }
+    // a sine of amplitude A peaks at A * sum(window) / 2 in its bin
+    _power_scale = 4.0f / (window_sum * window_sum);
+
+    for (uint16_t i = 0; i < half / 2; i++) {
+        _cos[i] = cosf(2 * M_PI_F * i / half);
+        _sin[i] = sinf(2 * M_PI_F * i / half);
+    }
+
+    for (uint16_t i = 0; i < half; i++) {
+        _split_cos[i] = cosf(2 * M_PI_F * i / window_size);
+        _split_sin[i] = sinf(2 * M_PI_F * i / window_size);
+    }
+
+    uint8_t bits = 0;
+    while ((1U << bits) < half) {
+        bits++;
+    }
+    for (uint16_t i = 0; i < half; i++) {
+        uint16_t r = 0;
+        for (uint8_t b = 0; b < bits; b++) {
+            if (i & (1U << b)) {
+                r |= 1U << (bits - 1 - b);
+            }
+        }
+        _bitrev[i] = r;
+    }
+
+    _window_size = window_size;
+    return true;
+}
+
+/*
+  in-place radix-2 decimation in time transform of _re/_im, which must
+  already be in bit reversed order
+ */
+void AP_FFT::_complex_fft(void)
+{
+    const uint16_t n = _window_size / 2;
+
+    for (uint16_t size = 2; size <= n; size <<= 1) {
+        const uint16_t span = size >> 1;
+        const uint16_t step = n / size;
+        for (uint16_t start = 0; start < n; start += size) {
+            float *re_a = &_re[start];
+            float *im_a = &_im[start];
+            float *re_b = &_re[start + span];
+            float *im_b = &_im[start + span];
+            for (uint16_t j = 0; j < span; j++) {
+                const float c = _cos[j * step];
+                const float s = _sin[j * step];
+                const float tr = c * re_b[j] + s * im_b[j];
+                const float ti = c * im_b[j] - s * re_b[j];
+                re_b[j] = re_a[j] - tr;
+                im_b[j] = im_a[j] - ti;
+                re_a[j] += tr;
+                im_a[j] += ti;
+            }
+        }
+    }
+}
+
+void AP_FFT::analyse(const float *samples, float *power)
+{
+    if (!initialised()) {
+        return;
+    }
+
+    const uint16_t half = _window_size / 2;
+
+    // pack even samples into the real part and odd samples into the
+    // imaginary part, writing straight into bit reversed order
+    for (uint16_t i = 0; i < half; i++) {
+        const uint16_t r = _bitrev[i];
+        _re[r] = samples[2*i]   * _window[2*i];
+        _im[r] = samples[2*i+1] * _window[2*i+1];
+    }
+
+    _complex_fft();
+
+    // DC and Nyquist only have real parts
+    const float dc = _re[0] + _im[0];
+    const float nyquist = _re[0] - _im[0];
+    power[0] = dc * dc * _power_scale * 0.25f;
+    power[half] = nyquist * nyquist * _power_scale * 0.25f;
+
+    // split the packed transform Z into the real spectrum X:
+    //   X[k] = E[k] + W^k O[k]
+    //   E[k] = (Z[k] + conj(Z[N/2-k])) / 2
+    //   O[k] = -i (Z[k] - conj(Z[N/2-k])) / 2
+    for (uint16_t k = 1; k < half; k++) {
+        const float a = _re[k];
+        const float b = _im[k];
+        const float c = _re[half - k];
+        const float d = _im[half - k];
+
+        const float er = 0.5f * (a + c);
+        const float ei = 0.5f * (b - d);
+        const float orr = 0.5f * (b + d);
+        const float oi = -0.5f * (a - c);
+
+        const float wr = _split_cos[k];
+        const float wi = -_split_sin[k];
+
+        const float xr = er + wr * orr - wi * oi;
+        const float xi = ei + wr * oi + wi * orr;
+
+        power[k] = (xr * xr + xi * xi) * _power_scale;
+    }
+}
@@ -0,0 +1,87 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Windowed real-input FFT producing a power spectrum.
+
+  The N real samples are packed into an N/2 point complex transform
+  which is then split into the N/2+1 bins of the real spectrum. All
+  twiddle factors, the bit reversal permutation and the window are
+  precomputed at init() so that the transform itself is straight loops
+  over separate real and imaginary arrays, which the compiler can
+  vectorise on targets that have SIMD units.
+ */
+
+#ifndef __AP_FFT_H__
+#define __AP_FFT_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+#define AP_FFT_MIN_WINDOW_SIZE 16
+#define AP_FFT_MAX_WINDOW_SIZE 1024
+
+class AP_FFT
+{
+public:
+    AP_FFT(void);
+    ~AP_FFT(void);
+
+    // allocate the tables for a window of window_size samples, which
+    // must be a power of two. Returns false on bad size or no memory
+    bool init(uint16_t window_size);
+
+    bool initialised(void) const { return _window_size != 0; }
+    uint16_t window_size(void) const { return _window_size; }
+
+    // number of bins in the power spectrum, DC to Nyquist inclusive
+    uint16_t num_bins(void) const { return _window_size / 2 + 1; }
+
+    /*
+      apply the window to window_size samples and transform them. The
+      power in each bin is written to power[0 .. num_bins()-1]. Powers
+      are scaled so that a full scale sine of amplitude A gives a peak
+      of about A^2 regardless of the window size
+     */
+    void analyse(const float *samples, float *power);
+
+private:
+    uint16_t _window_size;
+
+    // hann window coefficients, window_size entries
+    float *_window;
+
+    // twiddles for the window_size/2 point complex transform
+    float *_cos;
+    float *_sin;
+
+    // twiddles for splitting the packed spectrum, window_size/2 entries
+    float *_split_cos;
+    float *_split_sin;
+
+    // bit reversal permutation, window_size/2 entries
+    uint16_t *_bitrev;
+
+    // complex working buffer, window_size/2 entries each
+    float *_re;
+    float *_im;
+
+    float _power_scale;
+
+    void _free(void);
+    void _complex_fft(void);
+};
+
+#endif // __AP_FFT_H__
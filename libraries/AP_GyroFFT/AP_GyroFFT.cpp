@@ -0,0 +1,331 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_GyroFFT.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+extern const AP_HAL::HAL& hal;
+
+// results older than this are not used for filter tuning
+#define GYROFFT_HEALTH_TIMEOUT_MS 1000
+
+// table of user settable parameters
+const AP_Param::GroupInfo AP_GyroFFT::var_info[] = {
+    // @Param: ENABLE
+    // @DisplayName: Enable gyro spectral analysis
+    // @Description: Enable onboard FFT analysis of the primary gyro. Requires a reboot to take effect
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("ENABLE", 0, AP_GyroFFT, _enable, 0),
+
+    // @Param: MINHZ
+    // @DisplayName: Minimum analysed frequency
+    // @Description: Lower bound of the frequency range searched for vibration peaks
+    // @Range: 10 400
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("MINHZ", 1, AP_GyroFFT, _min_hz, 50),
+
+    // @Param: MAXHZ
+    // @DisplayName: Maximum analysed frequency
+    // @Description: Upper bound of the frequency range searched for vibration peaks. Limited to the Nyquist frequency of the analysis rate
+    // @Range: 20 1000
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("MAXHZ", 2, AP_GyroFFT, _max_hz, 450),
+
+    // @Param: WINSIZE
+    // @DisplayName: FFT window size
+    // @Description: Number of samples in each analysis window. Larger windows give finer frequency resolution at the cost of memory, CPU and latency. Requires a reboot to take effect
+    // @Values: 32:32,64:64,128:128,256:256,512:512
+    // @User: Advanced
+    AP_GROUPINFO("WINSIZE", 3, AP_GyroFFT, _window_size, 128),
+
+    // @Param: RATE
+    // @DisplayName: FFT analysis sample rate
+    // @Description: Rate the raw gyro samples are decimated to before analysis. The achieved rate is the raw sensor rate divided by a whole number. Requires a reboot to take effect
+    // @Range: 100 2000
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("RATE", 4, AP_GyroFFT, _rate_hz, 1000),
+
+    // @Param: SNR
+    // @DisplayName: Peak detection threshold
+    // @Description: Ratio of the peak bin power to the mean power in the analysed range needed for a peak to be reported as valid
+    // @Range: 2 50
+    // @User: Advanced
+    AP_GROUPINFO("SNR", 5, AP_GyroFFT, _snr_threshold, 10.0f),
+
+    AP_GROUPEND
+};
+
+AP_GyroFFT::AP_GyroFFT(AP_InertialSensor &ins) :
+    _ins(ins),
+    _initialised(false),
+    _instance(0),
+    _sample_index(0),
+    _decimation(1),
+    _decimation_count(0),
+    _sample_rate_hz(0),
+    _ring_head(0),
+    _ring_fill(0),
+    _new_samples(0),
+    _power(nullptr),
+    _analysis_pending(false),
+    _analysis_axis(0),
+    _output_index(0)
+{
+    AP_Param::setup_object_defaults(this, var_info);
+
+    memset(_ring, 0, sizeof(_ring));
+    memset(_analysis_samples, 0, sizeof(_analysis_samples));
+    memset(_output, 0, sizeof(_output));
+}
+
+void AP_GyroFFT::init(void)
+{
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    if (_enable == 0 || _initialised) {
+        return;
+    }
+
+    _instance = _ins.get_primary_gyro();
+    const uint16_t raw_rate_hz = _ins.get_gyro_raw_sample_rate(_instance);
+    if (raw_rate_hz == 0 || _rate_hz <= 0) {
+        return;
+    }
+
+    _decimation = MAX(raw_rate_hz / _rate_hz, 1);
+    _sample_rate_hz = (float)raw_rate_hz / _decimation;
+
+    if (!_fft.init(_window_size)) {
+        hal.console->printf("GyroFFT: bad window size %d\n", (int)_window_size);
+        return;
+    }
+
+    const uint16_t n = _fft.window_size();
+    for (uint8_t i = 0; i < 3; i++) {
+        _ring[i] = (float *)calloc(n, sizeof(float));
+        _analysis_samples[i] = (float *)calloc(n, sizeof(float));
+        if (_ring[i] == nullptr || _analysis_samples[i] == nullptr) {
+            hal.console->printf("GyroFFT: out of memory\n");
+            return;
+        }
+    }
+    _power = (float *)calloc(_fft.num_bins(), sizeof(float));
+    if (_power == nullptr) {
+        hal.console->printf("GyroFFT: out of memory\n");
+        return;
+    }
+
+    _initialised = true;
+
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_GyroFFT::_io_timer, void));
+#endif
+}
+
+void AP_GyroFFT::update(void)
+{
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    if (!enabled()) {
+        return;
+    }
+
+    const uint8_t primary = _ins.get_primary_gyro();
+    if (primary != _instance) {
+        // the IO thread works at the old sample rate, so wait for it
+        // to finish before switching
+        if (__atomic_load_n(&_analysis_pending, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+        const uint16_t raw_rate_hz = _ins.get_gyro_raw_sample_rate(primary);
+        if (raw_rate_hz == 0) {
+            return;
+        }
+        // start again with the new gyro. Its raw buffer has its own
+        // sample count, and an index of zero makes the INS skip to
+        // the oldest sample it still holds
+        _instance = primary;
+        _sample_index = 0;
+        _decimation = MAX(raw_rate_hz / _rate_hz, 1);
+        _sample_rate_hz = (float)raw_rate_hz / _decimation;
+        _decimation_count = 0;
+        _decimation_sum.zero();
+        _ring_fill = 0;
+        _new_samples = 0;
+    }
+
+    Vector3f samples[INS_RAW_SAMPLE_BUFFER_SIZE];
+    uint16_t n = _ins.get_raw_gyro_samples(_instance, _sample_index, samples, INS_RAW_SAMPLE_BUFFER_SIZE);
+
+    for (uint16_t i = 0; i < n; i++) {
+        _decimation_sum += samples[i];
+        if (++_decimation_count < _decimation) {
+            continue;
+        }
+        _push_sample(_decimation_sum / _decimation);
+        _decimation_sum.zero();
+        _decimation_count = 0;
+    }
+
+    // windows overlap by half
+    if (_ring_fill == _fft.window_size() && _new_samples >= _fft.window_size() / 2 &&
+        !__atomic_load_n(&_analysis_pending, __ATOMIC_ACQUIRE)) {
+        _start_analysis();
+    }
+#endif
+}
+
+void AP_GyroFFT::_push_sample(const Vector3f &sample)
+{
+    const uint16_t n = _fft.window_size();
+
+    _ring[0][_ring_head] = sample.x;
+    _ring[1][_ring_head] = sample.y;
+    _ring[2][_ring_head] = sample.z;
+    _ring_head = (_ring_head + 1) & (n - 1);
+
+    if (_ring_fill < n) {
+        _ring_fill++;
+    }
+    if (_new_samples < n) {
+        _new_samples++;
+    }
+}
+
+/*
+  copy the ring into time order for the IO thread
+ */
+void AP_GyroFFT::_start_analysis(void)
+{
+    const uint16_t n = _fft.window_size();
+    const uint16_t older = n - _ring_head;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        memcpy(_analysis_samples[i], &_ring[i][_ring_head], older * sizeof(float));
+        memcpy(&_analysis_samples[i][older], _ring[i], _ring_head * sizeof(float));
+    }
+
+    _new_samples = 0;
+    _analysis_axis = 0;
+    __atomic_store_n(&_analysis_pending, true, __ATOMIC_RELEASE);
+}
+
+void AP_GyroFFT::_io_timer(void)
+{
+    if (!__atomic_load_n(&_analysis_pending, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    // only this thread changes the index
+    const uint8_t index = _output_index;
+    Output &out = _output[index ^ 1];
+
+    _analyse_axis(out.axis[_analysis_axis], _analysis_samples[_analysis_axis]);
+
+    if (++_analysis_axis < 3) {
+        return;
+    }
+
+    out.last_update_ms = AP_HAL::millis();
+    out.update_count = _output[index].update_count + 1;
+    // publish the new output before the main thread may start the
+    // next analysis into the old one
+    __atomic_store_n(&_output_index, index ^ 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&_analysis_pending, false, __ATOMIC_RELEASE);
+}
+
+void AP_GyroFFT::_analyse_axis(Axis &result, const float *samples)
+{
+    _fft.analyse(samples, _power);
+
+    const uint16_t num_bins = _fft.num_bins();
+    const float bin_hz = _sample_rate_hz / _fft.window_size();
+    const float max_hz = MIN((float)_max_hz, _sample_rate_hz * 0.5f);
+
+    uint16_t start_bin = MAX((uint16_t)(_min_hz / bin_hz), 1);
+    uint16_t end_bin = MIN((uint16_t)(max_hz / bin_hz), num_bins - 1);
+    if (end_bin <= start_bin) {
+        memset(&result, 0, sizeof(result));
+        return;
+    }
+
+    uint16_t peak_bin = start_bin;
+    float total = 0;
+    memset(result.band_energy, 0, sizeof(result.band_energy));
+    const float band_width = (float)(end_bin - start_bin + 1) / GYROFFT_NUM_BANDS;
+
+    for (uint16_t k = start_bin; k <= end_bin; k++) {
+        total += _power[k];
+        if (_power[k] > _power[peak_bin]) {
+            peak_bin = k;
+        }
+        uint8_t band = MIN((uint8_t)((k - start_bin) / band_width), GYROFFT_NUM_BANDS - 1);
+        result.band_energy[band] += _power[k];
+    }
+
+    // parabolic interpolation on the bin magnitudes either side of the
+    // peak to get below the bin resolution
+    float offset = 0;
+    if (peak_bin > 0 && peak_bin < num_bins - 1) {
+        const float m0 = sqrtf(_power[peak_bin - 1]);
+        const float m1 = sqrtf(_power[peak_bin]);
+        const float m2 = sqrtf(_power[peak_bin + 1]);
+        const float denom = m0 - 2 * m1 + m2;
+        if (!is_zero(denom)) {
+            offset = constrain_float(0.5f * (m0 - m2) / denom, -0.5f, 0.5f);
+        }
+    }
+
+    const float mean = total / (end_bin - start_bin + 1);
+
+    result.peak_freq_hz = (peak_bin + offset) * bin_hz;
+    result.peak_energy = _power[peak_bin];
+    result.total_energy = total;
+    result.valid = mean > 0 && _power[peak_bin] >= _snr_threshold * mean;
+}
+
+bool AP_GyroFFT::healthy(void) const
+{
+    if (!enabled()) {
+        return false;
+    }
+    const Output &out = _latest_output();
+    if (out.update_count == 0 || AP_HAL::millis() - out.last_update_ms > GYROFFT_HEALTH_TIMEOUT_MS) {
+        return false;
+    }
+    return out.axis[0].valid || out.axis[1].valid;
+}
+
+float AP_GyroFFT::get_weighted_peak_freq_hz(void) const
+{
+    const Output &out = _latest_output();
+    float weighted_freq = 0;
+    float weight = 0;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (out.axis[i].valid) {
+            weighted_freq += out.axis[i].peak_freq_hz * out.axis[i].peak_energy;
+            weight += out.axis[i].peak_energy;
+        }
+    }
+    if (weight <= 0.0f) {
+        return 0;
+    }
+    return weighted_freq / weight;
+}
@@ -0,0 +1,145 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Onboard spectral analysis of the primary gyro.
+
+  Raw gyro samples are collected from the main loop, decimated to the
+  analysis rate and handed over a window at a time to the IO thread,
+  which runs the FFT one axis per call so the main loop never pays for
+  the transform. Results are double buffered so the main loop always
+  sees a complete set of axes.
+ */
+
+#ifndef __AP_GYROFFT_H__
+#define __AP_GYROFFT_H__
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include "AP_FFT.h"
+
+// number of equal width energy bands between FFT_MINHZ and FFT_MAXHZ
+#define GYROFFT_NUM_BANDS 4
+
+class AP_GyroFFT
+{
+public:
+    AP_GyroFFT(AP_InertialSensor &ins);
+
+    // analysis results for one gyro axis
+    struct Axis {
+        float peak_freq_hz;               // interpolated frequency of the strongest bin
+        float peak_energy;                // power in the strongest bin
+        float total_energy;               // power between FFT_MINHZ and FFT_MAXHZ
+        float band_energy[GYROFFT_NUM_BANDS];
+        bool valid;                       // peak stands out from the noise floor
+    };
+
+    static const struct AP_Param::GroupInfo var_info[];
+
+    // allocate buffers and start the analysis thread. Must be called
+    // after the INS has been initialised
+    void init(void);
+
+    // collect new gyro samples. Should be called from the main loop
+    // at the INS loop rate
+    void update(void);
+
+    bool enabled(void) const { return _enable != 0 && _initialised; }
+
+    // true if a recent analysis found a clear peak on roll or pitch
+    bool healthy(void) const;
+
+    const Axis &get_axis(uint8_t axis) const { return _latest_output().axis[axis]; }
+    uint32_t get_last_update_ms(void) const { return _latest_output().last_update_ms; }
+
+    // incremented every time a full set of axes is published
+    uint32_t get_update_count(void) const { return _latest_output().update_count; }
+
+    /*
+      frequency of the dominant vibration, taken as the energy weighted
+      average of the roll and pitch peaks. Returns zero when no axis has
+      a clear peak
+     */
+    float get_weighted_peak_freq_hz(void) const;
+
+    float get_sample_rate_hz(void) const { return _sample_rate_hz; }
+
+private:
+    AP_InertialSensor &_ins;
+
+    // parameters
+    AP_Int8  _enable;
+    AP_Int16 _min_hz;
+    AP_Int16 _max_hz;
+    AP_Int16 _window_size;
+    AP_Int16 _rate_hz;
+    AP_Float _snr_threshold;
+
+    bool _initialised;
+    AP_FFT _fft;
+
+    // gyro instance being analysed and our position in its raw buffer
+    uint8_t _instance;
+    uint32_t _sample_index;
+
+    // decimation of raw samples to _sample_rate_hz
+    uint16_t _decimation;
+    uint16_t _decimation_count;
+    Vector3f _decimation_sum;
+    float _sample_rate_hz;
+
+    // most recent window_size decimated samples per axis
+    float *_ring[3];
+    uint16_t _ring_head;
+    uint16_t _ring_fill;
+    uint16_t _new_samples;
+
+    // window handed to the IO thread, and the IO thread's work
+    // space. The pending flag passes ownership of the window between
+    // the threads, so it is set with release and read with acquire
+    float *_analysis_samples[3];
+    float *_power;
+    bool _analysis_pending;
+    uint8_t _analysis_axis;
+
+    struct Output {
+        Axis axis[3];
+        uint32_t last_update_ms;
+        uint32_t update_count;
+    } _output[2];
+    uint8_t _output_index;
+
+    /*
+      the IO thread fills the other output and then publishes it by
+      flipping the index. It only writes into an output again after
+      the main thread has started the next analysis, so an output
+      read on the main thread stays complete until the next update()
+     */
+    const Output &_latest_output(void) const {
+        return _output[__atomic_load_n(&_output_index, __ATOMIC_ACQUIRE)];
+    }
+
+    void _push_sample(const Vector3f &sample);
+    void _start_analysis(void);
+    void _analyse_axis(Axis &result, const float *samples);
+    void _io_timer(void);
+};
+
+#endif // __AP_GYROFFT_H__
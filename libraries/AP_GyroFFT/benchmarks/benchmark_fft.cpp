@@ -0,0 +1,26 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_GyroFFT/AP_FFT.h>
+#include <AP_Math/AP_Math.h>
+
+static void BM_FFTAnalyse(benchmark::State& state)
+{
+    const uint16_t window_size = state.range_x();
+    float samples[AP_FFT_MAX_WINDOW_SIZE];
+    float power[AP_FFT_MAX_WINDOW_SIZE / 2 + 1];
+    AP_FFT fft;
+
+    fft.init(window_size);
+    for (uint16_t i = 0; i < window_size; i++) {
+        samples[i] = sinf(2 * M_PI_F * 13 * i / window_size) + 0.1f * cosf(2 * M_PI_F * 40 * i / window_size);
+    }
+
+    while (state.KeepRunning()) {
+        fft.analyse(samples, power);
+        gbenchmark_escape(power);
+    }
+}
+
+BENCHMARK(BM_FFTAnalyse)->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+
+BENCHMARK_MAIN()
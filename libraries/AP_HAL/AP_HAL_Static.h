@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+  static binding of the HAL drivers called from the main loop.
+
+  Calls through hal.rcout and hal.scheduler go through the AP_HAL
+  interfaces, so each one is an indirect call the compiler can't see
+  through. A board which knows its drivers at build time can name them
+  as HAL_STATIC_RCOUTPUT and HAL_STATIC_SCHEDULER. When the build sets
+  HAL_STATIC_BINDING (waf configure --static-hal), HAL_RCOUT and
+  HAL_SCHEDULER then give pointers to those final classes, and the
+  calls become direct calls. Otherwise they are plain hal.rcout and
+  hal.scheduler.
+
+  Files using these macros need the usual extern declaration of hal.
+ */
+
+#include "AP_HAL.h"
+
+#ifndef HAL_STATIC_BINDING
+#define HAL_STATIC_BINDING 0
+#endif
+
+#if HAL_STATIC_BINDING && CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#include <AP_HAL_Linux/HAL_Linux_Static.h>
+#endif
+
+#if HAL_STATIC_BINDING && defined(HAL_STATIC_RCOUTPUT)
+#define HAL_RCOUT (static_cast<HAL_STATIC_RCOUTPUT *>(hal.rcout))
+#else
+#define HAL_RCOUT (hal.rcout)
+#endif
+
+#if HAL_STATIC_BINDING && defined(HAL_STATIC_SCHEDULER)
+#define HAL_SCHEDULER (static_cast<HAL_STATIC_SCHEDULER *>(hal.scheduler))
+#else
+#define HAL_SCHEDULER (hal.scheduler)
+#endif
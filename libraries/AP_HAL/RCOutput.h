@@ -103,6 +103,27 @@ public:
       will be used to convert channel writes into a percentage
      */
     virtual void     set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm) {}
+
+    /*
+      output protocol of a channel. The DShot modes send each write as
+      a digital frame to the ESC instead of a pulse, scaled by
+      set_esc_scaling()
+     */
+    enum output_mode {
+        MODE_PWM_NORMAL = 0,
+        MODE_DSHOT150   = 1,
+        MODE_DSHOT300   = 2,
+        MODE_DSHOT600   = 3,
+    };
+
+    /*
+      set the output mode of a group of channels. Returns false if the
+      board can't output the mode on those channels, in which case they
+      are left as they were. Boards only support normal PWM by default
+     */
+    virtual bool     set_output_mode(uint32_t chmask, enum output_mode mode) {
+        return mode == MODE_PWM_NORMAL;
+    }
 };
 
 #endif // __AP_HAL_RC_OUTPUT_H__
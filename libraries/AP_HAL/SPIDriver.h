@@ -22,6 +22,32 @@ public:
     virtual AP_HAL::Semaphore* get_semaphore() = 0;
     virtual bool transaction(const uint8_t *tx, uint8_t *rx, uint16_t len) = 0;
 
+    /*
+      one chip-selected transfer within a multi-transfer request. Either
+      of tx or rx may be NULL
+     */
+    struct Transfer {
+        const uint8_t *tx;
+        uint8_t *rx;
+        uint16_t len;
+    };
+
+    /**
+       optional transactions() interface. Performs several transfers,
+       each with its own chip select cycle, in order. Backends which can
+       submit all transfers to the bus in one request (e.g. a single
+       SPI_IOC_MESSAGE ioctl on Linux) should override this; the default
+       issues one transaction() per transfer.
+     */
+    virtual bool transactions(const Transfer *transfers, uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (!transaction(transfers[i].tx, transfers[i].rx, transfers[i].len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     virtual void cs_assert() = 0;
     virtual void cs_release() = 0;
     virtual uint8_t transfer (uint8_t data) = 0;
@@ -40,6 +40,14 @@ public:
     // register a low priority IO task
     virtual void     register_io_process(AP_HAL::MemberProc) = 0;
 
+    /*
+      optionally run a rate loop on its own realtime thread, woken at
+      about rate_hz as new IMU samples are read. Returns false if the
+      board has no rate thread, in which case the caller keeps running
+      it from its main loop. Must be called before system_initialized()
+     */
+    virtual bool     register_rate_process(AP_HAL::MemberProc, uint16_t rate_hz) { return false; }
+
     // suspend and resume both timer and IO processes
     virtual void     suspend_timer_procs() = 0;
     virtual void     resume_timer_procs() = 0;
@@ -58,6 +66,29 @@ public:
        optional function to stop clock at a given time, used by log replay
      */
     virtual void     stop_clock(uint64_t time_usec) {}
+
+    /*
+      called when motor outputs have been written, so boards that
+      measure it can track the latency from the main loop waking for
+      an IMU sample to its outputs
+     */
+    virtual void     outputs_written() {}
+
+    // scheduling latency of one thread, or of the sample to output path
+    struct latency_stats {
+        const char *name;
+        const char *tag;        // short upper case name, at most 5 characters
+        uint32_t count;
+        uint32_t late_max_us;
+        uint32_t late_p99_us;
+        uint32_t run_max_us;
+        uint32_t run_p99_us;
+        uint32_t missed;
+        uint32_t preempted;
+    };
+
+    // get the index'th set of latency stats, false past the last one
+    virtual bool     get_latency_stats(uint8_t index, latency_stats &stats) { return false; }
 };
 
 #endif // __AP_HAL_SCHEDULER_H__
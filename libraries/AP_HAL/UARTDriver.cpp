@@ -37,3 +37,16 @@ void AP_HAL::UARTDriver::vprintf(const char *fmt, va_list ap)
 {
     print_vprintf(this, fmt, ap);
 }
+
+uint16_t AP_HAL::UARTDriver::read_bytes(uint8_t *buf, uint16_t len)
+{
+    uint16_t n = 0;
+    while (n < len) {
+        int16_t c = read();
+        if (c < 0) {
+            break;
+        }
+        buf[n++] = (uint8_t)c;
+    }
+    return n;
+}
@@ -47,6 +47,29 @@ public:
     virtual void set_flow_control(enum flow_control flow_control_setting) {};
     virtual enum flow_control get_flow_control(void) { return FLOW_CONTROL_DISABLE; };
 
+    /*
+      zero copy receive. Point data at the oldest received bytes and
+      return how many of them are contiguous in the receive buffer,
+      which may be fewer than available() when the buffer wraps. The
+      bytes stay valid until consume() is called. Drivers without a
+      contiguous receive buffer return zero
+     */
+    virtual uint16_t peek_span(const uint8_t *&data) { data = nullptr; return 0; }
+
+    // discard len bytes previously returned by peek_span()
+    virtual void consume(uint16_t len) {}
+
+    // most bytes the receive buffer behind peek_span() can hold, zero
+    // without span support
+    virtual uint16_t rx_capacity() { return 0; }
+
+    /*
+      bulk receive. Copy up to len received bytes into buf, returning
+      the number copied. The default implementation reads a byte at a
+      time
+     */
+    virtual uint16_t read_bytes(uint8_t *buf, uint16_t len);
+
     /* Implementations of BetterStream virtual methods. These are
      * provided by AP_HAL to ensure consistency between ports to
      * different boards
@@ -90,6 +90,39 @@ public:
     virtual void perf_end(perf_counter_t h) {}
     virtual void perf_count(perf_counter_t h) {}
 
+    // summary of one perf counter, times in microseconds
+    struct perf_stats {
+        const char *name;
+        perf_counter_type type;
+        uint64_t count;
+        uint64_t total_us;
+        uint32_t max_us;
+    };
+
+    // get the stats of the index'th counter, false past the last one
+    virtual bool perf_get_stats(uint16_t index, perf_stats &stats) { return false; }
+
+    // write a trace of recent perf_begin()/perf_end() calls, if supported
+    virtual bool perf_dump_trace(const char *path) { return false; }
+
+    /*
+      time the rest of the enclosing scope with an elapsed perf
+      counter. Scopes on the same thread nest, so a profiler that
+      traces can show which counters each one spent its time in
+     */
+    class PerfScope {
+    public:
+        PerfScope(Util *util, perf_counter_t h) : _util(util), _h(h) {
+            _util->perf_begin(_h);
+        }
+        ~PerfScope() {
+            _util->perf_end(_h);
+        }
+    private:
+        Util *_util;
+        perf_counter_t _h;
+    };
+
     // create a new semaphore
     virtual Semaphore *new_semaphore(void) { return nullptr; }
     
@@ -100,5 +133,11 @@ protected:
     uint64_t capabilities = 0;
 };
 
+#define PERF_SCOPE_NAME2(a, b) a ## b
+#define PERF_SCOPE_NAME(line) PERF_SCOPE_NAME2(_perf_scope_, line)
+
+// time the rest of the current scope with perf counter h
+#define PERF_SCOPE(h) AP_HAL::Util::PerfScope PERF_SCOPE_NAME(__LINE__)(hal.util, h)
+
 #endif // __AP_HAL_UTIL_H__
 
@@ -0,0 +1,90 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+#define NUM_MOTORS 8
+
+/*
+  an RCOutput driver which only keeps the last writes. Its methods are
+  kept out of line, as the board drivers are in their own translation
+  units, so the benchmarks compare an indirect call with a direct one
+ */
+class BenchRCOutput final : public AP_HAL::RCOutput {
+public:
+    void init() override {}
+    void set_freq(uint32_t chmask, uint16_t freq_hz) override {}
+    uint16_t get_freq(uint8_t ch) override { return 50; }
+    void enable_ch(uint8_t ch) override {}
+    void disable_ch(uint8_t ch) override {}
+    void write(uint8_t ch, uint16_t period_us) override;
+    void cork() override;
+    void push() override;
+    uint16_t read(uint8_t ch) override { return _period[ch]; }
+    void read(uint16_t *period_us, uint8_t len) override {}
+
+private:
+    uint16_t _period[NUM_MOTORS];
+    bool _corked;
+    uint32_t _pushes;
+};
+
+__attribute__((noinline)) void BenchRCOutput::write(uint8_t ch, uint16_t period_us)
+{
+    _period[ch] = period_us;
+}
+
+__attribute__((noinline)) void BenchRCOutput::cork()
+{
+    _corked = true;
+}
+
+__attribute__((noinline)) void BenchRCOutput::push()
+{
+    _corked = false;
+    _pushes++;
+}
+
+// one pass of AP_MotorsMulticopter::output() with eight motors
+template <typename T>
+static void output_motors(T *rcout, const uint16_t *pwm)
+{
+    rcout->cork();
+    for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+        rcout->write(i, pwm[i]);
+    }
+    rcout->push();
+}
+
+static const uint16_t motor_pwm[NUM_MOTORS] = {
+    1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800
+};
+
+// through the AP_HAL interface, as hal.rcout
+static void BM_RCOutputVirtual(benchmark::State& state)
+{
+    BenchRCOutput driver;
+    AP_HAL::RCOutput *rcout = &driver;
+
+    while (state.KeepRunning()) {
+        // hide the driver's type, as it is hidden behind hal.rcout
+        gbenchmark_escape(&rcout);
+        output_motors(rcout, motor_pwm);
+    }
+}
+
+// through the final driver class, as HAL_RCOUT with HAL_STATIC_BINDING
+static void BM_RCOutputStatic(benchmark::State& state)
+{
+    BenchRCOutput driver;
+    AP_HAL::RCOutput *rcout = &driver;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&rcout);
+        output_motors(static_cast<BenchRCOutput *>(rcout), motor_pwm);
+    }
+}
+
+BENCHMARK(BM_RCOutputVirtual);
+BENCHMARK(BM_RCOutputStatic);
+
+BENCHMARK_MAIN()
@@ -0,0 +1,140 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/DShot.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const AP_HAL::RCOutput::output_mode dshot_modes[] = {
+    AP_HAL::RCOutput::MODE_DSHOT150,
+    AP_HAL::RCOutput::MODE_DSHOT300,
+    AP_HAL::RCOutput::MODE_DSHOT600,
+};
+
+// clocks of the PRU and the ZYNQ PWM core, and the SITL loopback
+static const uint32_t tick_rates[] = { 200000000, 100000000, 1000000000 };
+
+TEST(DShot, Packet)
+{
+    EXPECT_EQ(0x82C6, DShot::packet(1046, false));
+
+    for (uint16_t value = 0; value <= DShot::THROTTLE_MAX; value++) {
+        for (uint8_t telem = 0; telem < 2; telem++) {
+            const uint16_t packet = DShot::packet(value, telem);
+            uint16_t decoded;
+            bool decoded_telem;
+            ASSERT_TRUE(DShot::decode_packet(packet, decoded, decoded_telem));
+            EXPECT_EQ(value, decoded);
+            EXPECT_EQ(telem != 0, decoded_telem);
+
+            // any single bit error is caught by the checksum
+            for (uint8_t bit = 0; bit < DShot::FRAME_BITS; bit++) {
+                EXPECT_FALSE(DShot::decode_packet(packet ^ (1U << bit), decoded, decoded_telem));
+            }
+        }
+    }
+}
+
+TEST(DShot, Timing)
+{
+    DShot::timing t;
+
+    ASSERT_TRUE(DShot::get_timing(AP_HAL::RCOutput::MODE_DSHOT150, 200000000, t));
+    EXPECT_EQ(1333U, t.bit_ticks);
+    EXPECT_EQ(500U, t.t0h_ticks);
+    EXPECT_EQ(1000U, t.t1h_ticks);
+
+    ASSERT_TRUE(DShot::get_timing(AP_HAL::RCOutput::MODE_DSHOT600, 100000000, t));
+    EXPECT_EQ(166U, t.bit_ticks);
+    EXPECT_EQ(62U, t.t0h_ticks);
+    EXPECT_EQ(125U, t.t1h_ticks);
+
+    EXPECT_FALSE(DShot::get_timing(AP_HAL::RCOutput::MODE_PWM_NORMAL, 200000000, t));
+    EXPECT_FALSE(DShot::get_timing(AP_HAL::RCOutput::MODE_DSHOT600, 1000000, t));
+}
+
+TEST(DShot, Bitstream)
+{
+    for (uint32_t tick_hz : tick_rates) {
+        for (AP_HAL::RCOutput::output_mode mode : dshot_modes) {
+            DShot::timing t;
+            ASSERT_TRUE(DShot::get_timing(mode, tick_hz, t));
+
+            uint32_t period[DShot::FRAME_BITS];
+            for (uint8_t i = 0; i < DShot::FRAME_BITS; i++) {
+                period[i] = t.bit_ticks;
+            }
+
+            for (uint16_t value = 0; value <= DShot::THROTTLE_MAX; value += 7) {
+                const uint16_t packet = DShot::packet(value, value % 3 == 0);
+                uint32_t high[DShot::FRAME_BITS];
+                DShot::encode(packet, t, high);
+
+                // bits are high for 3/8 or 3/4 of the bit
+                for (uint8_t i = 0; i < DShot::FRAME_BITS; i++) {
+                    const bool one = packet & (0x8000 >> i);
+                    EXPECT_NEAR(one ? 0.75 : 0.375, high[i] / (double)t.bit_ticks, 0.01);
+                }
+
+                uint16_t decoded = 0;
+                ASSERT_TRUE(DShot::decode(high, period, t, decoded));
+                EXPECT_EQ(packet, decoded);
+
+                // edges that are a little late or early still decode
+                uint32_t jittered[DShot::FRAME_BITS];
+                uint32_t jittered_period[DShot::FRAME_BITS];
+                for (uint8_t i = 0; i < DShot::FRAME_BITS; i++) {
+                    const int32_t jitter = (i % 2 ? 1 : -1) * (int32_t)(t.bit_ticks / 20);
+                    jittered[i] = high[i] + jitter;
+                    jittered_period[i] = period[i] - jitter;
+                }
+                ASSERT_TRUE(DShot::decode(jittered, jittered_period, t, decoded));
+                EXPECT_EQ(packet, decoded);
+            }
+        }
+    }
+}
+
+TEST(DShot, BadTiming)
+{
+    DShot::timing t;
+    ASSERT_TRUE(DShot::get_timing(AP_HAL::RCOutput::MODE_DSHOT300, 200000000, t));
+
+    uint32_t high[DShot::FRAME_BITS];
+    uint32_t period[DShot::FRAME_BITS];
+    uint16_t decoded;
+    DShot::encode(DShot::packet(1000, false), t, high);
+
+    for (uint8_t bad = 0; bad < DShot::FRAME_BITS; bad++) {
+        for (uint8_t i = 0; i < DShot::FRAME_BITS; i++) {
+            period[i] = t.bit_ticks;
+        }
+
+        // a pulse between a 0 and a 1
+        uint32_t saved = high[bad];
+        high[bad] = (t.t0h_ticks + t.t1h_ticks) / 2;
+        EXPECT_FALSE(DShot::decode(high, period, t, decoded));
+        high[bad] = saved;
+
+        // a bit of the wrong length
+        period[bad] = t.bit_ticks * 5 / 4;
+        EXPECT_FALSE(DShot::decode(high, period, t, decoded));
+    }
+}
+
+TEST(DShot, Scaling)
+{
+    EXPECT_EQ(0, DShot::pwm_to_value(1000, 1000, 2000));
+    EXPECT_EQ(0, DShot::pwm_to_value(900, 1000, 2000));
+    EXPECT_EQ(DShot::THROTTLE_MAX, DShot::pwm_to_value(2000, 1000, 2000));
+    EXPECT_EQ(DShot::THROTTLE_MAX, DShot::pwm_to_value(2100, 1000, 2000));
+    EXPECT_EQ(1048, DShot::pwm_to_value(1500, 1000, 2000));
+    EXPECT_GE(DShot::pwm_to_value(1001, 1000, 2000), DShot::THROTTLE_MIN);
+
+    for (uint16_t pwm = 1100; pwm <= 1900; pwm++) {
+        const uint16_t value = DShot::pwm_to_value(pwm, 1100, 1900);
+        EXPECT_EQ(pwm, DShot::value_to_pwm(value, 1100, 1900));
+    }
+}
+
+AP_GTEST_MAIN()
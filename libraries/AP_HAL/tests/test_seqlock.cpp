@@ -0,0 +1,90 @@
+#include <AP_gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/SeqLock.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// every field holds the same value, so a torn copy is easy to spot
+struct Sample {
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+};
+
+TEST(SeqLock, Empty)
+{
+    SeqLock<Sample> lock;
+    Sample s = { 7, 7, 7, 7 };
+
+    EXPECT_FALSE(lock.read(s));
+    EXPECT_EQ(7U, s.a);
+    EXPECT_EQ(0U, lock.count());
+}
+
+TEST(SeqLock, Latest)
+{
+    SeqLock<Sample> lock;
+    Sample s;
+
+    for (uint32_t i = 1; i <= 10; i++) {
+        const Sample w = { i, i, i, i };
+        lock.write(w);
+    }
+    EXPECT_TRUE(lock.read(s));
+    EXPECT_EQ(10U, s.a);
+    EXPECT_EQ(10U, s.d);
+    EXPECT_EQ(10U, lock.count());
+}
+
+static SeqLock<Sample> shared;
+static volatile bool writer_done;
+
+static void *writer(void *arg)
+{
+    for (uint32_t i = 1; i <= 1000000; i++) {
+        const Sample w = { i, i, i, i };
+        shared.write(w);
+        // let the reader in between writes when both share a CPU
+        if ((i & 0x3ff) == 0) {
+            sched_yield();
+        }
+    }
+    writer_done = true;
+    return NULL;
+}
+
+TEST(SeqLock, Threads)
+{
+    pthread_t ctx;
+    uint32_t reads = 0;
+    uint32_t last = 0;
+
+    writer_done = false;
+    ASSERT_EQ(0, pthread_create(&ctx, NULL, writer, NULL));
+    while (!writer_done) {
+        Sample s;
+        if (!shared.read(s)) {
+            continue;
+        }
+        ASSERT_EQ(s.a, s.b);
+        ASSERT_EQ(s.a, s.c);
+        ASSERT_EQ(s.a, s.d);
+        ASSERT_GE(s.a, last);
+        last = s.a;
+        reads++;
+    }
+    pthread_join(ctx, NULL);
+
+    EXPECT_GT(reads, 0U);
+    EXPECT_EQ(1000000U, shared.count());
+    Sample s;
+    EXPECT_TRUE(shared.read(s));
+    EXPECT_EQ(1000000U, s.a);
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,127 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DShot.h"
+
+const uint16_t DShot::THROTTLE_MIN;
+const uint16_t DShot::THROTTLE_MAX;
+const uint8_t DShot::FRAME_BITS;
+
+static inline uint32_t ticks_apart(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+bool DShot::get_timing(AP_HAL::RCOutput::output_mode mode, uint32_t tick_hz, timing &t)
+{
+    uint32_t bitrate;
+    switch (mode) {
+    case AP_HAL::RCOutput::MODE_DSHOT150:
+        bitrate = 150000;
+        break;
+    case AP_HAL::RCOutput::MODE_DSHOT300:
+        bitrate = 300000;
+        break;
+    case AP_HAL::RCOutput::MODE_DSHOT600:
+        bitrate = 600000;
+        break;
+    default:
+        return false;
+    }
+
+    // the decoder needs at least a tick of tolerance
+    if (tick_hz / bitrate < 10) {
+        return false;
+    }
+
+    t.bit_ticks = tick_hz / bitrate;
+    t.t0h_ticks = (uint64_t)tick_hz * 3 / (8 * bitrate);
+    t.t1h_ticks = (uint64_t)tick_hz * 3 / (4 * bitrate);
+    return true;
+}
+
+uint16_t DShot::pwm_to_value(uint16_t pwm, uint16_t min_pwm, uint16_t max_pwm)
+{
+    if (pwm <= min_pwm || max_pwm <= min_pwm) {
+        return 0;
+    }
+    if (pwm >= max_pwm) {
+        return THROTTLE_MAX;
+    }
+    const uint32_t range = max_pwm - min_pwm;
+    return THROTTLE_MIN +
+        ((uint32_t)(pwm - min_pwm) * (THROTTLE_MAX - THROTTLE_MIN) + range / 2) / range;
+}
+
+uint16_t DShot::value_to_pwm(uint16_t value, uint16_t min_pwm, uint16_t max_pwm)
+{
+    if (value < THROTTLE_MIN || max_pwm <= min_pwm) {
+        return min_pwm;
+    }
+    if (value > THROTTLE_MAX) {
+        value = THROTTLE_MAX;
+    }
+    const uint32_t range = max_pwm - min_pwm;
+    const uint32_t steps = THROTTLE_MAX - THROTTLE_MIN;
+    return min_pwm + ((uint32_t)(value - THROTTLE_MIN) * range + steps / 2) / steps;
+}
+
+uint16_t DShot::packet(uint16_t value, bool telem)
+{
+    const uint16_t data = ((value & 0x7FF) << 1) | (telem ? 1 : 0);
+    const uint16_t csum = (data ^ (data >> 4) ^ (data >> 8)) & 0xF;
+    return (data << 4) | csum;
+}
+
+bool DShot::decode_packet(uint16_t packet, uint16_t &value, bool &telem)
+{
+    const uint16_t data = packet >> 4;
+    if (((data ^ (data >> 4) ^ (data >> 8)) & 0xF) != (packet & 0xF)) {
+        return false;
+    }
+    value = data >> 1;
+    telem = data & 1;
+    return true;
+}
+
+void DShot::encode(uint16_t packet, const timing &t, uint32_t high_ticks[FRAME_BITS])
+{
+    for (uint8_t i = 0; i < FRAME_BITS; i++) {
+        const bool one = packet & (1U << (FRAME_BITS - 1 - i));
+        high_ticks[i] = one ? t.t1h_ticks : t.t0h_ticks;
+    }
+}
+
+bool DShot::decode(const uint32_t high_ticks[FRAME_BITS],
+                   const uint32_t period_ticks[FRAME_BITS],
+                   const timing &t, uint16_t &packet)
+{
+    const uint32_t high_tolerance = t.bit_ticks / 8;
+    const uint32_t period_tolerance = t.bit_ticks / 10;
+
+    uint16_t p = 0;
+    for (uint8_t i = 0; i < FRAME_BITS; i++) {
+        if (ticks_apart(period_ticks[i], t.bit_ticks) > period_tolerance) {
+            return false;
+        }
+        p <<= 1;
+        if (ticks_apart(high_ticks[i], t.t1h_ticks) <= high_tolerance) {
+            p |= 1;
+        } else if (ticks_apart(high_ticks[i], t.t0h_ticks) > high_tolerance) {
+            return false;
+        }
+    }
+    packet = p;
+    return true;
+}
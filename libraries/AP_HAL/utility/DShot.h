@@ -0,0 +1,74 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  DShot digital ESC protocol, for the RCOutput backends that generate
+  it and for checking what they generate.
+
+  A frame is 16 bits sent most significant bit first: an 11 bit
+  throttle value, a telemetry request bit and a 4 bit checksum. Every
+  bit starts with a rising edge and lasts the same time. A 0 bit is
+  high for 3/8 of it and a 1 bit for 3/4 of it. The bit rate is 150,
+  300 or 600 kbit/s, so a frame takes 107, 53 or 27us.
+ */
+#ifndef __AP_HAL_UTILITY_DSHOT_H__
+#define __AP_HAL_UTILITY_DSHOT_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+class DShot
+{
+public:
+    // 0 stops the motor, 1 to 47 are commands to the ESC
+    static const uint16_t THROTTLE_MIN = 48;
+    static const uint16_t THROTTLE_MAX = 2047;
+    static const uint8_t FRAME_BITS = 16;
+
+    // bit timing in ticks of the clock generating or measuring it
+    struct timing {
+        uint32_t bit_ticks;
+        uint32_t t0h_ticks;
+        uint32_t t1h_ticks;
+    };
+
+    /*
+      timing of a DShot mode for a clock running at tick_hz. Returns
+      false if mode isn't DShot or the clock is too slow for it
+     */
+    static bool get_timing(AP_HAL::RCOutput::output_mode mode, uint32_t tick_hz, timing &t);
+
+    // throttle value for a PWM width, 0 at or below min_pwm
+    static uint16_t pwm_to_value(uint16_t pwm, uint16_t min_pwm, uint16_t max_pwm);
+    static uint16_t value_to_pwm(uint16_t value, uint16_t min_pwm, uint16_t max_pwm);
+
+    static uint16_t packet(uint16_t value, bool telem);
+
+    // returns false if the checksum is wrong
+    static bool decode_packet(uint16_t packet, uint16_t &value, bool &telem);
+
+    // high time of each bit of a frame, in the order they are sent
+    static void encode(uint16_t packet, const timing &t, uint32_t high_ticks[FRAME_BITS]);
+
+    /*
+      packet of a received frame, from the high time of each bit and the
+      time from its rising edge to the next. Returns false if any bit is
+      out of tolerance, which is 1/8 of a bit for the high times and
+      1/10 of a bit for the bit period
+     */
+    static bool decode(const uint32_t high_ticks[FRAME_BITS],
+                       const uint32_t period_ticks[FRAME_BITS],
+                       const timing &t, uint16_t &packet);
+};
+
+#endif // __AP_HAL_UTILITY_DSHOT_H__
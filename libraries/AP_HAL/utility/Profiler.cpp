@@ -0,0 +1,265 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+
+// state of the calling thread, created on its first perf_begin()
+static __thread void *_current_thread;
+
+// the profiler being traced, for the exit and signal handlers
+static Profiler *_traced;
+static volatile sig_atomic_t _dump_requested;
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+Profiler::Profiler(void) :
+    _num_counters(0),
+    _threads(NULL),
+    _tracing(false),
+    _trace_path(NULL)
+{
+    memset(_counters, 0, sizeof(_counters));
+    pthread_mutex_init(&_lock, NULL);
+}
+
+Profiler::perf_counter_t Profiler::alloc(perf_counter_type type, const char *name)
+{
+    if (type == AP_HAL::Util::PC_INTERVAL) {
+        // not used by any caller, as on the old Linux implementation
+        return NULL;
+    }
+
+    pthread_mutex_lock(&_lock);
+    counter *c = NULL;
+    if (_num_counters < PROFILER_MAX_COUNTERS) {
+        c = &_counters[_num_counters++];
+        c->name = name;
+        c->type = type;
+    }
+    pthread_mutex_unlock(&_lock);
+    return (perf_counter_t)c;
+}
+
+Profiler::thread_state *Profiler::_thread(void)
+{
+    thread_state *t = (thread_state *)_current_thread;
+    if (t != NULL) {
+        return t;
+    }
+
+    t = (thread_state *)calloc(1, sizeof(thread_state));
+    if (t == NULL) {
+        return NULL;
+    }
+#ifdef SYS_gettid
+    t->tid = syscall(SYS_gettid);
+#else
+    t->tid = getpid();
+#endif
+
+    pthread_mutex_lock(&_lock);
+    t->next = _threads;
+    _threads = t;
+    pthread_mutex_unlock(&_lock);
+
+    _current_thread = t;
+    return t;
+}
+
+void Profiler::_trace(thread_state *t, uint64_t now, const counter *c, bool begin)
+{
+    if (t->events == NULL) {
+        t->events = (event *)calloc(PROFILER_TRACE_EVENTS, sizeof(event));
+        if (t->events == NULL) {
+            return;
+        }
+    }
+    event &e = t->events[t->head % PROFILER_TRACE_EVENTS];
+    e.time_ns = now;
+    e.counter = c - _counters;
+    e.begin = begin;
+    // publish the event after it is complete
+    __atomic_store_n(&t->head, t->head + 1, __ATOMIC_RELEASE);
+}
+
+void Profiler::begin(perf_counter_t h)
+{
+    counter *c = (counter *)h;
+    if (c == NULL || c->type != AP_HAL::Util::PC_ELAPSED) {
+        return;
+    }
+    thread_state *t = _thread();
+    if (t == NULL || t->depth == PROFILER_MAX_DEPTH) {
+        return;
+    }
+
+    const uint64_t now = now_ns();
+    t->stack[t->depth].c = c;
+    t->stack[t->depth].start_ns = now;
+    t->depth++;
+
+    if (_tracing) {
+        _trace(t, now, c, true);
+    }
+}
+
+void Profiler::end(perf_counter_t h)
+{
+    counter *c = (counter *)h;
+    if (c == NULL || c->type != AP_HAL::Util::PC_ELAPSED) {
+        return;
+    }
+    thread_state *t = (thread_state *)_current_thread;
+    if (t == NULL) {
+        return;
+    }
+
+    // find the matching begin, closing anything left open inside it
+    int8_t i = t->depth - 1;
+    while (i >= 0 && t->stack[i].c != c) {
+        i--;
+    }
+    if (i < 0) {
+        return;
+    }
+
+    const uint64_t now = now_ns();
+    const uint64_t elapsed = now - t->stack[i].start_ns;
+    t->depth = i;
+
+    // counters can be shared between threads
+    __atomic_add_fetch(&c->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->total_ns, elapsed, __ATOMIC_RELAXED);
+    uint64_t max_ns = __atomic_load_n(&c->max_ns, __ATOMIC_RELAXED);
+    while (elapsed > max_ns &&
+           !__atomic_compare_exchange_n(&c->max_ns, &max_ns, elapsed, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    if (_tracing) {
+        _trace(t, now, c, false);
+    }
+}
+
+void Profiler::count(perf_counter_t h)
+{
+    counter *c = (counter *)h;
+    if (c == NULL || c->type != AP_HAL::Util::PC_COUNT) {
+        return;
+    }
+    __atomic_add_fetch(&c->count, 1, __ATOMIC_RELAXED);
+}
+
+bool Profiler::get_stats(uint16_t index, AP_HAL::Util::perf_stats &stats)
+{
+    if (index >= __atomic_load_n(&_num_counters, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    const counter &c = _counters[index];
+    stats.name = c.name;
+    stats.type = c.type;
+    stats.count = __atomic_load_n(&c.count, __ATOMIC_RELAXED);
+    stats.total_us = __atomic_load_n(&c.total_ns, __ATOMIC_RELAXED) / 1000;
+    stats.max_us = __atomic_load_n(&c.max_ns, __ATOMIC_RELAXED) / 1000;
+    return true;
+}
+
+void Profiler::enable_trace(const char *path)
+{
+    if (_traced != NULL) {
+        return;
+    }
+    _trace_path = path;
+    _tracing = true;
+    _traced = this;
+    atexit(_at_exit);
+    signal(SIGUSR1, _sigusr1);
+}
+
+void Profiler::_at_exit(void)
+{
+    _traced->dump_trace(_traced->_trace_path);
+}
+
+void Profiler::_sigusr1(int signum)
+{
+    _dump_requested = 1;
+}
+
+void Profiler::poll(void)
+{
+    if (_dump_requested && _traced == this) {
+        _dump_requested = 0;
+        dump_trace(_trace_path);
+    }
+}
+
+/*
+  write the events held for each thread. A thread that keeps running
+  while this is written may overwrite the oldest of its events, which
+  can leave an unmatched end at the start of its trace
+ */
+bool Profiler::dump_trace(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+
+    const pid_t pid = getpid();
+    bool first = true;
+    fprintf(f, "{\"traceEvents\":[\n");
+
+    pthread_mutex_lock(&_lock);
+    for (thread_state *t = _threads; t != NULL; t = t->next) {
+        if (t->events == NULL) {
+            continue;
+        }
+        const uint32_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+        const uint32_t start = head > PROFILER_TRACE_EVENTS ? head - PROFILER_TRACE_EVENTS : 0;
+        for (uint32_t i = start; i < head; i++) {
+            const event &e = t->events[i % PROFILER_TRACE_EVENTS];
+            fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    first ? "" : ",\n",
+                    _counters[e.counter].name,
+                    e.begin ? 'B' : 'E',
+                    e.time_ns * 1.0e-3,
+                    (int)pid, (int)t->tid);
+            first = false;
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    return true;
+}
+
+#endif // CONFIG_HAL_BOARD
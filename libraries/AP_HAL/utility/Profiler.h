@@ -0,0 +1,112 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  perf counter implementation for boards running on an OS with
+  pthreads, used by the Linux and SITL HALs
+
+  Each thread keeps its own stack of open perf_begin() calls, so the
+  same counter can be used from several threads and nested counters
+  time correctly. When tracing is enabled every begin and end is also
+  recorded into a per-thread ring of events, written only by its own
+  thread, which can be dumped as Chrome trace JSON for chrome://tracing
+  or Perfetto. A dump is written at exit and whenever the process
+  receives SIGUSR1.
+ */
+#ifndef __AP_HAL_UTILITY_PROFILER_H__
+#define __AP_HAL_UTILITY_PROFILER_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <pthread.h>
+#include <sys/types.h>
+
+#define PROFILER_MAX_COUNTERS 128
+#define PROFILER_MAX_DEPTH     16
+#define PROFILER_TRACE_EVENTS  16384
+
+class Profiler
+{
+public:
+    typedef AP_HAL::Util::perf_counter_t perf_counter_t;
+    typedef AP_HAL::Util::perf_counter_type perf_counter_type;
+
+    Profiler(void);
+
+    perf_counter_t alloc(perf_counter_type type, const char *name);
+    void begin(perf_counter_t h);
+    void end(perf_counter_t h);
+    void count(perf_counter_t h);
+
+    bool get_stats(uint16_t index, AP_HAL::Util::perf_stats &stats);
+
+    // start recording trace events, dumped to path at exit and on SIGUSR1
+    void enable_trace(const char *path);
+    bool dump_trace(const char *path);
+
+    // write a dump requested by SIGUSR1. Called from an IO thread
+    void poll(void);
+
+private:
+    struct counter {
+        const char *name;
+        perf_counter_type type;
+        uint64_t count;
+        uint64_t total_ns;
+        uint64_t max_ns;
+    };
+
+    struct event {
+        uint64_t time_ns;
+        uint16_t counter;
+        bool begin;
+    };
+
+    struct thread_state {
+        pid_t tid;
+        struct {
+            counter *c;
+            uint64_t start_ns;
+        } stack[PROFILER_MAX_DEPTH];
+        uint8_t depth;
+
+        // trace ring, written only by this thread
+        event *events;
+        uint32_t head;
+
+        thread_state *next;
+    };
+
+    counter _counters[PROFILER_MAX_COUNTERS];
+    uint16_t _num_counters;
+
+    // list of every thread that has used a counter
+    thread_state *_threads;
+    pthread_mutex_t _lock;
+
+    bool _tracing;
+    const char *_trace_path;
+
+    thread_state *_thread(void);
+    void _trace(thread_state *t, uint64_t now, const counter *c, bool begin);
+
+    static void _at_exit(void);
+    static void _sigusr1(int signum);
+};
+
+#endif // CONFIG_HAL_BOARD
+
+#endif // __AP_HAL_UTILITY_PROFILER_H__
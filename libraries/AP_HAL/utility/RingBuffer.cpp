@@ -2,6 +2,43 @@
 #include <stdlib.h>
 #include <string.h>
 
+uint16_t ringbuf_peek_span(const uint8_t *buf, uint16_t size, uint16_t head, uint16_t tail,
+                           const uint8_t *&data)
+{
+    if (buf == nullptr || head == tail) {
+        data = nullptr;
+        return 0;
+    }
+    data = &buf[head];
+    if (tail > head) {
+        return tail - head;
+    }
+    return size - head;
+}
+
+/*
+  at most two copies, as the tail is only read once
+ */
+uint16_t ringbuf_read(const uint8_t *buf, uint16_t size, volatile uint16_t &head, uint16_t tail,
+                      uint8_t *out, uint16_t len)
+{
+    uint16_t n = 0;
+    while (n < len) {
+        const uint8_t *data;
+        uint16_t span = ringbuf_peek_span(buf, size, head, tail, data);
+        if (span == 0) {
+            break;
+        }
+        if (span > len - n) {
+            span = len - n;
+        }
+        memcpy(&out[n], data, span);
+        head = (head + span) % size;
+        n += span;
+    }
+    return n;
+}
+
 /*
   implement a simple ringbuffer of bytes
  */
@@ -22,6 +22,20 @@
 #define BUF_ADVANCETAIL(buf, n) buf##_tail = (buf##_tail + n) % buf##_size
 #define BUF_ADVANCEHEAD(buf, n) buf##_head = (buf##_head + n) % buf##_size
 
+/*
+  bulk reads from an old style ring buffer, for the thread which
+  advances the head. BUF_PEEK_SPAN points data at the oldest bytes and
+  gives how many of them are contiguous. BUF_READ copies up to len bytes
+  out, advancing the head past them
+ */
+#define BUF_PEEK_SPAN(buf, data) ringbuf_peek_span(buf, buf##_size, buf##_head, buf##_tail, data)
+#define BUF_READ(buf, out, len) ringbuf_read(buf, buf##_size, buf##_head, buf##_tail, out, len)
+
+uint16_t ringbuf_peek_span(const uint8_t *buf, uint16_t size, uint16_t head, uint16_t tail,
+                           const uint8_t *&data);
+uint16_t ringbuf_read(const uint8_t *buf, uint16_t size, volatile uint16_t &head, uint16_t tail,
+                      uint8_t *out, uint16_t len);
+
 
 /*
   new style buffers
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+// times a reader retries a copy that overlapped a write before giving up
+#define SEQLOCK_READ_TRIES 4
+
+/*
+  lock-free handoff of the latest value of a small object from a single
+  writer thread to any number of reader threads. The writer never
+  waits. A reader copies the value and tries again if a write overlapped
+  the copy.
+
+  A reader that has preempted the writer part way through a write, such
+  as a higher priority thread on the same CPU, would spin forever, so
+  read() gives up after SEQLOCK_READ_TRIES and the caller keeps the
+  value it had
+ */
+template <class T>
+class SeqLock {
+public:
+    SeqLock() : _seq(0), _value() {}
+
+    void write(const T &value)
+    {
+        const uint32_t seq = __atomic_load_n(&_seq, __ATOMIC_RELAXED);
+
+        // the sequence is odd while the value is being written
+        __atomic_store_n(&_seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        _value = value;
+        __atomic_store_n(&_seq, seq + 2, __ATOMIC_RELEASE);
+    }
+
+    // copy the latest value. Returns false if nothing has been written
+    // yet or no consistent copy could be made
+    bool read(T &value) const
+    {
+        for (uint8_t i = 0; i < SEQLOCK_READ_TRIES; i++) {
+            const uint32_t seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+            if (seq & 1) {
+                continue;
+            }
+            const T copy = _value;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&_seq, __ATOMIC_RELAXED) == seq) {
+                if (seq == 0) {
+                    return false;
+                }
+                value = copy;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // number of values written so far
+    uint32_t count() const { return __atomic_load_n(&_seq, __ATOMIC_ACQUIRE) / 2; }
+
+private:
+    uint32_t _seq;
+    T _value;
+};
@@ -63,6 +63,9 @@ public:
     // listen has been used. A new socket is returned
     SocketAPM *accept(uint32_t timeout_ms);
 
+    // file descriptor, for use with poll() and epoll
+    int get_read_fd(void) const { return fd; }
+
 private:
     bool datagram;
     struct sockaddr_in in_addr {};
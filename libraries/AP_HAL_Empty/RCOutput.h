@@ -5,6 +5,7 @@
 #include "AP_HAL_Empty.h"
 
 class Empty::RCOutput : public AP_HAL::RCOutput {
+public:
     void     init();
     void     set_freq(uint32_t chmask, uint16_t freq_hz);
     uint16_t get_freq(uint8_t ch);
@@ -39,8 +39,11 @@ namespace Linux {
     class RCOutput_Bebop;
     class RCOutput_Sysfs;
     class RCOutput_QFLIGHT;
+    template <class Driver> class RCOutput_Locked;
     class Semaphore;
     class Scheduler;
+    class LatencyTracker;
+    class Poller;
     class Util;
     class UtilRPI;
     class ToneAlarm;
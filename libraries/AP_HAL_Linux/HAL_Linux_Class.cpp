@@ -5,11 +5,13 @@
 
 #include "HAL_Linux_Class.h"
 #include "AP_HAL_Linux_Private.h"
+#include "HAL_Linux_Static.h"
 
 #include <AP_HAL/utility/getopt_cpp.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <type_traits>
 
 #include <AP_HAL_Empty/AP_HAL_Empty.h>
 #include <AP_HAL_Empty/AP_HAL_Empty_Private.h>
@@ -173,8 +175,19 @@ static RCOutput_QFLIGHT rcoutDriver;
 static Empty::RCOutput rcoutDriver;
 #endif
 
+// the main loop and the rate thread both write to the outputs
+static RCOutput_Locked<decltype(rcoutDriver)> rcoutLocked(rcoutDriver);
+
 static Scheduler schedulerInstance;
 
+// AP_HAL_Static.h binds calls to these types when HAL_STATIC_BINDING is set
+#ifdef HAL_STATIC_RCOUTPUT
+static_assert(std::is_same<decltype(rcoutLocked), HAL_STATIC_RCOUTPUT>::value,
+              "HAL_STATIC_RCOUTPUT must be the type of rcoutLocked");
+#endif
+static_assert(std::is_same<decltype(schedulerInstance), HAL_STATIC_SCHEDULER>::value,
+              "HAL_STATIC_SCHEDULER must be the type of schedulerInstance");
+
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
 static OpticalFlow_Onboard opticalFlow;
 #else
@@ -207,7 +220,7 @@ HAL_Linux::HAL_Linux() :
         &uartADriver,
         &gpioDriver,
         &rcinDriver,
-        &rcoutDriver,
+        &rcoutLocked,
         &schedulerInstance,
         &utilInstance,
         &opticalFlow)
@@ -222,12 +235,21 @@ void _usage(void)
     printf("\t-tcp:             -C tcp:192.168.2.15:1243:wait\n");
     printf("\t                  -A tcp:11.0.0.2:5678\n");    
     printf("\t                  -A udp:11.0.0.2:5678\n");    
+    printf("\t-many clients:    -C tcp:0.0.0.0:5760 serves up to 4 TCP clients\n");
+    printf("\t                  -C udp:0.0.0.0:14550:multi sends to every UDP peer\n");
     printf("\t-custom log path:\n");        
     printf("\t                  --log-directory /var/APM/logs\n");
     printf("\t                  -l /var/APM/logs\n");
     printf("\t-custom terrain path:\n");
     printf("\t                   --terrain-directory /var/APM/terrain\n");
     printf("\t                   -t /var/APM/terrain\n");
+    printf("\t-perf counter trace, written at exit and on SIGUSR1:\n");
+    printf("\t                   --perf-trace /tmp/trace.json\n");
+    printf("\t-thread CPUs and realtime priority, as name:cpus[:priority]\n");
+    printf("\t for main, timer, uart, rcin, tonealarm, io (which writes logs)\n");
+    printf("\t and rate (the vehicle rate loop, if enabled):\n");
+    printf("\t                   --thread main:2 --thread timer:3:15\n");
+    printf("\t                   -T io:0-1:10\n");
 }
 
 void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
@@ -247,11 +269,13 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
 #endif
         {"log-directory",       true,  0, 'l'},
         {"terrain-directory",   true,  0, 't'},
+        {"perf-trace",          true,  0, 'p'},
+        {"thread",              true,  0, 'T'},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:l:t:he:S",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:l:t:p:T:he:S",
                     options);
 
     /*
@@ -288,6 +312,15 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         case 't':
             utilInstance.set_custom_terrain_directory(gopt.optarg);
             break;
+        case 'p':
+            utilInstance.perf_enable_trace(gopt.optarg);
+            break;
+        case 'T':
+            if (!schedulerInstance.set_thread_option(gopt.optarg)) {
+                printf("Invalid thread option '%s'\n", gopt.optarg);
+                exit(1);
+            }
+            break;
         case 'h':
             _usage();
             exit(0);
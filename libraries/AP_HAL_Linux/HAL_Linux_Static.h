@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+  the RCOutput and Scheduler drivers HAL_Linux_Class.cpp creates for
+  this board, for AP_HAL/AP_HAL_Static.h. HAL_Linux_Class.cpp checks
+  its drivers are of these types, so the two can't drift apart
+ */
+
+#include "AP_HAL_Linux.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_PXF || CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_ERLEBOARD
+#include "RCOutput_PRU.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_PRU
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BBBMINI
+#include "RCOutput_AioPRU.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_AioPRU
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_NAVIO || CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_ERLEBRAIN2 || \
+      CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_PXFMINI || CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BH || \
+      CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_MINLURE
+#include "RCOutput_PCA9685.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_PCA9685
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_RASPILOT
+#include "RCOutput_Raspilot.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_Raspilot
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_ZYNQ
+#include "RCOutput_ZYNQ.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_ZYNQ
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
+#include "RCOutput_Bebop.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_Bebop
+#elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_QFLIGHT
+#include "RCOutput_qflight.h"
+#define HAL_STATIC_RCOUTPUT_DRIVER Linux::RCOutput_QFLIGHT
+#endif
+// other boards use Empty::RCOutput, which stays behind the interface
+
+#ifdef HAL_STATIC_RCOUTPUT_DRIVER
+#include "RCOutput_Locked.h"
+#define HAL_STATIC_RCOUTPUT Linux::RCOutput_Locked<HAL_STATIC_RCOUTPUT_DRIVER>
+#endif
+
+#include "Scheduler.h"
+#define HAL_STATIC_SCHEDULER Linux::Scheduler
+
+#endif // CONFIG_HAL_BOARD
@@ -0,0 +1,125 @@
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <string.h>
+#include <sys/resource.h>
+
+#include "LatencyTracker.h"
+
+using namespace Linux;
+
+LatencyTracker::LatencyTracker(const char *name, const char *tag) :
+    _name(name),
+    _tag(tag),
+    _count(0),
+    _late_max_us(0),
+    _run_max_us(0),
+    _missed(0),
+    _wake_us(0),
+    _preempted(0),
+    _last_nivcsw(-1),
+    _last_rusage_us(0)
+{
+    memset(_late, 0, sizeof(_late));
+    memset(_run, 0, sizeof(_run));
+}
+
+void LatencyTracker::_add(uint32_t *hist, uint32_t &max, uint32_t value_us)
+{
+    uint8_t bucket = 0;
+    uint32_t v = value_us >> 1;
+    while (v != 0 && bucket < LATENCY_BUCKETS-1) {
+        v >>= 1;
+        bucket++;
+    }
+    hist[bucket]++;
+    if (value_us > max) {
+        max = value_us;
+    }
+}
+
+void LatencyTracker::wakeup(uint64_t expected_us, uint64_t now_us)
+{
+    _add(_late, _late_max_us, now_us > expected_us ? now_us - expected_us : 0);
+    _count++;
+    _wake_us = now_us;
+    _update_preempted(now_us);
+}
+
+void LatencyTracker::woken(uint64_t now_us)
+{
+    _wake_us = now_us;
+    _update_preempted(now_us);
+}
+
+void LatencyTracker::done(uint64_t now_us)
+{
+    if (_wake_us != 0) {
+        _add(_run, _run_max_us, now_us - _wake_us);
+        _wake_us = 0;
+    }
+}
+
+void LatencyTracker::sample(uint32_t latency_us)
+{
+    _add(_late, _late_max_us, latency_us);
+    _count++;
+}
+
+/*
+  count the involuntary context switches of the calling thread, which
+  are the times it was preempted
+ */
+void LatencyTracker::_update_preempted(uint64_t now_us)
+{
+    if (now_us - _last_rusage_us < 1000000) {
+        return;
+    }
+    _last_rusage_us = now_us;
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return;
+    }
+    if (_last_nivcsw >= 0) {
+        _preempted += usage.ru_nivcsw - _last_nivcsw;
+    }
+    _last_nivcsw = usage.ru_nivcsw;
+}
+
+// upper bound of the bucket holding the pct'th percentile
+uint32_t LatencyTracker::_percentile(const uint32_t *hist, uint8_t pct)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const uint64_t target = ((uint64_t)total * pct + 99) / 100;
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+        sum += hist[i];
+        if (sum >= target) {
+            return 2U << i;
+        }
+    }
+    return 2U << (LATENCY_BUCKETS-1);
+}
+
+void LatencyTracker::get_stats(AP_HAL::Scheduler::latency_stats &stats) const
+{
+    stats.name = _name;
+    stats.tag = _tag;
+    stats.count = _count;
+    stats.late_max_us = _late_max_us;
+    stats.late_p99_us = _percentile(_late, 99);
+    stats.run_max_us = _run_max_us;
+    stats.run_p99_us = _percentile(_run, 99);
+    stats.missed = _missed;
+    stats.preempted = _preempted;
+}
+
+#endif // CONFIG_HAL_BOARD
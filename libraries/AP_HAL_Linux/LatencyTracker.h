@@ -0,0 +1,63 @@
+#ifndef __AP_HAL_LINUX_LATENCYTRACKER_H__
+#define __AP_HAL_LINUX_LATENCYTRACKER_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+#include "AP_HAL_Linux.h"
+
+#define LATENCY_BUCKETS 16
+
+/*
+  histograms of how late a thread wakes and how long it then runs,
+  for checking the behaviour of a (PREEMPT_RT) kernel. Bucket i counts
+  times from 2^i to 2^(i+1) microseconds, with bucket 0 also holding
+  times under a microsecond.
+
+  A tracker is only updated by the thread it measures. Readers may see
+  a partly updated set of counters, which is fine for statistics
+ */
+class Linux::LatencyTracker {
+public:
+    LatencyTracker(const char *name, const char *tag);
+
+    // the thread woke at now_us, and was due to wake at expected_us
+    void wakeup(uint64_t expected_us, uint64_t now_us);
+
+    // the thread woke at now_us for input rather than at a time it
+    // was due, so only its run time is recorded
+    void woken(uint64_t now_us);
+
+    // the thread finished the work started when it last woke
+    void done(uint64_t now_us);
+
+    // periodic ticks that were skipped entirely
+    void missed(uint32_t n) { _missed += n; }
+
+    // a latency with no run time, such as sample to output
+    void sample(uint32_t latency_us);
+
+    void get_stats(AP_HAL::Scheduler::latency_stats &stats) const;
+
+private:
+    const char *_name;
+    const char *_tag;
+    uint32_t _late[LATENCY_BUCKETS];
+    uint32_t _run[LATENCY_BUCKETS];
+    uint32_t _count;
+    uint32_t _late_max_us;
+    uint32_t _run_max_us;
+    uint32_t _missed;
+
+    uint64_t _wake_us;
+
+    // involuntary context switches, read once a second
+    uint32_t _preempted;
+    long _last_nivcsw;
+    uint64_t _last_rusage_us;
+
+    static void _add(uint32_t *hist, uint32_t &max, uint32_t value_us);
+    static uint32_t _percentile(const uint32_t *hist, uint8_t pct);
+    void _update_preempted(uint64_t now_us);
+};
+
+#endif // __AP_HAL_LINUX_LATENCYTRACKER_H__
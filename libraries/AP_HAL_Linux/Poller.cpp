@@ -0,0 +1,138 @@
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "Poller.h"
+
+using namespace Linux;
+
+Poller::Poller() :
+    _epoll_fd(-1),
+    _timer_fd(-1),
+    _period_usec(0),
+    _next_usec(0)
+{
+    for (uint8_t i = 0; i < POLLER_MAX_FDS; i++) {
+        _fds[i] = -1;
+    }
+}
+
+Poller::~Poller()
+{
+    if (_timer_fd != -1) {
+        close(_timer_fd);
+    }
+    if (_epoll_fd != -1) {
+        close(_epoll_fd);
+    }
+}
+
+bool Poller::init(uint32_t period_usec)
+{
+    _period_usec = period_usec;
+
+    _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (_timer_fd == -1) {
+        return false;
+    }
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        return false;
+    }
+
+    struct epoll_event ev = { };
+    ev.events = EPOLLIN;
+    ev.data.fd = _timer_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _timer_fd, &ev) == -1) {
+        return false;
+    }
+
+    struct itimerspec spec = { };
+    spec.it_interval.tv_sec = period_usec / 1000000;
+    spec.it_interval.tv_nsec = (period_usec % 1000000) * 1000UL;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(_timer_fd, 0, &spec, NULL) == -1) {
+        return false;
+    }
+
+    _next_usec = AP_HAL::micros64() + period_usec;
+    return true;
+}
+
+/*
+  a device that is closed is dropped from the epoll set by the
+  kernel. If it is reopened with the same fd number it is not watched
+  again, and is then only serviced on each period
+ */
+void Poller::watch(uint8_t slot, int fd)
+{
+    if (_epoll_fd == -1 || slot >= POLLER_MAX_FDS || _fds[slot] == fd) {
+        return;
+    }
+
+    const int old_fd = _fds[slot];
+    _fds[slot] = fd;
+
+    // the same fd can be used by more than one slot, such as a console
+    bool old_used = false;
+    bool new_used = false;
+    for (uint8_t i = 0; i < POLLER_MAX_FDS; i++) {
+        if (i == slot) {
+            continue;
+        }
+        old_used |= (old_fd != -1 && _fds[i] == old_fd);
+        new_used |= (fd != -1 && _fds[i] == fd);
+    }
+
+    if (old_fd != -1 && !old_used) {
+        epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, old_fd, NULL);
+    }
+    if (fd != -1 && !new_used) {
+        struct epoll_event ev = { };
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = fd;
+        epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+uint32_t Poller::wait(uint64_t &due_usec)
+{
+    if (_next_usec == 0) {
+        // no timerfd, sleep for a period as the threads used to
+        due_usec = AP_HAL::micros64() + _period_usec;
+        struct timespec ts;
+        ts.tv_sec = _period_usec / 1000000;
+        ts.tv_nsec = (_period_usec % 1000000) * 1000UL;
+        while (nanosleep(&ts, &ts) == -1 && errno == EINTR) ;
+        return 1;
+    }
+
+    struct epoll_event events[POLLER_MAX_FDS + 1];
+    int n;
+
+    while ((n = epoll_wait(_epoll_fd, events, POLLER_MAX_FDS + 1, -1)) == -1 &&
+           errno == EINTR) ;
+
+    uint64_t expirations = 0;
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == _timer_fd &&
+            read(_timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            expirations = 0;
+        }
+    }
+
+    if (expirations == 0) {
+        return 0;
+    }
+    due_usec = _next_usec;
+    _next_usec += expirations * _period_usec;
+    return expirations;
+}
+
+#endif // CONFIG_HAL_BOARD
@@ -0,0 +1,50 @@
+#ifndef __AP_HAL_LINUX_POLLER_H__
+#define __AP_HAL_LINUX_POLLER_H__
+
+#include <AP_HAL/AP_HAL.h>
+
+#include "AP_HAL_Linux.h"
+
+#define POLLER_MAX_FDS 8
+
+/*
+  wait for the next period of a scheduler thread, or for input on any
+  of a set of file descriptors, using a timerfd and epoll.
+
+  The period is kept by the kernel, so a thread does not drift or have
+  to work out how long to sleep, and a thread watching device fds can
+  run as soon as data arrives instead of at its next period. Watched
+  fds are edge triggered, so input that is left unread until the next
+  period does not wake the thread again.
+
+  A Poller is only used by the thread that owns it.
+ */
+class Linux::Poller {
+public:
+    Poller();
+    ~Poller();
+
+    // create the timerfd and epoll set. Returns false if the kernel
+    // does not support them, in which case wait() sleeps for a period
+    bool init(uint32_t period_usec);
+
+    // watch fd for input, replacing the fd watched in this slot. Use
+    // -1 to stop watching
+    void watch(uint8_t slot, int fd);
+
+    /*
+      wait for the next period or for input on a watched fd. Returns
+      the number of periods that have expired, with due_usec set to
+      the time the first of them was due, or 0 when woken by input
+     */
+    uint32_t wait(uint64_t &due_usec);
+
+private:
+    int _epoll_fd;
+    int _timer_fd;
+    int _fds[POLLER_MAX_FDS];
+    uint32_t _period_usec;
+    uint64_t _next_usec;
+};
+
+#endif // __AP_HAL_LINUX_POLLER_H__
@@ -27,6 +27,8 @@
 
 using namespace Linux;
 
+extern const AP_HAL::HAL& hal;
+
 static void catch_sigbus(int sig)
 {
     AP_HAL::panic("RCOutputAioPRU.cpp:SIGBUS error gernerated\n");
@@ -56,6 +58,8 @@ void RCOutput_AioPRU::init()
    // Start PRU 1
    *ctrl |= 2;
 
+   _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
    // all outputs default to 50Hz, the top level vehicle code
    // overrides this when necessary
    set_freq(0xFFFFFFFF, 50);
@@ -100,9 +104,42 @@ void RCOutput_AioPRU::disable_ch(uint8_t ch)
 
 void RCOutput_AioPRU::write(uint8_t ch, uint16_t period_us)
 {
-   if(ch < PWM_CHAN_COUNT) {
-      pwm->channel[ch].time_high = TICK_PER_US * period_us;
+   if (ch >= PWM_CHAN_COUNT) {
+      return;
+   }
+
+   _pending[ch] = period_us;
+   _pending_mask |= 1U << ch;
+
+   if (!_corking) {
+      push();
+   }
+}
+
+void RCOutput_AioPRU::cork()
+{
+   _corking = true;
+}
+
+/*
+  write all the channels set since the last push back to back, so
+  they take effect in the same PWM period
+ */
+void RCOutput_AioPRU::push()
+{
+   _corking = false;
+
+   if (_pending_mask == 0) {
+      return;
+   }
+
+   PERF_SCOPE(_perf_push);
+   for (uint8_t ch = 0; ch < PWM_CHAN_COUNT; ch++) {
+      if (_pending_mask & (1U << ch)) {
+         pwm->channel[ch].time_high = TICK_PER_US * _pending[ch];
+      }
    }
+   _pending_mask = 0;
 }
 
 uint16_t RCOutput_AioPRU::read(uint8_t ch)
@@ -19,13 +19,16 @@
 #define RCOUT_PRUSS_IRAM_BASE 0x4a338000
 #define PWM_CHAN_COUNT 12
 
-class Linux::RCOutput_AioPRU : public AP_HAL::RCOutput {
+class Linux::RCOutput_AioPRU final : public AP_HAL::RCOutput {
+public:
     void     init();
     void     set_freq(uint32_t chmask, uint16_t freq_hz);
     uint16_t get_freq(uint8_t ch);
     void     enable_ch(uint8_t ch);
     void     disable_ch(uint8_t ch);
     void     write(uint8_t ch, uint16_t period_us);
+    void     cork() override;
+    void     push() override;
     uint16_t read(uint8_t ch);
     void     read(uint16_t* period_us, uint8_t len);
 
@@ -42,6 +45,12 @@ private:
     };
 
     volatile struct pwm *pwm;
+
+    // channels written since the last push
+    uint16_t _pending[PWM_CHAN_COUNT] {};
+    uint32_t _pending_mask = 0;
+    bool _corking = false;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
 
 #endif // __AP_HAL_LINUX_RCOUTPUT_AIOPRU_H__
@@ -2,6 +2,7 @@
 #define __AP_HAL_LINUX_RCOUTPUT_BEBOP_H__
 
 #include "AP_HAL_Linux.h"
+#include "RCOutput_Locked.h"
 
 enum bebop_bldc_motor {
     BEBOP_BLDC_MOTOR_1 = 0,
@@ -58,12 +59,13 @@ struct bldc_info {
     uint8_t last_error;
 }__attribute__((packed));
 
-class Linux::RCOutput_Bebop : public AP_HAL::RCOutput {
+class Linux::RCOutput_Bebop final : public AP_HAL::RCOutput {
 public:
     RCOutput_Bebop();
 
+    // hal.rcout is the board's RCOutput_Locked around this driver
     static RCOutput_Bebop *from(AP_HAL::RCOutput *rcout) {
-        return static_cast<RCOutput_Bebop*>(rcout);
+        return &RCOutput_Locked<RCOutput_Bebop>::from(rcout)->driver();
     }
 
     void     init();
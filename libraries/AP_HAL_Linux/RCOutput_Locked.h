@@ -0,0 +1,164 @@
+#ifndef __AP_HAL_LINUX_RCOUTPUT_LOCKED_H__
+#define __AP_HAL_LINUX_RCOUTPUT_LOCKED_H__
+
+#include "AP_HAL_Linux.h"
+#include <pthread.h>
+
+/*
+  serialises the calls into an RCOutput driver, which may come from
+  both the main loop and the rate thread.
+
+  Each call holds the lock only while it runs. The thread which corks
+  first owns the cork: writes from other threads go out with its
+  push(), and their own cork() and push() do nothing until it has
+  pushed. So a servo write from the main loop can't flush or drop the
+  motor writes the rate thread is grouping, and no thread waits on
+  another between its cork() and push()
+ */
+template <class Driver>
+class Linux::RCOutput_Locked final : public AP_HAL::RCOutput {
+public:
+    RCOutput_Locked(Driver &driver) :
+        _driver(driver)
+    {
+        pthread_mutex_init(&_mutex, NULL);
+    }
+
+    static RCOutput_Locked *from(AP_HAL::RCOutput *rcout) {
+        return static_cast<RCOutput_Locked*>(rcout);
+    }
+
+    // the driver, for its board specific calls
+    Driver &driver() { return _driver; }
+
+    void init() override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.init();
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void set_freq(uint32_t chmask, uint16_t freq_hz) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.set_freq(chmask, freq_hz);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    uint16_t get_freq(uint8_t ch) override
+    {
+        pthread_mutex_lock(&_mutex);
+        uint16_t freq_hz = _driver.get_freq(ch);
+        pthread_mutex_unlock(&_mutex);
+        return freq_hz;
+    }
+
+    void enable_ch(uint8_t ch) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.enable_ch(ch);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void disable_ch(uint8_t ch) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.disable_ch(ch);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void write(uint8_t ch, uint16_t period_us) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.write(ch, period_us);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void cork() override
+    {
+        pthread_mutex_lock(&_mutex);
+        if (!_corked) {
+            _driver.cork();
+            _corked = true;
+            _cork_owner = pthread_self();
+        }
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void push() override
+    {
+        pthread_mutex_lock(&_mutex);
+        if (_corked && pthread_equal(_cork_owner, pthread_self())) {
+            _driver.push();
+            _corked = false;
+        }
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    uint16_t read(uint8_t ch) override
+    {
+        pthread_mutex_lock(&_mutex);
+        uint16_t period_us = _driver.read(ch);
+        pthread_mutex_unlock(&_mutex);
+        return period_us;
+    }
+
+    void read(uint16_t* period_us, uint8_t len) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.read(period_us, len);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void set_safety_pwm(uint32_t chmask, uint16_t period_us) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.set_safety_pwm(chmask, period_us);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void set_failsafe_pwm(uint32_t chmask, uint16_t period_us) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.set_failsafe_pwm(chmask, period_us);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    bool force_safety_on(void) override
+    {
+        pthread_mutex_lock(&_mutex);
+        bool ret = _driver.force_safety_on();
+        pthread_mutex_unlock(&_mutex);
+        return ret;
+    }
+
+    void force_safety_off(void) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.force_safety_off();
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    void set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm) override
+    {
+        pthread_mutex_lock(&_mutex);
+        _driver.set_esc_scaling(min_pwm, max_pwm);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    bool set_output_mode(uint32_t chmask, enum output_mode mode) override
+    {
+        pthread_mutex_lock(&_mutex);
+        bool ret = _driver.set_output_mode(chmask, mode);
+        pthread_mutex_unlock(&_mutex);
+        return ret;
+    }
+
+private:
+    Driver &_driver;
+    pthread_mutex_t _mutex;
+    bool _corked = false;
+    pthread_t _cork_owner;
+};
+
+#endif // __AP_HAL_LINUX_RCOUTPUT_LOCKED_H__
@@ -89,6 +89,8 @@ void RCOutput_PCA9685::init()
         return; /* never reached */
     }
 
+    _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
     reset_all_channels();
 
     /* Set the initial frequency */
@@ -228,6 +230,7 @@ void RCOutput_PCA9685::push()
         return;
     }
 
+    PERF_SCOPE(_perf_push);
     hal.i2c->writeRegisters(_addr,
                             PCA9685_RA_LED0_ON_L + 4 * (_channel_offset + min_ch),
                             (max_ch - min_ch) * 4,
@@ -9,7 +9,7 @@
 #define PCA9685_TERTIARY_ADDRESS            0x42
 #define PCA9685_QUATENARY_ADDRESS           0x55
 
-class Linux::RCOutput_PCA9685 : public AP_HAL::RCOutput {
+class Linux::RCOutput_PCA9685 final : public AP_HAL::RCOutput {
     public:
     RCOutput_PCA9685(uint8_t addr, bool external_clock, uint8_t channel_offset,
                           int16_t oe_pin_number);
@@ -42,6 +42,7 @@ private:
     uint8_t _channel_offset;
     int16_t _oe_pin_number;
     uint16_t _pending_write_mask;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
 
 #endif // __AP_HAL_LINUX_RCOUTPUT_PCA9685_H__
@@ -18,6 +18,8 @@
 #include <signal.h>
 using namespace Linux;
 
+extern const AP_HAL::HAL& hal;
+
 
 #define PWM_CHAN_COUNT 12
 
@@ -37,6 +39,8 @@ void RCOutput_PRU::init()
                                             MAP_SHARED, mem_fd, RCOUT_PRUSS_SHAREDRAM_BASE);
     close(mem_fd);
 
+    _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
     // all outputs default to 50Hz, the top level vehicle code
     // overrides this when necessary
     set_freq(0xFFFFFFFF, 50);
@@ -71,11 +75,127 @@ void RCOutput_PRU::disable_ch(uint8_t ch)
 
 void RCOutput_PRU::write(uint8_t ch, uint16_t period_us)
 {
-    sharedMem_cmd->periodhi[chan_pru_map[ch]][1] = TICK_PER_US*period_us;
+    if (ch >= PWM_CHAN_COUNT) {
+        return;
+    }
+
+    _pending[ch] = period_us;
+    _pending_mask |= 1U << ch;
+
+    if (!_corking) {
+        push();
+    }
+}
+
+void RCOutput_PRU::cork()
+{
+    _corking = true;
+}
+
+/*
+  write all the channels set since the last push back to back, so
+  they take effect in the same PWM period
+ */
+void RCOutput_PRU::push()
+{
+    _corking = false;
+
+    if (_pending_mask == 0) {
+        return;
+    }
+
+    PERF_SCOPE(_perf_push);
+    for (uint8_t ch = 0; ch < PWM_CHAN_COUNT; ch++) {
+        if (!(_pending_mask & (1U << ch))) {
+            continue;
+        }
+        if (_dshot_mask & (1U << ch)) {
+            const uint16_t value = DShot::pwm_to_value(_pending[ch], _esc_min_pwm, _esc_max_pwm);
+            sharedMem_cmd->dshot_packet[chan_pru_map[ch]] = DShot::packet(value, false);
+        } else {
+            sharedMem_cmd->periodhi[chan_pru_map[ch]][1] = TICK_PER_US*_pending[ch];
+        }
+    }
+
+    // the PRU sends a frame on every DShot channel when the sequence changes
+    if (_pending_mask & _dshot_mask) {
+        sharedMem_cmd->dshot_seq++;
+    }
+    _pending_mask = 0;
+}
+
+void RCOutput_PRU::set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm)
+{
+    _esc_min_pwm = min_pwm;
+    _esc_max_pwm = max_pwm;
+}
+
+/*
+  firmware without DShot support ignores the DShot fields and keeps
+  sending the last PWM period, so ask it before using DShot. The
+  firmware rewrites caps every time round its main loop, which is at
+  least once per PWM period
+ */
+bool RCOutput_PRU::dshot_supported()
+{
+    if (!_caps_probed) {
+        sharedMem_cmd->caps = 0;
+        for (uint8_t i = 0; i < 50 && sharedMem_cmd->caps == 0; i++) {
+            hal.scheduler->delay(1);
+        }
+        _dshot_supported = (sharedMem_cmd->caps & PWM_CAPS_DSHOT) != 0;
+        _caps_probed = true;
+        if (!_dshot_supported) {
+            hal.console->printf("RCOutput_PRU: PRU firmware has no DShot, staying on PWM\n");
+        }
+    }
+    return _dshot_supported;
+}
+
+/*
+  the PRU sends DShot frames on any of its outputs, but all of them
+  share one bit rate. A different DShot rate is refused while other
+  channels are using DShot
+ */
+bool RCOutput_PRU::set_output_mode(uint32_t chmask, enum output_mode mode)
+{
+    chmask &= (1U << PWM_CHAN_COUNT) - 1;
+
+    if (mode != MODE_PWM_NORMAL) {
+        if (!dshot_supported()) {
+            return false;
+        }
+        if ((_dshot_mask & ~chmask) != 0 && mode != _dshot_mode) {
+            return false;
+        }
+        DShot::timing t;
+        if (!DShot::get_timing(mode, TICK_PER_S, t)) {
+            return false;
+        }
+        sharedMem_cmd->dshot_bit = t.bit_ticks;
+        sharedMem_cmd->dshot_t0h = t.t0h_ticks;
+        sharedMem_cmd->dshot_t1h = t.t1h_ticks;
+        _dshot_mode = mode;
+        _dshot_mask |= chmask;
+    } else {
+        _dshot_mask &= ~chmask;
+    }
+
+    uint32_t pru_mask = 0;
+    for (uint8_t ch = 0; ch < PWM_CHAN_COUNT; ch++) {
+        if (_dshot_mask & (1U << ch)) {
+            pru_mask |= 1U << chan_pru_map[ch];
+        }
+    }
+    sharedMem_cmd->dshot_mask = pru_mask;
+    return true;
 }
 
 uint16_t RCOutput_PRU::read(uint8_t ch)
 {
+    if (_dshot_mask & (1U << ch)) {
+        return _pending[ch];
+    }
     return (sharedMem_cmd->hilo_read[chan_pru_map[ch]][1]/TICK_PER_US);
 }
 
@@ -86,7 +206,7 @@ void RCOutput_PRU::read(uint16_t* period_us, uint8_t len)
         len = PWM_CHAN_COUNT;
     }
     for(i=0;i<len;i++){
-        period_us[i] = sharedMem_cmd->hilo_read[chan_pru_map[i]][1]/TICK_PER_US;
+        period_us[i] = read(i);
     }
 }
 
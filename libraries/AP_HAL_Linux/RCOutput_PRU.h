@@ -3,6 +3,8 @@
 #define __AP_HAL_LINUX_RCOUTPUT_PRU_H__
 
 #include "AP_HAL_Linux.h"
+#include <AP_HAL/utility/DShot.h>
+
 #define RCOUT_PRUSS_SHAREDRAM_BASE     0x4a310000
 #define MAX_PWMS                 12
 #define PWM_CMD_MAGIC            0xf00fbaaf
@@ -14,16 +16,22 @@
 #define PWM_CMD_SET	         4	/* set a pwm output explicitly */
 #define PWM_CMD_CLR	         5	/* clr a pwm output explicitly */
 #define PWM_CMD_TEST	         6	/* various crap */
+#define PWM_CAPS_DSHOT           (1U<<0)
 
-class Linux::RCOutput_PRU : public AP_HAL::RCOutput {
+class Linux::RCOutput_PRU final : public AP_HAL::RCOutput {
+public:
     void     init();
     void     set_freq(uint32_t chmask, uint16_t freq_hz);
     uint16_t get_freq(uint8_t ch);
     void     enable_ch(uint8_t ch);
     void     disable_ch(uint8_t ch);
     void     write(uint8_t ch, uint16_t period_us);
+    void     cork() override;
+    void     push() override;
     uint16_t read(uint8_t ch);
     void     read(uint16_t* period_us, uint8_t len);
+    void     set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm) override;
+    bool     set_output_mode(uint32_t chmask, enum output_mode mode) override;
 
 private:
     static const int TICK_PER_US=200;
@@ -35,9 +43,30 @@ private:
         uint32_t periodhi[MAX_PWMS][2];
         uint32_t hilo_read[MAX_PWMS][2];
         uint32_t enmask_read;
+        uint32_t dshot_mask;  /* PRU outputs sending DShot */
+        uint32_t dshot_bit;
+        uint32_t dshot_t0h;
+        uint32_t dshot_t1h;
+        uint32_t dshot_seq;   /* incremented to send dshot_packet */
+        uint32_t dshot_packet[MAX_PWMS];
+        uint32_t caps;        /* PWM_CAPS_* from the firmware */
     };
     volatile struct pwm_cmd *sharedMem_cmd;
 
+    // channels written since the last push
+    uint16_t _pending[MAX_PWMS] {};
+    uint32_t _pending_mask = 0;
+    bool _corking = false;
+
+    // channels sending DShot, all at the same bit rate
+    uint32_t _dshot_mask = 0;
+    enum output_mode _dshot_mode = MODE_PWM_NORMAL;
+    bool _caps_probed = false;
+    bool _dshot_supported = false;
+    bool dshot_supported();
+    uint16_t _esc_min_pwm = 1000;
+    uint16_t _esc_max_pwm = 2000;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
 
 #endif // __AP_HAL_LINUX_RCOUTPUT_PRU_H__
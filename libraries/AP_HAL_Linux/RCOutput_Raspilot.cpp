@@ -33,6 +33,8 @@ void RCOutput_Raspilot::init()
         return; // never reached
     }
     
+    _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
     hal.scheduler->register_timer_process(FUNCTOR_BIND_MEMBER(&RCOutput_Raspilot::_update, void));
 }
 
@@ -79,6 +81,21 @@ void RCOutput_Raspilot::write(uint8_t ch, uint16_t period_us)
     }
     
     _period_us[ch] = period_us;
+
+    if (!_corking) {
+        _new_output = true;
+    }
+}
+
+void RCOutput_Raspilot::cork()
+{
+    _corking = true;
+}
+
+void RCOutput_Raspilot::push()
+{
+    _corking = false;
+    _new_output = true;
 }
 
 uint16_t RCOutput_Raspilot::read(uint8_t ch)
@@ -100,16 +117,23 @@ void RCOutput_Raspilot::_update(void)
 {
     int i;
     
-    if (AP_HAL::micros() - _last_update_timestamp < 10000) {
+    /*
+      send new outputs on the next timer tick after a push, and the
+      current ones at least every 10ms
+     */
+    if (_corking ||
+        (!_new_output && AP_HAL::micros() - _last_update_timestamp < 10000)) {
         return;
     }
     
-    _last_update_timestamp = AP_HAL::micros();
-    
     if (!_spi_sem->take_nonblocking()) {
         return;
     }
 
+    _last_update_timestamp = AP_HAL::micros();
+    _new_output = false;
+    PERF_SCOPE(_perf_push);
+
     struct IOPacket _dma_packet_tx, _dma_packet_rx;
     uint16_t count = 1;
     _dma_packet_tx.count_code = count | PKT_CODE_WRITE;
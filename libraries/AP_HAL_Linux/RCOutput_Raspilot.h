@@ -4,13 +4,16 @@
 
 #include "AP_HAL_Linux.h"
 
-class Linux::RCOutput_Raspilot : public AP_HAL::RCOutput {
+class Linux::RCOutput_Raspilot final : public AP_HAL::RCOutput {
+public:
     void     init();
     void     set_freq(uint32_t chmask, uint16_t freq_hz);
     uint16_t get_freq(uint8_t ch);
     void     enable_ch(uint8_t ch);
     void     disable_ch(uint8_t ch);
     void     write(uint8_t ch, uint16_t period_us);
+    void     cork() override;
+    void     push() override;
     uint16_t read(uint8_t ch);
     void     read(uint16_t* period_us, uint8_t len);
 
@@ -24,6 +27,12 @@ private:
     uint32_t _last_update_timestamp;
     uint16_t _frequency;
     uint16_t _period_us[8];
+
+    // while corked the timer doesn't send a partly written set of
+    // outputs, and after a push it sends them straight away
+    volatile bool _corking = false;
+    volatile bool _new_output = false;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
 
 #endif // __AP_HAL_LINUX_RCOUTPUT_RASPILOT_H__
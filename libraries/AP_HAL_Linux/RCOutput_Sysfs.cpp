@@ -25,12 +25,15 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_Math/AP_Math.h>
 
+extern const AP_HAL::HAL& hal;
+
 namespace Linux {
 
 RCOutput_Sysfs::RCOutput_Sysfs(uint8_t chip, uint8_t channel_count)
     : _chip(chip)
     , _channel_count(channel_count)
     , _pwm_channels(new PWM_Sysfs *[_channel_count])
+    , _pending(new uint16_t[_channel_count])
 {
 }
 
@@ -41,10 +44,13 @@ RCOutput_Sysfs::~RCOutput_Sysfs()
     }
 
     delete _pwm_channels;
+    delete [] _pending;
 }
 
 void RCOutput_Sysfs::init()
 {
+    _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
     for (uint8_t i = 0; i < _channel_count; i++) {
         _pwm_channels[i] = new PWM_Sysfs(_chip, i);
         if (!_pwm_channels[i]) {
@@ -101,7 +107,39 @@ void RCOutput_Sysfs::write(uint8_t ch, uint16_t period_us)
         return;
     }
 
-    _pwm_channels[ch]->set_duty_cycle(usec_to_nsec(period_us));
+    _pending[ch] = period_us;
+    _pending_mask |= 1U << ch;
+
+    if (!_corking) {
+        push();
+    }
+}
+
+void RCOutput_Sysfs::cork()
+{
+    _corking = true;
+}
+
+/*
+  each channel is its own sysfs file, so this is still a write per
+  channel, but they are done together and only for channels that were
+  written since the last push
+ */
+void RCOutput_Sysfs::push()
+{
+    _corking = false;
+
+    if (_pending_mask == 0) {
+        return;
+    }
+
+    PERF_SCOPE(_perf_push);
+    for (uint8_t ch = 0; ch < _channel_count; ch++) {
+        if (_pending_mask & (1U << ch)) {
+            _pwm_channels[ch]->set_duty_cycle(usec_to_nsec(_pending[ch]));
+        }
+    }
+    _pending_mask = 0;
 }
 
 uint16_t RCOutput_Sysfs::read(uint8_t ch)
@@ -19,6 +19,8 @@ public:
     void enable_ch(uint8_t ch);
     void disable_ch(uint8_t ch);
     void write(uint8_t ch, uint16_t period_us);
+    void cork() override;
+    void push() override;
     uint16_t read(uint8_t ch);
     void read(uint16_t *period_us, uint8_t len);
 
@@ -26,4 +28,10 @@ private:
     const uint8_t _chip;
     const uint8_t _channel_count;
     PWM_Sysfs **_pwm_channels;
+
+    // channels written since the last push
+    uint16_t *_pending;
+    uint32_t _pending_mask = 0;
+    bool _corking = false;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
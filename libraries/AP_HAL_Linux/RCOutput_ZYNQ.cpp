@@ -18,6 +18,8 @@
 #include <signal.h>
 using namespace Linux;
 
+extern const AP_HAL::HAL& hal;
+
 #define PWM_CHAN_COUNT 8	// FIXME
 
 static void catch_sigbus(int sig)
@@ -33,6 +35,8 @@ void RCOutput_ZYNQ::init()
                                             MAP_SHARED, mem_fd, RCOUT_ZYNQ_PWM_BASE);
     close(mem_fd);
 
+    _perf_push = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "RCOut_push");
+
     // all outputs default to 50Hz, the top level vehicle code
     // overrides this when necessary
     set_freq(0xFFFFFFFF, 50);
@@ -67,7 +71,42 @@ void RCOutput_ZYNQ::disable_ch(uint8_t ch)
 
 void RCOutput_ZYNQ::write(uint8_t ch, uint16_t period_us)
 {
-    sharedMem_cmd->periodhi[ch].hi = TICK_PER_US*period_us;
+    if (ch >= PWM_CHAN_COUNT) {
+        return;
+    }
+
+    _pending[ch] = period_us;
+    _pending_mask |= 1U << ch;
+
+    if (!_corking) {
+        push();
+    }
+}
+
+void RCOutput_ZYNQ::cork()
+{
+    _corking = true;
+}
+
+/*
+  write all the channels set since the last push back to back, so
+  they take effect in the same PWM period
+ */
+void RCOutput_ZYNQ::push()
+{
+    _corking = false;
+
+    if (_pending_mask == 0) {
+        return;
+    }
+
+    PERF_SCOPE(_perf_push);
+    for (uint8_t ch = 0; ch < PWM_CHAN_COUNT; ch++) {
+        if (_pending_mask & (1U << ch)) {
+            sharedMem_cmd->periodhi[ch].hi = TICK_PER_US*_pending[ch];
+        }
+    }
+    _pending_mask = 0;
 }
 
 uint16_t RCOutput_ZYNQ::read(uint8_t ch)
@@ -14,13 +14,16 @@
 #define PWM_CMD_TEST	         6	/* various crap */
 
 
-class Linux::RCOutput_ZYNQ : public AP_HAL::RCOutput {
+class Linux::RCOutput_ZYNQ final : public AP_HAL::RCOutput {
+public:
     void     init();
     void     set_freq(uint32_t chmask, uint16_t freq_hz);
     uint16_t get_freq(uint8_t ch);
     void     enable_ch(uint8_t ch);
     void     disable_ch(uint8_t ch);
     void     write(uint8_t ch, uint16_t period_us);
+    void     cork() override;
+    void     push() override;
     uint16_t read(uint8_t ch);
     void     read(uint16_t* period_us, uint8_t len);
 
@@ -37,6 +40,12 @@ private:
         struct s_period_hi periodhi[MAX_ZYNQ_PWMS];
     };
     volatile struct pwm_cmd *sharedMem_cmd;
+
+    // channels written since the last push
+    uint16_t _pending[MAX_ZYNQ_PWMS] {};
+    uint32_t _pending_mask = 0;
+    bool _corking = false;
+    AP_HAL::Util::perf_counter_t _perf_push;
 };
 
 #endif // __AP_HAL_LINUX_RCOUTPUT_ZYNQ_H__
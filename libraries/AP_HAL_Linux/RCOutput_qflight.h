@@ -5,7 +5,7 @@
 
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_QFLIGHT
 
-class Linux::RCOutput_QFLIGHT : public AP_HAL::RCOutput {
+class Linux::RCOutput_QFLIGHT final : public AP_HAL::RCOutput {
 public:
     void init();
     void set_freq(uint32_t chmask, uint16_t freq_hz);
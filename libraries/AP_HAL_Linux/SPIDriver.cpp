@@ -121,6 +121,11 @@ bool SPIDeviceDriver::transaction(const uint8_t *tx, uint8_t *rx, uint16_t len)
     return SPIDeviceManager::transaction(*this, tx, rx, len);
 }
 
+bool SPIDeviceDriver::transactions(const Transfer *transfers, uint8_t count)
+{
+    return SPIDeviceManager::transactions(*this, transfers, count);
+}
+
 void SPIDeviceDriver::set_bus_speed(enum bus_speed speed)
 {
     if (speed == SPI_SPEED_LOW) {
@@ -274,6 +279,62 @@ bool SPIDeviceManager::transaction(SPIDeviceDriver &driver, const uint8_t *tx, u
     return true;
 }
 
+/*
+  submit several transfers to the kernel with a single ioctl. The chip
+  select is toggled between transfers by setting cs_change, so this is
+  only possible when the kernel handles CS. With a GPIO CS we fall back
+  to one ioctl per transfer
+ */
+bool SPIDeviceManager::transactions(SPIDeviceDriver &driver,
+                                    const AP_HAL::SPIDeviceDriver::Transfer *transfers,
+                                    uint8_t count)
+{
+    if (driver._cs_pin != SPI_CS_KERNEL || count > LINUX_SPI_MAX_TRANSFERS) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (!transaction(driver, transfers[i].tx, transfers[i].rx, transfers[i].len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    int r = ioctl(driver._fd, SPI_IOC_WR_MODE, &driver._mode);
+    if (r == -1) {
+        hal.console->printf("SPI: error on setting mode\n");
+        return false;
+    }
+
+    struct spi_ioc_transfer spi[LINUX_SPI_MAX_TRANSFERS];
+    memset(spi, 0, sizeof(spi));
+    for (uint8_t i = 0; i < count; i++) {
+        spi[i].tx_buf        = (uint64_t)transfers[i].tx;
+        spi[i].rx_buf        = (uint64_t)transfers[i].rx;
+        spi[i].len           = transfers[i].len;
+        spi[i].delay_usecs   = 0;
+        spi[i].speed_hz      = driver._speed;
+        spi[i].bits_per_word = driver._bitsPerWord;
+        // deselect the device between transfers, but not after the last
+        spi[i].cs_change     = (i < count - 1) ? 1 : 0;
+
+        if (transfers[i].rx != NULL) {
+            // keep valgrind happy
+            memset(transfers[i].rx, 0, transfers[i].len);
+        }
+    }
+
+    r = ioctl(driver._fd, SPI_IOC_MESSAGE(count), &spi);
+    if (r == -1) {
+        hal.console->printf("SPI: error on doing transactions\n");
+        return false;
+    }
+
+    return true;
+}
+
 /*
   return a SPIDeviceDriver for a particular device
  */
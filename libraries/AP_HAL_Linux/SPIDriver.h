@@ -12,6 +12,9 @@
 
 #define LINUX_SPI_MAX_BUSES 3
 
+// maximum number of transfers submitted in a single SPI_IOC_MESSAGE ioctl
+#define LINUX_SPI_MAX_TRANSFERS 8
+
 // Fake CS pin to indicate in-kernel handling
 #define SPI_CS_KERNEL -1
 
@@ -22,6 +25,7 @@ public:
     void init();
     AP_HAL::Semaphore *get_semaphore();
     bool transaction(const uint8_t *tx, uint8_t *rx, uint16_t len);
+    bool transactions(const Transfer *transfers, uint8_t count) override;
 
     void cs_assert();
     void cs_release();
@@ -53,6 +57,7 @@ public:
     static void cs_assert(enum AP_HAL::SPIDevice type);
     static void cs_release(enum AP_HAL::SPIDevice type);
     static bool transaction(SPIDeviceDriver &driver, const uint8_t *tx, uint8_t *rx, uint16_t len);
+    static bool transactions(SPIDeviceDriver &driver, const AP_HAL::SPIDeviceDriver::Transfer *transfers, uint8_t count);
 
 private:
     static SPIDeviceDriver _device[];
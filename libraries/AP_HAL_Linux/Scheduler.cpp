@@ -13,8 +13,10 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <sys/mman.h>
+#include <sys/eventfd.h>
 
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_QFLIGHT
 #include <rpcmem.h>
@@ -28,6 +30,7 @@ using namespace Linux;
 
 extern const AP_HAL::HAL& hal;
 
+#define APM_LINUX_RATE_PRIORITY         16
 #define APM_LINUX_TIMER_PRIORITY        15
 #define APM_LINUX_UART_PRIORITY         14
 #define APM_LINUX_RCIN_PRIORITY         13
@@ -35,6 +38,13 @@ extern const AP_HAL::HAL& hal;
 #define APM_LINUX_TONEALARM_PRIORITY    11
 #define APM_LINUX_IO_PRIORITY           10
 
+// stack touched by each thread at startup, so it is already locked in
+// memory by mlockall() when the thread first needs it
+#define APM_LINUX_STACK_PREFAULT        (64 * 1024)
+
+#define APM_LINUX_TIMER_PERIOD          1000
+#define APM_LINUX_RATE_MAX_HZ           2000
+
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_NAVIO ||    \
     CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_ERLEBRAIN2 || \
     CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BH || \
@@ -53,14 +63,114 @@ extern const AP_HAL::HAL& hal;
 
 
 
-Scheduler::Scheduler()
-{}
+Scheduler::Scheduler() :
+    _timer_period_usec(APM_LINUX_TIMER_PERIOD),
+    _rate_event_fd(-1),
+    _rate_divider(1),
+    _rate_ticks(0),
+    _rate_kick_us(0),
+    _latency{ {"timer", "TIMER"}, {"uart", "UART"}, {"rcin", "RCIN"},
+              {"tonealarm", "TONE"}, {"io", "IO"}, {"rate", "RATE"},
+              {"main", "MAIN"}, {"output", "OUT"} }
+{
+    static const struct {
+        const char *name;
+        int rtprio;
+    } defaults[THREAD_NUM] = {
+        { "main",      APM_LINUX_MAIN_PRIORITY },
+        { "timer",     APM_LINUX_TIMER_PRIORITY },
+        { "uart",      APM_LINUX_UART_PRIORITY },
+        { "rcin",      APM_LINUX_RCIN_PRIORITY },
+        { "tonealarm", APM_LINUX_TONEALARM_PRIORITY },
+        { "io",        APM_LINUX_IO_PRIORITY },
+        { "rate",      APM_LINUX_RATE_PRIORITY },
+    };
+    for (uint8_t i = 0; i < THREAD_NUM; i++) {
+        _thread_config[i].name = defaults[i].name;
+        _thread_config[i].rtprio = defaults[i].rtprio;
+        CPU_ZERO(&_thread_config[i].cpus);
+    }
+}
+
+/*
+  parse a name:cpus[:priority] thread option, where cpus is a list of
+  CPUs and ranges such as 0-1,3
+ */
+bool Scheduler::set_thread_option(const char *option)
+{
+    const char *sep = strchr(option, ':');
+    if (sep == NULL) {
+        return false;
+    }
+
+    thread_config *config = NULL;
+    for (uint8_t i = 0; i < THREAD_NUM; i++) {
+        if (strlen(_thread_config[i].name) == (size_t)(sep - option) &&
+            strncmp(_thread_config[i].name, option, sep - option) == 0) {
+            config = &_thread_config[i];
+        }
+    }
+    if (config == NULL) {
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    const char *p = sep + 1;
+    while (*p != 0 && *p != ':') {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p) {
+            return false;
+        }
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p) {
+                return false;
+            }
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, &cpus);
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+
+    if (*p == ':') {
+        char *end;
+        long rtprio = strtol(p + 1, &end, 10);
+        if (end == p + 1 || *end != 0 ||
+            rtprio < sched_get_priority_min(SCHED_FIFO) ||
+            rtprio > sched_get_priority_max(SCHED_FIFO)) {
+            return false;
+        }
+        config->rtprio = rtprio;
+    }
+    config->cpus = cpus;
+    return true;
+}
+
+/*
+  touch the top of the calling thread's stack, so page faults don't
+  happen the first time it runs deep in a driver
+ */
+static void __attribute__((noinline)) prefault_stack(void)
+{
+    volatile uint8_t stack[APM_LINUX_STACK_PREFAULT];
+    for (uint32_t i = 0; i < sizeof(stack); i += 1024) {
+        stack[i] = 0;
+    }
+}
 
-void Scheduler::_create_realtime_thread(pthread_t *ctx, int rtprio,
+void Scheduler::_create_realtime_thread(pthread_t *ctx, const thread_config &config,
                                              const char *name,
                                              pthread_startroutine_t start_routine)
 {
-    struct sched_param param = { .sched_priority = rtprio };
+    struct sched_param param = { .sched_priority = config.rtprio };
     pthread_attr_t attr;
     int r;
 
@@ -75,6 +185,9 @@ void Scheduler::_create_realtime_thread(pthread_t *ctx, int rtprio,
         pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
         pthread_attr_setschedparam(&attr, &param);
     }
+    if (CPU_COUNT(&config.cpus) != 0) {
+        pthread_attr_setaffinity_np(&attr, sizeof(config.cpus), &config.cpus);
+    }
     r = pthread_create(ctx, &attr, start_routine, this);
     if (r != 0) {
         hal.console->printf("Error creating thread '%s': %s\n",
@@ -90,39 +203,46 @@ void Scheduler::_create_realtime_thread(pthread_t *ctx, int rtprio,
 
 void Scheduler::init()
 {
-    mlockall(MCL_CURRENT|MCL_FUTURE);
+    if (mlockall(MCL_CURRENT|MCL_FUTURE) != 0) {
+        printf("WARNING: mlockall failed: %s\n", strerror(errno));
+    }
 
-    struct sched_param param = { .sched_priority = APM_LINUX_MAIN_PRIORITY };
+    const thread_config &main_config = _thread_config[THREAD_MAIN];
+    struct sched_param param = { .sched_priority = main_config.rtprio };
     sched_setscheduler(0, SCHED_FIFO, &param);
+    if (CPU_COUNT(&main_config.cpus) != 0) {
+        sched_setaffinity(0, sizeof(main_config.cpus), &main_config.cpus);
+    }
+    prefault_stack();
 
     struct {
         pthread_t *ctx;
-        int rtprio;
+        uint8_t thread;
         const char *name;
         pthread_startroutine_t start_routine;
     } *iter, table[] = {
         { .ctx = &_timer_thread_ctx,
-          .rtprio = APM_LINUX_TIMER_PRIORITY,
+          .thread = THREAD_TIMER,
           .name = "sched-timer",
           .start_routine = &Linux::Scheduler::_timer_thread,
         },
         { .ctx = &_uart_thread_ctx,
-          .rtprio = APM_LINUX_UART_PRIORITY,
+          .thread = THREAD_UART,
           .name = "sched-uart",
           .start_routine = &Linux::Scheduler::_uart_thread,
         },
         { .ctx = &_rcin_thread_ctx,
-          .rtprio = APM_LINUX_RCIN_PRIORITY,
+          .thread = THREAD_RCIN,
           .name = "sched-rcin",
           .start_routine = &Linux::Scheduler::_rcin_thread,
         },
         { .ctx = &_tonealarm_thread_ctx,
-          .rtprio = APM_LINUX_TONEALARM_PRIORITY,
+          .thread = THREAD_TONEALARM,
           .name = "sched-tonealarm",
           .start_routine = &Linux::Scheduler::_tonealarm_thread,
         },
         { .ctx = &_io_thread_ctx,
-          .rtprio = APM_LINUX_IO_PRIORITY,
+          .thread = THREAD_IO,
           .name = "sched-io",
           .start_routine = &Linux::Scheduler::_io_thread,
         },
@@ -134,8 +254,37 @@ void Scheduler::init()
     }
 
     for (iter = table; iter->ctx; iter++)
-        _create_realtime_thread(iter->ctx, iter->rtprio, iter->name,
-                                iter->start_routine);
+        _create_realtime_thread(iter->ctx, _thread_config[iter->thread],
+                                iter->name, iter->start_routine);
+
+    _report_thread("main", pthread_self());
+    for (iter = table; iter->ctx; iter++)
+        _report_thread(iter->name, *iter->ctx);
+}
+
+// print the scheduling policy, priority and CPUs a thread ended up with
+void Scheduler::_report_thread(const char *name, pthread_t ctx)
+{
+    int policy;
+    struct sched_param param;
+    cpu_set_t cpus;
+    char cpu_list[64] = "";
+
+    if (pthread_getschedparam(ctx, &policy, &param) != 0) {
+        return;
+    }
+    if (pthread_getaffinity_np(ctx, sizeof(cpus), &cpus) == 0) {
+        size_t len = 0;
+        for (int cpu = 0; cpu < CPU_SETSIZE && len < sizeof(cpu_list); cpu++) {
+            if (CPU_ISSET(cpu, &cpus)) {
+                len += snprintf(&cpu_list[len], sizeof(cpu_list) - len,
+                                "%s%d", len ? "," : "", cpu);
+            }
+        }
+    }
+    printf("%-16s %s %2d cpus %s\n", name,
+           policy == SCHED_FIFO ? "SCHED_FIFO " : "SCHED_OTHER",
+           param.sched_priority, cpu_list);
 }
 
 void Scheduler::_microsleep(uint32_t usec)
@@ -172,6 +321,67 @@ void Scheduler::delay_microseconds(uint16_t us)
     _microsleep(us);
 }
 
+/*
+  the main loop uses this to wait for the next IMU sample, so it is
+  where main thread wakeup latency is measured
+ */
+void Scheduler::delay_microseconds_boost(uint16_t us)
+{
+    const uint64_t now = AP_HAL::micros64();
+    _latency[LATENCY_MAIN].done(now);
+    delay_microseconds(us);
+    _sample_wake_us = AP_HAL::micros64();
+    _latency[LATENCY_MAIN].wakeup(now + us, _sample_wake_us);
+}
+
+// called once the outputs for a sample are written, by the main loop or
+// the rate loop
+void Scheduler::outputs_written()
+{
+    if (_rate_proc && pthread_equal(pthread_self(), _rate_thread_ctx)) {
+        // the rate loop writes the outputs, so measure from the IMU read
+        _latency[LATENCY_OUTPUT].sample(AP_HAL::micros64() -
+                                        __atomic_load_n(&_rate_kick_us, __ATOMIC_RELAXED));
+        return;
+    }
+    if (_sample_wake_us != 0) {
+        _latency[LATENCY_OUTPUT].sample(AP_HAL::micros64() - _sample_wake_us);
+        _sample_wake_us = 0;
+    }
+}
+
+bool Scheduler::get_latency_stats(uint8_t index, latency_stats &stats)
+{
+    if (index >= LATENCY_NUM) {
+        return false;
+    }
+    _latency[index].get_stats(stats);
+    return true;
+}
+
+/*
+  wait for the next period of a thread or for input it is watching,
+  recording how long the last run took and how late the thread wakes.
+  Returns the number of periods that have expired, 0 for input
+ */
+uint32_t Scheduler::_thread_wait(LatencyTracker &tracker, Poller &poller)
+{
+    tracker.done(AP_HAL::micros64());
+
+    uint64_t due_usec;
+    const uint32_t periods = poller.wait(due_usec);
+    const uint64_t now = AP_HAL::micros64();
+    if (periods == 0) {
+        tracker.woken(now);
+        return 0;
+    }
+    if (periods > 1) {
+        tracker.missed(periods - 1);
+    }
+    tracker.wakeup(due_usec, now);
+    return periods;
+}
+
 void Scheduler::register_delay_callback(AP_HAL::Proc proc,
                                              uint16_t min_time_ms)
 {
@@ -211,6 +421,38 @@ void Scheduler::register_io_process(AP_HAL::MemberProc proc)
     }
 }
 
+/*
+  start the rate thread. The timer thread runs at least as fast as the
+  rate loop, so that the IMU FIFO is read before every run of it
+ */
+bool Scheduler::register_rate_process(AP_HAL::MemberProc proc, uint16_t rate_hz)
+{
+    if (_rate_proc || _initialized || rate_hz == 0) {
+        return false;
+    }
+    if (rate_hz > APM_LINUX_RATE_MAX_HZ) {
+        rate_hz = APM_LINUX_RATE_MAX_HZ;
+    }
+
+    _rate_event_fd = eventfd(0, EFD_CLOEXEC);
+    if (_rate_event_fd == -1) {
+        hal.console->printf("No eventfd for rate thread: %s\n", strerror(errno));
+        return false;
+    }
+
+    const uint32_t period_usec = 1000000UL / rate_hz;
+    if (period_usec < _timer_period_usec) {
+        _timer_period_usec = period_usec;
+    }
+    _rate_divider = (period_usec + _timer_period_usec / 2) / _timer_period_usec;
+    _rate_proc = proc;
+
+    _create_realtime_thread(&_rate_thread_ctx, _thread_config[THREAD_RATE],
+                            "sched-rate", &Linux::Scheduler::_rate_thread);
+    _report_thread("sched-rate", _rate_thread_ctx);
+    return true;
+}
+
 void Scheduler::register_timer_failsafe(AP_HAL::Proc failsafe, uint32_t period_us)
 {
     _failsafe = failsafe;
@@ -267,6 +509,8 @@ void *Scheduler::_timer_thread(void* arg)
 {
     Scheduler* sched = (Scheduler *)arg;
 
+    prefault_stack();
+
     while (sched->system_initializing()) {
         poll(NULL, 0, 1);
     }
@@ -276,23 +520,26 @@ void *Scheduler::_timer_thread(void* arg)
     rpcmem_init();
 #endif
     
-/*
-      this aims to run at an average of 1kHz, so that it can be used
-      to drive 1kHz processes without drift
+    /*
+      this runs at 1kHz, or the rate loop rate if that is faster, from
+      a timerfd, so that it can be used to drive 1kHz processes without
+      drift. Ticks that are missed are skipped rather than run back to
+      back
      */
-    uint64_t next_run_usec = AP_HAL::micros64() + 1000;
+    Poller poller;
+    if (!poller.init(sched->_timer_period_usec)) {
+        printf("WARNING: no timerfd, timer thread will drift\n");
+    }
     while (true) {
-        uint64_t dt = next_run_usec - AP_HAL::micros64();
-        if (dt > 2000) {
-            // we've lost sync - restart
-            next_run_usec = AP_HAL::micros64();
-        } else {
-            sched->_microsleep(dt);
+        if (sched->_thread_wait(sched->_latency[LATENCY_TIMER], poller) > 1) {
+            sched->_timer_event_missed = true;
         }
-        next_run_usec += 1000;
         // run registered timers
         sched->_run_timers(true);
 
+        // the IMU drivers have read their FIFOs, so run the rate loop
+        sched->_kick_rate_thread();
+
 #if HAL_LINUX_UARTS_ON_TIMER_THREAD
         /*
           some boards require that UART calls happen on the same
@@ -306,6 +553,53 @@ void *Scheduler::_timer_thread(void* arg)
     return NULL;
 }
 
+void Scheduler::_kick_rate_thread(void)
+{
+    if (_rate_event_fd == -1 || ++_rate_ticks < _rate_divider) {
+        return;
+    }
+    _rate_ticks = 0;
+
+    const uint64_t one = 1;
+    __atomic_store_n(&_rate_kick_us, AP_HAL::micros64(), __ATOMIC_RELAXED);
+    if (write(_rate_event_fd, &one, sizeof(one)) != sizeof(one)) {
+        _latency[LATENCY_RATE].missed(1);
+    }
+}
+
+/*
+  run the rate loop each time the timer thread has read new IMU
+  samples. Kicks that arrive while it is still running are counted
+  as missed, rather than run back to back on the same samples
+ */
+void *Scheduler::_rate_thread(void* arg)
+{
+    Scheduler* sched = (Scheduler *)arg;
+    LatencyTracker &tracker = sched->_latency[LATENCY_RATE];
+
+    prefault_stack();
+
+    while (sched->system_initializing()) {
+        poll(NULL, 0, 1);
+    }
+    while (true) {
+        tracker.done(AP_HAL::micros64());
+
+        uint64_t kicks;
+        if (read(sched->_rate_event_fd, &kicks, sizeof(kicks)) != sizeof(kicks)) {
+            continue;
+        }
+        if (kicks > 1) {
+            tracker.missed(kicks - 1);
+        }
+        tracker.wakeup(__atomic_load_n(&sched->_rate_kick_us, __ATOMIC_RELAXED),
+                       AP_HAL::micros64());
+
+        sched->_rate_proc();
+    }
+    return NULL;
+}
+
 void Scheduler::_run_io(void)
 {
     if (!_io_semaphore.take(0)) {
@@ -320,17 +614,23 @@ void Scheduler::_run_io(void)
     }
 
     _io_semaphore.give();
+
+    Util::from(hal.util)->perf_poll();
 }
 
 void *Scheduler::_rcin_thread(void *arg)
 {
     Scheduler* sched = (Scheduler *)arg;
 
+    prefault_stack();
+
     while (sched->system_initializing()) {
         poll(NULL, 0, 1);
     }
+    Poller poller;
+    poller.init(APM_LINUX_RCIN_PERIOD);
     while (true) {
-        sched->_microsleep(APM_LINUX_RCIN_PERIOD);
+        sched->_thread_wait(sched->_latency[LATENCY_RCIN], poller);
 #if !HAL_LINUX_UARTS_ON_TIMER_THREAD
         RCInput::from(hal.rcin)->_timer_tick();
 #endif
@@ -358,17 +658,38 @@ void Scheduler::_run_uarts(void)
     UARTDriver::from(hal.uartE)->_timer_tick();
 }
 
+/*
+  watch the devices of the UARTs run by _run_uarts() for input
+ */
+void Scheduler::_watch_uarts(Poller &poller)
+{
+    poller.watch(0, UARTDriver::from(hal.uartA)->get_read_fd());
+    poller.watch(1, UARTDriver::from(hal.uartB)->get_read_fd());
+    poller.watch(2, UARTDriver::from(hal.uartC)->get_read_fd());
+    poller.watch(3, UARTDriver::from(hal.uartE)->get_read_fd());
+}
+
 void *Scheduler::_uart_thread(void* arg)
 {
     Scheduler* sched = (Scheduler *)arg;
 
+    prefault_stack();
+
     while (sched->system_initializing()) {
         poll(NULL, 0, 1);
     }
+    /*
+      the UARTs are run on each period to send queued output, and as
+      soon as input arrives on any of their devices
+     */
+    Poller poller;
+    poller.init(APM_LINUX_UART_PERIOD);
     while (true) {
-        sched->_microsleep(APM_LINUX_UART_PERIOD);
+        sched->_thread_wait(sched->_latency[LATENCY_UART], poller);
 #if !HAL_LINUX_UARTS_ON_TIMER_THREAD
         _run_uarts();
+        // devices can be opened, and TCP clients accepted, by a run
+        _watch_uarts(poller);
 #endif
     }
     return NULL;
@@ -378,11 +699,15 @@ void *Scheduler::_tonealarm_thread(void* arg)
 {
     Scheduler* sched = (Scheduler *)arg;
 
+    prefault_stack();
+
     while (sched->system_initializing()) {
         poll(NULL, 0, 1);
     }
+    Poller poller;
+    poller.init(APM_LINUX_TONEALARM_PERIOD);
     while (true) {
-        sched->_microsleep(APM_LINUX_TONEALARM_PERIOD);
+        sched->_thread_wait(sched->_latency[LATENCY_TONEALARM], poller);
 
         // process tone command
         Util::from(hal.util)->_toneAlarm_timer_tick();
@@ -394,11 +719,15 @@ void *Scheduler::_io_thread(void* arg)
 {
     Scheduler* sched = (Scheduler *)arg;
 
+    prefault_stack();
+
     while (sched->system_initializing()) {
         poll(NULL, 0, 1);
     }
+    Poller poller;
+    poller.init(APM_LINUX_IO_PERIOD);
     while (true) {
-        sched->_microsleep(APM_LINUX_IO_PERIOD);
+        sched->_thread_wait(sched->_latency[LATENCY_IO], poller);
 
         // process any pending storage writes
         Storage::from(hal.storage)->_timer_tick();
@@ -4,15 +4,18 @@
 
 #include "AP_HAL_Linux.h"
 #include "Semaphores.h"
+#include "LatencyTracker.h"
+#include "Poller.h"
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
 #include <sys/time.h>
 #include <pthread.h>
+#include <sched.h>
 
 #define LINUX_SCHEDULER_MAX_TIMER_PROCS 10
 #define LINUX_SCHEDULER_MAX_IO_PROCS 10
 
-class Linux::Scheduler : public AP_HAL::Scheduler {
+class Linux::Scheduler final : public AP_HAL::Scheduler {
 
 typedef void *(*pthread_startroutine_t)(void *);
 
@@ -26,11 +29,13 @@ public:
     void     init();
     void     delay(uint16_t ms);
     void     delay_microseconds(uint16_t us);
+    void     delay_microseconds_boost(uint16_t us);
     void     register_delay_callback(AP_HAL::Proc,
                 uint16_t min_time_ms);
 
     void     register_timer_process(AP_HAL::MemberProc);
     void     register_io_process(AP_HAL::MemberProc);
+    bool     register_rate_process(AP_HAL::MemberProc, uint16_t rate_hz);
     void     suspend_timer_procs();
     void     resume_timer_procs();
 
@@ -50,6 +55,16 @@ public:
 
     uint64_t stopped_clock_usec() const { return _stopped_clock_usec; }
 
+    void     outputs_written();
+    bool     get_latency_stats(uint8_t index, latency_stats &stats);
+
+    /*
+      set the CPUs and realtime priority of a thread from a
+      name:cpus[:priority] option, such as timer:3:15 or io:0-1,
+      before init() is called. Returns false if it is not valid
+     */
+    bool     set_thread_option(const char *option);
+
 private:
     void _timer_handler(int signum);
     void _microsleep(uint32_t usec);
@@ -72,26 +87,83 @@ private:
 
     volatile bool _timer_event_missed;
 
+    // the timer thread period, shortened for a rate loop faster than 1kHz
+    uint32_t _timer_period_usec;
+
+    /*
+      the rate loop is run on its own thread, woken through an eventfd
+      by the timer thread after every _rate_divider runs of the timer
+      procs, so it always has the latest IMU samples
+     */
+    AP_HAL::MemberProc _rate_proc;
+    int _rate_event_fd;
+    uint16_t _rate_divider;
+    uint16_t _rate_ticks;
+    uint64_t _rate_kick_us;
+
     pthread_t _timer_thread_ctx;
     pthread_t _io_thread_ctx;
     pthread_t _rcin_thread_ctx;
     pthread_t _uart_thread_ctx;
     pthread_t _tonealarm_thread_ctx;
+    pthread_t _rate_thread_ctx;
 
     static void *_timer_thread(void* arg);
     static void *_io_thread(void* arg);
     static void *_rcin_thread(void* arg);
     static void *_uart_thread(void* arg);
     static void _run_uarts(void);
+    static void _watch_uarts(Poller &poller);
     static void *_tonealarm_thread(void* arg);
+    static void *_rate_thread(void* arg);
 
     void _run_timers(bool called_from_timer_thread);
+    void _kick_rate_thread(void);
     void _run_io(void);
-    void _create_realtime_thread(pthread_t *ctx, int rtprio, const char *name,
+
+    enum {
+        THREAD_MAIN = 0,
+        THREAD_TIMER,
+        THREAD_UART,
+        THREAD_RCIN,
+        THREAD_TONEALARM,
+        THREAD_IO,
+        THREAD_RATE,
+        THREAD_NUM
+    };
+
+    // where each thread runs. An empty set of CPUs leaves it to the kernel
+    struct thread_config {
+        const char *name;
+        int rtprio;
+        cpu_set_t cpus;
+    } _thread_config[THREAD_NUM];
+
+    void _create_realtime_thread(pthread_t *ctx, const thread_config &config,
+                                 const char *name,
                                  pthread_startroutine_t start_routine);
+    void _report_thread(const char *name, pthread_t ctx);
 
     uint64_t _stopped_clock_usec;
 
+    enum {
+        LATENCY_TIMER = 0,
+        LATENCY_UART,
+        LATENCY_RCIN,
+        LATENCY_TONEALARM,
+        LATENCY_IO,
+        LATENCY_RATE,
+        LATENCY_MAIN,
+        LATENCY_OUTPUT,
+        LATENCY_NUM
+    };
+    LatencyTracker _latency[LATENCY_NUM];
+
+    // when the main loop last woke for an IMU sample
+    uint64_t _sample_wake_us;
+
+    uint32_t _thread_wait(LatencyTracker &tracker, Poller &poller);
+
     Semaphore _timer_semaphore;
     Semaphore _io_semaphore;
 };
@@ -14,6 +14,9 @@ public:
     virtual ssize_t read(uint8_t *buf, uint16_t n) = 0;
     virtual void set_blocking(bool blocking) = 0;
     virtual void set_speed(uint32_t speed) = 0;
+
+    // fd that becomes readable when there is input, or -1 if none
+    virtual int get_read_fd() { return -1; }
 };
 
 #endif
@@ -6,6 +6,9 @@
 #include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/epoll.h>
 
 #include "TCPServerDevice.h"
 
@@ -20,47 +23,165 @@ TCPServerDevice::TCPServerDevice(const char *ip, uint16_t port, bool wait):
 
 TCPServerDevice::~TCPServerDevice()
 {
-    if (sock != NULL) {
+    close();
+    if (_epoll_fd != -1) {
+        ::close(_epoll_fd);
+    }
+}
+
+void TCPServerDevice::_add_client(SocketAPM *sock)
+{
+    client &c = _clients[_num_clients];
+    c.queue = new ByteBuffer(TCP_SERVER_QUEUE_SIZE);
+    if (c.queue == NULL) {
         delete sock;
-        sock = NULL;
+        return;
+    }
+    sock->set_blocking(_blocking);
+    c.sock = sock;
+    c.last_progress_ms = AP_HAL::millis();
+    c.dropped = 0;
+    _num_clients++;
+
+    struct epoll_event ev = { };
+    ev.events = EPOLLIN;
+    ev.data.fd = sock->get_read_fd();
+    epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+}
+
+void TCPServerDevice::_remove_client(uint8_t i)
+{
+    // closing the socket also removes it from the epoll set
+    delete _clients[i].sock;
+    delete _clients[i].queue;
+    _num_clients--;
+    memmove(&_clients[i], &_clients[i+1], (_num_clients - i) * sizeof(client));
+}
+
+// accept any new connections there is room for
+void TCPServerDevice::_accept(void)
+{
+    while (_num_clients < TCP_SERVER_MAX_CLIENTS) {
+        SocketAPM *sock = listener.accept(0);
+        if (sock == NULL) {
+            break;
+        }
+        _add_client(sock);
+    }
+}
+
+/*
+  send as much of a client's queue as its socket will take. Returns
+  false if the client has gone away or has stalled
+ */
+bool TCPServerDevice::_flush(client &c, uint32_t now)
+{
+    while (!c.queue->empty()) {
+        uint32_t n;
+        const uint8_t *p = c.queue->readptr(n);
+        ssize_t ret = c.sock->send(p, n);
+        if (ret < 0) {
+            if (errno != EAGAIN) {
+                return false;
+            }
+            break;
+        }
+        c.queue->advance(ret);
+        c.last_progress_ms = now;
+        if ((uint32_t)ret < n) {
+            break;
+        }
+    }
+    if (c.queue->empty()) {
+        c.last_progress_ms = now;
+    }
+    if (now - c.last_progress_ms >= TCP_SERVER_STALL_TIMEOUT_MS) {
+        ::printf("dropping stalled client on port %u, %u writes lost\n",
+                 (unsigned)_port, (unsigned)c.dropped);
+        return false;
     }
+    return true;
 }
 
 ssize_t TCPServerDevice::write(const uint8_t *buf, uint16_t n)
 {
-    if (sock == NULL) {
+    if (_num_clients == 0) {
         return -1;
     }
-    return sock->send(buf, n);
+
+    const uint32_t now = AP_HAL::millis();
+    for (int8_t i = _num_clients - 1; i >= 0; i--) {
+        client &c = _clients[i];
+        if (!_flush(c, now)) {
+            _remove_client(i);
+            continue;
+        }
+
+        // send directly when nothing is queued, keeping the order
+        ssize_t sent = 0;
+        if (c.queue->empty()) {
+            sent = c.sock->send(buf, n);
+            if (sent < 0) {
+                if (errno != EAGAIN) {
+                    _remove_client(i);
+                    continue;
+                }
+                sent = 0;
+            }
+        }
+        if (sent < n) {
+            if (c.queue->space() >= (uint32_t)(n - sent)) {
+                c.queue->write(&buf[sent], n - sent);
+            } else {
+                c.dropped++;
+            }
+        }
+    }
+
+    // the data has been taken for every client, even if some dropped it
+    return n;
 }
 
 /*
-  when we try to read we accept new connections if one isn't already
-  established
+  when we try to read we accept new connections if there is room for
+  them, and push out anything queued for slow clients
  */
 ssize_t TCPServerDevice::read(uint8_t *buf, uint16_t n)
 {
-    if (sock == NULL) {
-        sock = listener.accept(0);
-        if (sock != NULL) {
-            sock->set_blocking(_blocking);
+    _accept();
+
+    const uint32_t now = AP_HAL::millis();
+    for (int8_t i = _num_clients - 1; i >= 0; i--) {
+        if (!_flush(_clients[i], now)) {
+            _remove_client(i);
         }
     }
-    if (sock == NULL) {
-        return -1;
-    }
-    ssize_t ret = sock->recv(buf, n, 1);
-    if (ret == 0) {
-        // EOF, go back to waiting for a new connection
-        delete sock;
-        sock = NULL;
-        return -1;
+
+    uint8_t tries = _num_clients;
+    while (tries-- > 0 && _num_clients > 0) {
+        if (_reading >= _num_clients) {
+            _reading = 0;
+        }
+        ssize_t ret = _clients[_reading].sock->recv(buf, n, 0);
+        if (ret > 0) {
+            // keep reading this client until it runs dry
+            return ret;
+        }
+        if (ret == 0) {
+            // EOF, the next client moves into this slot
+            _remove_client(_reading);
+            continue;
+        }
+        _reading++;
     }
-    return ret;
+    return -1;
 }
 
 bool TCPServerDevice::open()
 {
+    // a client disconnecting while we send to it must not kill us
+    signal(SIGPIPE, SIG_IGN);
+
     listener.reuseaddress();
 
     if (!listener.bind(_ip, _port)) {
@@ -74,7 +195,7 @@ bool TCPServerDevice::open()
         return false;
     }
 
-    if (!listener.listen(1)) {
+    if (!listener.listen(TCP_SERVER_MAX_CLIENTS)) {
         if (AP_HAL::millis() - _last_bind_warning > 5000) {
             ::printf("listen failed on %s port %u - %s\n",
                      _ip,
@@ -87,14 +208,27 @@ bool TCPServerDevice::open()
 
     listener.set_blocking(false);
 
+    if (_epoll_fd == -1) {
+        _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll_fd == -1) {
+            return false;
+        }
+        struct epoll_event ev = { };
+        ev.events = EPOLLIN;
+        ev.data.fd = listener.get_read_fd();
+        epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    }
+
     if (_wait) {
         ::printf("Waiting for connection on %s:%u ....\n",
                  _ip, (unsigned)_port);
         ::fflush(stdout);
-        while (sock == NULL) {
-            sock = listener.accept(1000);
+        while (_num_clients == 0) {
+            SocketAPM *sock = listener.accept(1000);
+            if (sock != NULL) {
+                _add_client(sock);
+            }
         }
-        sock->set_blocking(_blocking);
         ::printf("connected\n");
         ::fflush(stdout);
     }
@@ -104,9 +238,8 @@ bool TCPServerDevice::open()
 
 bool TCPServerDevice::close()
 {
-    if (sock != NULL) {
-        delete sock;
-        sock = NULL;
+    while (_num_clients > 0) {
+        _remove_client(_num_clients - 1);
     }
     return true;
 }
@@ -3,7 +3,28 @@
 
 #include "SerialDevice.h"
 #include <AP_HAL/utility/Socket.h>
+#include <AP_HAL/utility/RingBuffer.h>
 
+#define TCP_SERVER_MAX_CLIENTS      4
+#define TCP_SERVER_QUEUE_SIZE       16384
+// a client that can't take any data for this long is disconnected
+#define TCP_SERVER_STALL_TIMEOUT_MS 5000
+
+/*
+  TCP server for a serial port, serving up to TCP_SERVER_MAX_CLIENTS
+  clients at once.
+
+  Output is sent to every client. Each client has its own queue for
+  data the socket can't take straight away, so one slow client doesn't
+  hold up the others. If a write doesn't fit in a client's queue it is
+  dropped for that client only, and a client that accepts nothing for
+  TCP_SERVER_STALL_TIMEOUT_MS is disconnected.
+
+  Input is read from one client at a time. The same client keeps being
+  read until it has no more data, so MAVLink packets from different
+  clients are not interleaved as long as each client sends whole
+  packets at once.
+ */
 class TCPServerDevice: public SerialDevice {
 public:
     TCPServerDevice(const char *ip, uint16_t port, bool wait);
@@ -16,14 +37,33 @@ public:
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
 
+    // an epoll set of the listener and all clients, readable when any
+    // of them is
+    virtual int get_read_fd() override { return _epoll_fd; }
+
 private:
+    struct client {
+        SocketAPM *sock;
+        ByteBuffer *queue;
+        uint32_t last_progress_ms;
+        uint32_t dropped;
+    };
+
     SocketAPM listener{false};
-    SocketAPM *sock = NULL;
+    client _clients[TCP_SERVER_MAX_CLIENTS] {};
+    uint8_t _num_clients = 0;
+    uint8_t _reading = 0;
+    int _epoll_fd = -1;
     const char *_ip;
     uint16_t _port;
     bool _wait;
     bool _blocking = false;
     uint32_t _last_bind_warning = 0;
+
+    void _accept(void);
+    void _add_client(SocketAPM *sock);
+    void _remove_client(uint8_t i);
+    bool _flush(client &c, uint32_t now);
 };
 
 #endif
@@ -195,6 +195,7 @@ void UARTDriver::_deallocate_buffers()
         - /dev/ttyO1
         - tcp:*:1243:wait
         - udp:192.168.2.15:1243
+        - udp:0.0.0.0:14550:multi
 */
 UARTDriver::device_type UARTDriver::_parseDevicePath(const char *arg)
 {
@@ -290,7 +291,8 @@ bool UARTDriver::_qflight_start_connection()
 void UARTDriver::_udp_start_connection(void)
 {
     bool bcast = (_flag && strcmp(_flag, "bcast") == 0);
-    _device = new UDPDevice(_ip, _base_port, bcast);
+    bool multi = (_flag && strcmp(_flag, "multi") == 0);
+    _device = new UDPDevice(_ip, _base_port, bcast, multi);
     _connected = _device->open();
     _device->set_blocking(false);
 
@@ -393,6 +395,50 @@ int16_t UARTDriver::read()
     return c;
 }
 
+/*
+  return the oldest bytes in the read buffer without copying them. Only
+  the run up to the end of the buffer is returned when it wraps
+ */
+uint16_t UARTDriver::peek_span(const uint8_t *&data)
+{
+    data = nullptr;
+    if (!_initialised || _readbuf == NULL) {
+        return 0;
+    }
+    return BUF_PEEK_SPAN(_readbuf, data);
+}
+
+void UARTDriver::consume(uint16_t len)
+{
+    if (_readbuf == NULL) {
+        return;
+    }
+    uint16_t _tail;
+    const uint16_t avail = BUF_AVAILABLE(_readbuf);
+    if (len > avail) {
+        len = avail;
+    }
+    BUF_ADVANCEHEAD(_readbuf, len);
+}
+
+// one slot of the ring is always left empty
+uint16_t UARTDriver::rx_capacity()
+{
+    if (_readbuf == NULL || _readbuf_size == 0) {
+        return 0;
+    }
+    return _readbuf_size - 1;
+}
+
+// copy up to len bytes out of the read buffer
+uint16_t UARTDriver::read_bytes(uint8_t *buf, uint16_t len)
+{
+    if (!_initialised || _readbuf == NULL) {
+        return 0;
+    }
+    return BUF_READ(_readbuf, buf, len);
+}
+
 /* Linux implementations of Print virtual methods */
 size_t UARTDriver::write(uint8_t c) 
 { 
@@ -28,6 +28,12 @@ public:
     int16_t txspace();
     int16_t read();
 
+    /* Linux bulk receive */
+    uint16_t peek_span(const uint8_t *&data);
+    void consume(uint16_t len);
+    uint16_t rx_capacity();
+    uint16_t read_bytes(uint8_t *buf, uint16_t len);
+
     /* Linux implementations of Print virtual methods */
     size_t write(uint8_t c);
     size_t write(const uint8_t *buffer, size_t size);
@@ -39,6 +45,9 @@ public:
 
     enum flow_control get_flow_control(void) { return _flow_control; }
 
+    // fd of the device that becomes readable on input, or -1
+    int get_read_fd(void) { return _device != nullptr ? _device->get_read_fd() : -1; }
+
 private:
     SerialDevice *_device = nullptr;
     bool _nonblocking_writes;
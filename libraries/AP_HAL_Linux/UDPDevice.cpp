@@ -3,15 +3,18 @@
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
 
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <sys/ioctl.h>
 #include <fcntl.h>
 
 #include "UDPDevice.h"
 
-UDPDevice::UDPDevice(const char *ip, uint16_t port, bool bcast):
+UDPDevice::UDPDevice(const char *ip, uint16_t port, bool bcast, bool multi):
     _ip(ip),
     _port(port),
-    _bcast(bcast)
+    _bcast(bcast),
+    _multi(multi)
 {
 }
 
@@ -21,6 +24,9 @@ UDPDevice::~UDPDevice()
 
 ssize_t UDPDevice::write(const uint8_t *buf, uint16_t n)
 {
+    if (_multi) {
+        return _write_subscribers(buf, n);
+    }
     if (!socket.pollout(0)) {
         return -1;
     }
@@ -30,9 +36,62 @@ ssize_t UDPDevice::write(const uint8_t *buf, uint16_t n)
     return socket.sendto(buf, n, _ip, _port);
 }
 
+/*
+  send a datagram to every subscriber, forgetting those that have gone
+  quiet
+ */
+ssize_t UDPDevice::_write_subscribers(const uint8_t *buf, uint16_t n)
+{
+    const uint32_t now = AP_HAL::millis();
+    for (int8_t i = _num_subscribers - 1; i >= 0; i--) {
+        subscriber &s = _subscribers[i];
+        if (now - s.last_recv_ms > UDP_SUBSCRIBER_TIMEOUT_MS) {
+            _num_subscribers--;
+            memmove(&s, &_subscribers[i+1], (_num_subscribers - i) * sizeof(s));
+            continue;
+        }
+        if (socket.sendto(buf, n, s.ip, s.port) < 0) {
+            s.dropped++;
+        }
+    }
+
+    // with no subscribers output is discarded, as it would be by the network
+    return n;
+}
+
+// add or refresh the sender of the last received packet
+void UDPDevice::_subscribe(uint32_t now)
+{
+    const char *ip;
+    uint16_t port;
+    socket.last_recv_address(ip, port);
+
+    for (uint8_t i = 0; i < _num_subscribers; i++) {
+        subscriber &s = _subscribers[i];
+        if (s.port == port && strcmp(s.ip, ip) == 0) {
+            s.last_recv_ms = now;
+            return;
+        }
+    }
+    if (_num_subscribers < UDP_MAX_SUBSCRIBERS) {
+        subscriber &s = _subscribers[_num_subscribers++];
+        strncpy(s.ip, ip, sizeof(s.ip) - 1);
+        s.ip[sizeof(s.ip) - 1] = 0;
+        s.port = port;
+        s.last_recv_ms = now;
+        s.dropped = 0;
+    }
+}
+
 ssize_t UDPDevice::read(uint8_t *buf, uint16_t n)
 {
     ssize_t ret = socket.recv(buf, n, 0);
+    if (_multi) {
+        if (ret > 0) {
+            _subscribe(AP_HAL::millis());
+        }
+        return ret;
+    }
     if (!_connected && ret > 0) {
         const char *ip;
         uint16_t port;
@@ -44,6 +103,14 @@ ssize_t UDPDevice::read(uint8_t *buf, uint16_t n)
 
 bool UDPDevice::open()
 {
+    if (_multi) {
+        socket.reuseaddress();
+        if (!socket.bind(_ip, _port)) {
+            return false;
+        }
+        socket.set_blocking(false);
+        return true;
+    }
     if (_bcast) {
         // open now, then connect on first received packet
         socket.set_broadcast();
@@ -4,15 +4,31 @@
 #include "SerialDevice.h"
 #include <AP_HAL/utility/Socket.h>
 
+#define UDP_MAX_SUBSCRIBERS         8
+// a subscriber that sends nothing for this long is forgotten
+#define UDP_SUBSCRIBER_TIMEOUT_MS   30000
+
+/*
+  UDP endpoint for a serial port. By default it talks to a single peer,
+  or to the first peer to answer a broadcast. In multi mode it binds to
+  the given address and port instead, and every peer that sends it a
+  packet becomes a subscriber which is sent all output until it has
+  been silent for UDP_SUBSCRIBER_TIMEOUT_MS. A GCS sending heartbeats
+  stays subscribed.
+
+  Sends never block. A datagram a subscriber's socket buffer can't take
+  is dropped for that subscriber only
+ */
 class UDPDevice: public SerialDevice {
 public:
-    UDPDevice(const char *ip, uint16_t port, bool bcast);
+    UDPDevice(const char *ip, uint16_t port, bool bcast, bool multi = false);
     virtual ~UDPDevice();
 
     virtual bool open() override;
     virtual bool close() override;
     virtual void set_blocking(bool blocking) override;
     virtual void set_speed(uint32_t speed) override;
+    virtual int get_read_fd() override { return socket.get_read_fd(); }
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
 private:
@@ -20,7 +36,19 @@ private:
     const char *_ip;
     uint16_t _port;
     bool _bcast;
+    bool _multi;
     bool _connected = false;
+
+    struct subscriber {
+        char ip[16];
+        uint16_t port;
+        uint32_t last_recv_ms;
+        uint32_t dropped;
+    } _subscribers[UDP_MAX_SUBSCRIBERS];
+    uint8_t _num_subscribers = 0;
+
+    void _subscribe(uint32_t now);
+    ssize_t _write_subscribers(const uint8_t *buf, uint16_t n);
 };
 
 #endif
@@ -4,6 +4,7 @@
 
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Profiler.h>
 
 #include "AP_HAL_Linux_Namespace.h"
 #include "ToneAlarmDriver.h"
@@ -69,6 +70,12 @@ public:
     void perf_begin(perf_counter_t perf) override;
     void perf_end(perf_counter_t perf) override;
     void perf_count(perf_counter_t perf) override;
+    bool perf_get_stats(uint16_t index, perf_stats &stats) override;
+    bool perf_dump_trace(const char *path) override;
+
+    // record perf_begin()/perf_end() calls for a trace written to path
+    void perf_enable_trace(const char *path) { _profiler.enable_trace(path); }
+    void perf_poll(void) { _profiler.poll(); }
 
     // create a new semaphore
     AP_HAL::Semaphore *new_semaphore(void) override { return new Linux::Semaphore; }
@@ -83,6 +90,7 @@ private:
     const char* custom_log_directory = NULL;
     const char* custom_terrain_directory = NULL;
     static const char *_hw_names[UTIL_NUM_HARDWARES];
+    Profiler _profiler;
 };
 
 
@@ -283,6 +283,58 @@ int16_t PX4UARTDriver::read()
 	return c;
 }
 
+/*
+  return the oldest bytes in the read buffer without copying them. Only
+  the run up to the end of the buffer is returned when it wraps
+ */
+uint16_t PX4UARTDriver::peek_span(const uint8_t *&data)
+{
+    data = nullptr;
+    if (_uart_owner_pid != getpid()) {
+        return 0;
+    }
+    if (!_initialised) {
+        try_initialise();
+        return 0;
+    }
+    return BUF_PEEK_SPAN(_readbuf, data);
+}
+
+void PX4UARTDriver::consume(uint16_t len)
+{
+    if (_readbuf == NULL) {
+        return;
+    }
+    uint16_t _tail;
+    const uint16_t avail = BUF_AVAILABLE(_readbuf);
+    if (len > avail) {
+        len = avail;
+    }
+    BUF_ADVANCEHEAD(_readbuf, len);
+}
+
+// one slot of the ring is always left empty
+uint16_t PX4UARTDriver::rx_capacity()
+{
+    if (_readbuf == NULL || _readbuf_size == 0) {
+        return 0;
+    }
+    return _readbuf_size - 1;
+}
+
+// copy up to len bytes out of the read buffer
+uint16_t PX4UARTDriver::read_bytes(uint8_t *buf, uint16_t len)
+{
+    if (_uart_owner_pid != getpid()) {
+        return 0;
+    }
+    if (!_initialised) {
+        try_initialise();
+        return 0;
+    }
+    return BUF_READ(_readbuf, buf, len);
+}
+
 /* 
    write one byte to the buffer
  */
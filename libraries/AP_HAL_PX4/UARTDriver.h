@@ -22,6 +22,12 @@ public:
     int16_t txspace();
     int16_t read();
 
+    /* PX4 bulk receive */
+    uint16_t peek_span(const uint8_t *&data);
+    void consume(uint16_t len);
+    uint16_t rx_capacity();
+    uint16_t read_bytes(uint8_t *buf, uint16_t len);
+
     /* PX4 implementations of Print virtual methods */
     size_t write(uint8_t c);
     size_t write(const uint8_t *buffer, size_t size);
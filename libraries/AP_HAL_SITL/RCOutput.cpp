@@ -45,9 +45,73 @@ void SITLRCOutput::disable_ch(uint8_t ch)
 
 void SITLRCOutput::write(uint8_t ch, uint16_t period_us)
 {
-    if (ch < SITL_NUM_CHANNELS) {
-        _sitlState->pwm_output[ch] = period_us;
+    if (ch >= SITL_NUM_CHANNELS) {
+        return;
+    }
+    if (_dshot_mask & (1U << ch)) {
+        _dshot_loopback(ch, period_us);
+        return;
+    }
+    _sitlState->pwm_output[ch] = period_us;
+}
+
+void SITLRCOutput::set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm)
+{
+    _esc_min_pwm = min_pwm;
+    _esc_max_pwm = max_pwm;
+}
+
+bool SITLRCOutput::set_output_mode(uint32_t chmask, enum output_mode mode)
+{
+    Debug("set_output_mode(0x%04x, %u)\n", (unsigned)chmask, (unsigned)mode);
+    if (mode == MODE_PWM_NORMAL) {
+        _dshot_mask &= ~chmask;
+        return true;
+    }
+
+    DShot::timing t;
+    if (!DShot::get_timing(mode, SITL_DSHOT_TICK_HZ, t)) {
+        return false;
+    }
+    for (uint8_t ch = 0; ch < SITL_NUM_CHANNELS; ch++) {
+        if (chmask & (1U << ch)) {
+            _dshot_timing[ch] = t;
+            _dshot_mask |= 1U << ch;
+        }
+    }
+    return true;
+}
+
+/*
+  generate the frame a DShot ESC would be sent and decode it as the ESC
+  would, checking the timing of every bit. The simulated motor gets the
+  throttle the ESC would see, including the loss of resolution
+ */
+void SITLRCOutput::_dshot_loopback(uint8_t ch, uint16_t period_us)
+{
+    const DShot::timing &t = _dshot_timing[ch];
+    const uint16_t sent = DShot::packet(DShot::pwm_to_value(period_us, _esc_min_pwm, _esc_max_pwm), false);
+
+    uint32_t high[DShot::FRAME_BITS];
+    uint32_t period[DShot::FRAME_BITS];
+    DShot::encode(sent, t, high);
+    for (uint8_t i = 0; i < DShot::FRAME_BITS; i++) {
+        period[i] = t.bit_ticks;
+    }
+
+    uint16_t received;
+    uint16_t value;
+    bool telem;
+    if (!DShot::decode(high, period, t, received) ||
+        !DShot::decode_packet(received, value, telem) ||
+        received != sent) {
+        // the ESC would ignore the frame and keep its last throttle
+        _dshot_errors++;
+        ::printf("DShot frame error on channel %u (%u errors)\n",
+                 (unsigned)ch + 1, (unsigned)_dshot_errors);
+        return;
     }
+    _sitlState->pwm_output[ch] = DShot::value_to_pwm(value, _esc_min_pwm, _esc_max_pwm);
 }
 
 uint16_t SITLRCOutput::read(uint8_t ch)
@@ -5,6 +5,10 @@
 #include <AP_HAL/AP_HAL.h>
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include "AP_HAL_SITL.h"
+#include <AP_HAL/utility/DShot.h>
+
+// clock the DShot loopback measures the bitstream with
+#define SITL_DSHOT_TICK_HZ 1000000000UL
 
 class HALSITL::SITLRCOutput : public AP_HAL::RCOutput {
 public:
@@ -20,11 +24,22 @@ public:
     void     write(uint8_t ch, uint16_t period_us) override;
     uint16_t read(uint8_t ch) override;
     void     read(uint16_t* period_us, uint8_t len) override;
+    void     set_esc_scaling(uint16_t min_pwm, uint16_t max_pwm) override;
+    bool     set_output_mode(uint32_t chmask, enum output_mode mode) override;
 
 private:
     SITL_State *_sitlState;
     uint16_t _freq_hz;
     uint16_t _enable_mask;
+
+    // channels sending DShot, and the timing of each
+    uint32_t _dshot_mask = 0;
+    DShot::timing _dshot_timing[SITL_NUM_CHANNELS];
+    uint16_t _esc_min_pwm = 1000;
+    uint16_t _esc_max_pwm = 2000;
+    uint32_t _dshot_errors = 0;
+
+    void _dshot_loopback(uint8_t ch, uint16_t period_us);
 };
 
 #endif
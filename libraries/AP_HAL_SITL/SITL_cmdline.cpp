@@ -8,6 +8,7 @@
 #include "AP_HAL_SITL_Namespace.h"
 #include "HAL_SITL_Class.h"
 #include "UARTDriver.h"
+#include "Util.h"
 #include <stdio.h>
 #include <signal.h>
 #include <unistd.h>
@@ -55,6 +56,7 @@ void SITL_State::_usage(void)
            "\t--uartC device     set device string for UARTC\n"
            "\t--uartD device     set device string for UARTD\n"
            "\t--uartE device     set device string for UARTE\n"
+           "\t--perf-trace FILE  write a trace of perf counters at exit and on SIGUSR1\n"
         );
 }
 
@@ -120,6 +122,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_UARTD,
         CMDLINE_UARTE,
         CMDLINE_ADSB,
+        CMDLINE_PERF_TRACE,
     };
 
     const struct GetOptLong::option options[] = {
@@ -142,6 +145,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"gimbal",          false,  0, CMDLINE_GIMBAL},
         {"adsb",            false,  0, CMDLINE_ADSB},
         {"autotest-dir",    true,   0, CMDLINE_AUTOTESTDIR},
+        {"perf-trace",      true,   0, CMDLINE_PERF_TRACE},
         {0, false, 0, 0}
     };
 
@@ -197,6 +201,9 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_AUTOTESTDIR:
             autotest_dir = strdup(gopt.optarg);
             break;
+        case CMDLINE_PERF_TRACE:
+            static_cast<SITLUtil *>(hal.util)->perf_enable_trace(gopt.optarg);
+            break;
 
         case CMDLINE_UARTA:
         case CMDLINE_UARTB:
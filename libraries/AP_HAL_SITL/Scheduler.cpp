@@ -5,6 +5,7 @@
 
 #include "AP_HAL_SITL.h"
 #include "Scheduler.h"
+#include "Util.h"
 #include <sys/time.h>
 #include <unistd.h>
 #include <fenv.h>
@@ -212,6 +213,8 @@ void SITLScheduler::_run_io_procs(bool called_from_isr)
         _timer_event_missed = true;
     }
 
+    static_cast<SITLUtil *>(hal.util)->perf_poll();
+
     _in_io_proc = false;
 }
 
@@ -3,6 +3,7 @@
 #define __AP_HAL_SITL_UTIL_H__
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/Profiler.h>
 #include "AP_HAL_SITL_Namespace.h"
 #include "Semaphores.h"
 
@@ -22,6 +23,26 @@ public:
 
     // create a new semaphore
     AP_HAL::Semaphore *new_semaphore(void) override { return new HALSITL::Semaphore; }
+
+    perf_counter_t perf_alloc(perf_counter_type t, const char *name) override {
+        return _profiler.alloc(t, name);
+    }
+    void perf_begin(perf_counter_t h) override { _profiler.begin(h); }
+    void perf_end(perf_counter_t h) override { _profiler.end(h); }
+    void perf_count(perf_counter_t h) override { _profiler.count(h); }
+    bool perf_get_stats(uint16_t index, perf_stats &stats) override {
+        return _profiler.get_stats(index, stats);
+    }
+    bool perf_dump_trace(const char *path) override {
+        return _profiler.dump_trace(path);
+    }
+
+    // record perf_begin()/perf_end() calls for a trace written to path
+    void perf_enable_trace(const char *path) { _profiler.enable_trace(path); }
+    void perf_poll(void) { _profiler.poll(); }
+
+private:
+    Profiler _profiler;
 };
 
 #endif // __AP_HAL_SITL_UTIL_H__
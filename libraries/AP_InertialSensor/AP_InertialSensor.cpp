@@ -6,6 +6,7 @@
 
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/AP_HAL_Static.h>
 #include <AP_Notify/AP_Notify.h>
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <AP_Math/AP_Math.h>
@@ -309,6 +310,11 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
     // @User: Advanced
     // @Values: 1:IMU 1,2:IMU 2,3:IMU 3
     AP_GROUPINFO("ACC_BODYFIX", 26, AP_InertialSensor, _acc_body_aligned, 2),
+
+    // @Group: HNTCH_
+    // @Path: ../Filter/HarmonicNotchFilter.cpp
+    AP_SUBGROUPINFO(_harmonic_notch_filter, "HNTCH_", 27, AP_InertialSensor, HarmonicNotchFilterParams),
+
     /*
       NOTE: parameter indexes have gaps above. When adding new
       parameters check for conflicts carefully
@@ -332,6 +338,7 @@ AP_InertialSensor::AP_InertialSensor() :
     _calibrating(false),
     _log_raw_data(false),
     _backends_detected(false),
+    _calculated_harmonic_notch_freq_hz(0),
     _dataflash(NULL),
     _accel_cal_requires_reboot(false)
 {
@@ -360,6 +367,11 @@ AP_InertialSensor::AP_InertialSensor() :
         _delta_angle_acc[i].zero();
         _last_delta_angle[i].zero();
         _last_raw_gyro[i].zero();
+
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+        _raw_gyro_buffer[i].count = 0;
+        _raw_accel_buffer[i].count = 0;
+#endif
     }
     for (uint8_t i=0; i<INS_VIBRATION_CHECK_INSTANCES; i++) {
         _accel_vibe_floor_filter[i].set_cutoff_frequency(AP_INERTIAL_SENSOR_ACCEL_VIBE_FLOOR_FILT_HZ);
@@ -989,7 +1001,7 @@ void AP_InertialSensor::wait_for_sample(void)
     if (_next_sample_usec - now <=_sample_period_usec) {
         // we're ahead on time, schedule next sample at expected period
         uint32_t wait_usec = _next_sample_usec - now;
-        hal.scheduler->delay_microseconds_boost(wait_usec);
+        HAL_SCHEDULER->delay_microseconds_boost(wait_usec);
         uint32_t now2 = AP_HAL::micros();
         if (now2+100 < _next_sample_usec) {
             timing_printf("shortsleep %u\n", (unsigned)(_next_sample_usec-now2));
@@ -1401,3 +1413,94 @@ bool AP_InertialSensor::get_primary_accel_cal_sample_avg(uint8_t sample_num, Vec
     ret.rotate(_board_orientation);
     return true;
 }
+
+/*
+  set the base frequency of the gyro harmonic notch. The notch is never
+  moved below the configured base frequency
+ */
+void AP_InertialSensor::update_harmonic_notch_freq_hz(float center_freq_hz)
+{
+    _calculated_harmonic_notch_freq_hz = MAX(center_freq_hz, _harmonic_notch_filter.center_freq_hz());
+}
+
+/*
+  return the base frequency the gyro harmonic notch is currently placed on
+ */
+float AP_InertialSensor::get_harmonic_notch_freq_hz(void) const
+{
+    if (_harmonic_notch_filter.tracking_mode() == HarmonicNotchFilterParams::TRACKING_FIXED ||
+        _calculated_harmonic_notch_freq_hz <= 0.0f) {
+        return _harmonic_notch_filter.center_freq_hz();
+    }
+    return _calculated_harmonic_notch_freq_hz;
+}
+
+/*
+  store raw samples from a backend for high-rate consumers
+ */
+void AP_InertialSensor::_push_raw_gyro_samples(uint8_t instance, const Vector3f *samples, uint16_t count)
+{
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    _push_raw_samples(_raw_gyro_buffer[instance], samples, count);
+#endif
+}
+
+void AP_InertialSensor::_push_raw_accel_samples(uint8_t instance, const Vector3f *samples, uint16_t count)
+{
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    _push_raw_samples(_raw_accel_buffer[instance], samples, count);
+#endif
+}
+
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+void AP_InertialSensor::_push_raw_samples(raw_sample_buffer &buf, const Vector3f *samples, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        buf.samples[(buf.count + i) & (INS_RAW_SAMPLE_BUFFER_SIZE - 1)] = samples[i];
+    }
+    buf.count += count;
+}
+
+uint16_t AP_InertialSensor::_copy_raw_samples(const raw_sample_buffer &buf, uint32_t &sample_index,
+                                              Vector3f *samples, uint16_t max_samples)
+{
+    // the buffer is filled from the timer thread
+    hal.scheduler->suspend_timer_procs();
+
+    uint32_t available = buf.count - sample_index;
+    if (available > INS_RAW_SAMPLE_BUFFER_SIZE) {
+        // the caller has fallen behind, skip to the oldest sample we have
+        sample_index = buf.count - INS_RAW_SAMPLE_BUFFER_SIZE;
+        available = INS_RAW_SAMPLE_BUFFER_SIZE;
+    }
+    if (available > max_samples) {
+        available = max_samples;
+    }
+    for (uint16_t i = 0; i < available; i++) {
+        samples[i] = buf.samples[(sample_index + i) & (INS_RAW_SAMPLE_BUFFER_SIZE - 1)];
+    }
+    sample_index += available;
+
+    hal.scheduler->resume_timer_procs();
+
+    return available;
+}
+
+uint16_t AP_InertialSensor::get_raw_gyro_samples(uint8_t instance, uint32_t &sample_index,
+                                                 Vector3f *samples, uint16_t max_samples)
+{
+    if (instance >= _gyro_count) {
+        return 0;
+    }
+    return _copy_raw_samples(_raw_gyro_buffer[instance], sample_index, samples, max_samples);
+}
+
+uint16_t AP_InertialSensor::get_raw_accel_samples(uint8_t instance, uint32_t &sample_index,
+                                                  Vector3f *samples, uint16_t max_samples)
+{
+    if (instance >= _accel_count) {
+        return 0;
+    }
+    return _copy_raw_samples(_raw_accel_buffer[instance], sample_index, samples, max_samples);
+}
+#endif // INS_RAW_SAMPLE_BUFFER_SIZE
@@ -21,11 +21,23 @@
 
 #include <stdint.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/SeqLock.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_AccelCal/AP_AccelCal.h>
 #include "AP_InertialSensor_UserInteract.h"
 #include <Filter/LowPassFilter.h>
 #include <Filter/LowPassFilter2p.h>
+#include <Filter/HarmonicNotchFilter.h>
+
+/*
+  number of raw (rotated and corrected but unfiltered) samples kept per
+  instance for high-rate consumers. Must be a power of 2
+ */
+#if HAL_CPU_CLASS >= HAL_CPU_CLASS_150
+#define INS_RAW_SAMPLE_BUFFER_SIZE 64
+#else
+#define INS_RAW_SAMPLE_BUFFER_SIZE 0
+#endif
 
 class AP_InertialSensor_Backend;
 class AuxiliaryBus;
@@ -121,6 +133,7 @@ public:
     bool get_gyro_health(void) const { return get_gyro_health(_primary_gyro); }
     bool get_gyro_health_all(void) const;
     uint8_t get_gyro_count(void) const { return _gyro_count; }
+    uint16_t get_gyro_raw_sample_rate(uint8_t instance) const { return (instance<_gyro_count) ? _gyro_raw_sample_rates[instance] : 0; }
     bool gyro_calibrated_ok(uint8_t instance) const { return _gyro_cal_ok[instance]; }
     bool gyro_calibrated_ok_all() const;
     bool use_gyro(uint8_t instance) const;
@@ -248,6 +261,33 @@ public:
     void acal_update();
 
     bool accel_cal_requires_reboot() const { return _accel_cal_requires_reboot; }
+
+    // harmonic notch filter on the gyros. The vehicle feeds the tracked
+    // base frequency from the configured source at its loop rate
+    const HarmonicNotchFilterParams &get_gyro_harmonic_notch_params(void) const { return _harmonic_notch_filter; }
+    void update_harmonic_notch_freq_hz(float center_freq_hz);
+    float get_harmonic_notch_freq_hz(void) const;
+
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    /*
+      high-rate raw sample access. Copies up to max_samples raw samples
+      received after sample_index into samples[] and advances
+      sample_index. If the caller has fallen more than
+      INS_RAW_SAMPLE_BUFFER_SIZE samples behind the oldest samples are
+      skipped. Returns the number of samples copied
+     */
+    uint16_t get_raw_gyro_samples(uint8_t instance, uint32_t &sample_index, Vector3f *samples, uint16_t max_samples);
+    uint16_t get_raw_accel_samples(uint8_t instance, uint32_t &sample_index, Vector3f *samples, uint16_t max_samples);
+#endif
+
+    /*
+      the latest filtered sample of the primary gyro, as it is read by
+      the drivers rather than as published by update(), for a rate loop
+      running on its own thread. Returns false if there is no sample
+      yet, or it could not be read without waiting for the driver
+     */
+    bool get_latest_gyro(Vector3f &gyro) const { return _latest_gyro.read(gyro); }
+
 private:
 
     // load backend drivers
@@ -296,6 +336,12 @@ private:
     LowPassFilter2pVector3f _gyro_filter[INS_MAX_INSTANCES];
     Vector3f _accel_filtered[INS_MAX_INSTANCES];
     Vector3f _gyro_filtered[INS_MAX_INSTANCES];
+
+    // harmonic notch filters for gyro, applied at the raw sample rate
+    // before the low pass filter
+    HarmonicNotchFilterParams _harmonic_notch_filter;
+    HarmonicNotchFilterVector3f _gyro_harmonic_notch_filter[INS_MAX_INSTANCES];
+    float _calculated_harmonic_notch_freq_hz;
     bool _new_accel_data[INS_MAX_INSTANCES];
     bool _new_gyro_data[INS_MAX_INSTANCES];
     
@@ -307,6 +353,9 @@ private:
     Vector3f _last_delta_angle[INS_MAX_INSTANCES];
     Vector3f _last_raw_gyro[INS_MAX_INSTANCES];
 
+    // filtered primary gyro, handed to a rate loop thread by the drivers
+    SeqLock<Vector3f> _latest_gyro;
+
     // product id
     AP_Int16 _product_id;
 
@@ -420,6 +469,24 @@ private:
     bool _new_trim;
 
     bool _accel_cal_requires_reboot;
+
+    // store raw samples for high-rate consumers (called by backends)
+    void _push_raw_gyro_samples(uint8_t instance, const Vector3f *samples, uint16_t count);
+    void _push_raw_accel_samples(uint8_t instance, const Vector3f *samples, uint16_t count);
+
+#if INS_RAW_SAMPLE_BUFFER_SIZE
+    struct raw_sample_buffer {
+        Vector3f samples[INS_RAW_SAMPLE_BUFFER_SIZE];
+        // total number of samples ever pushed
+        uint32_t count;
+    };
+    raw_sample_buffer _raw_gyro_buffer[INS_MAX_INSTANCES];
+    raw_sample_buffer _raw_accel_buffer[INS_MAX_INSTANCES];
+
+    static void _push_raw_samples(raw_sample_buffer &buf, const Vector3f *samples, uint16_t count);
+    uint16_t _copy_raw_samples(const raw_sample_buffer &buf, uint32_t &sample_index,
+                               Vector3f *samples, uint16_t max_samples);
+#endif
 };
 
 #include "AP_InertialSensor_Backend.h"
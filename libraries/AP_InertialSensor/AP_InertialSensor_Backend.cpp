@@ -10,7 +10,14 @@ const extern AP_HAL::HAL& hal;
 AP_InertialSensor_Backend::AP_InertialSensor_Backend(AP_InertialSensor &imu) :
     _imu(imu),
     _product_id(AP_PRODUCT_ID_NONE)
-{}
+{
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        _harmonic_notch_active[i] = false;
+        _last_harmonic_notch_bandwidth_hz[i] = 0;
+        _last_harmonic_notch_attenuation_dB[i] = 0;
+        _last_harmonic_notch_harmonics[i] = 0;
+    }
+}
 
 void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vector3f &accel) 
 {
@@ -40,6 +47,36 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     gyro.rotate(_imu._board_orientation);
 }
 
+/*
+  block versions of the rotate and correct functions. The calibration
+  values are loaded once for the whole block of samples
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vector3f *accel, uint16_t count)
+{
+    const Vector3f accel_offset = _imu._accel_offset[instance].get();
+    const Vector3f accel_scale = _imu._accel_scale[instance].get();
+    const enum Rotation rotation = _imu._board_orientation;
+
+    for (uint16_t i = 0; i < count; i++) {
+        Vector3f &a = accel[i];
+        a.x = (a.x - accel_offset.x) * accel_scale.x;
+        a.y = (a.y - accel_offset.y) * accel_scale.y;
+        a.z = (a.z - accel_offset.z) * accel_scale.z;
+        a.rotate(rotation);
+    }
+}
+
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vector3f *gyro, uint16_t count)
+{
+    const Vector3f gyro_offset = _imu._gyro_offset[instance].get();
+    const enum Rotation rotation = _imu._board_orientation;
+
+    for (uint16_t i = 0; i < count; i++) {
+        gyro[i] -= gyro_offset;
+        gyro[i].rotate(rotation);
+    }
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -92,12 +129,23 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     _imu._last_delta_angle[instance] = delta_angle;
     _imu._last_raw_gyro[instance] = gyro;
 
-    _imu._gyro_filtered[instance] = _imu._gyro_filter[instance].apply(gyro);
+    Vector3f gyro_notched = gyro;
+    if (_harmonic_notch_active[instance]) {
+        gyro_notched = _imu._gyro_harmonic_notch_filter[instance].apply(gyro);
+    }
+
+    _imu._gyro_filtered[instance] = _imu._gyro_filter[instance].apply(gyro_notched);
     if (_imu._gyro_filtered[instance].is_nan() || _imu._gyro_filtered[instance].is_inf()) {
         _imu._gyro_filter[instance].reset();
+        _imu._gyro_harmonic_notch_filter[instance].reset();
     }
 
     _imu._new_gyro_data[instance] = true;
+    if (instance == _imu._primary_gyro) {
+        _imu._latest_gyro.write(_imu._gyro_filtered[instance]);
+    }
+
+    _imu._push_raw_gyro_samples(instance, &gyro, 1);
 
     DataFlash_Class *dataflash = get_dataflash();
     if (dataflash != NULL) {
@@ -114,6 +162,79 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     }
 }
 
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance,
+                                                             const Vector3f *gyro,
+                                                             uint16_t count,
+                                                             uint64_t last_sample_us)
+{
+    if (count == 0 || _imu._gyro_raw_sample_rates[instance] <= 0) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+
+    // integrate delta angle with coning correction, as in
+    // _notify_new_gyro_raw_sample(), keeping the state local for the block
+    Vector3f delta_angle_acc = _imu._delta_angle_acc[instance];
+    Vector3f last_delta_angle = _imu._last_delta_angle[instance];
+    Vector3f last_raw_gyro = _imu._last_raw_gyro[instance];
+
+    for (uint16_t i = 0; i < count; i++) {
+        Vector3f delta_angle = (gyro[i] + last_raw_gyro) * 0.5f * dt;
+        Vector3f delta_coning = (delta_angle_acc + last_delta_angle * (1.0f / 6.0f));
+        delta_coning = delta_coning % delta_angle;
+        delta_coning *= 0.5f;
+        delta_angle_acc += delta_angle + delta_coning;
+        last_delta_angle = delta_angle;
+        last_raw_gyro = gyro[i];
+    }
+
+    _imu._delta_angle_acc[instance] = delta_angle_acc;
+    _imu._last_delta_angle[instance] = last_delta_angle;
+    _imu._last_raw_gyro[instance] = last_raw_gyro;
+
+    if (_harmonic_notch_active[instance]) {
+        HarmonicNotchFilterVector3f &notch = _imu._gyro_harmonic_notch_filter[instance];
+        LowPassFilter2pVector3f &lpf = _imu._gyro_filter[instance];
+        for (uint16_t i = 0; i < count; i++) {
+            _imu._gyro_filtered[instance] = lpf.apply(notch.apply(gyro[i]));
+        }
+    } else {
+        _imu._gyro_filtered[instance] = _imu._gyro_filter[instance].apply_block(gyro, count);
+    }
+    if (_imu._gyro_filtered[instance].is_nan() || _imu._gyro_filtered[instance].is_inf()) {
+        _imu._gyro_filter[instance].reset();
+        _imu._gyro_harmonic_notch_filter[instance].reset();
+    }
+
+    _imu._new_gyro_data[instance] = true;
+    if (instance == _imu._primary_gyro) {
+        _imu._latest_gyro.write(_imu._gyro_filtered[instance]);
+    }
+
+    _imu._push_raw_gyro_samples(instance, gyro, count);
+
+    DataFlash_Class *dataflash = get_dataflash();
+    if (dataflash != NULL) {
+        uint64_t now = AP_HAL::micros64();
+        if (last_sample_us == 0) {
+            last_sample_us = now;
+        }
+        const uint32_t dt_us = 1000000UL / _imu._gyro_raw_sample_rates[instance];
+        for (uint16_t i = 0; i < count; i++) {
+            struct log_GYRO pkt = {
+                LOG_PACKET_HEADER_INIT((uint8_t)(LOG_GYR1_MSG+instance)),
+                time_us   : now,
+                sample_us : last_sample_us - (uint64_t)(count - 1 - i) * dt_us,
+                GyrX      : gyro[i].x,
+                GyrY      : gyro[i].y,
+                GyrZ      : gyro[i].z
+            };
+            dataflash->WriteBlock(&pkt, sizeof(pkt));
+        }
+    }
+}
+
 /*
   rotate accel vector, scale and add the accel offset
  */
@@ -178,6 +299,8 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 
     _imu._new_accel_data[instance] = true;
 
+    _imu._push_raw_accel_samples(instance, &accel, 1);
+
     DataFlash_Class *dataflash = get_dataflash();
     if (dataflash != NULL) {
         uint64_t now = AP_HAL::micros64();
@@ -193,6 +316,59 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
     }
 }
 
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance,
+                                                              const Vector3f *accel,
+                                                              uint16_t count,
+                                                              uint64_t last_sample_us)
+{
+    if (count == 0 || _imu._accel_raw_sample_rates[instance] <= 0) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+
+    Vector3f delta_velocity = Vector3f();
+    for (uint16_t i = 0; i < count; i++) {
+        _imu.calc_vibration_and_clipping(instance, accel[i], dt);
+        delta_velocity += accel[i];
+    }
+
+    // delta velocity
+    _imu._delta_velocity_acc[instance] += delta_velocity * dt;
+    _imu._delta_velocity_acc_dt[instance] += dt * count;
+
+    _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply_block(accel, count);
+    if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+        _imu._accel_filter[instance].reset();
+    }
+
+    _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+
+    _imu._new_accel_data[instance] = true;
+
+    _imu._push_raw_accel_samples(instance, accel, count);
+
+    DataFlash_Class *dataflash = get_dataflash();
+    if (dataflash != NULL) {
+        uint64_t now = AP_HAL::micros64();
+        if (last_sample_us == 0) {
+            last_sample_us = now;
+        }
+        const uint32_t dt_us = 1000000UL / _imu._accel_raw_sample_rates[instance];
+        for (uint16_t i = 0; i < count; i++) {
+            struct log_ACCEL pkt = {
+                LOG_PACKET_HEADER_INIT((uint8_t)(LOG_ACC1_MSG+instance)),
+                time_us   : now,
+                sample_us : last_sample_us - (uint64_t)(count - 1 - i) * dt_us,
+                AccX      : accel[i].x,
+                AccY      : accel[i].y,
+                AccZ      : accel[i].z
+            };
+            dataflash->WriteBlock(&pkt, sizeof(pkt));
+        }
+    }
+}
+
 void AP_InertialSensor_Backend::_set_accel_max_abs_offset(uint8_t instance,
                                                           float max_offset)
 {
@@ -244,9 +420,43 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
         _last_gyro_filter_hz[instance] = _gyro_filter_cutoff();
     }
 
+    update_harmonic_notch(instance);
+
     hal.scheduler->resume_timer_procs();
 }
 
+/*
+  (re)configure the gyro harmonic notch for an instance and move it to
+  the latest tracked frequency. Called with timer procs suspended
+ */
+void AP_InertialSensor_Backend::update_harmonic_notch(uint8_t instance)
+{
+    const HarmonicNotchFilterParams &params = _imu._harmonic_notch_filter;
+
+    if (!params.enabled() || _gyro_raw_sample_rate(instance) == 0) {
+        _harmonic_notch_active[instance] = false;
+        return;
+    }
+
+    const float center_freq_hz = _imu.get_harmonic_notch_freq_hz();
+
+    HarmonicNotchFilterVector3f &notch = _imu._gyro_harmonic_notch_filter[instance];
+
+    if (!_harmonic_notch_active[instance] ||
+        !is_equal(_last_harmonic_notch_bandwidth_hz[instance], params.bandwidth_hz()) ||
+        !is_equal(_last_harmonic_notch_attenuation_dB[instance], params.attenuation_dB()) ||
+        _last_harmonic_notch_harmonics[instance] != params.harmonics()) {
+        notch.init(_gyro_raw_sample_rate(instance), center_freq_hz,
+                   params.bandwidth_hz(), params.attenuation_dB(), params.harmonics());
+        _last_harmonic_notch_bandwidth_hz[instance] = params.bandwidth_hz();
+        _last_harmonic_notch_attenuation_dB[instance] = params.attenuation_dB();
+        _last_harmonic_notch_harmonics[instance] = params.harmonics();
+        _harmonic_notch_active[instance] = true;
+    } else {
+        notch.update(center_freq_hz);
+    }
+}
+
 /*
   common accel update function for all backends
  */
@@ -73,6 +73,10 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel);
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro);
 
+    // rotate and correct a contiguous block of samples from one sensor
+    void _rotate_and_correct_accel(uint8_t instance, Vector3f *accel, uint16_t count);
+    void _rotate_and_correct_gyro(uint8_t instance, Vector3f *gyro, uint16_t count);
+
     // rotate gyro vector, offset and publish
     void _publish_gyro(uint8_t instance, const Vector3f &gyro);
 
@@ -82,6 +86,11 @@ protected:
     // be rotated and corrected (_rotate_and_correct_gyro)
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0);
 
+    // block version of _notify_new_gyro_raw_sample() for drivers that read
+    // a burst of samples at once (e.g. from a FIFO). The samples must be in
+    // time order and last_sample_us is the timestamp of the last one
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint16_t count, uint64_t last_sample_us=0);
+
     // rotate accel vector, scale, offset and publish
     void _publish_accel(uint8_t instance, const Vector3f &accel);
 
@@ -91,6 +100,9 @@ protected:
     // be rotated and corrected (_rotate_and_correct_accel)
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0);
 
+    // block version of _notify_new_accel_raw_sample()
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint16_t count, uint64_t last_sample_us=0);
+
     // set accelerometer max absolute offset for calibration
     void _set_accel_max_abs_offset(uint8_t instance, float offset);
 
@@ -142,6 +154,13 @@ protected:
     // support for updating filter at runtime
     int8_t _last_accel_filter_hz[INS_MAX_INSTANCES];
     int8_t _last_gyro_filter_hz[INS_MAX_INSTANCES];
+
+    // support for updating the gyro harmonic notch at runtime
+    void update_harmonic_notch(uint8_t instance);
+    bool _harmonic_notch_active[INS_MAX_INSTANCES];
+    float _last_harmonic_notch_bandwidth_hz[INS_MAX_INSTANCES];
+    float _last_harmonic_notch_attenuation_dB[INS_MAX_INSTANCES];
+    uint8_t _last_harmonic_notch_harmonics[INS_MAX_INSTANCES];
     
     // note that each backend is also expected to have a static detect()
     // function which instantiates an instance of the backend sensor
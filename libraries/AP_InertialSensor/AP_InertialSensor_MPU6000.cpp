@@ -654,44 +654,51 @@ void AP_InertialSensor_MPU6000::_poll_data(void)
 
 void AP_InertialSensor_MPU6000::_accumulate(uint8_t *samples, uint8_t n_samples)
 {
+    Vector3f accel[MPU6000_MAX_FIFO_SAMPLES];
+    Vector3f gyro[MPU6000_MAX_FIFO_SAMPLES];
+
+    if (n_samples > MPU6000_MAX_FIFO_SAMPLES) {
+        n_samples = MPU6000_MAX_FIFO_SAMPLES;
+    }
+
     for(uint8_t i=0; i < n_samples; i++) {
         uint8_t *data = samples + MPU6000_SAMPLE_SIZE * i;
-        Vector3f accel, gyro;
         float temp;
 
-        accel = Vector3f(int16_val(data, 1),
-                         int16_val(data, 0),
-                         -int16_val(data, 2));
-        accel *= MPU6000_ACCEL_SCALE_1G;
+        accel[i] = Vector3f(int16_val(data, 1),
+                            int16_val(data, 0),
+                            -int16_val(data, 2));
+        accel[i] *= MPU6000_ACCEL_SCALE_1G;
 
-        gyro = Vector3f(int16_val(data, 5),
-                        int16_val(data, 4),
-                        -int16_val(data, 6));
-        gyro *= _gyro_scale;
+        gyro[i] = Vector3f(int16_val(data, 5),
+                           int16_val(data, 4),
+                           -int16_val(data, 6));
+        gyro[i] *= _gyro_scale;
 
         temp = int16_val(data, 3);
         /* scaling/offset values from the datasheet */
         temp = temp/340 + 36.53;
 
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_PXF
-        accel.rotate(ROTATION_PITCH_180_YAW_90);
-        gyro.rotate(ROTATION_PITCH_180_YAW_90);
+        accel[i].rotate(ROTATION_PITCH_180_YAW_90);
+        gyro[i].rotate(ROTATION_PITCH_180_YAW_90);
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
-        accel.rotate(ROTATION_YAW_270);
-        gyro.rotate(ROTATION_YAW_270);
+        accel[i].rotate(ROTATION_YAW_270);
+        gyro[i].rotate(ROTATION_YAW_270);
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_MINLURE
-        accel.rotate(ROTATION_YAW_90);
-        gyro.rotate(ROTATION_YAW_90);
+        accel[i].rotate(ROTATION_YAW_90);
+        gyro[i].rotate(ROTATION_YAW_90);
 #endif
 
-        _rotate_and_correct_accel(_accel_instance, accel);
-        _rotate_and_correct_gyro(_gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(_accel_instance, accel);
-        _notify_new_gyro_raw_sample(_gyro_instance, gyro);
-
         _temp_filtered = _temp_filter.apply(temp);
     }
+
+    // correct and publish the whole FIFO burst at once
+    _rotate_and_correct_accel(_accel_instance, accel, n_samples);
+    _rotate_and_correct_gyro(_gyro_instance, gyro, n_samples);
+
+    _notify_new_accel_raw_samples(_accel_instance, accel, n_samples);
+    _notify_new_gyro_raw_samples(_gyro_instance, gyro, n_samples);
 }
 
 void AP_InertialSensor_MPU6000::_read_data_transaction()
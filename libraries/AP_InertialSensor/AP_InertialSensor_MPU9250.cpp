@@ -77,6 +77,11 @@ extern const AP_HAL::HAL& hal;
 #define MPUREG_ZRMOT_THR                                0x21    // detection threshold for Zero Motion interrupt generation.
 #define MPUREG_ZRMOT_DUR                                0x22    // duration counter threshold for Zero Motion interrupt generation. The duration counter ticks at 16 Hz, therefore ZRMOT_DUR has a unit of 1 LSB = 64 ms.
 #define MPUREG_FIFO_EN                                  0x23
+#       define BIT_TEMP_FIFO_EN                                 0x80
+#       define BIT_XG_FIFO_EN                                   0x40
+#       define BIT_YG_FIFO_EN                                   0x20
+#       define BIT_ZG_FIFO_EN                                   0x10
+#       define BIT_ACCEL_FIFO_EN                                0x08
 #define MPUREG_INT_PIN_CFG                              0x37
 #       define BIT_INT_RD_CLEAR                                 0x10    // clear the interrupt when any read occurs
 #       define BIT_LATCH_INT_EN                                 0x20    // latch data ready pin
@@ -181,6 +186,14 @@ extern const AP_HAL::HAL& hal;
 #define DEFAULT_SMPLRT_DIV MPUREG_SMPLRT_1000HZ
 #define DEFAULT_SAMPLE_RATE (1000 / (DEFAULT_SMPLRT_DIV + 1))
 
+/*
+ * With DLPF_CFG set to BITS_DLPF_CFG_256HZ_NOLPF2 the internal sample rate
+ * is 8kHz and SMPLRT_DIV is ignored. The data registers are simply
+ * overwritten at that rate, but the FIFO receives every sample
+ */
+#define FIFO_SAMPLE_RATE 8000
+#define MPU9250_FIFO_SIZE 512
+
 /*
  *  PS-MPU-9250A-00.pdf, page 8, lists LSB sensitivity of
  *  gyro as 16.4 LSB/DPS at scale factor of +/- 2000dps (FS_SEL==3)
@@ -201,16 +214,33 @@ extern const AP_HAL::HAL& hal;
  */
 #define MPU9250_SAMPLE_SIZE 14
 
+/*
+ * a FIFO read which finds more than this many samples waiting is counted
+ * as late, as it was at risk of overflowing
+ */
+#define MPU9250_FIFO_LATE_SAMPLES (MPU9250_FIFO_SIZE / MPU9250_SAMPLE_SIZE / 2)
+
 /* SPI bus driver implementation */
 AP_MPU9250_BusDriver_SPI::AP_MPU9250_BusDriver_SPI(AP_HAL::SPIDeviceDriver *spi)
 {
     _spi = spi;
+    _fifo_tx = nullptr;
+    _fifo_rx = nullptr;
 }
 
 void AP_MPU9250_BusDriver_SPI::init()
 {
     // disable I2C as recommended by the datasheet
     write8(MPUREG_USER_CTRL, BIT_USER_CTRL_I2C_IF_DIS);
+
+    if (_fifo_tx == nullptr) {
+        // register address followed by the largest burst we read
+        const uint16_t len = 1 + MPU9250_MAX_FIFO_SAMPLES * MPU9250_SAMPLE_SIZE;
+        _fifo_tx = new uint8_t[len];
+        _fifo_rx = new uint8_t[len];
+        memset(_fifo_tx, 0, len);
+        _fifo_tx[0] = MPUREG_FIFO_R_W | 0x80;
+    }
 }
 
 void AP_MPU9250_BusDriver_SPI::read8(uint8_t reg, uint8_t *val)
@@ -279,6 +309,71 @@ bool AP_MPU9250_BusDriver_SPI::read_data_transaction(uint8_t *samples, uint8_t &
     return true;
 }
 
+void AP_MPU9250_BusDriver_SPI::_reset_fifo()
+{
+    uint8_t user_ctrl;
+
+    read8(MPUREG_USER_CTRL, &user_ctrl);
+    write8(MPUREG_USER_CTRL, user_ctrl | BIT_USER_CTRL_FIFO_RESET);
+}
+
+/*
+  read all complete samples from the FIFO. The interrupt status and FIFO
+  count are fetched in one bus request, followed by one bulk transfer
+  for the samples themselves
+ */
+bool AP_MPU9250_BusDriver_SPI::read_fifo(const uint8_t *&samples, uint8_t &n_samples, uint16_t &n_dropped)
+{
+    n_samples = 0;
+    n_dropped = 0;
+
+    if (_fifo_tx == nullptr || _fifo_rx == nullptr) {
+        return false;
+    }
+
+    uint8_t status_tx[2] = { MPUREG_INT_STATUS | 0x80, 0 };
+    uint8_t status_rx[2];
+    uint8_t count_tx[3] = { MPUREG_FIFO_COUNTH | 0x80, 0, 0 };
+    uint8_t count_rx[3];
+    const AP_HAL::SPIDeviceDriver::Transfer transfers[] = {
+        { status_tx, status_rx, sizeof(status_tx) },
+        { count_tx, count_rx, sizeof(count_tx) },
+    };
+
+    if (!_spi->transactions(transfers, ARRAY_SIZE(transfers))) {
+        return false;
+    }
+
+    uint16_t bytes = ((uint16_t)count_rx[1] << 8) | count_rx[2];
+
+    if ((status_rx[1] & BIT_FIFO_OFLOW_INT) ||
+        bytes > MPU9250_FIFO_SIZE - MPU9250_SAMPLE_SIZE) {
+        // the FIFO has wrapped, so its contents can no longer be
+        // trusted to be sample aligned. Throw them away
+        n_dropped = bytes / MPU9250_SAMPLE_SIZE;
+        _reset_fifo();
+        return false;
+    }
+
+    uint16_t available = bytes / MPU9250_SAMPLE_SIZE;
+    if (available == 0) {
+        return false;
+    }
+    if (available > MPU9250_MAX_FIFO_SAMPLES) {
+        // leave the rest for the next read
+        available = MPU9250_MAX_FIFO_SAMPLES;
+    }
+
+    if (!_spi->transaction(_fifo_tx, _fifo_rx, 1 + available * MPU9250_SAMPLE_SIZE)) {
+        return false;
+    }
+
+    samples = &_fifo_rx[1];
+    n_samples = available;
+
+    return true;
+}
+
 AP_HAL::Semaphore* AP_MPU9250_BusDriver_SPI::get_semaphore()
 {
     return _spi->get_semaphore();
@@ -363,6 +458,11 @@ bool AP_MPU9250_BusDriver_I2C::has_auxiliary_bus()
 AP_InertialSensor_MPU9250::AP_InertialSensor_MPU9250(AP_InertialSensor &imu, AP_MPU9250_BusDriver *bus) :
 	AP_InertialSensor_Backend(imu),
     _bus(bus),
+    _fifo_mode(false),
+    _fifo_dropped_samples(0),
+    _fifo_late_reads(0),
+    _perf_dropped(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "MPU9250_dropped")),
+    _perf_late(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "MPU9250_late")),
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_PXF
     _default_rotation(ROTATION_ROLL_180_YAW_270)
 #elif CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_NAVIO
@@ -434,8 +534,13 @@ bool AP_InertialSensor_MPU9250::_init_sensor()
     if (!_hardware_init())
         return false;
 
-    _gyro_instance = _imu.register_gyro(DEFAULT_SAMPLE_RATE);
-    _accel_instance = _imu.register_accel(DEFAULT_SAMPLE_RATE);
+    if (_fifo_mode) {
+        _gyro_instance = _imu.register_gyro(FIFO_SAMPLE_RATE);
+        _accel_instance = _imu.register_accel(FIFO_SAMPLE_RATE);
+    } else {
+        _gyro_instance = _imu.register_gyro(DEFAULT_SAMPLE_RATE);
+        _accel_instance = _imu.register_accel(DEFAULT_SAMPLE_RATE);
+    }
 
     _product_id = AP_PRODUCT_ID_MPU9250;
 
@@ -475,7 +580,11 @@ void AP_InertialSensor_MPU9250::_poll_data(void)
         */
         return;
     }
-    _read_data_transaction();
+    if (_fifo_mode) {
+        _read_fifo();
+    } else {
+        _read_data_transaction();
+    }
     _bus_sem->give();
 }
 
@@ -487,30 +596,80 @@ void AP_InertialSensor_MPU9250::_read_data_transaction()
     uint8_t n_samples;
     uint8_t rx[MPU9250_SAMPLE_SIZE];
 
-    Vector3f accel, gyro;
-
     if (!_bus->read_data_transaction(rx, n_samples)) {
         return;
     }
 
+    _accumulate(rx, 1);
+}
+
+/*
+  read all pending samples from the FIFO in one burst
+ */
+void AP_InertialSensor_MPU9250::_read_fifo()
+{
+    const uint8_t *samples = nullptr;
+    uint8_t n_samples;
+    uint16_t n_dropped;
+
+    bool ok = _bus->read_fifo(samples, n_samples, n_dropped);
+
+    if (n_dropped > 0) {
+        _fifo_dropped_samples += n_dropped;
+        hal.util->perf_count(_perf_dropped);
+        _set_gyro_error_count(_gyro_instance, _fifo_dropped_samples);
+        _set_accel_error_count(_accel_instance, _fifo_dropped_samples);
+    }
+
+    if (!ok) {
+        return;
+    }
+
+    if (n_samples > MPU9250_FIFO_LATE_SAMPLES) {
+        _fifo_late_reads++;
+        hal.util->perf_count(_perf_late);
+    }
+
+    _accumulate(samples, n_samples);
+}
+
+/*
+  convert a block of raw samples and pass them to the frontend. The last
+  sample is taken to have been measured now
+ */
+void AP_InertialSensor_MPU9250::_accumulate(const uint8_t *samples, uint8_t n_samples)
+{
+    Vector3f accel[MPU9250_MAX_FIFO_SAMPLES];
+    Vector3f gyro[MPU9250_MAX_FIFO_SAMPLES];
+    uint64_t now = AP_HAL::micros64();
+
+    if (n_samples > MPU9250_MAX_FIFO_SAMPLES) {
+        n_samples = MPU9250_MAX_FIFO_SAMPLES;
+    }
+
 #define int16_val(v, idx) ((int16_t)(((uint16_t)v[2*idx] << 8) | v[2*idx+1]))
 
-    accel = Vector3f(int16_val(rx, 1),
-                     int16_val(rx, 0),
-                     -int16_val(rx, 2));
-    accel *= MPU9250_ACCEL_SCALE_1G;
-    accel.rotate(_default_rotation);
-    _rotate_and_correct_accel(_accel_instance, accel);
-    _notify_new_accel_raw_sample(_accel_instance, accel);
+    for (uint8_t i = 0; i < n_samples; i++) {
+        const uint8_t *data = samples + MPU9250_SAMPLE_SIZE * i;
+
+        accel[i] = Vector3f(int16_val(data, 1),
+                            int16_val(data, 0),
+                            -int16_val(data, 2));
+        accel[i] *= MPU9250_ACCEL_SCALE_1G;
+        accel[i].rotate(_default_rotation);
 
-    gyro = Vector3f(int16_val(rx, 5),
-                    int16_val(rx, 4),
-                    -int16_val(rx, 6));
-    gyro *= GYRO_SCALE;
-    gyro.rotate(_default_rotation);
+        gyro[i] = Vector3f(int16_val(data, 5),
+                           int16_val(data, 4),
+                           -int16_val(data, 6));
+        gyro[i] *= GYRO_SCALE;
+        gyro[i].rotate(_default_rotation);
+    }
+
+    _rotate_and_correct_accel(_accel_instance, accel, n_samples);
+    _notify_new_accel_raw_samples(_accel_instance, accel, n_samples, now);
 
-    _rotate_and_correct_gyro(_gyro_instance, gyro);
-    _notify_new_gyro_raw_sample(_gyro_instance, gyro);
+    _rotate_and_correct_gyro(_gyro_instance, gyro, n_samples);
+    _notify_new_gyro_raw_samples(_gyro_instance, gyro, n_samples, now);
 }
 
 /*
@@ -622,6 +781,18 @@ bool AP_InertialSensor_MPU9250::_hardware_init(void)
     value |= BIT_INT_RD_CLEAR | BIT_LATCH_INT_EN;
     _register_write(MPUREG_INT_PIN_CFG, value);
 
+    if (_bus->has_fifo()) {
+        // queue accel, temperature and gyro samples in the FIFO, in the
+        // same order as the data registers, so we can read them in bursts
+        _register_write(MPUREG_INT_ENABLE, BIT_RAW_RDY_EN | BIT_FIFO_OFLOW_EN);
+        _register_write(MPUREG_FIFO_EN, BIT_ACCEL_FIFO_EN | BIT_TEMP_FIFO_EN |
+                        BIT_XG_FIFO_EN | BIT_YG_FIFO_EN | BIT_ZG_FIFO_EN);
+        value = _register_read(MPUREG_USER_CTRL);
+        _register_write(MPUREG_USER_CTRL, value | BIT_USER_CTRL_FIFO_RESET);
+        _register_write(MPUREG_USER_CTRL, value | BIT_USER_CTRL_FIFO_EN);
+        _fifo_mode = true;
+    }
+
     // now that we have initialized, we set the SPI bus speed to high
     _bus->set_bus_speed(AP_HAL::SPIDeviceDriver::SPI_SPEED_HIGH);
 
@@ -17,6 +17,9 @@ class AP_MPU9250_AuxiliaryBusSlave;
 // enable debug to see a register dump on startup
 #define MPU9250_DEBUG 0
 
+// maximum number of samples read from the FIFO in one bulk transfer
+#define MPU9250_MAX_FIFO_SAMPLES 32
+
 class AP_MPU9250_BusDriver
 {
 public:
@@ -30,6 +33,16 @@ public:
                                        uint8_t &n_samples) = 0;
     virtual AP_HAL::Semaphore* get_semaphore() = 0;
     virtual bool has_auxiliary_bus() = 0;
+
+    /*
+      FIFO support. If has_fifo() returns true the sensor is read with
+      read_fifo() which returns up to MPU9250_MAX_FIFO_SAMPLES samples
+      per call, pointing samples at the bus driver's buffer. n_dropped
+      is set to the number of samples discarded because of a FIFO
+      overflow
+     */
+    virtual bool has_fifo() { return false; }
+    virtual bool read_fifo(const uint8_t *&samples, uint8_t &n_samples, uint16_t &n_dropped) { return false; }
 };
 
 class AP_InertialSensor_MPU9250 : public AP_InertialSensor_Backend
@@ -73,10 +86,23 @@ private:
     AP_HAL::Semaphore *_bus_sem;
     AP_MPU9250_AuxiliaryBus *_auxiliar_bus = nullptr;
 
+    void                 _read_fifo();
+    void                 _accumulate(const uint8_t *samples, uint8_t n_samples);
+
     // gyro and accel instances
     uint8_t _gyro_instance;
     uint8_t _accel_instance;
 
+    // are samples read in bursts from the FIFO?
+    bool _fifo_mode;
+
+    // FIFO accounting: samples lost to overflows and reads that found
+    // the FIFO more than half full
+    uint32_t _fifo_dropped_samples;
+    uint32_t _fifo_late_reads;
+    AP_HAL::Util::perf_counter_t _perf_dropped;
+    AP_HAL::Util::perf_counter_t _perf_late;
+
     // The default rotation for the IMU, its value depends on how the IMU is
     // placed by default on the system
     enum Rotation _default_rotation;
@@ -98,9 +124,15 @@ public:
     bool read_data_transaction(uint8_t* samples, uint8_t &n_samples);
     AP_HAL::Semaphore* get_semaphore();
     bool has_auxiliary_bus();
+    bool has_fifo() override { return true; }
+    bool read_fifo(const uint8_t *&samples, uint8_t &n_samples, uint16_t &n_dropped) override;
 
 private:
+    void _reset_fifo();
+
     AP_HAL::SPIDeviceDriver *_spi;
+    uint8_t *_fifo_tx;
+    uint8_t *_fifo_rx;
 };
 
 class AP_MPU9250_BusDriver_I2C : public AP_MPU9250_BusDriver
@@ -151,8 +151,12 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
 
 	Vector2f _groundspeed_vector = _ahrs.groundspeed_vector();
 
+    // take all offsets in one plane about the aircraft, so the
+    // longitude scale is only calculated once
+    const LocationFrame frame(_current_loc);
+
 	// update _target_bearing_cd
-	_target_bearing_cd = get_bearing_cd(_current_loc, next_WP);
+	_target_bearing_cd = frame.bearing_cd(next_WP);
 	
 	//Calculate groundspeed
 	float groundSpeed = _groundspeed_vector.length();
@@ -169,12 +173,12 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
 	_L1_dist = 0.3183099f * _L1_damping * _L1_period * groundSpeed;
 	
 	// Calculate the NE position of WP B relative to WP A
-    Vector2f AB = location_diff(prev_WP, next_WP);
+    Vector2f AB = frame.ne(prev_WP, next_WP);
 	
 	// Check for AB zero length and track directly to the destination
 	// if too small
 	if (AB.length() < 1.0e-6f) {
-		AB = location_diff(_current_loc, next_WP);
+		AB = frame.ne(next_WP);
         if (AB.length() < 1.0e-6f) {
             AB = Vector2f(cosf(_ahrs.yaw), sinf(_ahrs.yaw));
         }
@@ -182,7 +186,7 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
 	AB.normalize();
 
 	// Calculate the NE position of the aircraft relative to WP A
-    Vector2f A_air = location_diff(prev_WP, _current_loc);
+    Vector2f A_air = -frame.ne(prev_WP);
 
 	// calculate distance to target track, for reporting
 	_crosstrack_error = A_air % AB;
@@ -274,8 +278,10 @@ void AP_L1_Control::update_loiter(const struct Location &center_WP, float radius
 	float groundSpeed = MAX(_groundspeed_vector.length() , 1.0f);
 
 
+    const LocationFrame frame(_current_loc);
+
 	// update _target_bearing_cd
-	_target_bearing_cd = get_bearing_cd(_current_loc, center_WP);
+	_target_bearing_cd = frame.bearing_cd(center_WP);
 
 
 	// Calculate time varying control parameters
@@ -284,7 +290,7 @@ void AP_L1_Control::update_loiter(const struct Location &center_WP, float radius
 	_L1_dist = 0.3183099f * _L1_damping * _L1_period * groundSpeed;
 
 	//Calculate the NE position of the aircraft relative to WP A
-    Vector2f A_air = location_diff(center_WP, _current_loc);
+    Vector2f A_air = -frame.ne(center_WP);
 
     // Calculate the unit vector from WP A to aircraft
     // protect against being on the waypoint and having zero velocity
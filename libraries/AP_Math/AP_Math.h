@@ -16,6 +16,7 @@
 #include "quaternion.h"
 #include "polygon.h"
 #include "edc.h"
+#include "location_frame.h"
 #include "float.h"
 #include <AP_Param/AP_Param.h>
 
@@ -0,0 +1,54 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+#define NUM_LOCATIONS 16
+
+static void setup_locations(Location &origin, Location *locs)
+{
+    memset(&origin, 0, sizeof(origin));
+    origin.lat = -353632610;
+    origin.lng = 1491652300;
+    for (uint8_t i = 0; i < NUM_LOCATIONS; i++) {
+        locs[i] = origin;
+        locs[i].lat += i * 1733;
+        locs[i].lng -= i * 2917;
+    }
+}
+
+// distances from one location to a list, as in AP_Rally and AP_ADSB
+static void BM_LocationDiff(benchmark::State& state)
+{
+    Location origin;
+    Location locs[NUM_LOCATIONS];
+    Vector2f ne[NUM_LOCATIONS];
+    setup_locations(origin, locs);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&origin);
+        for (uint8_t i = 0; i < NUM_LOCATIONS; i++) {
+            ne[i] = location_diff(origin, locs[i]);
+        }
+        gbenchmark_escape(ne);
+    }
+}
+
+static void BM_LocationFrame(benchmark::State& state)
+{
+    Location origin;
+    Location locs[NUM_LOCATIONS];
+    Vector2f ne[NUM_LOCATIONS];
+    setup_locations(origin, locs);
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&origin);
+        const LocationFrame frame(origin);
+        frame.ne(locs, ne, NUM_LOCATIONS);
+        gbenchmark_escape(ne);
+    }
+}
+
+BENCHMARK(BM_LocationDiff);
+BENCHMARK(BM_LocationFrame);
+
+BENCHMARK_MAIN()
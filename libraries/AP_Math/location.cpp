@@ -148,6 +148,92 @@ Vector2f location_diff(const struct Location &loc1, const struct Location &loc2)
                     (loc2.lng - loc1.lng) * LOCATION_SCALING_FACTOR * longitude_scale(loc1));
 }
 
+LocationFrame::LocationFrame() :
+    _lng_scale(1.0f),
+    _lng_to_m(LOCATION_SCALING_FACTOR),
+    _m_to_lng(LOCATION_SCALING_FACTOR_INV)
+{
+    memset(&_origin, 0, sizeof(_origin));
+}
+
+LocationFrame::LocationFrame(const struct Location &origin)
+{
+    // force the scale to be calculated
+    _origin.lat = origin.lat + 1;
+    set_origin(origin);
+}
+
+void LocationFrame::set_origin(const struct Location &origin)
+{
+    if (origin.lat != _origin.lat) {
+        _lng_scale = constrain_float(cosf(origin.lat * 1.0e-7f * DEG_TO_RAD), 0.01f, 1.0f);
+        _lng_to_m = LOCATION_SCALING_FACTOR * _lng_scale;
+        _m_to_lng = LOCATION_SCALING_FACTOR_INV / _lng_scale;
+    }
+    _origin = origin;
+}
+
+// wrap a longitude, or a difference of two, to -180..180 degrees
+static int32_t wrap_lng(int64_t lng)
+{
+    if (lng > 1800000000LL) {
+        lng -= 3600000000LL;
+    } else if (lng < -1800000000LL) {
+        lng += 3600000000LL;
+    }
+    return (int32_t)lng;
+}
+
+// longitude difference from the origin, the short way round
+int32_t LocationFrame::lng_diff(int32_t lng) const
+{
+    return wrap_lng((int64_t)lng - _origin.lng);
+}
+
+Vector2f LocationFrame::ne(const struct Location &loc) const
+{
+    return Vector2f((loc.lat - _origin.lat) * LOCATION_SCALING_FACTOR,
+                    lng_diff(loc.lng) * _lng_to_m);
+}
+
+Vector2f LocationFrame::ne(const struct Location &loc1, const struct Location &loc2) const
+{
+    // difference the integer longitudes before scaling, so close locations far from the origin stay accurate
+    return Vector2f((loc2.lat - loc1.lat) * LOCATION_SCALING_FACTOR,
+                    wrap_lng((int64_t)loc2.lng - loc1.lng) * _lng_to_m);
+}
+
+struct Location LocationFrame::location(const Vector2f &ne) const
+{
+    struct Location loc = _origin;
+    loc.lat += (int32_t)roundf(ne.x * LOCATION_SCALING_FACTOR_INV);
+    loc.lng = wrap_lng((int64_t)loc.lng + (int32_t)roundf(ne.y * _m_to_lng));
+    return loc;
+}
+
+int32_t LocationFrame::bearing_cd(const struct Location &loc) const
+{
+    const Vector2f ofs = ne(loc);
+    int32_t bearing = atan2f(ofs.y, ofs.x) * 5729.57795f;
+    if (bearing < 0) bearing += 36000;
+    return bearing;
+}
+
+void LocationFrame::ne(const struct Location *locs, Vector2f *ne, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        ne[i].x = (locs[i].lat - _origin.lat) * LOCATION_SCALING_FACTOR;
+        ne[i].y = lng_diff(locs[i].lng) * _lng_to_m;
+    }
+}
+
+void LocationFrame::locations(const Vector2f *ne, struct Location *locs, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        locs[i] = location(ne[i]);
+    }
+}
+
 /*
   wrap an angle in centi-degrees to 0..35999
  */
@@ -0,0 +1,54 @@
+/// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/*
+  local North/East tangent plane about an origin location.
+
+  The longitude scale of the origin is worked out once, when the origin
+  is set, so conversions to and from the plane need no trigonometry.
+  Use one where several locations are compared with the same location,
+  such as the vehicle's position against a list of waypoints.
+
+  Offsets are taken between integer latitudes and longitudes before
+  they are scaled, and longitude differences are wrapped across the
+  date line, so precision is kept far from the origin
+ */
+class LocationFrame {
+public:
+    LocationFrame();
+    explicit LocationFrame(const struct Location &origin);
+
+    // move the origin. The longitude scale is only recalculated if the latitude changed
+    void set_origin(const struct Location &origin);
+    const struct Location &get_origin() const { return _origin; }
+
+    // the longitude scale at the origin, as longitude_scale()
+    float longitude_scale() const { return _lng_scale; }
+
+    // distance in meters in the North/East plane from the origin to loc
+    Vector2f ne(const struct Location &loc) const;
+
+    // distance in meters in the North/East plane from loc1 to loc2
+    Vector2f ne(const struct Location &loc1, const struct Location &loc2) const;
+
+    // location at a North/East offset in meters from the origin, at the origin's altitude
+    struct Location location(const Vector2f &ne) const;
+
+    // distance in meters and bearing in centi-degrees from the origin to loc
+    float distance(const struct Location &loc) const { return ne(loc).length(); }
+    int32_t bearing_cd(const struct Location &loc) const;
+
+    // convert count locations at once, to and from the plane
+    void ne(const struct Location *locs, Vector2f *ne, uint16_t count) const;
+    void locations(const Vector2f *ne, struct Location *locs, uint16_t count) const;
+
+private:
+    int32_t lng_diff(int32_t lng) const;
+
+    struct Location _origin;
+    float _lng_scale;
+
+    // meters per 1e-7 degrees of longitude at the origin, and its inverse
+    float _lng_to_m;
+    float _m_to_lng;
+};
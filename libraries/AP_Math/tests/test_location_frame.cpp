@@ -0,0 +1,103 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+
+static Location make_loc(int32_t lat, int32_t lng)
+{
+    Location loc = {};
+    loc.lat = lat;
+    loc.lng = lng;
+    return loc;
+}
+
+static const Location origin = make_loc(-353632610, 1491652300);
+
+// agrees with the per call helpers near the origin
+TEST(LocationFrameTest, MatchesHelpers)
+{
+    const LocationFrame frame(origin);
+    const Location loc = make_loc(origin.lat + 12345, origin.lng - 23456);
+
+    const Vector2f expected = location_diff(origin, loc);
+    const Vector2f ne = frame.ne(loc);
+    EXPECT_NEAR(expected.x, ne.x, 1.0e-3f);
+    EXPECT_NEAR(expected.y, ne.y, 1.0e-3f);
+    EXPECT_NEAR(get_distance(origin, loc), frame.distance(loc), 0.01f);
+    EXPECT_NEAR(get_bearing_cd(origin, loc), frame.bearing_cd(loc), 1);
+    EXPECT_FLOAT_EQ(longitude_scale(origin), frame.longitude_scale());
+}
+
+TEST(LocationFrameTest, RoundTrip)
+{
+    const LocationFrame frame(origin);
+    const Vector2f ne(1234.5f, -678.9f);
+
+    const Location loc = frame.location(ne);
+    const Vector2f back = frame.ne(loc);
+    EXPECT_NEAR(ne.x, back.x, 0.01f);
+    EXPECT_NEAR(ne.y, back.y, 0.01f);
+
+    Location offset = origin;
+    location_offset(offset, ne.x, ne.y);
+    EXPECT_NEAR(offset.lat, loc.lat, 1);
+    EXPECT_NEAR(offset.lng, loc.lng, 1);
+}
+
+// two close locations far from the origin keep their separation
+TEST(LocationFrameTest, FarFromOrigin)
+{
+    const LocationFrame frame(origin);
+    const Location loc1 = make_loc(origin.lat + 100000000, origin.lng + 100000000);
+    const Location loc2 = make_loc(loc1.lat + 3, loc1.lng + 4);
+
+    const Vector2f ne = frame.ne(loc1, loc2);
+    EXPECT_NEAR(3 * 0.011131884502145034f, ne.x, 1.0e-6f);
+    EXPECT_NEAR(4 * 0.011131884502145034f * frame.longitude_scale(), ne.y, 1.0e-6f);
+}
+
+TEST(LocationFrameTest, DateLine)
+{
+    const LocationFrame frame(make_loc(0, 1799999000));
+    const Location loc = make_loc(0, -1799999000);
+
+    const Vector2f ne = frame.ne(loc);
+    EXPECT_NEAR(2000 * 0.011131884502145034f, ne.y, 1.0e-3f);
+
+    const Location back = frame.location(ne);
+    EXPECT_EQ(loc.lng, back.lng);
+}
+
+// two locations either side of the date line, seen from the other side of the world
+TEST(LocationFrameTest, DateLineFarFromOrigin)
+{
+    const LocationFrame frame(make_loc(0, 0));
+    const Location loc1 = make_loc(0, 1799999000);
+    const Location loc2 = make_loc(0, -1799999000);
+
+    EXPECT_NEAR(2000 * 0.011131884502145034f, frame.ne(loc1, loc2).y, 1.0e-3f);
+    EXPECT_NEAR(-2000 * 0.011131884502145034f, frame.ne(loc2, loc1).y, 1.0e-3f);
+}
+
+TEST(LocationFrameTest, Batch)
+{
+    LocationFrame frame;
+    frame.set_origin(origin);
+
+    Location locs[4];
+    Vector2f ne[4];
+    Location back[4];
+    for (uint8_t i = 0; i < 4; i++) {
+        locs[i] = make_loc(origin.lat + i * 1000, origin.lng - i * 2000);
+    }
+    frame.ne(locs, ne, 4);
+    frame.locations(ne, back, 4);
+    for (uint8_t i = 0; i < 4; i++) {
+        const Vector2f single = frame.ne(locs[i]);
+        EXPECT_FLOAT_EQ(single.x, ne[i].x);
+        EXPECT_FLOAT_EQ(single.y, ne[i].y);
+        EXPECT_EQ(locs[i].lat, back[i].lat);
+        EXPECT_EQ(locs[i].lng, back[i].lng);
+    }
+}
+
+AP_GTEST_MAIN()
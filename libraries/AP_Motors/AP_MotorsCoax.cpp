@@ -111,12 +111,12 @@ void AP_MotorsCoax::enable()
 void AP_MotorsCoax::output_min()
 {
     // send minimum value to each motor
-    hal.rcout->cork();
+    rc_cork();
     rc_write(AP_MOTORS_MOT_1, _servo1.radio_trim);
     rc_write(AP_MOTORS_MOT_2, _servo2.radio_trim);
     rc_write(AP_MOTORS_MOT_3, _throttle_radio_min);
     rc_write(AP_MOTORS_MOT_4, _throttle_radio_min);
-    hal.rcout->push();
+    rc_push();
 }
 
 void AP_MotorsCoax::output_armed_not_stabilizing()
@@ -156,12 +156,12 @@ void AP_MotorsCoax::output_armed_not_stabilizing()
         motor_out = apply_thrust_curve_and_volt_scaling(motor_out, out_min, _throttle_radio_max);
     }
 
-    hal.rcout->cork();
+    rc_cork();
     rc_write(AP_MOTORS_MOT_1, _servo1.radio_out);
     rc_write(AP_MOTORS_MOT_2, _servo2.radio_out);
     rc_write(AP_MOTORS_MOT_3, motor_out);
     rc_write(AP_MOTORS_MOT_4, motor_out);
-    hal.rcout->push();
+    rc_push();
 }
 
 // sends commands to the motors
@@ -216,12 +216,12 @@ void AP_MotorsCoax::output_armed_stabilizing()
     motor_out[AP_MOTORS_MOT_4] = MAX(motor_out[AP_MOTORS_MOT_4],    out_min);
 
     // send output to each motor
-    hal.rcout->cork();
+    rc_cork();
     rc_write(AP_MOTORS_MOT_1, _servo1.radio_out);
     rc_write(AP_MOTORS_MOT_2, _servo2.radio_out);
     rc_write(AP_MOTORS_MOT_3, motor_out[AP_MOTORS_MOT_3]);
     rc_write(AP_MOTORS_MOT_4, motor_out[AP_MOTORS_MOT_4]);
-    hal.rcout->push();
+    rc_push();
 }
 
 // output_disarmed - sends commands to the motors
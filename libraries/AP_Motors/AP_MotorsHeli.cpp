@@ -21,6 +21,7 @@
  */
 #include <stdlib.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/AP_HAL_Static.h>
 #include "AP_MotorsHeli.h"
 #include <GCS_MAVLink/GCS.h>
 
@@ -203,6 +204,9 @@ void AP_MotorsHeli::output()
     // update throttle filter
     update_throttle_filter();
 
+    // send all the outputs below in one transaction
+    rc_cork();
+
     if (_flags.armed) {
         calculate_armed_scalars();
         if (!_flags.interlock) {
@@ -215,6 +219,9 @@ void AP_MotorsHeli::output()
     } else {
         output_disarmed();
     }
+
+    rc_push();
+    HAL_SCHEDULER->outputs_written();
 };
 
 // sends commands to the motors
@@ -435,7 +435,7 @@ void AP_MotorsHeli_Single::move_actuators(int16_t roll_out, int16_t pitch_out, i
     _swash_servo_2.calc_pwm();
     _swash_servo_3.calc_pwm();
 
-    hal.rcout->cork();
+    rc_cork();
 
     // actually move the servos
     rc_write(AP_MOTORS_MOT_1, _swash_servo_1.radio_out);
@@ -445,7 +445,7 @@ void AP_MotorsHeli_Single::move_actuators(int16_t roll_out, int16_t pitch_out, i
     // update the yaw rate using the tail rotor/servo
     move_yaw(yaw_out + yaw_offset);
 
-    hal.rcout->push();
+    rc_push();
 }
 
 // move_yaw
@@ -24,11 +24,262 @@
 
 extern const AP_HAL::HAL& hal;
 
+const AP_Param::GroupInfo AP_MotorsMatrix::var_info[] = {
+    // variables from parent vehicle
+    AP_NESTEDGROUPINFO(AP_MotorsMulticopter, 0),
+
+    // parameters 1 ~ 29 were reserved for tradheli
+    // parameters 30 ~ 39 reserved for tricopter
+    // parameters 40 ~ 49 for single copter and coax copter (these have identical parameter files)
+    // parameters 50 ~ 61 for the custom frame of matrix copters
+
+    // @Param: MIX1_X
+    // @DisplayName: Custom frame output 1 roll factor
+    // @Description: Roll factor of output 1 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX1_Y
+    // @DisplayName: Custom frame output 1 pitch factor
+    // @Description: Pitch factor of output 1 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX1_Z
+    // @DisplayName: Custom frame output 1 yaw factor
+    // @Description: Yaw factor of output 1 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX1", 50, AP_MotorsMatrix, _custom_factors[0], 0),
+
+    // @Param: MIX2_X
+    // @DisplayName: Custom frame output 2 roll factor
+    // @Description: Roll factor of output 2 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX2_Y
+    // @DisplayName: Custom frame output 2 pitch factor
+    // @Description: Pitch factor of output 2 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX2_Z
+    // @DisplayName: Custom frame output 2 yaw factor
+    // @Description: Yaw factor of output 2 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX2", 51, AP_MotorsMatrix, _custom_factors[1], 0),
+
+    // @Param: MIX3_X
+    // @DisplayName: Custom frame output 3 roll factor
+    // @Description: Roll factor of output 3 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX3_Y
+    // @DisplayName: Custom frame output 3 pitch factor
+    // @Description: Pitch factor of output 3 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX3_Z
+    // @DisplayName: Custom frame output 3 yaw factor
+    // @Description: Yaw factor of output 3 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX3", 52, AP_MotorsMatrix, _custom_factors[2], 0),
+
+    // @Param: MIX4_X
+    // @DisplayName: Custom frame output 4 roll factor
+    // @Description: Roll factor of output 4 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX4_Y
+    // @DisplayName: Custom frame output 4 pitch factor
+    // @Description: Pitch factor of output 4 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX4_Z
+    // @DisplayName: Custom frame output 4 yaw factor
+    // @Description: Yaw factor of output 4 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX4", 53, AP_MotorsMatrix, _custom_factors[3], 0),
+
+    // @Param: MIX5_X
+    // @DisplayName: Custom frame output 5 roll factor
+    // @Description: Roll factor of output 5 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX5_Y
+    // @DisplayName: Custom frame output 5 pitch factor
+    // @Description: Pitch factor of output 5 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX5_Z
+    // @DisplayName: Custom frame output 5 yaw factor
+    // @Description: Yaw factor of output 5 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX5", 54, AP_MotorsMatrix, _custom_factors[4], 0),
+
+    // @Param: MIX6_X
+    // @DisplayName: Custom frame output 6 roll factor
+    // @Description: Roll factor of output 6 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX6_Y
+    // @DisplayName: Custom frame output 6 pitch factor
+    // @Description: Pitch factor of output 6 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX6_Z
+    // @DisplayName: Custom frame output 6 yaw factor
+    // @Description: Yaw factor of output 6 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX6", 55, AP_MotorsMatrix, _custom_factors[5], 0),
+
+    // @Param: MIX7_X
+    // @DisplayName: Custom frame output 7 roll factor
+    // @Description: Roll factor of output 7 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX7_Y
+    // @DisplayName: Custom frame output 7 pitch factor
+    // @Description: Pitch factor of output 7 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX7_Z
+    // @DisplayName: Custom frame output 7 yaw factor
+    // @Description: Yaw factor of output 7 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX7", 56, AP_MotorsMatrix, _custom_factors[6], 0),
+
+    // @Param: MIX8_X
+    // @DisplayName: Custom frame output 8 roll factor
+    // @Description: Roll factor of output 8 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX8_Y
+    // @DisplayName: Custom frame output 8 pitch factor
+    // @Description: Pitch factor of output 8 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX8_Z
+    // @DisplayName: Custom frame output 8 yaw factor
+    // @Description: Yaw factor of output 8 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX8", 57, AP_MotorsMatrix, _custom_factors[7], 0),
+
+    // @Param: MIX9_X
+    // @DisplayName: Custom frame output 9 roll factor
+    // @Description: Roll factor of output 9 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX9_Y
+    // @DisplayName: Custom frame output 9 pitch factor
+    // @Description: Pitch factor of output 9 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX9_Z
+    // @DisplayName: Custom frame output 9 yaw factor
+    // @Description: Yaw factor of output 9 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX9", 58, AP_MotorsMatrix, _custom_factors[8], 0),
+
+    // @Param: MIX10_X
+    // @DisplayName: Custom frame output 10 roll factor
+    // @Description: Roll factor of output 10 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX10_Y
+    // @DisplayName: Custom frame output 10 pitch factor
+    // @Description: Pitch factor of output 10 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX10_Z
+    // @DisplayName: Custom frame output 10 yaw factor
+    // @Description: Yaw factor of output 10 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX10", 59, AP_MotorsMatrix, _custom_factors[9], 0),
+
+    // @Param: MIX11_X
+    // @DisplayName: Custom frame output 11 roll factor
+    // @Description: Roll factor of output 11 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX11_Y
+    // @DisplayName: Custom frame output 11 pitch factor
+    // @Description: Pitch factor of output 11 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX11_Z
+    // @DisplayName: Custom frame output 11 yaw factor
+    // @Description: Yaw factor of output 11 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX11", 60, AP_MotorsMatrix, _custom_factors[10], 0),
+
+    // @Param: MIX12_X
+    // @DisplayName: Custom frame output 12 roll factor
+    // @Description: Roll factor of output 12 when FRAME is 14 (Custom). Set all three factors of an output to zero to leave it unused
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX12_Y
+    // @DisplayName: Custom frame output 12 pitch factor
+    // @Description: Pitch factor of output 12 when FRAME is 14 (Custom)
+    // @Range: -1 1
+    // @User: Advanced
+
+    // @Param: MIX12_Z
+    // @DisplayName: Custom frame output 12 yaw factor
+    // @Description: Yaw factor of output 12 when FRAME is 14 (Custom), normally 1 for counter-clockwise and -1 for clockwise propellers
+    // @Range: -1 1
+    // @User: Advanced
+    AP_GROUPINFO("MIX12", 61, AP_MotorsMatrix, _custom_factors[11], 0),
+
+    AP_GROUPEND
+};
+
+// mixer_range - lowest and highest of the values of num motors, starting from zero
+static void mixer_range(const int16_t *values, uint8_t num, int16_t &low, int16_t &high)
+{
+    low = 0;
+    high = 0;
+    for (uint8_t i=0; i<num; i++) {
+        low = MIN(low, values[i]);
+        high = MAX(high, values[i]);
+    }
+}
+
 // Init
 void AP_MotorsMatrix::Init()
 {
     // setup the motors
-    setup_motors();
+    setup_frame();
 
     // enable fast channels or instant pwm
     set_update_rate(_speed_hz);
@@ -50,13 +301,14 @@ void AP_MotorsMatrix::set_update_rate( uint16_t speed_hz )
         }
     }
     hal.rcout->set_freq( mask, _speed_hz );
+    update_output_mode(mask);
 }
 
 // set frame orientation (normally + or X)
 void AP_MotorsMatrix::set_frame_orientation( uint8_t new_orientation )
 {
     // return if nothing has changed
-    if( new_orientation == _flags.frame_orientation ) {
+    if( new_orientation == _flags.frame_orientation && !custom_factors_changed() ) {
         return;
     }
 
@@ -64,7 +316,7 @@ void AP_MotorsMatrix::set_frame_orientation( uint8_t new_orientation )
     AP_Motors::set_frame_orientation( new_orientation );
 
     // setup the motors
-    setup_motors();
+    setup_frame();
 
     // enable fast channels or instant pwm
     set_update_rate(_speed_hz);
@@ -95,13 +347,11 @@ void AP_MotorsMatrix::output_min()
     limit.throttle_upper = false;
 
     // fill the motor_out[] array for HIL use and send minimum value to each motor
-    hal.rcout->cork();
-    for( i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++ ) {
-        if( motor_enabled[i] ) {
-            rc_write(i, _throttle_radio_min);
-        }
+    rc_cork();
+    for( i=0; i<_mix_num; i++ ) {
+        rc_write(_mix_chan[i], _throttle_radio_min);
     }
-    hal.rcout->push();
+    rc_push();
 }
 
 // get_motor_mask - returns a bitmask of which outputs are being used for motors (1 means being used)
@@ -145,37 +395,34 @@ void AP_MotorsMatrix::output_armed_not_stabilizing()
     throttle_radio_output = calc_throttle_radio_output();
 
     // set output throttle
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            motor_out[i] = throttle_radio_output;
-        }
+    for (i=0; i<_mix_num; i++) {
+        motor_out[i] = throttle_radio_output;
     }
 
     if(throttle_radio_output >= out_min_pwm) {
         // apply thrust curve and voltage scaling
-        for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-            if (motor_enabled[i]) {
-                motor_out[i] = apply_thrust_curve_and_volt_scaling(motor_out[i], out_min_pwm, out_max_pwm);
-            }
+        for (i=0; i<_mix_num; i++) {
+            motor_out[i] = apply_thrust_curve_and_volt_scaling(motor_out[i], out_min_pwm, out_max_pwm);
         }
     }
 
     // send output to each motor
-    hal.rcout->cork();
-    for( i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++ ) {
-        if( motor_enabled[i] ) {
-            rc_write(i, motor_out[i]);
-        }
+    rc_cork();
+    for( i=0; i<_mix_num; i++ ) {
+        rc_write(_mix_chan[i], motor_out[i]);
     }
-    hal.rcout->push();
+    rc_push();
 }
 
 // output_armed - sends commands to the motors
 // includes new scaling stability patch
 // TODO pull code that is common to output_armed_not_stabilizing into helper functions
+// the motors are mixed from the packed mixer arrays, so each step is a plain loop over the enabled motors only
+// priority when the motors saturate is roll and pitch first, then yaw down to _yaw_headroom, then throttle
 void AP_MotorsMatrix::output_armed_stabilizing()
 {
-    int8_t i;
+    uint8_t i;
+    const uint8_t num = _mix_num;                                   // number of enabled motors
     int16_t roll_pwm;                                               // roll pwm value, initially calculated by calc_roll_pwm() but may be modified after, +/- 400
     int16_t pitch_pwm;                                              // pitch pwm value, initially calculated by calc_roll_pwm() but may be modified after, +/- 400
     int16_t yaw_pwm;                                                // yaw pwm value, initially calculated by calc_yaw_pwm() but may be modified after, +/- 400
@@ -185,12 +432,13 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     int16_t out_mid_pwm = (out_min_pwm+out_max_pwm)/2;              // mid pwm value we can send to the motors
     int16_t out_best_thr_pwm;                                       // the is the best throttle we can come up which provides good control without climbing
     float rpy_scale = 1.0;                                          // this is used to scale the roll, pitch and yaw to fit within the motor limits
+    const float compensation_gain = get_compensation_gain();        // voltage and air density compensation, the same for every motor
 
     int16_t rpy_out[AP_MOTORS_MAX_NUM_MOTORS]; // buffer so we don't have to multiply coefficients multiple times.
     int16_t motor_out[AP_MOTORS_MAX_NUM_MOTORS];    // final outputs sent to the motors
 
-    int16_t rpy_low = 0;    // lowest motor value
-    int16_t rpy_high = 0;   // highest motor value
+    int16_t rpy_low;        // lowest motor value
+    int16_t rpy_high;       // highest motor value
     int16_t yaw_allowed;    // amount of yaw we can fit in
     int16_t thr_adj;        // the difference between the pilot's desired throttle and out_best_thr_pwm (the throttle that is actually provided)
 
@@ -218,21 +466,11 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // calculate roll and pitch for each motor
     // set rpy_low and rpy_high to the lowest and highest values of the motors
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            rpy_out[i] = roll_pwm * _roll_factor[i] * get_compensation_gain() +
-                            pitch_pwm * _pitch_factor[i] * get_compensation_gain();
-
-            // record lowest roll pitch command
-            if (rpy_out[i] < rpy_low) {
-                rpy_low = rpy_out[i];
-            }
-            // record highest roll pich command
-            if (rpy_out[i] > rpy_high) {
-                rpy_high = rpy_out[i];
-            }
-        }
+    for (i=0; i<num; i++) {
+        rpy_out[i] = roll_pwm * _mix_roll[i] * compensation_gain +
+                        pitch_pwm * _mix_pitch[i] * compensation_gain;
     }
+    mixer_range(rpy_out, num, rpy_low, rpy_high);
 
     // calculate throttle that gives most possible room for yaw (range 1000 ~ 2000) which is the lower of:
     //      1. mid throttle - average of highest and lowest motor (this would give the maximum possible room margin above the highest motor and below the lowest)
@@ -253,39 +491,26 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     if (yaw_pwm >= 0) {
         // if yawing right
-        if (yaw_allowed > yaw_pwm * get_compensation_gain()) {
-            yaw_allowed = yaw_pwm * get_compensation_gain(); // to-do: this is bad form for yaw_allows to change meaning to become the amount that we are going to output
+        if (yaw_allowed > yaw_pwm * compensation_gain) {
+            yaw_allowed = yaw_pwm * compensation_gain; // to-do: this is bad form for yaw_allows to change meaning to become the amount that we are going to output
         }else{
             limit.yaw = true;
         }
     }else{
         // if yawing left
         yaw_allowed = -yaw_allowed;
-        if (yaw_allowed < yaw_pwm * get_compensation_gain()) {
-            yaw_allowed = yaw_pwm * get_compensation_gain(); // to-do: this is bad form for yaw_allows to change meaning to become the amount that we are going to output
+        if (yaw_allowed < yaw_pwm * compensation_gain) {
+            yaw_allowed = yaw_pwm * compensation_gain; // to-do: this is bad form for yaw_allows to change meaning to become the amount that we are going to output
         }else{
             limit.yaw = true;
         }
     }
 
     // add yaw to intermediate numbers for each motor
-    rpy_low = 0;
-    rpy_high = 0;
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            rpy_out[i] =    rpy_out[i] +
-                            yaw_allowed * _yaw_factor[i];
-
-            // record lowest roll+pitch+yaw command
-            if( rpy_out[i] < rpy_low ) {
-                rpy_low = rpy_out[i];
-            }
-            // record highest roll+pitch+yaw command
-            if( rpy_out[i] > rpy_high) {
-                rpy_high = rpy_out[i];
-            }
-        }
+    for (i=0; i<num; i++) {
+        rpy_out[i] = rpy_out[i] + yaw_allowed * _mix_yaw[i];
     }
+    mixer_range(rpy_out, num, rpy_low, rpy_high);
 
     // check everything fits
     thr_adj = throttle_radio_output - out_best_thr_pwm;
@@ -337,35 +562,22 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     }
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            motor_out[i] = out_best_thr_pwm+thr_adj +
-                            rpy_scale*rpy_out[i];
-        }
+    const int16_t thr_out = out_best_thr_pwm+thr_adj;
+    for (i=0; i<num; i++) {
+        motor_out[i] = thr_out + rpy_scale*rpy_out[i];
     }
 
-    // apply thrust curve and voltage scaling
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            motor_out[i] = apply_thrust_curve_and_volt_scaling(motor_out[i], out_min_pwm, out_max_pwm);
-        }
-    }
-
-    // clip motor output if required (shouldn't be)
-    for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            motor_out[i] = constrain_int16(motor_out[i], out_min_pwm, out_max_pwm);
-        }
+    // apply thrust curve and voltage scaling, and clip motor output if required (shouldn't be)
+    for (i=0; i<num; i++) {
+        motor_out[i] = constrain_int16(apply_thrust_curve_and_volt_scaling(motor_out[i], out_min_pwm, out_max_pwm), out_min_pwm, out_max_pwm);
     }
 
     // send output to each motor
-    hal.rcout->cork();
-    for( i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++ ) {
-        if( motor_enabled[i] ) {
-            rc_write(i, motor_out[i]);
-        }
+    rc_cork();
+    for (i=0; i<num; i++) {
+        rc_write(_mix_chan[i], motor_out[i]);
     }
-    hal.rcout->push();
+    rc_push();
 }
 
 // output_disarmed - sends commands to the motors
@@ -386,14 +598,14 @@ void AP_MotorsMatrix::output_test(uint8_t motor_seq, int16_t pwm)
     }
 
     // loop through all the possible orders spinning any motors that match that description
-    hal.rcout->cork();
+    rc_cork();
     for (uint8_t i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
         if (motor_enabled[i] && _test_order[i] == motor_seq) {
             // turn on this motor
             rc_write(i, pwm);
         }
     }
-    hal.rcout->push();
+    rc_push();
 }
 
 // add_motor
@@ -417,6 +629,8 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
 
         // disable this channel from being used by RC_Channel_aux
         RC_Channel_aux::disable_aux_channel(motor_num);
+
+        update_mixer();
     }
 }
 
@@ -447,6 +661,8 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
         _roll_factor[motor_num] = 0;
         _pitch_factor[motor_num] = 0;
         _yaw_factor[motor_num] = 0;
+
+        update_mixer();
     }
 }
 
@@ -457,3 +673,79 @@ void AP_MotorsMatrix::remove_all_motors()
         remove_motor(i);
     }
 }
+
+// load_factors - replace the frame with a table of roll, pitch and yaw factors, one row per output starting at channel 1
+bool AP_MotorsMatrix::load_factors(const float factors[][3], uint8_t num_rows)
+{
+    if (num_rows > AP_MOTORS_MAX_NUM_MOTORS) {
+        return false;
+    }
+
+    remove_all_motors();
+    for (uint8_t i=0; i<num_rows; i++) {
+        if (!is_zero(factors[i][0]) || !is_zero(factors[i][1]) || !is_zero(factors[i][2])) {
+            add_motor_raw(i, factors[i][0], factors[i][1], factors[i][2], i+1);
+        }
+    }
+
+    // outputs may have changed
+    set_update_rate(_speed_hz);
+    if (armed()) {
+        enable();
+    }
+    return true;
+}
+
+// setup_frame - sets up the motors for the frame orientation, from the MOT_MIXn parameters for the custom frame
+void AP_MotorsMatrix::setup_frame()
+{
+    if (_flags.frame_orientation != AP_MOTORS_CUSTOM_FRAME) {
+        setup_motors();
+        return;
+    }
+
+    float factors[AP_MOTORS_MAX_NUM_MOTORS][3];
+    for (uint8_t i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        const Vector3f &mix = _custom_factors[i].get();
+        factors[i][0] = mix.x;
+        factors[i][1] = mix.y;
+        factors[i][2] = mix.z;
+    }
+    load_factors(factors, AP_MOTORS_MAX_NUM_MOTORS);
+}
+
+// custom_factors_changed - true if the custom frame is in use and the MOT_MIXn parameters differ from the motors
+//  lets the parameters be changed while disarmed, as the vehicle calls set_frame_orientation() regularly then
+bool AP_MotorsMatrix::custom_factors_changed() const
+{
+    if (_flags.frame_orientation != AP_MOTORS_CUSTOM_FRAME) {
+        return false;
+    }
+
+    for (uint8_t i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        const Vector3f &mix = _custom_factors[i].get();
+        if (motor_enabled[i] != !mix.is_zero()) {
+            return true;
+        }
+        if (motor_enabled[i] && (!is_equal(_roll_factor[i], mix.x) || !is_equal(_pitch_factor[i], mix.y) || !is_equal(_yaw_factor[i], mix.z))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// update_mixer - packs the factors of the enabled motors into the mixer arrays
+//  called whenever a motor is added or removed, so the output loops only visit enabled motors
+void AP_MotorsMatrix::update_mixer()
+{
+    _mix_num = 0;
+    for (uint8_t i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (motor_enabled[i]) {
+            _mix_chan[_mix_num] = i;
+            _mix_roll[_mix_num] = _roll_factor[i];
+            _mix_pitch[_mix_num] = _pitch_factor[i];
+            _mix_yaw[_mix_num] = _yaw_factor[i];
+            _mix_num++;
+        }
+    }
+}
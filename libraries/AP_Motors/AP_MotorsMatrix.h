@@ -20,8 +20,11 @@ public:
 
     /// Constructor
     AP_MotorsMatrix(uint16_t loop_rate, uint16_t speed_hz = AP_MOTORS_SPEED_DEFAULT) :
-        AP_MotorsMulticopter(loop_rate, speed_hz)
-    {};
+        AP_MotorsMulticopter(loop_rate, speed_hz),
+        _mix_num(0)
+    {
+        AP_Param::setup_object_defaults(this, var_info);
+    };
 
     // init
     virtual void        Init();
@@ -56,6 +59,11 @@ public:
     // remove_all_motors - removes all motor definitions
     void                remove_all_motors();
 
+    // load_factors - replace the frame with a table of roll, pitch and yaw factors, one row per output starting at channel 1
+    //  rows with all factors zero leave that output unused.  Returns false, leaving the frame unchanged, if the table has too many rows
+    //  should be called after Init(), as Init() and set_frame_orientation() set up the standard frame again
+    bool                load_factors(const float factors[][3], uint8_t num_rows);
+
     // setup_motors - configures the motors for a given frame type - should be overwritten by child classes
     virtual void        setup_motors() {
         remove_all_motors();
@@ -65,6 +73,9 @@ public:
     //  this can be used to ensure other pwm outputs (i.e. for servos) do not conflict
     virtual uint16_t    get_motor_mask();
 
+    // var_info for holding Parameter information
+    static const struct AP_Param::GroupInfo var_info[];
+
 protected:
     // output - sends commands to the motors
     void                output_armed_stabilizing();
@@ -74,10 +85,29 @@ protected:
     // add_motor using raw roll, pitch, throttle and yaw factors
     void                add_motor_raw(int8_t motor_num, float roll_fac, float pitch_fac, float yaw_fac, uint8_t testing_order);
 
+    // update_mixer - packs the factors of the enabled motors into the mixer arrays
+    void                update_mixer();
+
+    // setup_frame - sets up the motors for the frame orientation, from the MOT_MIXn parameters for the custom frame
+    void                setup_frame();
+
+    // custom_factors_changed - true if the custom frame is in use and the MOT_MIXn parameters differ from the motors
+    bool                custom_factors_changed() const;
+
+    // parameters
+    AP_Vector3f         _custom_factors[AP_MOTORS_MAX_NUM_MOTORS];  // roll, pitch and yaw factors of each output for the custom frame
+
     float               _roll_factor[AP_MOTORS_MAX_NUM_MOTORS]; // each motors contribution to roll
     float               _pitch_factor[AP_MOTORS_MAX_NUM_MOTORS]; // each motors contribution to pitch
     float               _yaw_factor[AP_MOTORS_MAX_NUM_MOTORS];  // each motors contribution to yaw (normally 1 or -1)
     uint8_t             _test_order[AP_MOTORS_MAX_NUM_MOTORS];  // order of the motors in the test sequence
+
+    // mixer - the factors of the enabled motors only, packed from index 0 so the output loops have no gaps or branches
+    uint8_t             _mix_num;                               // number of enabled motors
+    uint8_t             _mix_chan[AP_MOTORS_MAX_NUM_MOTORS];    // output channel of each enabled motor
+    float               _mix_roll[AP_MOTORS_MAX_NUM_MOTORS];    // roll factor of each enabled motor
+    float               _mix_pitch[AP_MOTORS_MAX_NUM_MOTORS];   // pitch factor of each enabled motor
+    float               _mix_yaw[AP_MOTORS_MAX_NUM_MOTORS];     // yaw factor of each enabled motor
 };
 
 #endif  // AP_MOTORSMATRIX
@@ -22,6 +22,7 @@
 
 #include "AP_MotorsMulticopter.h"
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/AP_HAL_Static.h>
 extern const AP_HAL::HAL& hal;
 
 // parameters for the motor class
@@ -98,6 +99,14 @@ const AP_Param::GroupInfo AP_MotorsMulticopter::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("THR_MIX_MAX", 14, AP_MotorsMulticopter, _thr_mix_max, AP_MOTORS_THR_MIX_MAX_DEFAULT),
 
+    // @Param: PWM_TYPE
+    // @DisplayName: Output PWM type
+    // @Description: This selects the output protocol of the motors. DShot sends a digital throttle to the ESC instead of a pulse and needs ESCs and a board that support it. The board keeps normal PWM if it doesn't support the selected type
+    // @Values: 0:Normal,1:DShot150,2:DShot300,3:DShot600
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("PWM_TYPE", 15, AP_MotorsMulticopter, _pwm_type, AP_HAL::RCOutput::MODE_PWM_NORMAL),
+
     AP_GROUPEND
 };
 
@@ -149,6 +158,9 @@ void AP_MotorsMulticopter::output()
     // move throttle_low_comp towards desired throttle low comp
     update_throttle_thr_mix();
 
+    // send all the outputs below in one transaction
+    rc_cork();
+
     if (_flags.armed) {
         if (!_flags.interlock) {
             output_armed_zero_throttle();
@@ -161,6 +173,9 @@ void AP_MotorsMulticopter::output()
         _multicopter_flags.slow_start_low_end = true;
         output_disarmed();
     }
+
+    rc_push();
+    HAL_SCHEDULER->outputs_written();
 };
 
 // update the throttle input filter
@@ -340,6 +355,13 @@ float AP_MotorsMulticopter::get_compensation_gain() const
     return ret;
 }
 
+// update_output_mode - set the output protocol of the motor channels in mask
+void AP_MotorsMulticopter::update_output_mode(uint32_t mask)
+{
+    // a board that can't output the type keeps sending PWM
+    hal.rcout->set_output_mode(mask, (AP_HAL::RCOutput::output_mode)_pwm_type.get());
+}
+
 float AP_MotorsMulticopter::rel_pwm_to_thr_range(float pwm) const
 {
     return pwm/_throttle_pwm_scalar;
@@ -378,12 +400,12 @@ void AP_MotorsMulticopter::throttle_pass_through(int16_t pwm)
 {
     if (armed()) {
         // send the pilot's input directly to each enabled motor
-        hal.rcout->cork();
+        rc_cork();
         for (uint16_t i=0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
             if (motor_enabled[i]) {
                 rc_write(i, pwm);
             }
         }
-        hal.rcout->push();
+        rc_push();
     }
 }
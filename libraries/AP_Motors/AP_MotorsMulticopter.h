@@ -125,6 +125,9 @@ protected:
     // get_hover_throttle_as_pwm - converts hover throttle to pwm (i.e. range 1000 ~ 2000)
     int16_t             get_hover_throttle_as_pwm() const;
 
+    // set the output mode of the motor channels in mask from MOT_PWM_TYPE
+    void                update_output_mode(uint32_t mask);
+
     float               rel_pwm_to_thr_range(float pwm) const;
     float               thr_range_to_rel_pwm(float thr) const;
 
@@ -154,6 +157,7 @@ protected:
     AP_Float            _batt_current_max;      // current over which maximum throttle is limited
     AP_Float            _thr_mix_min;           // throttle vs attitude control prioritisation used when landing (higher values mean we prioritise attitude control over throttle)
     AP_Float            _thr_mix_max;           // throttle vs attitude control prioritisation used during active flight (higher values mean we prioritise attitude control over throttle)
+    AP_Int8             _pwm_type;              // output protocol of the motor channels, an AP_HAL::RCOutput::output_mode
 
     // internal variables
     bool                motor_enabled[AP_MOTORS_MAX_NUM_MOTORS];    // true if motor is enabled
@@ -117,12 +117,12 @@ void AP_MotorsTri::output_min()
     limit.throttle_lower = true;
 
     // send minimum value to each motor
-    hal.rcout->cork();
+    rc_cork();
     rc_write(AP_MOTORS_MOT_1, _throttle_radio_min);
     rc_write(AP_MOTORS_MOT_2, _throttle_radio_min);
     rc_write(AP_MOTORS_MOT_4, _throttle_radio_min);
     rc_write(AP_MOTORS_CH_TRI_YAW, _yaw_servo_trim);
-    hal.rcout->push();
+    rc_push();
 }
 
 // get_motor_mask - returns a bitmask of which outputs are being used for motors or servos (1 means being used)
@@ -173,7 +173,7 @@ void AP_MotorsTri::output_armed_not_stabilizing()
         motor_out[AP_MOTORS_MOT_4] = apply_thrust_curve_and_volt_scaling(motor_out[AP_MOTORS_MOT_4], out_min, out_max);
     }
 
-    hal.rcout->cork();
+    rc_cork();
 
     // send output to each motor
     rc_write(AP_MOTORS_MOT_1, motor_out[AP_MOTORS_MOT_1]);
@@ -183,7 +183,7 @@ void AP_MotorsTri::output_armed_not_stabilizing()
     // send centering signal to yaw servo
     rc_write(AP_MOTORS_CH_TRI_YAW, _yaw_servo_trim);
 
-    hal.rcout->push();
+    rc_push();
 }
 
 // sends commands to the motors
@@ -290,7 +290,7 @@ void AP_MotorsTri::output_armed_stabilizing()
         motor_out[AP_MOTORS_MOT_4] = MAX(motor_out[AP_MOTORS_MOT_4],    out_min);
     }
 
-    hal.rcout->cork();
+    rc_cork();
 
     // send output to each motor
     rc_write(AP_MOTORS_MOT_1, motor_out[AP_MOTORS_MOT_1]);
@@ -300,7 +300,7 @@ void AP_MotorsTri::output_armed_stabilizing()
     // send out to yaw command to tail servo
     rc_write(AP_MOTORS_CH_TRI_YAW, yaw_radio_output);
 
-    hal.rcout->push();
+    rc_push();
 }
 
 // output_disarmed - sends commands to the motors
@@ -22,6 +22,7 @@
 
 #include "AP_Motors_Class.h"
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/AP_HAL_Static.h>
 extern const AP_HAL::HAL& hal;
 
 // Constructor
@@ -40,7 +41,8 @@ AP_Motors::AP_Motors(uint16_t loop_rate, uint16_t speed_hz) :
     _throttle_filter(),
     _batt_voltage(0.0f),
     _batt_current(0.0f),
-    _air_density_ratio(1.0f)
+    _air_density_ratio(1.0f),
+    _cork_depth(0)
 {
     // init other flags
     _flags.armed = false;
@@ -70,5 +72,24 @@ void AP_Motors::armed(bool arm)
  */
 void AP_Motors::rc_write(uint8_t chan, uint16_t pwm)
 {
-    hal.rcout->write(chan, pwm);
+    HAL_RCOUT->write(chan, pwm);
+}
+
+/*
+  start grouping output writes, so boards which support it send all
+  the motors in one bus transaction
+ */
+void AP_Motors::rc_cork()
+{
+    if (_cork_depth++ == 0) {
+        HAL_RCOUT->cork();
+    }
+}
+
+// send the writes since the outermost rc_cork()
+void AP_Motors::rc_push()
+{
+    if (_cork_depth > 0 && --_cork_depth == 0) {
+        HAL_RCOUT->push();
+    }
 }
@@ -18,8 +18,12 @@
 #define AP_MOTORS_MOT_6 5U
 #define AP_MOTORS_MOT_7 6U
 #define AP_MOTORS_MOT_8 7U
+#define AP_MOTORS_MOT_9 8U
+#define AP_MOTORS_MOT_10 9U
+#define AP_MOTORS_MOT_11 10U
+#define AP_MOTORS_MOT_12 11U
 
-#define AP_MOTORS_MAX_NUM_MOTORS 8
+#define AP_MOTORS_MAX_NUM_MOTORS 12
 
 // frame definitions
 #define AP_MOTORS_PLUS_FRAME        0
@@ -32,6 +36,7 @@
 #define AP_MOTORS_NEW_X_FRAME       11
 #define AP_MOTORS_NEW_V_FRAME       12
 #define AP_MOTORS_NEW_H_FRAME       13   // same as X frame but motors spin in opposite direction
+#define AP_MOTORS_CUSTOM_FRAME      14   // factors from the MOT_MIXn parameters, matrix frames only
 
 // motor update rate
 #define AP_MOTORS_SPEED_DEFAULT     490 // default output rate to the motors
@@ -46,6 +51,9 @@ public:
     // set update rate to motors - a value in hertz
     virtual void        set_update_rate( uint16_t speed_hz ) { _speed_hz = speed_hz; };
 
+    // set the rate at which output() is called - a value in hertz
+    void                set_loop_rate( uint16_t loop_rate ) { _loop_rate = loop_rate; };
+
     // set frame orientation (normally + or X)
     virtual void        set_frame_orientation( uint8_t new_orientation ) { _flags.frame_orientation = new_orientation; };
 
@@ -130,6 +138,11 @@ protected:
     virtual void        output_armed_zero_throttle() { output_min(); }
     virtual void        output_disarmed()=0;
     virtual void        rc_write(uint8_t chan, uint16_t pwm);
+
+    // group writes into one output transaction. These nest, so output()
+    // can cork around output functions which cork for themselves
+    void                rc_cork();
+    void                rc_push();
     
     // update the throttle input filter
     virtual void        update_throttle_filter() = 0;
@@ -138,10 +151,12 @@ protected:
     struct AP_Motors_flags {
         uint8_t armed              : 1;    // 0 if disarmed, 1 if armed
         uint8_t stabilizing        : 1;    // 0 if not controlling attitude, 1 if controlling attitude
-        uint8_t frame_orientation  : 4;    // PLUS_FRAME 0, X_FRAME 1, V_FRAME 2, H_FRAME 3, NEW_PLUS_FRAME 10, NEW_X_FRAME, NEW_V_FRAME, NEW_H_FRAME
+        uint8_t frame_orientation  : 4;    // PLUS_FRAME 0, X_FRAME 1, V_FRAME 2, H_FRAME 3, NEW_PLUS_FRAME 10, NEW_X_FRAME, NEW_V_FRAME, NEW_H_FRAME, CUSTOM_FRAME
         uint8_t interlock          : 1;    // 1 if the motor interlock is enabled (i.e. motors run), 0 if disabled (motors don't run)
     } _flags;
 
+    uint8_t             _cork_depth;                // nesting of rc_cork() calls
+
     // internal variables
     float               _roll_control_input;        // desired roll control from attitude controllers, +/- 4500
     float               _pitch_control_input;       // desired pitch control from attitude controller, +/- 4500
@@ -0,0 +1,169 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Motors/AP_MotorsMatrix.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define NUM_MOTORS 12
+#define PWM_MIN 1000
+#define PWM_MAX 2000
+
+// a matrix frame with a linear thrust curve, whose mixer can be run directly
+class TestMotors : public AP_MotorsMatrix {
+public:
+    TestMotors() :
+        AP_MotorsMatrix(400)
+    {
+        _thrust_curve_expo.set(0.0f);
+        _thrust_curve_max.set(1.0f);
+        set_throttle_range(0, PWM_MIN, PWM_MAX);
+        set_hover_throttle(500);
+    }
+
+    void mix(int16_t roll, int16_t pitch, int16_t yaw, float throttle)
+    {
+        set_roll(roll);
+        set_pitch(pitch);
+        set_yaw(yaw);
+        _throttle_control_input = throttle;
+        output_armed_stabilizing();
+    }
+
+    void set_custom_factors(uint8_t i, const Vector3f &factors)
+    {
+        _custom_factors[i].set(factors);
+    }
+};
+
+// a dodecacopter, motors every 30 degrees clockwise from the front with alternating propeller directions
+class MotorsMatrixTest : public ::testing::Test {
+protected:
+    MotorsMatrixTest()
+    {
+        for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+            const float angle = radians(i * 30.0f);
+            table[i][0] = cosf(angle + radians(90.0f));
+            table[i][1] = cosf(angle);
+            table[i][2] = (i % 2) ? AP_MOTORS_MATRIX_YAW_FACTOR_CW : AP_MOTORS_MATRIX_YAW_FACTOR_CCW;
+        }
+        motors.Init();
+    }
+
+    TestMotors motors;
+    float table[NUM_MOTORS][3];
+};
+
+TEST_F(MotorsMatrixTest, LoadTwelveMotors)
+{
+    EXPECT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    EXPECT_EQ(0x0FFF, motors.get_motor_mask());
+
+    // a row of zeros leaves its output unused
+    table[5][0] = table[5][1] = table[5][2] = 0.0f;
+    EXPECT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    EXPECT_EQ(0x0FDF, motors.get_motor_mask());
+}
+
+TEST_F(MotorsMatrixTest, RejectTooManyMotors)
+{
+    float big[AP_MOTORS_MAX_NUM_MOTORS + 1][3] = {};
+    big[0][2] = 1.0f;
+
+    ASSERT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    EXPECT_FALSE(motors.load_factors(big, AP_MOTORS_MAX_NUM_MOTORS + 1));
+    EXPECT_EQ(0x0FFF, motors.get_motor_mask());
+}
+
+TEST_F(MotorsMatrixTest, Level)
+{
+    ASSERT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    motors.mix(0, 0, 0, 500.0f);
+
+    const uint16_t out = hal.rcout->read(0);
+    EXPECT_GT(out, PWM_MIN);
+    EXPECT_LT(out, PWM_MAX);
+    for (uint8_t i = 1; i < NUM_MOTORS; i++) {
+        EXPECT_EQ(out, hal.rcout->read(i)) << "motor " << (int)i;
+    }
+    EXPECT_FALSE(motors.limit.roll_pitch);
+    EXPECT_FALSE(motors.limit.yaw);
+}
+
+TEST_F(MotorsMatrixTest, RollPitchYaw)
+{
+    ASSERT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    motors.mix(0, 0, 0, 500.0f);
+    uint16_t level[NUM_MOTORS];
+    hal.rcout->read(level, NUM_MOTORS);
+
+    // each motor moves by its own factor, to within the rounding to whole microseconds
+    const struct {
+        int16_t roll, pitch, yaw;
+        uint8_t axis;
+    } inputs[] = {
+        { 1000, 0, 0, 0 },
+        { 0, -1000, 0, 1 },
+        { 0, 0, 1000, 2 },
+    };
+    for (const auto &in : inputs) {
+        motors.mix(in.roll, in.pitch, in.yaw, 500.0f);
+        uint16_t out[NUM_MOTORS];
+        hal.rcout->read(out, NUM_MOTORS);
+
+        const int16_t input = in.roll + in.pitch + in.yaw;
+        float scale = 0.0f;
+        for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+            if (fabsf(table[i][in.axis]) > 0.9f) {
+                scale = (out[i] - level[i]) / (input * table[i][in.axis]);
+                break;
+            }
+        }
+        EXPECT_GT(scale, 0.0f);
+        for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+            EXPECT_NEAR(input * table[i][in.axis] * scale, out[i] - level[i], 1.5f) << "axis " << (int)in.axis << " motor " << (int)i;
+        }
+        EXPECT_FALSE(motors.limit.roll_pitch);
+    }
+}
+
+TEST_F(MotorsMatrixTest, Saturation)
+{
+    ASSERT_TRUE(motors.load_factors(table, NUM_MOTORS));
+    motors.mix(4500, 4500, 4500, 950.0f);
+
+    uint16_t out[NUM_MOTORS];
+    hal.rcout->read(out, NUM_MOTORS);
+    for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+        EXPECT_GE(out[i], PWM_MIN) << "motor " << (int)i;
+        EXPECT_LE(out[i], PWM_MAX) << "motor " << (int)i;
+    }
+    EXPECT_TRUE(motors.limit.roll_pitch);
+    EXPECT_TRUE(motors.limit.yaw);
+}
+
+TEST_F(MotorsMatrixTest, CustomFrameParameters)
+{
+    for (uint8_t i = 0; i < NUM_MOTORS; i++) {
+        motors.set_custom_factors(i, Vector3f(table[i][0], table[i][1], table[i][2]));
+    }
+    motors.set_frame_orientation(AP_MOTORS_CUSTOM_FRAME);
+    EXPECT_EQ(0x0FFF, motors.get_motor_mask());
+
+    motors.mix(0, 0, 0, 500.0f);
+    const uint16_t out = hal.rcout->read(0);
+    for (uint8_t i = 1; i < NUM_MOTORS; i++) {
+        EXPECT_EQ(out, hal.rcout->read(i)) << "motor " << (int)i;
+    }
+
+    // changed parameters are picked up the next time the orientation is set
+    motors.set_custom_factors(11, Vector3f());
+    motors.set_frame_orientation(AP_MOTORS_CUSTOM_FRAME);
+    EXPECT_EQ(0x07FF, motors.get_motor_mask());
+
+    // and the standard frames are set up again
+    motors.set_frame_orientation(AP_MOTORS_X_FRAME);
+    EXPECT_EQ(0, motors.get_motor_mask());
+}
+
+AP_GTEST_MAIN()
@@ -419,6 +419,15 @@ const AP_Param::GroupInfo NavEKF2::var_info[] = {
     // @Units: %
     AP_GROUPINFO("CHECK_SCALE", 34, NavEKF2, _gpsCheckScaler, CHECK_SCALER_DEFAULT),
 
+    // @Param: PRED_MS
+    // @DisplayName: State and covariance prediction period (msec)
+    // @Description: Interval between EKF state and covariance predictions. IMU data is accumulated without coning or sculling errors over this interval and the output observer continues to run at the IMU rate. Longer intervals reduce the processor load of each EKF instance, allowing more instances to be run on slower processors, at the cost of some accuracy during rapid manoeuvres. Requires a reboot to take effect.
+    // @Range: 10 40
+    // @Increment: 5
+    // @User: Advanced
+    // @Units: msec
+    AP_GROUPINFO("PRED_MS", 35, NavEKF2, _predictPeriod_ms, 10),
+
     AP_GROUPEND
 };
 
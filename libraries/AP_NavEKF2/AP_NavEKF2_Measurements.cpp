@@ -222,9 +222,10 @@ void NavEKF2_core::readMagData()
 ********************************************************/
 
 /*
- *  Read IMU delta angle and delta velocity measurements and downsample to 100Hz
- *  for storage in the data buffers used by the EKF. If the IMU data arrives at
- *  lower rate than 100Hz, then no downsampling or upsampling will be performed.
+ *  Read IMU delta angle and delta velocity measurements and downsample to the
+ *  prediction rate (100Hz by default) for storage in the data buffers used by the
+ *  EKF. If the IMU data arrives at lower rate than the prediction rate, then no
+ *  downsampling or upsampling will be performed.
  *  Downsampling is done using a method that does not introduce coning or sculling
  *  errors.
  */
@@ -288,9 +289,10 @@ void NavEKF2_core::readIMUData()
     // Keep track of the number of IMU frames since the last state prediction
     framesSincePredict++;
 
-    // If 10msec has elapsed, and the frontend has allowed us to start a new predict cycle, then store the accumulated IMU data
-    // to be used by the state prediction, ignoring the frontend permission if more than 20msec has lapsed
-    if ((dtIMUavg*(float)framesSincePredict >= 0.01f && startPredictEnabled) || (dtIMUavg*(float)framesSincePredict >= 0.02f)) {
+    // If the prediction period has elapsed, and the frontend has allowed us to start a new predict cycle, then store the accumulated
+    // IMU data to be used by the state prediction, ignoring the frontend permission if twice the period has lapsed
+    const float timeSincePredict = dtIMUavg*(float)framesSincePredict;
+    if ((timeSincePredict >= predictPeriod && startPredictEnabled) || (timeSincePredict >= 2.0f*predictPeriod)) {
         // convert the accumulated quaternion to an equivalent delta angle
         imuQuatDownSampleNew.to_axis_angle(imuDataDownSampledNew.delAng);
         // Time stamp the data
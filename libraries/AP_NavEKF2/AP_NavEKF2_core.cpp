@@ -62,18 +62,21 @@ bool NavEKF2_core::setup_core(NavEKF2 *_frontend, uint8_t _imu_index, uint8_t _c
     core_index = _core_index;
     _ahrs = frontend->_ahrs;
 
+    // IMU data is downsampled to the prediction rate set by the user
+    predictPeriod = constrain_int16(frontend->_predictPeriod_ms, 10, 40) * 0.001f;
+
     /*
-      the imu_buffer_length needs to cope with a 260ms delay at a
-      maximum fusion rate of 100Hz. Non-imu data coming in at faster
-      than 100Hz is downsampled. For 50Hz main loop rate we need a
-      shorter buffer.
+      the imu_buffer_length needs to cope with a 260ms delay at the
+      prediction rate. Non-imu data coming in faster than the
+      prediction rate is downsampled. For a main loop rate slower than
+      the prediction rate each loop is a prediction.
      */
-    if (_ahrs->get_ins().get_sample_rate() < 100) {
-        imu_buffer_length = 13;
-    } else {
-        // maximum 260 msec delay at 100 Hz fusion rate
-        imu_buffer_length = 26;
+    const uint16_t sample_rate = _ahrs->get_ins().get_sample_rate();
+    float storage_period = predictPeriod;
+    if (sample_rate > 0) {
+        storage_period = MAX(predictPeriod, 1.0f / sample_rate);
     }
+    imu_buffer_length = (uint8_t)(0.26f / storage_period + 0.5f);
     if(!storedGPS.init(OBS_BUFFER_LENGTH)) {
         return false;
     }
@@ -113,7 +116,7 @@ void NavEKF2_core::InitialiseVariables()
     // calculate the nominal filter update rate
     const AP_InertialSensor &ins = _ahrs->get_ins();
     localFilterTimeStep_ms = (uint8_t)(1000*ins.get_loop_delta_t());
-    localFilterTimeStep_ms = MAX(localFilterTimeStep_ms,10);
+    localFilterTimeStep_ms = MAX(localFilterTimeStep_ms,(uint8_t)(1000*predictPeriod));
 
     // initialise time stamps
     imuSampleTime_ms = AP_HAL::millis();
@@ -275,7 +278,7 @@ bool NavEKF2_core::InitialiseFilterBootstrap(void)
 
     // Initialise IMU data
     dtIMUavg = _ahrs->get_ins().get_loop_delta_t();
-    dtEkfAvg = MIN(0.01f,dtIMUavg);
+    dtEkfAvg = MAX(predictPeriod,dtIMUavg);
     readIMUData();
     storedIMU.reset_history(imuDataNew);
     imuDataDelayed = imuDataNew;
@@ -70,9 +70,9 @@ bool RCOutputRGBLed::hw_set_rgb(uint8_t red, uint8_t green, uint8_t blue)
     }
 
     /*
-     * Not calling push() to have a better performance on RCOutput's that
-     * implements cork()/push(), so this changes will be committed together
-     * with the motors.
+     * Group the three writes. The motors may be pushed from another
+     * thread, so push them here rather than leaving the outputs corked
+     * until the motors push.
      */
     hal.rcout->cork();
 
@@ -85,5 +85,7 @@ bool RCOutputRGBLed::hw_set_rgb(uint8_t red, uint8_t green, uint8_t blue)
     usec_duty = usec_period * blue / _led_bright;
     hal.rcout->write(_blue_channel, usec_duty);
 
+    hal.rcout->push();
+
     return true;
 }
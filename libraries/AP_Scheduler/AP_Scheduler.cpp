@@ -81,6 +81,10 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks)
     _num_tasks = num_tasks;
     _last_run = new uint16_t[_num_tasks];
     memset(_last_run, 0, sizeof(_last_run[0]) * _num_tasks);
+    _perf_tasks = new AP_HAL::Util::perf_counter_t[_num_tasks];
+    for (uint8_t i=0; i<_num_tasks; i++) {
+        _perf_tasks[i] = hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, _tasks[i].name);
+    }
     _tick_counter = 0;
 }
 
@@ -125,7 +129,9 @@ void AP_Scheduler::run(uint16_t time_available)
                 // run it
                 _task_time_started = now;
                 current_task = i;
+                hal.util->perf_begin(_perf_tasks[i]);
                 _tasks[i].function();
+                hal.util->perf_end(_perf_tasks[i]);
                 current_task = -1;
 
                 // record the tick counter when we ran. This drives
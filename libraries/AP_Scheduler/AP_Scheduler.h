@@ -117,6 +117,9 @@ private:
     // tick counter at the time we last ran each task
     uint16_t *_last_run;
 
+    // elapsed perf counter for each task
+    AP_HAL::Util::perf_counter_t *_perf_tasks;
+
     // number of microseconds allowed for the current task
     uint32_t _task_time_allowed;
 
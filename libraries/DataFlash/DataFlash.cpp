@@ -16,6 +16,14 @@ const AP_Param::GroupInfo DataFlash_Class::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("_FILE_BUFSIZE",  1, DataFlash_Class, _params.file_bufsize,       16),
 
+    // @Param: _FILE_RATEMAX
+    // @DisplayName: Maximum logging rate for non-critical messages
+    // @Description: Default maximum rate for each type of non-critical log message. Message types with their own rate, and full rate types such as IMU, are not affected. When the log buffer fills up, rate limited message types are slowed down further, and types with no limit are held to 50Hz or less, before anything else is dropped. Zero means no default limit.
+    // @Units: Hz
+    // @Range: 0 400
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_RATEMAX",  2, DataFlash_Class, _params.file_ratemax,        0),
+
     AP_GROUPEND
 };
 
@@ -43,15 +51,40 @@ void DataFlash_Class::set_mission(const AP_Mission *mission) {
 
 // start functions pass straight through to backend:
 void DataFlash_Class::WriteBlock(const void *pBuffer, uint16_t size) {
-    FOR_EACH_BACKEND(WriteBlock(pBuffer, size));
+    WritePrioritisedBlock(pBuffer, size, false);
 }
 
 void DataFlash_Class::WriteCriticalBlock(const void *pBuffer, uint16_t size) {
-    FOR_EACH_BACKEND(WriteCriticalBlock(pBuffer, size));
+    WritePrioritisedBlock(pBuffer, size, true);
 }
 
 void DataFlash_Class::WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) {
-    FOR_EACH_BACKEND(WritePrioritisedBlock(pBuffer, size, is_critical));
+    if (!is_critical &&
+        !_rate_limiter.should_log(((const uint8_t *)pBuffer)[2])) {
+        return;
+    }
+    write_to_backends(pBuffer, size, is_critical);
+}
+
+// write to every backend, counting messages a logging backend drops
+void DataFlash_Class::write_to_backends(const void *pBuffer, uint16_t size, bool is_critical) {
+    for (uint8_t i=0; i<_next_backend; i++) {
+        if (!backends[i]->WritePrioritisedBlock(pBuffer, size, is_critical) &&
+            backends[i]->logging_started()) {
+            _rate_limiter.count_dropped(((const uint8_t *)pBuffer)[2]);
+        }
+    }
+}
+
+uint8_t *DataFlash_Class::reserve_block(uint16_t size) {
+    if (_next_backend != 1) {
+        return nullptr;
+    }
+    return backends[0]->reserve_block(size);
+}
+
+void DataFlash_Class::commit_block(uint16_t size) {
+    backends[0]->commit_block(size);
 }
 
 // change me to "DoTimeConsumingPreparations"?
@@ -167,6 +200,32 @@ void DataFlash_Class::remote_log_block_status_msg(mavlink_channel_t chan,
 
 void DataFlash_Class::periodic_tasks() {
      FOR_EACH_BACKEND(periodic_tasks());
+     update_rate_limiter();
+
+     const uint32_t now = AP_HAL::millis();
+     if (now - _last_perf_log_ms >= 10000 && logging_started()) {
+         _last_perf_log_ms = now;
+         Log_Write_Perf();
+         Log_Write_Latency();
+     }
+}
+
+// follow the parameter and backend buffer levels, and log the
+// per-type counters once a second
+void DataFlash_Class::update_rate_limiter() {
+    _rate_limiter.set_default_rate(_params.file_ratemax);
+
+    uint8_t pressure = 0;
+    for (uint8_t i=0; i<_next_backend; i++) {
+        pressure = MAX(pressure, backends[i]->buffer_pressure());
+    }
+    _rate_limiter.set_pressure(pressure);
+
+    const uint32_t now = AP_HAL::millis();
+    if (now - _last_rate_log_ms >= 1000) {
+        _last_rate_log_ms = now;
+        Log_Write_Rate_Limit();
+    }
 }
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
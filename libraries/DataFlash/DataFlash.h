@@ -19,6 +19,7 @@
 #include <AP_Airspeed/AP_Airspeed.h>
 #include <AP_BattMonitor/AP_BattMonitor.h>
 #include <AP_RPM/AP_RPM.h>
+#include <AP_GyroFFT/AP_GyroFFT.h>
 #include <AP_RangeFinder/AP_RangeFinder.h>
 #include <DataFlash/LogStructure.h>
 #include <stdint.h>
@@ -28,6 +29,7 @@
 #endif
 
 #include "DFMessageWriter.h"
+#include "DataFlash_RateLimiter.h"
 
 class DataFlash_Backend;
 
@@ -70,6 +72,21 @@ public:
     /* Write an *important* block of data at current offset */
     void WriteCriticalBlock(const void *pBuffer, uint16_t size);
 
+    /* limit a message type to rate_hz, or 0 for the LOG_FILE_RATEMAX
+     * default. Vehicles call this after Init() for their own high rate
+     * types */
+    void set_msg_rate(uint8_t msg_type, uint8_t rate_hz) {
+        _rate_limiter.set_rate(msg_type, rate_hz);
+    }
+    /* never rate limit a message type */
+    void set_msg_full_rate(uint8_t msg_type) {
+        _rate_limiter.set_full_rate(msg_type);
+    }
+
+    /* Write a message described by a log schema (see LogSchema.h) */
+    template <typename S, typename... Args>
+    void WriteSchema(const Args &... args);
+
     // high level interface
     uint16_t find_last_log() const;
     void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page);
@@ -91,10 +108,13 @@ public:
 
     void Log_Write_Parameter(const char *name, float value);
     void Log_Write_GPS(const AP_GPS &gps, uint8_t instance, int32_t relative_alt);
+    void Log_Write_GPS_Blend(const AP_GPS &gps);
     void Log_Write_RFND(const RangeFinder &rangefinder);
     void Log_Write_IMU(const AP_InertialSensor &ins);
     void Log_Write_IMUDT(const AP_InertialSensor &ins);
     void Log_Write_Vibration(const AP_InertialSensor &ins);
+    void Log_Write_Notch(const AP_InertialSensor &ins);
+    void Log_Write_GyroFFT(const AP_GyroFFT &fft);
     void Log_Write_RCIN(void);
     void Log_Write_RCOUT(void);
     void Log_Write_RSSI(AP_RSSI &rssi);
@@ -156,6 +176,7 @@ public:
     struct {
         AP_Int8 backend_types;
         AP_Int8 file_bufsize; // in kilobytes
+        AP_Float file_ratemax;
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
@@ -176,6 +197,42 @@ private:
     uint8_t _next_backend;
     DataFlash_Backend *backends[DATAFLASH_MAX_BACKENDS];
     const char *_firmware_string;
+
+    DataFlash_RateLimiter _rate_limiter;
+    uint32_t _last_rate_log_ms;
+
+    void write_to_backends(const void *pBuffer, uint16_t size, bool is_critical);
+    void update_rate_limiter(void);
+    void Log_Write_Rate_Limit(void);
+
+    uint32_t _last_perf_log_ms;
+    void Log_Write_Perf(void);
+    void Log_Write_Latency(void);
+
+    uint8_t *reserve_block(uint16_t size);
+    void commit_block(uint16_t size);
 };
 
+/*
+  with a single backend that can take it, the message is packed
+  straight into the backend write buffer. Otherwise it is packed on
+  the stack and written to each backend as a block
+ */
+template <typename S, typename... Args>
+void DataFlash_Class::WriteSchema(const Args &... args)
+{
+    if (!_rate_limiter.should_log(S::msg_type)) {
+        return;
+    }
+    uint8_t *p = reserve_block(S::length);
+    if (p != nullptr) {
+        S::pack(p, args...);
+        commit_block(S::length);
+        return;
+    }
+    uint8_t buf[S::length];
+    S::pack(buf, args...);
+    write_to_backends(buf, S::length, false);
+}
+
 #endif
@@ -38,6 +38,15 @@ public:
 
     virtual bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) = 0;
 
+    /*
+      reserve size contiguous bytes in the write buffer so a message
+      can be packed in place. Returns NULL if the backend can't do
+      that right now, and the caller should use WriteBlock()
+      instead. A non-NULL return must be followed by commit_block()
+     */
+    virtual uint8_t *reserve_block(uint16_t size) { return NULL; }
+    virtual void commit_block(uint16_t size) { }
+
     // high level interface
     virtual uint16_t find_last_log() = 0;
     virtual void get_log_boundaries(uint16_t log_num, uint16_t & start_page, uint16_t & end_page) = 0;
@@ -63,6 +72,9 @@ public:
 
     virtual uint16_t bufferspace_available() = 0;
 
+    // how full the write buffer is, from 0 (keeping up) to 3 (nearly full)
+    virtual uint8_t buffer_pressure() { return 0; }
+
     virtual uint16_t start_new_log(void) = 0;
     bool log_write_started;
 
@@ -210,6 +210,22 @@ uint16_t DataFlash_File::bufferspace_available()
     return (BUF_SPACE(_writebuf)) - critical_message_reserved_space();
 }
 
+// free space of half the buffer or more is no pressure, with each
+// halving below that adding a level
+uint8_t DataFlash_File::buffer_pressure()
+{
+    if (_writebuf == NULL) {
+        return 0;
+    }
+    uint16_t _head;
+    uint32_t space = BUF_SPACE(_writebuf);
+    uint8_t pressure = 0;
+    while (pressure < 3 && space < (_writebuf_size >> (pressure+1))) {
+        pressure++;
+    }
+    return pressure;
+}
+
 // return true for CardInserted() if we successfully initialised
 bool DataFlash_File::CardInserted(void)
 {
@@ -538,6 +554,42 @@ bool DataFlash_File::WritePrioritisedBlock(const void *pBuffer, uint16_t size, b
     return true;
 }
 
+/*
+  reserve space for a non-critical message at the tail of the write
+  buffer. Anything unusual - startup messages still being written, a
+  full buffer or a message that would wrap - is left to
+  WritePrioritisedBlock()
+ */
+uint8_t *DataFlash_File::reserve_block(uint16_t size)
+{
+    if (_write_fd == -1 || !_initialised || _open_error || !_writes_enabled) {
+        return NULL;
+    }
+    if (_writing_startup_messages || !_startup_messagewriter->fmt_done()) {
+        return NULL;
+    }
+    if (((uint32_t)_writebuf_tail) + size > _writebuf_size) {
+        return NULL;
+    }
+    if (!semaphore->take(1)) {
+        return NULL;
+    }
+
+    uint16_t _head;
+    uint16_t space = BUF_SPACE(_writebuf);
+    if (space < critical_message_reserved_space() + size) {
+        semaphore->give();
+        return NULL;
+    }
+    return &_writebuf[_writebuf_tail];
+}
+
+void DataFlash_File::commit_block(uint16_t size)
+{
+    BUF_ADVANCETAIL(_writebuf, size);
+    semaphore->give();
+}
+
 /*
   read a packet. The header bytes have already been read.
 */
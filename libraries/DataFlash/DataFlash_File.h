@@ -47,7 +47,10 @@ public:
 
     /* Write a block of data at current offset */
     bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical);
+    uint8_t *reserve_block(uint16_t size);
+    void commit_block(uint16_t size);
     uint16_t bufferspace_available();
+    uint8_t buffer_pressure();
 
     // high level interface
     uint16_t find_last_log() override;
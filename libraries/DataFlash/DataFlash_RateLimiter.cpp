@@ -0,0 +1,119 @@
+#include "DataFlash_RateLimiter.h"
+
+#include <stdlib.h>
+
+#include <AP_Math/AP_Math.h>
+
+// slowest interval a limited type is stretched to under pressure
+#define RATELIMIT_MAX_PRESSURE 3
+
+// base rate for types with no limit of their own, so the first
+// pressure level holds them to half of this
+#define RATELIMIT_PRESSURE_RATE_HZ 100
+
+DataFlash_RateLimiter::DataFlash_RateLimiter(void) :
+    _state(NULL),
+    _default_rate_hz(0),
+    _pressure(0)
+{
+}
+
+bool DataFlash_RateLimiter::init(void)
+{
+    if (_state == NULL) {
+        _state = (msg_state *)calloc(256, sizeof(msg_state));
+    }
+    return _state != NULL;
+}
+
+void DataFlash_RateLimiter::set_rate(uint8_t msg_type, uint8_t rate_hz)
+{
+    if (_state == NULL) {
+        return;
+    }
+    _state[msg_type].rate_hz = rate_hz;
+    _state[msg_type].full_rate = false;
+}
+
+void DataFlash_RateLimiter::set_full_rate(uint8_t msg_type)
+{
+    if (_state == NULL) {
+        return;
+    }
+    _state[msg_type].full_rate = true;
+}
+
+bool DataFlash_RateLimiter::should_log(uint8_t msg_type)
+{
+    if (_state == NULL) {
+        return true;
+    }
+    msg_state &m = _state[msg_type];
+    if (m.full_rate) {
+        return true;
+    }
+
+    uint16_t interval_ms;
+    if (m.rate_hz != 0) {
+        interval_ms = 1000 / m.rate_hz;
+    } else if (_default_rate_hz > 0) {
+        interval_ms = 1000 / constrain_float(_default_rate_hz, 1, 1000);
+    } else if (_pressure != 0) {
+        // unlimited types are only thinned once the buffer fills
+        interval_ms = 1000 / RATELIMIT_PRESSURE_RATE_HZ;
+    } else {
+        return true;
+    }
+    interval_ms <<= MIN(_pressure, RATELIMIT_MAX_PRESSURE);
+
+    /*
+      samples are due on a fixed schedule and may come up to a quarter
+      of an interval early, so a type written at exactly its limit by
+      a jittery scheduler loses nothing while its average rate still
+      cannot exceed the limit
+     */
+    const uint16_t now = AP_HAL::millis();
+    if (now == m.last_ms) {
+        return true;
+    }
+    const int16_t early_ms = (int16_t)(m.next_ms - now);
+    if ((uint16_t)(now - m.last_ms) >= 2 * interval_ms || early_ms <= 0) {
+        // first sample, or late: restart the schedule from now
+        m.next_ms = now + interval_ms;
+    } else if (early_ms > (int16_t)(interval_ms / 4)) {
+        if (m.limited < UINT16_MAX) {
+            m.limited++;
+        }
+        return false;
+    } else {
+        m.next_ms += interval_ms;
+    }
+    m.last_ms = now;
+    return true;
+}
+
+void DataFlash_RateLimiter::count_dropped(uint8_t msg_type)
+{
+    if (_state != NULL && _state[msg_type].dropped < UINT16_MAX) {
+        _state[msg_type].dropped++;
+    }
+}
+
+bool DataFlash_RateLimiter::next_counts(uint8_t &msg_type, uint16_t &limited, uint16_t &dropped)
+{
+    if (_state == NULL) {
+        return false;
+    }
+    for (uint16_t i = msg_type; i < 256; i++) {
+        msg_state &m = _state[i];
+        if (m.limited != 0 || m.dropped != 0) {
+            msg_type = i;
+            limited = m.limited;
+            dropped = m.dropped;
+            m.limited = 0;
+            m.dropped = 0;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+#ifndef DATAFLASH_RATELIMITER_H
+#define DATAFLASH_RATELIMITER_H
+
+#include <AP_HAL/AP_HAL.h>
+
+/*
+  per message type rate limiting for DataFlash
+
+  Each message type can be given a maximum rate, and types without one
+  use the default rate from the LOG_FILE_RATEMAX parameter. Types
+  marked as full rate are never limited. When a backend reports that
+  its write buffer is filling up the interval of every limited type is
+  doubled for each pressure level, and types with no limit at all are
+  held to 50Hz at the first level and halved for each level after it. The high rate types
+  which tolerate decimation lose data first and in a predictable way,
+  while slow types such as GPS and events are left alone.
+
+  Messages of the same type written in the same millisecond (one per
+  instance or per axis) are treated as a single sample.
+ */
+class DataFlash_RateLimiter
+{
+public:
+    DataFlash_RateLimiter(void);
+
+    // allocate per type state. Returns false if out of memory
+    bool init(void);
+
+    // maximum rate in Hz for a message type, 0 for the default
+    // rate. Ignored until init() has succeeded
+    void set_rate(uint8_t msg_type, uint8_t rate_hz);
+
+    // never limit a message type. Ignored until init() has succeeded
+    void set_full_rate(uint8_t msg_type);
+
+    // default rate in Hz for types without their own rate, 0 for none
+    void set_default_rate(float rate_hz) { _default_rate_hz = rate_hz; }
+
+    // buffer pressure, 0 when the backends are keeping up
+    void set_pressure(uint8_t pressure) { _pressure = pressure; }
+    uint8_t get_pressure(void) const { return _pressure; }
+
+    // true if a non-critical message of this type should be written now
+    bool should_log(uint8_t msg_type);
+
+    // count a message of this type the backends failed to write
+    void count_dropped(uint8_t msg_type);
+
+    /*
+      get and clear the counters for the next type at or after
+      msg_type with messages limited or dropped since the last call.
+      Returns false when there are no more
+     */
+    bool next_counts(uint8_t &msg_type, uint16_t &limited, uint16_t &dropped);
+
+private:
+    struct msg_state {
+        uint16_t last_ms;
+        uint16_t next_ms;
+        uint16_t limited;
+        uint16_t dropped;
+        uint8_t rate_hz;
+        bool full_rate;
+    };
+    msg_state *_state;
+
+    float _default_rate_hz;
+    uint8_t _pressure;
+};
+
+#endif // DATAFLASH_RATELIMITER_H
@@ -73,6 +73,31 @@ void DataFlash_Class::Init(const struct LogStructure *structures, uint8_t num_ty
     for (uint8_t i=0; i<_next_backend; i++) {
         backends[i]->Init();
     }
+
+#if HAL_CPU_CLASS > HAL_CPU_CLASS_16
+    if (_rate_limiter.init()) {
+        // sensor data is only useful at the rate it was sampled
+        set_msg_full_rate(LOG_IMU_MSG);
+        set_msg_full_rate(LOG_IMU2_MSG);
+        set_msg_full_rate(LOG_IMU3_MSG);
+        set_msg_full_rate(LOG_IMUDT_MSG);
+        set_msg_full_rate(LOG_IMUDT2_MSG);
+        set_msg_full_rate(LOG_IMUDT3_MSG);
+
+        // attitude, estimator and PID state are logged at up to
+        // 50Hz, and are the first to be thinned when the buffer fills
+        static const uint8_t fifty_hz_types[] = {
+            LOG_ATTITUDE_MSG, LOG_AHR2_MSG, LOG_POS_MSG,
+            LOG_EKF1_MSG, LOG_EKF2_MSG, LOG_EKF3_MSG, LOG_EKF4_MSG, LOG_EKF5_MSG,
+            LOG_NKF1_MSG, LOG_NKF2_MSG, LOG_NKF3_MSG, LOG_NKF4_MSG, LOG_NKF5_MSG,
+            LOG_NKF6_MSG, LOG_NKF7_MSG, LOG_NKF8_MSG, LOG_NKF9_MSG,
+            LOG_PIDR_MSG, LOG_PIDP_MSG, LOG_PIDY_MSG, LOG_PIDA_MSG, LOG_PIDS_MSG,
+        };
+        for (uint8_t i=0; i<ARRAY_SIZE(fifty_hz_types); i++) {
+            set_msg_rate(fifty_hz_types[i], 50);
+        }
+    }
+#endif
 }
 
 // This function determines the number of whole or partial log files in the DataFlash
@@ -702,9 +727,14 @@ bool DataFlash_Backend::Log_Write_Parameter(const AP_Param *ap,
 // Write an GPS packet
 void DataFlash_Class::Log_Write_GPS(const AP_GPS &gps, uint8_t i, int32_t relative_alt)
 {
+    static const uint8_t gps_msgs[GPS_MAX_INSTANCES] = { LOG_GPS_MSG, LOG_GPS2_MSG, LOG_GPS3_MSG, LOG_GPSB_MSG };
+    static const uint8_t gpa_msgs[GPS_MAX_INSTANCES] = { LOG_GPA_MSG, LOG_GPA2_MSG, LOG_GPA3_MSG, LOG_GPAB_MSG };
+    if (i >= GPS_MAX_INSTANCES) {
+        return;
+    }
     const struct Location &loc = gps.location(i);
     struct log_GPS pkt = {
-        LOG_PACKET_HEADER_INIT((uint8_t)(LOG_GPS_MSG+i)),
+        LOG_PACKET_HEADER_INIT(gps_msgs[i]),
         time_us       : AP_HAL::micros64(),
         status        : (uint8_t)gps.status(i),
         gps_week_ms   : gps.time_week_ms(i),
@@ -728,7 +758,7 @@ void DataFlash_Class::Log_Write_GPS(const AP_GPS &gps, uint8_t i, int32_t relati
     gps.vertical_accuracy(i, vacc);
     gps.speed_accuracy(i, sacc);
     struct log_GPA pkt2 = {
-        LOG_PACKET_HEADER_INIT((uint8_t)(LOG_GPA_MSG+i)),
+        LOG_PACKET_HEADER_INIT(gpa_msgs[i]),
         time_us       : AP_HAL::micros64(),
         vdop          : gps.get_vdop(i),
         hacc          : (uint16_t)(hacc*100),
@@ -736,6 +766,22 @@ void DataFlash_Class::Log_Write_GPS(const AP_GPS &gps, uint8_t i, int32_t relati
         sacc          : (uint16_t)(sacc*100)
     };
     WriteBlock(&pkt2, sizeof(pkt2));
+
+    if (i == GPS_BLENDED_INSTANCE) {
+        Log_Write_GPS_Blend(gps);
+    }
+}
+
+// Write the weight and offset of each receiver in the blended GPS solution
+void DataFlash_Class::Log_Write_GPS_Blend(const AP_GPS &gps)
+{
+    WriteSchema<log_GPS_Blend>(AP_HAL::micros64(),
+                               gps.get_blend_weight(0),
+                               gps.get_blend_weight(1),
+                               gps.get_blend_weight(2),
+                               gps.get_blend_offset(0).length(),
+                               gps.get_blend_offset(1).length(),
+                               gps.get_blend_offset(2).length());
 }
 
 
@@ -1005,6 +1051,86 @@ void DataFlash_Class::Log_Write_Vibration(const AP_InertialSensor &ins)
     WriteBlock(&pkt, sizeof(pkt));
 }
 
+// Write the state of the gyro harmonic notch filter
+void DataFlash_Class::Log_Write_Notch(const AP_InertialSensor &ins)
+{
+    const HarmonicNotchFilterParams &notch = ins.get_gyro_harmonic_notch_params();
+    WriteSchema<log_Notch>(AP_HAL::micros64(),
+                           (uint8_t)notch.tracking_mode(),
+                           notch.center_freq_hz(),
+                           ins.get_harmonic_notch_freq_hz());
+}
+
+// Write the latest gyro spectrum analysis, one packet per axis
+void DataFlash_Class::Log_Write_GyroFFT(const AP_GyroFFT &fft)
+{
+    uint64_t now = AP_HAL::micros64();
+    for (uint8_t i = 0; i < 3; i++) {
+        const AP_GyroFFT::Axis &axis = fft.get_axis(i);
+        WriteSchema<log_GyroFFT>(now, i,
+                                 axis.valid ? axis.peak_freq_hz : 0.0f,
+                                 axis.peak_energy,
+                                 axis.total_energy,
+                                 axis.band_energy[0],
+                                 axis.band_energy[1],
+                                 axis.band_energy[2],
+                                 axis.band_energy[3]);
+    }
+}
+
+// Write the messages rate limited or dropped for each type since the last call
+void DataFlash_Class::Log_Write_Rate_Limit(void)
+{
+    uint64_t now = AP_HAL::micros64();
+    uint8_t msg_type = 0;
+    uint16_t limited, dropped;
+    while (_rate_limiter.next_counts(msg_type, limited, dropped)) {
+        uint8_t buf[log_Rate_Limit::length];
+        log_Rate_Limit::pack(buf, now, msg_type, limited, dropped,
+                             _rate_limiter.get_pressure());
+        write_to_backends(buf, sizeof(buf), true);
+        if (msg_type == 255) {
+            break;
+        }
+        msg_type++;
+    }
+}
+
+// Write a summary of every elapsed perf counter the HAL can report
+void DataFlash_Class::Log_Write_Perf(void)
+{
+    uint64_t now = AP_HAL::micros64();
+    AP_HAL::Util::perf_stats stats;
+    for (uint16_t i = 0; hal.util->perf_get_stats(i, stats); i++) {
+        if (stats.type != AP_HAL::Util::PC_ELAPSED || stats.count == 0) {
+            continue;
+        }
+        WriteSchema<log_Perf>(now,
+                              stats.name,
+                              (uint32_t)stats.count,
+                              (uint32_t)(stats.total_us / stats.count),
+                              stats.max_us);
+    }
+}
+
+// write the scheduling latency of each thread the HAL tracks
+void DataFlash_Class::Log_Write_Latency(void)
+{
+    uint64_t now = AP_HAL::micros64();
+    AP_HAL::Scheduler::latency_stats stats;
+    for (uint8_t i = 0; hal.scheduler->get_latency_stats(i, stats); i++) {
+        WriteSchema<log_Latency>(now,
+                                 stats.name,
+                                 stats.count,
+                                 stats.late_max_us,
+                                 stats.late_p99_us,
+                                 stats.run_max_us,
+                                 stats.run_p99_us,
+                                 stats.missed,
+                                 stats.preempted);
+    }
+}
+
 // Write a mission command. Total length : 36 bytes
 bool DataFlash_Backend::Log_Write_Mission_Cmd(const AP_Mission &mission,
                                               const AP_Mission::Mission_Command &cmd)
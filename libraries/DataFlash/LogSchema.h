@@ -0,0 +1,145 @@
+#ifndef _LOGSCHEMA_H
+#define _LOGSCHEMA_H
+
+/*
+  compile time log message schemas
+
+  A schema describes a log message once, as its id, name, format
+  string and labels:
+
+    #define LOG_FOO_SCHEMA(X) \
+        X(log_Foo, LOG_FOO_MSG, "FOO", "QBf", "TimeUS,Mode,Val")
+
+  LOG_SCHEMA_DECLARE(LOG_FOO_SCHEMA) creates the log_Foo type,
+  whose length and field types come from the format string, and
+  LOG_SCHEMA_STRUCTURE(LOG_FOO_SCHEMA) gives the matching LogStructure
+  entry for the FMT message. A message is then written with
+
+    DataFlash.WriteSchema<log_Foo>(AP_HAL::micros64(), mode, val);
+
+  which checks the number of values against the format at compile
+  time and packs them directly into the log buffer, so there is no
+  PACKED struct to keep in step with the format string.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_PACKET_HEADER_LEN 3
+
+// size in bytes of one format character, zero if unknown
+constexpr uint8_t df_field_size(char f)
+{
+    return (f == 'b' || f == 'B' || f == 'M') ? 1 :
+           (f == 'h' || f == 'H' || f == 'c' || f == 'C') ? 2 :
+           (f == 'i' || f == 'I' || f == 'e' || f == 'E' || f == 'L' || f == 'f' || f == 'n') ? 4 :
+           (f == 'q' || f == 'Q' || f == 'N') ? (f == 'N' ? 16 : 8) :
+           (f == 'Z') ? 64 : 0;
+}
+
+// payload size of a format string, not including the header
+constexpr uint16_t df_format_size(const char *fmt)
+{
+    return *fmt == 0 ? 0 : df_field_size(*fmt) + df_format_size(fmt + 1);
+}
+
+// true if every character of a format string is known
+constexpr bool df_format_valid(const char *fmt)
+{
+    return *fmt == 0 || (df_field_size(*fmt) != 0 && df_format_valid(fmt + 1));
+}
+
+/*
+  C type and packing for each format character. An unknown character
+  has no specialisation and fails to compile
+ */
+template <char F> struct DFField;
+
+#define DF_FIELD_SCALAR(ch, ctype)                                      \
+    template <> struct DFField<ch> {                                    \
+        typedef ctype type;                                             \
+        static const uint8_t size = sizeof(ctype);                      \
+        static void put(uint8_t *p, type v) { memcpy(p, &v, sizeof(v)); } \
+    }
+
+#define DF_FIELD_STRING(ch, len)                                        \
+    template <> struct DFField<ch> {                                    \
+        typedef const char *type;                                       \
+        static const uint8_t size = len;                                \
+        static void put(uint8_t *p, type v) { strncpy((char *)p, v, len); } \
+    }
+
+DF_FIELD_SCALAR('b', int8_t);
+DF_FIELD_SCALAR('B', uint8_t);
+DF_FIELD_SCALAR('M', uint8_t);
+DF_FIELD_SCALAR('h', int16_t);
+DF_FIELD_SCALAR('H', uint16_t);
+DF_FIELD_SCALAR('c', int16_t);
+DF_FIELD_SCALAR('C', uint16_t);
+DF_FIELD_SCALAR('i', int32_t);
+DF_FIELD_SCALAR('I', uint32_t);
+DF_FIELD_SCALAR('e', int32_t);
+DF_FIELD_SCALAR('E', uint32_t);
+DF_FIELD_SCALAR('L', int32_t);
+DF_FIELD_SCALAR('f', float);
+DF_FIELD_SCALAR('q', int64_t);
+DF_FIELD_SCALAR('Q', uint64_t);
+DF_FIELD_STRING('n', 4);
+DF_FIELD_STRING('N', 16);
+DF_FIELD_STRING('Z', 64);
+
+#undef DF_FIELD_SCALAR
+#undef DF_FIELD_STRING
+
+/*
+  pack values into consecutive fields of schema S, starting at format
+  character I
+ */
+template <typename S, uint8_t I, typename... Args> struct DFPacker;
+
+template <typename S, uint8_t I>
+struct DFPacker<S, I> {
+    static_assert(S::field(I) == 0, "too few values for log message format");
+    static void put(uint8_t *) {}
+};
+
+template <typename S, uint8_t I, typename T, typename... Rest>
+struct DFPacker<S, I, T, Rest...> {
+    static_assert(S::field(I) != 0, "too many values for log message format");
+    typedef DFField<S::field(I)> F;
+    static_assert(F::size == df_field_size(S::field(I)), "log field size mismatch");
+
+    static void put(uint8_t *p, const T &v, const Rest &... rest) {
+        F::put(p, v);
+        DFPacker<S, I+1, Rest...>::put(p + F::size, rest...);
+    }
+};
+
+#define LOG_SCHEMA_TYPE(sname, id, name, fmt, labels)                   \
+    struct sname {                                                      \
+        static_assert(df_format_valid(fmt), "unknown format character in " name); \
+        static_assert(sizeof(fmt) <= 16, "format too long in " name);   \
+        static_assert(sizeof(labels) <= 64, "labels too long in " name); \
+        static_assert(LOG_PACKET_HEADER_LEN + df_format_size(fmt) <= 255, "message too long in " name); \
+        static constexpr uint8_t msg_type = id;                         \
+        static constexpr uint8_t length = LOG_PACKET_HEADER_LEN + df_format_size(fmt); \
+        static constexpr char field(uint8_t i) { return fmt[i]; }       \
+        template <typename... Args>                                     \
+        static void pack(uint8_t *p, const Args &... args) {            \
+            p[0] = HEAD_BYTE1;                                          \
+            p[1] = HEAD_BYTE2;                                          \
+            p[2] = id;                                                  \
+            DFPacker<sname, 0, Args...>::put(p + LOG_PACKET_HEADER_LEN, args...); \
+        }                                                               \
+    }
+
+#define LOG_SCHEMA_ENTRY(sname, id, name, fmt, labels)                  \
+    { id, LOG_PACKET_HEADER_LEN + df_format_size(fmt), name, fmt, labels }
+
+// declare the schema type for a LOG_*_SCHEMA definition
+#define LOG_SCHEMA_DECLARE(schema) schema(LOG_SCHEMA_TYPE)
+
+// LogStructure entry for a LOG_*_SCHEMA definition
+#define LOG_SCHEMA_STRUCTURE(schema) schema(LOG_SCHEMA_ENTRY)
+
+#endif // _LOGSCHEMA_H
@@ -13,6 +13,8 @@
 #define HEAD_BYTE1  0xA3    // Decimal 163
 #define HEAD_BYTE2  0x95    // Decimal 149
 
+#include "LogSchema.h"
+
 // structure used to define logging format
 struct LogStructure {
     uint8_t msg_type;
@@ -588,6 +590,24 @@ struct PACKED log_RPM {
     float rpm2;
 };
 
+/*
+  messages defined by a schema, see LogSchema.h
+ */
+#define LOG_NOTCH_SCHEMA(X) \
+    X(log_Notch, LOG_NOTCH_MSG, "FTN", "QBff", "TimeUS,Mode,BFreq,Freq")
+#define LOG_GYRO_FFT_SCHEMA(X) \
+    X(log_GyroFFT, LOG_GYRO_FFT_MSG, "FFT", "QBfffffff", "TimeUS,Axis,PkHz,PkEn,TotEn,B0,B1,B2,B3")
+#define LOG_GPS_BLEND_SCHEMA(X) \
+    X(log_GPS_Blend, LOG_GPS_BLEND_MSG, "GBLD", "Qffffff", "TimeUS,W1,W2,W3,Off1,Off2,Off3")
+#define LOG_GPS_INJECT_SCHEMA(X) \
+    X(log_GPS_Inject, LOG_GPS_INJECT_MSG, "GINJ", "QIIIIII", "TimeUS,Frames,Raw,CRC,Skip,Drop,Late")
+#define LOG_RATE_LIMIT_SCHEMA(X) \
+    X(log_Rate_Limit, LOG_RATE_LIMIT_MSG, "LRAT", "QBHHB", "TimeUS,Type,Lim,Drop,Pres")
+#define LOG_PERF_SCHEMA(X) \
+    X(log_Perf, LOG_PERF_MSG, "PERF", "QNIII", "TimeUS,Name,N,Avg,Max")
+#define LOG_LATENCY_SCHEMA(X) \
+    X(log_Latency, LOG_LATENCY_MSG, "LAT", "QNIIIIIII", "TimeUS,Name,N,LMax,L99,RMax,R99,Miss,Pre")
+
 // #if SBP_HW_LOGGING
 
 struct PACKED log_SbpLLH {
@@ -814,7 +834,22 @@ Format characters in the format string for binary log messages
     { LOG_ORGN_MSG, sizeof(log_ORGN), \
       "ORGN","QBLLe","TimeUS,Type,Lat,Lng,Alt" }, \
     { LOG_RPM_MSG, sizeof(log_RPM), \
-      "RPM",  "Qff", "TimeUS,rpm1,rpm2" }
+      "RPM",  "Qff", "TimeUS,rpm1,rpm2" }, \
+    LOG_SCHEMA_STRUCTURE(LOG_NOTCH_SCHEMA), \
+    LOG_SCHEMA_STRUCTURE(LOG_GYRO_FFT_SCHEMA), \
+    { LOG_GPS3_MSG, sizeof(log_GPS), \
+      "GPS3", "QBIHBcLLeeEefB", "TimeUS,Status,GMS,GWk,NSats,HDop,Lat,Lng,RAlt,Alt,Spd,GCrs,VZ,U" }, \
+    { LOG_GPSB_MSG, sizeof(log_GPS), \
+      "GPSB", "QBIHBcLLeeEefB", "TimeUS,Status,GMS,GWk,NSats,HDop,Lat,Lng,RAlt,Alt,Spd,GCrs,VZ,U" }, \
+    { LOG_GPA3_MSG, sizeof(log_GPA), \
+      "GPA3", "QCCCC", "TimeUS,VDop,HAcc,VAcc,SAcc" }, \
+    { LOG_GPAB_MSG, sizeof(log_GPA), \
+      "GPAB", "QCCCC", "TimeUS,VDop,HAcc,VAcc,SAcc" }, \
+    LOG_SCHEMA_STRUCTURE(LOG_GPS_BLEND_SCHEMA), \
+    LOG_SCHEMA_STRUCTURE(LOG_GPS_INJECT_SCHEMA), \
+    LOG_SCHEMA_STRUCTURE(LOG_RATE_LIMIT_SCHEMA), \
+    LOG_SCHEMA_STRUCTURE(LOG_PERF_SCHEMA), \
+    LOG_SCHEMA_STRUCTURE(LOG_LATENCY_SCHEMA)
 
 // #if SBP_HW_LOGGING
 #define LOG_SBP_STRUCTURES \
@@ -923,10 +958,30 @@ enum LogMessages {
     LOG_MSG_SBPRAW2,
     LOG_MSG_SBPRAWx,
 
+    LOG_NOTCH_MSG,
+    LOG_GYRO_FFT_MSG,
+    LOG_GPS3_MSG,
+    LOG_GPSB_MSG,
+    LOG_GPA3_MSG,
+    LOG_GPAB_MSG,
+    LOG_GPS_BLEND_MSG,
+    LOG_GPS_INJECT_MSG,
+    LOG_RATE_LIMIT_MSG,
+    LOG_PERF_MSG,
+    LOG_LATENCY_MSG,
+
 // message types 211 to 220 reversed for autotune use
 
 };
 
+LOG_SCHEMA_DECLARE(LOG_NOTCH_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_GYRO_FFT_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_GPS_BLEND_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_GPS_INJECT_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_RATE_LIMIT_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_PERF_SCHEMA);
+LOG_SCHEMA_DECLARE(LOG_LATENCY_SCHEMA);
+
 enum LogOriginType {
     ekf_origin = 0,
     ahrs_home = 1
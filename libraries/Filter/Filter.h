@@ -11,6 +11,8 @@
 #include "LowPassFilter.h"
 #include "ModeFilter.h"
 #include "Butter.h"
+#include "NotchFilter.h"
+#include "HarmonicNotchFilter.h"
 
 #endif //__FILTER_H__
 
@@ -0,0 +1,130 @@
+#include "HarmonicNotchFilter.h"
+
+template <class T>
+HarmonicNotchFilter<T>::HarmonicNotchFilter() :
+    _num_filters(0),
+    _sample_freq_hz(0),
+    _center_freq_hz(0)
+{
+}
+
+template <class T>
+void HarmonicNotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz,
+                                  float attenuation_dB, uint8_t harmonics)
+{
+    _sample_freq_hz = sample_freq_hz;
+    _center_freq_hz = center_freq_hz;
+    _num_filters = 0;
+
+    for (uint8_t i = 0; i < HNF_MAX_HARMONICS; i++) {
+        if (!(harmonics & (1U << i))) {
+            continue;
+        }
+        const uint8_t n = i + 1;
+        // keep the same Q on all harmonics by scaling the bandwidth
+        _filters[_num_filters].init(sample_freq_hz, center_freq_hz * n, bandwidth_hz * n, attenuation_dB);
+        _filters[_num_filters].reset();
+        _harmonic_number[_num_filters] = n;
+        _num_filters++;
+    }
+}
+
+template <class T>
+void HarmonicNotchFilter<T>::update(float center_freq_hz)
+{
+    if (is_equal(center_freq_hz, _center_freq_hz)) {
+        return;
+    }
+    _center_freq_hz = center_freq_hz;
+
+    // harmonics above the Nyquist frequency disable themselves
+    for (uint8_t i = 0; i < _num_filters; i++) {
+        _filters[i].set_center_freq_hz(center_freq_hz * _harmonic_number[i]);
+    }
+}
+
+template <class T>
+T HarmonicNotchFilter<T>::apply(const T &sample)
+{
+    T output = sample;
+    for (uint8_t i = 0; i < _num_filters; i++) {
+        output = _filters[i].apply(output);
+    }
+    return output;
+}
+
+template <class T>
+void HarmonicNotchFilter<T>::reset()
+{
+    for (uint8_t i = 0; i < _num_filters; i++) {
+        _filters[i].reset();
+    }
+}
+
+/* 
+ * Make an instances
+ * Otherwise we have to move the constructor implementations to the header file :P
+ */
+template class HarmonicNotchFilter<float>;
+template class HarmonicNotchFilter<Vector3f>;
+
+const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
+    // @Param: ENABLE
+    // @DisplayName: Harmonic notch filter enable
+    // @Description: Harmonic notch filter enable
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("ENABLE", 1, HarmonicNotchFilterParams, _enable, 0),
+
+    // @Param: FREQ
+    // @DisplayName: Harmonic notch filter base frequency
+    // @Description: Notch center frequency in Hz. This is the frequency at the reference value when the notch is tracking throttle or RPM, and the lowest frequency the notch will be moved to
+    // @Range: 10 400
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("FREQ", 2, HarmonicNotchFilterParams, _center_freq_hz, 80),
+
+    // @Param: BW
+    // @DisplayName: Harmonic notch filter bandwidth
+    // @Description: Harmonic notch filter bandwidth of the fundamental in Hz. Harmonics get a proportionally wider notch
+    // @Range: 5 100
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO("BW", 3, HarmonicNotchFilterParams, _bandwidth_hz, 40),
+
+    // @Param: ATT
+    // @DisplayName: Harmonic notch filter attenuation
+    // @Description: Harmonic notch filter attenuation at the center frequency in dB
+    // @Range: 5 30
+    // @Units: dB
+    // @User: Advanced
+    AP_GROUPINFO("ATT", 4, HarmonicNotchFilterParams, _attenuation_dB, 15),
+
+    // @Param: HMNCS
+    // @DisplayName: Harmonic notch filter harmonics
+    // @Description: Bitmask of harmonic frequencies to apply notches to. Bit 0 is the base frequency
+    // @Bitmask: 0:1st harmonic,1:2nd harmonic,2:3rd harmonic,3:4th harmonic,4:5th harmonic,5:6th harmonic,6:7th harmonic,7:8th harmonic
+    // @User: Advanced
+    AP_GROUPINFO("HMNCS", 5, HarmonicNotchFilterParams, _harmonics, 3),
+
+    // @Param: REF
+    // @DisplayName: Harmonic notch filter reference value
+    // @Description: Reference value for frequency scaling. With throttle tracking this is the throttle (0 to 1) at which the motors run at the base frequency, normally the hover throttle. With RPM tracking it is the ratio of the vibration frequency to the measured RPM in Hz. Zero disables tracking
+    // @Range: 0.0 1.0
+    // @User: Advanced
+    AP_GROUPINFO("REF", 6, HarmonicNotchFilterParams, _reference, 0),
+
+    // @Param: MODE
+    // @DisplayName: Harmonic notch filter tracking mode
+    // @Description: Source used to move the base frequency of the notch
+    // @Values: 0:Fixed,1:Throttle,2:RPM sensor,3:Gyro FFT
+    // @User: Advanced
+    AP_GROUPINFO("MODE", 7, HarmonicNotchFilterParams, _tracking_mode, TRACKING_THROTTLE),
+
+    AP_GROUPEND
+};
+
+HarmonicNotchFilterParams::HarmonicNotchFilterParams(void)
+{
+    AP_Param::setup_object_defaults(this, var_info);
+}
@@ -0,0 +1,101 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HARMONICNOTCHFILTER_H
+#define HARMONICNOTCHFILTER_H
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Param/AP_Param.h>
+#include "NotchFilter.h"
+
+// maximum number of harmonics, including the fundamental
+#define HNF_MAX_HARMONICS 8
+
+/// @file   HarmonicNotchFilter.h
+/// @brief  A bank of notch filters placed on a base frequency and its
+///         harmonics. The base frequency can be changed at runtime, for
+///         example to track motor speed
+template <class T>
+class HarmonicNotchFilter {
+public:
+    HarmonicNotchFilter();
+
+    // set the filter parameters. harmonics is a bitmask with bit 0 for
+    // the fundamental, bit 1 for the second harmonic and so on
+    void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB, uint8_t harmonics);
+
+    // move the notches to a new base frequency. Coefficients are only
+    // recalculated if the frequency has actually changed
+    void update(float center_freq_hz);
+
+    T apply(const T &sample);
+    void reset();
+
+    float get_center_freq_hz(void) const { return _center_freq_hz; }
+    float get_sample_freq_hz(void) const { return _sample_freq_hz; }
+
+private:
+    NotchFilter<T> _filters[HNF_MAX_HARMONICS];
+
+    // harmonic number (1 for the fundamental) of each active filter
+    uint8_t _harmonic_number[HNF_MAX_HARMONICS];
+    uint8_t _num_filters;
+
+    float _sample_freq_hz;
+    float _center_freq_hz;
+};
+
+typedef HarmonicNotchFilter<float>    HarmonicNotchFilterFloat;
+typedef HarmonicNotchFilter<Vector3f> HarmonicNotchFilterVector3f;
+
+/*
+  parameters for a harmonic notch filter, for use as a parameter
+  subgroup by the owner of the filter
+ */
+class HarmonicNotchFilterParams {
+public:
+    // source of the base frequency of the notch
+    enum TrackingMode {
+        TRACKING_FIXED    = 0,
+        TRACKING_THROTTLE = 1,
+        TRACKING_RPM      = 2,
+        TRACKING_FFT      = 3,
+    };
+
+    HarmonicNotchFilterParams(void);
+
+    bool enabled(void) const { return _enable != 0; }
+    float center_freq_hz(void) const { return _center_freq_hz; }
+    float bandwidth_hz(void) const { return _bandwidth_hz; }
+    float attenuation_dB(void) const { return _attenuation_dB; }
+    uint8_t harmonics(void) const { return _harmonics; }
+    float reference(void) const { return _reference; }
+    enum TrackingMode tracking_mode(void) const { return (enum TrackingMode)_tracking_mode.get(); }
+
+    static const struct AP_Param::GroupInfo var_info[];
+
+private:
+    AP_Int8 _enable;
+    AP_Float _center_freq_hz;
+    AP_Float _bandwidth_hz;
+    AP_Float _attenuation_dB;
+    AP_Int8 _harmonics;
+    AP_Float _reference;
+    AP_Int8 _tracking_mode;
+};
+
+#endif // HARMONICNOTCHFILTER_H
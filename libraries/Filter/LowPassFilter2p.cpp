@@ -26,6 +26,43 @@ T DigitalBiquadFilter<T>::apply(const T &sample, const struct biquad_params &par
     return output;
 }
 
+/*
+  run a block of samples through the filter. The parameters and delay
+  elements are loaded once for the whole block, so this is considerably
+  cheaper than calling apply() per sample when a driver reads a burst of
+  samples from a FIFO. Returns the output for the last sample
+ */
+template <class T>
+T DigitalBiquadFilter<T>::apply_block(const T *samples, uint16_t count, const struct biquad_params &params) {
+    if (count == 0) {
+        return T();
+    }
+    if(is_zero(params.cutoff_freq) || is_zero(params.sample_freq)) {
+        return samples[count-1];
+    }
+
+    const float a1 = params.a1;
+    const float a2 = params.a2;
+    const float b0 = params.b0;
+    const float b1 = params.b1;
+    const float b2 = params.b2;
+    T delay_element_1 = _delay_element_1;
+    T delay_element_2 = _delay_element_2;
+    T output = T();
+
+    for (uint16_t i = 0; i < count; i++) {
+        T delay_element_0 = samples[i] - delay_element_1 * a1 - delay_element_2 * a2;
+        output = delay_element_0 * b0 + delay_element_1 * b1 + delay_element_2 * b2;
+        delay_element_2 = delay_element_1;
+        delay_element_1 = delay_element_0;
+    }
+
+    _delay_element_1 = delay_element_1;
+    _delay_element_2 = delay_element_2;
+
+    return output;
+}
+
 template <class T>
 void DigitalBiquadFilter<T>::reset() { 
     _delay_element_1 = _delay_element_2 = T();
@@ -86,6 +123,11 @@ T LowPassFilter2p<T>::apply(const T &sample) {
     return _filter.apply(sample, _params);
 }
 
+template <class T>
+T LowPassFilter2p<T>::apply_block(const T *samples, uint16_t count) {
+    return _filter.apply_block(samples, count, _params);
+}
+
 template <class T>
 void LowPassFilter2p<T>::reset(void) {
     return _filter.reset();
@@ -42,6 +42,7 @@ public:
     DigitalBiquadFilter();
 
     T apply(const T &sample, const struct biquad_params &params);
+    T apply_block(const T *samples, uint16_t count, const struct biquad_params &params);
     void reset();
     static void compute_params(float sample_freq, float cutoff_freq, biquad_params &ret);
     
@@ -62,6 +63,8 @@ public:
     float get_cutoff_freq(void) const;
     float get_sample_freq(void) const;
     T apply(const T &sample);
+    // filter a contiguous block of samples, returning the last output
+    T apply_block(const T *samples, uint16_t count);
     void reset(void);
 
 protected:
@@ -0,0 +1,97 @@
+#include "NotchFilter.h"
+
+template <class T>
+NotchFilter<T>::NotchFilter() :
+    _initialised(false),
+    _sample_freq_hz(0),
+    _center_freq_hz(0),
+    _bandwidth_hz(0),
+    _attenuation_dB(0),
+    _b0(1), _b1(0), _b2(0), _a1(0), _a2(0)
+{
+    reset();
+}
+
+/*
+  initialise the filter. The bandwidth is the width of the notch at the
+  -3dB points
+ */
+template <class T>
+void NotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB)
+{
+    _sample_freq_hz = sample_freq_hz;
+    _bandwidth_hz = bandwidth_hz;
+    _attenuation_dB = attenuation_dB;
+    set_center_freq_hz(center_freq_hz);
+}
+
+template <class T>
+void NotchFilter<T>::set_center_freq_hz(float center_freq_hz)
+{
+    _center_freq_hz = center_freq_hz;
+
+    // the notch has to fit between DC and the Nyquist frequency
+    if (_sample_freq_hz <= 0.0f ||
+        _bandwidth_hz <= 0.0f ||
+        center_freq_hz <= 0.5f * _bandwidth_hz ||
+        center_freq_hz >= 0.5f * _sample_freq_hz) {
+        _initialised = false;
+        return;
+    }
+
+    calculate_coefficients();
+    if (!_initialised) {
+        // the filter has been passing samples through, so its history
+        // is stale
+        reset();
+        _initialised = true;
+    }
+}
+
+template <class T>
+void NotchFilter<T>::calculate_coefficients(void)
+{
+    const float omega = 2.0f * PI * _center_freq_hz / _sample_freq_hz;
+    const float octaves = log2f(_center_freq_hz / (_center_freq_hz - _bandwidth_hz * 0.5f)) * 2.0f;
+    const float Q = sqrtf(powf(2.0f, octaves)) / (powf(2.0f, octaves) - 1.0f);
+    const float A = powf(10.0f, -_attenuation_dB / 40.0f);
+    const float alpha = sinf(omega) / (2.0f * Q / A);
+    const float a0_inv = 1.0f / (1.0f + alpha);
+
+    _b0 = (1.0f + alpha * A * A) * a0_inv;
+    _b1 = -2.0f * cosf(omega) * a0_inv;
+    _b2 = (1.0f - alpha * A * A) * a0_inv;
+    _a1 = _b1;
+    _a2 = (1.0f - alpha) * a0_inv;
+}
+
+template <class T>
+T NotchFilter<T>::apply(const T &sample)
+{
+    if (!_initialised) {
+        return sample;
+    }
+
+    T output = sample * _b0 + _ntchsig1 * _b1 + _ntchsig2 * _b2 - _signal1 * _a1 - _signal2 * _a2;
+
+    _ntchsig2 = _ntchsig1;
+    _ntchsig1 = sample;
+    _signal2 = _signal1;
+    _signal1 = output;
+
+    return output;
+}
+
+template <class T>
+void NotchFilter<T>::reset()
+{
+    _signal1 = _signal2 = T();
+    _ntchsig1 = _ntchsig2 = T();
+}
+
+/* 
+ * Make an instances
+ * Otherwise we have to move the constructor implementations to the header file :P
+ */
+template class NotchFilter<float>;
+template class NotchFilter<Vector3f>;
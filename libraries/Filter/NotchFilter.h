@@ -0,0 +1,63 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NOTCHFILTER_H
+#define NOTCHFILTER_H
+
+#include <AP_Math/AP_Math.h>
+#include <math.h>
+#include <inttypes.h>
+
+/// @file   NotchFilter.h
+/// @brief  A second order notch (band-stop) biquad filter
+template <class T>
+class NotchFilter {
+public:
+    NotchFilter();
+
+    // set the filter parameters. The attenuation is the depth of the
+    // notch at the center frequency in dB
+    void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB);
+
+    // recalculate the coefficients for a new center frequency, keeping
+    // the filter state
+    void set_center_freq_hz(float center_freq_hz);
+
+    T apply(const T &sample);
+    void reset();
+
+    float get_center_freq_hz(void) const { return _center_freq_hz; }
+    bool initialised(void) const { return _initialised; }
+
+private:
+    void calculate_coefficients(void);
+
+    bool _initialised;
+    float _sample_freq_hz;
+    float _center_freq_hz;
+    float _bandwidth_hz;
+    float _attenuation_dB;
+
+    float _b0, _b1, _b2, _a1, _a2;
+    T _signal1, _signal2;
+    T _ntchsig1, _ntchsig2;
+};
+
+typedef NotchFilter<float>    NotchFilterFloat;
+typedef NotchFilter<Vector3f> NotchFilterVector3f;
+
+#endif // NOTCHFILTER_H
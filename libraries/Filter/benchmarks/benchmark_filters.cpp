@@ -0,0 +1,79 @@
+#include <AP_gbenchmark.h>
+
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/NotchFilter.h>
+#include <Filter/HarmonicNotchFilter.h>
+
+#define SAMPLE_RATE_HZ 8000
+#define BLOCK_SIZE 8
+
+static const Vector3f sample(0.1f, -0.2f, 0.3f);
+
+static void BM_LowPassFilter2pVector3f(benchmark::State& state)
+{
+    LowPassFilter2pVector3f filter(SAMPLE_RATE_HZ, 20);
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply(sample);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_LowPassFilter2pVector3fBlock(benchmark::State& state)
+{
+    LowPassFilter2pVector3f filter(SAMPLE_RATE_HZ, 20);
+    Vector3f samples[BLOCK_SIZE];
+
+    for (uint8_t i = 0; i < BLOCK_SIZE; i++) {
+        samples[i] = sample * i;
+    }
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply_block(samples, BLOCK_SIZE);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_NotchFilterVector3f(benchmark::State& state)
+{
+    NotchFilterVector3f filter;
+    filter.init(SAMPLE_RATE_HZ, 80, 40, 15);
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply(sample);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_HarmonicNotchFilterVector3f(benchmark::State& state)
+{
+    HarmonicNotchFilterVector3f filter;
+    filter.init(SAMPLE_RATE_HZ, 80, 40, 15, state.range_x());
+
+    while (state.KeepRunning()) {
+        Vector3f out = filter.apply(sample);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_HarmonicNotchFilterUpdate(benchmark::State& state)
+{
+    HarmonicNotchFilterVector3f filter;
+    filter.init(SAMPLE_RATE_HZ, 80, 40, 15, 0x07);
+    float freq = 80;
+
+    while (state.KeepRunning()) {
+        freq = (freq > 200) ? 80 : freq + 1;
+        filter.update(freq);
+        gbenchmark_clobber();
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2pVector3f);
+BENCHMARK(BM_LowPassFilter2pVector3fBlock);
+BENCHMARK(BM_NotchFilterVector3f);
+// bitmask of harmonics: fundamental only, 1st-2nd, 1st-3rd and 1st-4th
+BENCHMARK(BM_HarmonicNotchFilterVector3f)->Arg(0x01)->Arg(0x03)->Arg(0x07)->Arg(0x0F);
+BENCHMARK(BM_HarmonicNotchFilterUpdate);
+
+BENCHMARK_MAIN()
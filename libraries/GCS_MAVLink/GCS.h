@@ -15,6 +15,7 @@
 #include <AP_BattMonitor/AP_BattMonitor.h>
 #include <stdint.h>
 #include "MAVLink_routing.h"
+#include "MAVLink_parser.h"
 #include <AP_SerialManager/AP_SerialManager.h>
 #include <AP_Mount/AP_Mount.h>
 
@@ -69,6 +70,8 @@ enum ap_message {
     MSG_VIBRATION,
     MSG_RPM,
     MSG_MISSION_ITEM_REACHED,
+    MSG_GYRO_FFT,
+    MSG_LATENCY,
     MSG_RETRY_DEFERRED // this must be last
 };
 
@@ -152,6 +155,7 @@ public:
     void send_autopilot_version(uint8_t major_version, uint8_t minor_version, uint8_t patch_version, uint8_t version_type) const;
     void send_local_position(const AP_AHRS &ahrs) const;
     void send_vibration(const AP_InertialSensor &ins) const;
+    void send_latency();
     void send_home(const Location &home) const;
     static void send_home_all(const Location &home);
 
@@ -182,8 +186,23 @@ public:
     static bool find_by_mavtype(uint8_t mav_type, uint8_t &sysid, uint8_t &compid, mavlink_channel_t &channel) { return routing.find_by_mavtype(mav_type, sysid, compid, channel); }
 
 private:
+    // next set of scheduler latency stats to send
+    uint8_t _latency_index;
+
     void        handleMessage(mavlink_message_t * msg);
 
+    // process a good message from either receive path
+    void        packetReceived(mavlink_message_t &msg);
+
+    // per-byte receive, used while the CLI can still be started
+    void        update_receive_bytes(run_cli_fn run_cli);
+
+    // block receive through _parser
+    void        update_receive_blocks(void);
+
+    // frame level parser for the block receive path
+    MAVLink_parser _parser;
+
     /// The stream we are communicating over
     AP_HAL::UARTDriver *_port;
 
@@ -825,10 +825,28 @@ void GCS_MAVLINK::send_message(enum ap_message id)
     }
 }
 
+/*
+  handle a good message from either receive path
+ */
+void GCS_MAVLINK::packetReceived(mavlink_message_t &msg)
+{
+    // we exclude radio packets to make it possible to use the
+    // CLI over the radio
+    if (msg.msgid != MAVLINK_MSG_ID_RADIO && msg.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
+        mavlink_active |= (1U<<(chan-MAVLINK_COMM_0));
+    }
+    // if a snoop handler has been setup then use it
+    if (msg_snoop != NULL) {
+        msg_snoop(&msg);
+    }
+    if (routing.check_and_forward(chan, &msg)) {
+        handleMessage(&msg);
+    }
+}
+
 void
-GCS_MAVLINK::update(run_cli_fn run_cli)
+GCS_MAVLINK::update_receive_bytes(run_cli_fn run_cli)
 {
-    // receive new packets
     mavlink_message_t msg;
     mavlink_status_t status;
     status.packet_rx_drop_count = 0;
@@ -857,21 +875,88 @@ GCS_MAVLINK::update(run_cli_fn run_cli)
 
         // Try to get a new message
         if (mavlink_parse_char(chan, c, &msg, &status)) {
-            // we exclude radio packets to make it possible to use the
-            // CLI over the radio
-            if (msg.msgid != MAVLINK_MSG_ID_RADIO && msg.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
-                mavlink_active |= (1U<<(chan-MAVLINK_COMM_0));
-            }
-            // if a snoop handler has been setup then use it
-            if (msg_snoop != NULL) {
-                msg_snoop(&msg);
+            packetReceived(msg);
+        }
+        // parse errors are only reported for this byte, so keep a
+        // running count as update_receive_blocks() does
+        mavlink_get_channel_status(chan)->packet_rx_drop_count += status.packet_rx_drop_count;
+    }
+}
+
+/*
+  receive whole frames at a time. Ports with a contiguous receive
+  buffer are parsed in place, others are read in blocks. Bytes are
+  dropped from the port before each message is handled so a handler
+  never runs with a span into the receive buffer outstanding
+ */
+void
+GCS_MAVLINK::update_receive_blocks(void)
+{
+    mavlink_message_t msg;
+    mavlink_status_t *status = mavlink_get_channel_status(chan);
+    const uint32_t crc_errors = _parser.get_crc_errors();
+
+    // only process what was available on entry, so a fast link can't
+    // hold us here
+    uint16_t nbytes = comm_get_available(chan);
+    while (nbytes > 0) {
+        bool got_message;
+        const uint8_t *data;
+        uint16_t n = comm_receive_span(chan, data);
+        if (n > 0) {
+            n = MIN(n, nbytes);
+            uint16_t used = _parser.parse(data, n, msg, got_message);
+            comm_consume(chan, used);
+            nbytes -= used;
+            if (got_message) {
+                status->current_rx_seq = msg.seq;
+                status->packet_rx_success_count++;
+                packetReceived(msg);
             }
-            if (routing.check_and_forward(chan, &msg)) {
-                handleMessage(&msg);
+            continue;
+        }
+
+        uint8_t buf[64];
+        n = comm_receive_buffer(chan, buf, MIN(nbytes, (uint16_t)sizeof(buf)));
+        if (n == 0) {
+            break;
+        }
+        nbytes -= n;
+        uint16_t used = 0;
+        while (used < n) {
+            used += _parser.parse(&buf[used], n - used, msg, got_message);
+            if (got_message) {
+                status->current_rx_seq = msg.seq;
+                status->packet_rx_success_count++;
+                packetReceived(msg);
             }
         }
     }
 
+    // count bad frames as mavlink_parse_char() does, whether they
+    // were parsed in place or from a copy
+    status->packet_rx_drop_count += _parser.get_crc_errors() - crc_errors;
+
+    // keep comm_is_idle() meaningful for this channel
+    status->parse_state = _parser.idle() ? MAVLINK_PARSE_STATE_IDLE : MAVLINK_PARSE_STATE_GOT_STX;
+}
+
+void
+GCS_MAVLINK::update(run_cli_fn run_cli)
+{
+    // receive new packets. While the CLI can still be started every
+    // byte has to be looked at, so use the byte at a time parser. It
+    // is only switched to between frames
+    const bool cli_possible = run_cli && mavlink_active == 0 &&
+        (AP_HAL::millis() - _cli_timeout) < 20000;
+    if (_parser.idle() && (cli_possible || !comm_is_idle(chan))) {
+        // the second case lets the byte parser finish a frame it
+        // started before the CLI timed out
+        update_receive_bytes(run_cli);
+    } else {
+        update_receive_blocks();
+    }
+
     if (!waypoint_receiving) {
         return;
     }
@@ -1362,6 +1447,34 @@ void GCS_MAVLINK::send_vibration(const AP_InertialSensor &ins) const
         ins.get_accel_clip_count(2));
 }
 
+/*
+  send the scheduling latency of one thread per call as a DEBUG_VECT
+  named LAT_<tag>, such as LAT_TONE for the tone alarm thread, with the 99th percentile and maximum wakeup
+  lateness and the 99th percentile run time in microseconds
+ */
+void GCS_MAVLINK::send_latency()
+{
+    AP_HAL::Scheduler::latency_stats stats;
+    if (!hal.scheduler->get_latency_stats(_latency_index, stats)) {
+        if (_latency_index == 0 ||
+            !hal.scheduler->get_latency_stats(0, stats)) {
+            return;
+        }
+        _latency_index = 0;
+    }
+    _latency_index++;
+
+    char name[10];
+    hal.util->snprintf(name, sizeof(name), "LAT_%s", stats.tag);
+    mavlink_msg_debug_vect_send(
+        chan,
+        name,
+        AP_HAL::micros64(),
+        stats.late_p99_us,
+        stats.late_max_us,
+        stats.run_p99_us);
+}
+
 void GCS_MAVLINK::send_home(const Location &home) const
 {
     if (comm_get_txspace(chan) >= MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_HOME_POSITION_LEN) {
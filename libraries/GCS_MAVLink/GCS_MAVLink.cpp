@@ -93,6 +93,48 @@ uint8_t comm_receive_ch(mavlink_channel_t chan)
     return (uint8_t)mavlink_comm_port[chan]->read();
 }
 
+/// Get the oldest received bytes on the nominated MAVLink channel
+/// without copying them
+///
+/// @param chan		Channel to receive on
+/// @param data		Set to the start of the received bytes
+/// @returns		Number of contiguous bytes at data, zero if the
+///                 port does not support zero copy receive
+uint16_t comm_receive_span(mavlink_channel_t chan, const uint8_t *&data)
+{
+    data = nullptr;
+    if (chan >= MAVLINK_COMM_NUM_BUFFERS) {
+        return 0;
+    }
+    return mavlink_comm_port[chan]->peek_span(data);
+}
+
+/// Drop bytes returned by comm_receive_span()
+///
+/// @param chan		Channel to receive on
+/// @param len		Number of bytes to drop
+void comm_consume(mavlink_channel_t chan, uint16_t len)
+{
+    if (chan >= MAVLINK_COMM_NUM_BUFFERS) {
+        return;
+    }
+    mavlink_comm_port[chan]->consume(len);
+}
+
+/// Read a block of bytes from the nominated MAVLink channel
+///
+/// @param chan		Channel to receive on
+/// @param buf		Buffer to fill
+/// @param len		Size of buf
+/// @returns		Number of bytes read
+uint16_t comm_receive_buffer(mavlink_channel_t chan, uint8_t *buf, uint16_t len)
+{
+    if (chan >= MAVLINK_COMM_NUM_BUFFERS) {
+        return 0;
+    }
+    return mavlink_comm_port[chan]->read_bytes(buf, len);
+}
+
 /// Check for available transmit space on the nominated MAVLink channel
 ///
 /// @param chan		Channel to check
@@ -65,6 +65,29 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len);
 ///
 uint8_t comm_receive_ch(mavlink_channel_t chan);
 
+/// Get the oldest received bytes on the nominated MAVLink channel
+/// without copying them. They stay valid until comm_consume()
+///
+/// @param chan		Channel to receive on
+/// @param data		Set to the start of the received bytes
+/// @returns		Number of contiguous bytes at data, zero if the
+///                 port does not support zero copy receive
+uint16_t comm_receive_span(mavlink_channel_t chan, const uint8_t *&data);
+
+/// Drop bytes returned by comm_receive_span()
+///
+/// @param chan		Channel to receive on
+/// @param len		Number of bytes to drop
+void comm_consume(mavlink_channel_t chan, uint16_t len);
+
+/// Read a block of bytes from the nominated MAVLink channel
+///
+/// @param chan		Channel to receive on
+/// @param buf		Buffer to fill
+/// @param len		Size of buf
+/// @returns		Number of bytes read
+uint16_t comm_receive_buffer(mavlink_channel_t chan, uint8_t *buf, uint16_t len);
+
 /// Check for available data on the nominated MAVLink channel
 ///
 /// @param chan		Channel to check
@@ -0,0 +1,59 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/// @file	MAVLink_parser.h
+/// @brief	Frame level MAVLink parser working on blocks of received bytes
+
+#ifndef __MAVLINK_PARSER_H
+#define __MAVLINK_PARSER_H
+
+#include "GCS_MAVLink.h"
+
+/*
+  MAVLink_parser finds and checks whole MAVLink frames in a block of
+  received bytes, rather than running the byte at a time state machine
+  of mavlink_parse_char(). The start of a frame is found with memchr(),
+  the CRC is checked in place and only the header and payload of good
+  frames are copied into the message. Bytes are only buffered when a
+  frame is split across blocks.
+
+  On a bad CRC the search restarts one byte after the failed start
+  byte, so a message hidden behind a corrupt or false frame start is
+  not lost.
+ */
+class MAVLink_parser
+{
+public:
+    MAVLink_parser(void);
+
+    /*
+      parse up to len bytes, stopping after the first good message.
+      Returns the number of bytes used, which the caller should drop
+      from its input before calling again. got_message is set when msg
+      has been filled in
+     */
+    uint16_t parse(const uint8_t *data, uint16_t len, mavlink_message_t &msg, bool &got_message);
+
+    // true when no partial frame is held
+    bool idle(void) const { return _buf_len == 0; }
+
+    uint32_t get_rx_count(void) const { return _rx_count; }
+    uint32_t get_crc_errors(void) const { return _crc_errors; }
+    uint32_t get_bytes_skipped(void) const { return _bytes_skipped; }
+
+    // X.25 CRC of len bytes, continuing from crc
+    static uint16_t crc_calculate(const uint8_t *data, uint16_t len, uint16_t crc);
+
+private:
+    // partial frame carried over from a previous block
+    uint8_t _buf[MAVLINK_MAX_PACKET_LEN];
+    uint16_t _buf_len;
+
+    uint32_t _rx_count;
+    uint32_t _crc_errors;
+    uint32_t _bytes_skipped;
+
+    bool _decode(const uint8_t *frame, mavlink_message_t &msg);
+    void _discard(uint16_t n);
+};
+
+#endif // __MAVLINK_PARSER_H
@@ -0,0 +1,87 @@
+#include <AP_gbenchmark.h>
+
+#include <GCS_MAVLink/GCS.h>
+
+// a second of typical GCS to vehicle traffic, repeated
+#define STREAM_MESSAGES 64
+
+static uint8_t stream[STREAM_MESSAGES * MAVLINK_MAX_PACKET_LEN];
+static uint16_t stream_len;
+
+static void fill_stream(void)
+{
+    if (stream_len != 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < STREAM_MESSAGES; i++) {
+        mavlink_message_t msg;
+        switch (i % 4) {
+        case 0:
+            mavlink_msg_heartbeat_pack(255, 190, &msg, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, 0);
+            break;
+        case 1:
+            mavlink_msg_rc_channels_override_pack(255, 190, &msg, 1, 1, 1500, 1500, 1100, 1500, 0, 0, 0, 0);
+            break;
+        case 2:
+            mavlink_msg_param_request_read_pack(255, 190, &msg, 1, 1, "RATE_RLL_P", -1);
+            break;
+        default:
+            mavlink_msg_gps_inject_data_pack(255, 190, &msg, 1, 1, 110, (const uint8_t *)stream);
+            break;
+        }
+        stream_len += mavlink_msg_to_send_buffer(&stream[stream_len], &msg);
+    }
+}
+
+static void BM_MAVLinkParseChar(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    uint32_t count = 0;
+
+    fill_stream();
+
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < stream_len; i++) {
+            if (mavlink_parse_char(MAVLINK_COMM_0, stream[i], &msg, &status)) {
+                count++;
+            }
+        }
+        gbenchmark_escape(&count);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+/*
+  parse in blocks of range_x bytes, as handed over by a UART
+ */
+static void BM_MAVLinkParser(benchmark::State& state)
+{
+    MAVLink_parser parser;
+    mavlink_message_t msg;
+    uint32_t count = 0;
+    const uint16_t block = state.range_x();
+
+    fill_stream();
+
+    while (state.KeepRunning()) {
+        for (uint16_t ofs = 0; ofs < stream_len; ofs += block) {
+            const uint16_t n = MIN(block, (uint16_t)(stream_len - ofs));
+            uint16_t used = 0;
+            while (used < n) {
+                bool got_message;
+                used += parser.parse(&stream[ofs + used], n - used, msg, got_message);
+                if (got_message) {
+                    count++;
+                }
+            }
+        }
+        gbenchmark_escape(&count);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+BENCHMARK(BM_MAVLinkParseChar);
+BENCHMARK(BM_MAVLinkParser)->Arg(16)->Arg(64)->Arg(512);
+
+BENCHMARK_MAIN()